@@ -1,24 +1,26 @@
 #define SPICA_API_EXPORT
 #include "bvh.h"
 
-#include <stack>
+#include <cmath>
+#include <limits>
 #include <functional>
 #include <algorithm>
 
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "core/bounds3d.h"
+#include "core/float.h"
 #include "core/interaction.h"
+#include "core/parallel.h"
+#include "core/timer.h"
+#include "core/trimesh.h"
+#include "core/raybatch.h"
 
 namespace spica {
 
-const float inff = (float)INFTY;
-const float epsf = (float)EPS;
-alignas(16) float infs[4]  = { inff, inff, inff, inff };
-alignas(16) float zeros[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-alignas(16) float epss[4]  = { epsf, epsf, epsf, epsf };
-__m128 simdInf = _mm_load_ps(infs);
-__m128 simdZero = _mm_load_ps(zeros);
-__m128 simdEps  = _mm_load_ps(epss);
-
 static const int orderTable[] = {
     //+++      -++      +-+      --+      ++-      -+-      +--      ---       <-- right, left, top
     0x44444, 0x44444, 0x44444, 0x44444, 0x44444, 0x44444, 0x44444, 0x44444,  // --|-- (TL, TR | BL, BR)
@@ -39,19 +41,288 @@ static const int orderTable[] = {
     0x40123, 0x40132, 0x41023, 0x41032, 0x42301, 0x43201, 0x42310, 0x43210,  // ++|++
 };
 
-int test_AABB(const __m128 bboxes[2][3], const __m128 org[3], const __m128 idir[3], const int sign[3], __m128 tmin, __m128 tmax) {
-    tmin = _mm_max_ps(tmin, _mm_mul_ps(_mm_sub_ps(bboxes[sign[0]][0], org[0]), idir[0]));
-    tmax = _mm_min_ps(tmax, _mm_mul_ps(_mm_sub_ps(bboxes[1 - sign[0]][0], org[0]), idir[0]));
-    tmin = _mm_max_ps(tmin, _mm_mul_ps(_mm_sub_ps(bboxes[sign[1]][1], org[1]), idir[1]));
-    tmax = _mm_min_ps(tmax, _mm_mul_ps(_mm_sub_ps(bboxes[1 - sign[1]][1], org[1]), idir[1]));
-    tmin = _mm_max_ps(tmin, _mm_mul_ps(_mm_sub_ps(bboxes[sign[2]][2], org[2]), idir[2]));
-    tmax = _mm_min_ps(tmax, _mm_mul_ps(_mm_sub_ps(bboxes[1 - sign[2]][2], org[2]), idir[2]));
-    return _mm_movemask_ps(_mm_cmpge_ps(tmax, tmin));
+// Round double to float toward -inf/+inf, so that float bounds stay conservative.
+inline float roundDown(double d) {
+    float f = static_cast<float>(d);
+    return f > d ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+}
+
+inline float roundUp(double d) {
+    float f = static_cast<float>(d);
+    return f < d ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+}
+
+// Conservative scaling of the far distance against float rounding errors
+static constexpr float tMaxScale = 1.0f + 2.0f * gamma<float>(3);
+
+inline bool intersectLinearNode(const LinearBVHNode& node, const float org[3],
+                                const float invDir[3], const int dirIsNeg[3],
+                                float rayMax) {
+    const float* bounds[2] = { node.posMin, node.posMax };
+    float tMin  = (bounds[    dirIsNeg[0]][0] - org[0]) * invDir[0];
+    float tMax  = (bounds[1 - dirIsNeg[0]][0] - org[0]) * invDir[0];
+    float tyMin = (bounds[    dirIsNeg[1]][1] - org[1]) * invDir[1];
+    float tyMax = (bounds[1 - dirIsNeg[1]][1] - org[1]) * invDir[1];
+    tMax  *= tMaxScale;
+    tyMax *= tMaxScale;
+    if (tMin > tyMax || tyMin > tMax) return false;
+    if (tyMin > tMin) tMin = tyMin;
+    if (tyMax < tMax) tMax = tyMax;
+
+    float tzMin = (bounds[    dirIsNeg[2]][2] - org[2]) * invDir[2];
+    float tzMax = (bounds[1 - dirIsNeg[2]][2] - org[2]) * invDir[2];
+    tzMax *= tMaxScale;
+    if (tMin > tzMax || tzMin > tMax) return false;
+    if (tzMin > tMin) tMin = tzMin;
+    if (tzMax < tMax) tMax = tzMax;
+
+    return (tMin < rayMax) && (tMax > 0.0f);
+}
+
+// Ray data for the 4-wide box tests, which is computed once per traversal.
+struct SIMDRay {
+    __m128 org[3];     // origin
+    __m128 invDir[3];  // inverse direction
+    int dirIsNeg[3];   // signs of ray direction (pos -> 0, neg -> 1)
+
+    explicit SIMDRay(const Ray& ray) {
+        // Zero components of the direction are already replaced with
+        // INFTY, which is finite in float and never makes 0 * inf = NaN.
+        for (int i = 0; i < 3; i++) {
+            const float invd = static_cast<float>(ray.invdir()[i]);
+            org[i]      = _mm_set1_ps(static_cast<float>(ray.org()[i]));
+            invDir[i]   = _mm_set1_ps(invd);
+            dirIsNeg[i] = invd < 0.0f ? 1 : 0;
+        }
+    }
+};
+
+// Test the four child bounds of a QBVH node at once. The far distances are
+// scaled by "tMaxScale", so that the test is conservative against float
+// rounding errors. The entry distances are stored in "tNear" and the hit
+// mask is returned.
+static int test_AABB(const __m128 bboxes[2][3], const SIMDRay& ray,
+                     float rayMax, float tNear[4]) {
+    const __m128 scale = _mm_set1_ps(tMaxScale);
+    __m128 tmin = _mm_setzero_ps();
+    __m128 tmax = _mm_set1_ps(rayMax);
+    for (int a = 0; a < 3; a++) {
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(bboxes[    ray.dirIsNeg[a]][a], ray.org[a]), ray.invDir[a]);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(bboxes[1 - ray.dirIsNeg[a]][a], ray.org[a]), ray.invDir[a]);
+        tmin = _mm_max_ps(t0, tmin);
+        tmax = _mm_min_ps(_mm_mul_ps(t1, scale), tmax);
+    }
+    _mm_store_ps(tNear, tmin);
+    return _mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+}
+
+// Four consecutive rays of a batch, which traverse the BVH together. The
+// lanes without rays have negative "rayMax" and never hit anything.
+struct RayPacket4 {
+    __m128 org[3];
+    __m128 invDir[3];
+    alignas(16) float rayMax[4];
+    int dirIsNeg[3];  // signs of the first ray, which order the children
+    int mask;         // lanes with rays
+
+    RayPacket4(const RayBatch& rays, int start) {
+        alignas(16) float o[3][4] = {}, d[3][4] = {};
+        const int count = std::min(4, rays.size() - start);
+        for (int k = 0; k < 4; k++) {
+            rayMax[k] = -1.0f;
+            if (k >= count) continue;
+
+            const Ray& ray = rays[start + k];
+            for (int a = 0; a < 3; a++) {
+                o[a][k] = static_cast<float>(ray.org()[a]);
+                d[a][k] = static_cast<float>(ray.invdir()[a]);
+            }
+            rayMax[k] = static_cast<float>(ray.maxDist());
+        }
+
+        for (int a = 0; a < 3; a++) {
+            org[a]      = _mm_load_ps(o[a]);
+            invDir[a]   = _mm_load_ps(d[a]);
+            dirIsNeg[a] = d[a][0] < 0.0f ? 1 : 0;
+        }
+        mask = (1 << count) - 1;
+    }
+};
+
+// Test the bounds of a linearized node against the four rays at once. The
+// test is conservative against float rounding errors as "test_AABB", and
+// the hit mask is returned.
+static int test_RayPacket4(const LinearBVHNode& node, const RayPacket4& packet) {
+    const __m128 scale = _mm_set1_ps(tMaxScale);
+    __m128 tmin = _mm_setzero_ps();
+    __m128 tmax = _mm_load_ps(packet.rayMax);
+    for (int a = 0; a < 3; a++) {
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.posMin[a]), packet.org[a]), packet.invDir[a]);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.posMax[a]), packet.org[a]), packet.invDir[a]);
+        tmin = _mm_max_ps(_mm_min_ps(t0, t1), tmin);
+        tmax = _mm_min_ps(_mm_mul_ps(_mm_max_ps(t0, t1), scale), tmax);
+    }
+    return _mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+}
+
+// Moller-Trumbore test of four triangles at once. The hit distances and
+// the barycentric coordinates of the 2nd and 3rd vertices are stored, and
+// the hit mask is returned. Empty lanes have degenerate triangles (det = 0).
+static int test_Triangle4(const float p0[3][4], const float e1[3][4],
+                          const float e2[3][4], const __m128 org[3],
+                          const __m128 dir[3], float rayMax,
+                          float tHit[4], float b1[4], float b2[4]) {
+    __m128 E1[3], E2[3], T[3];
+    for (int a = 0; a < 3; a++) {
+        E1[a] = _mm_load_ps(e1[a]);
+        E2[a] = _mm_load_ps(e2[a]);
+        T[a]  = _mm_sub_ps(org[a], _mm_load_ps(p0[a]));
+    }
+
+    // pVec = dir x e2, qVec = tVec x e1
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dir[1], E2[2]), _mm_mul_ps(dir[2], E2[1]));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dir[2], E2[0]), _mm_mul_ps(dir[0], E2[2]));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dir[0], E2[1]), _mm_mul_ps(dir[1], E2[0]));
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(T[1], E1[2]), _mm_mul_ps(T[2], E1[1]));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(T[2], E1[0]), _mm_mul_ps(T[0], E1[2]));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(T[0], E1[1]), _mm_mul_ps(T[1], E1[0]));
+
+    auto dot = [](__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+    };
+
+    const __m128 det = dot(E1[0], E1[1], E1[2], px, py, pz);
+    const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+    const __m128 u = _mm_mul_ps(dot(T[0], T[1], T[2], px, py, pz), invDet);
+    const __m128 v = _mm_mul_ps(dot(dir[0], dir[1], dir[2], qx, qy, qz), invDet);
+    const __m128 t = _mm_mul_ps(dot(E2[0], E2[1], E2[2], qx, qy, qz), invDet);
+
+    // NaN in any of u, v and t fails the comparisons below.
+    const __m128 zero = _mm_setzero_ps();
+    __m128 mask = _mm_cmpneq_ps(det, zero);
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, _mm_set1_ps(static_cast<float>(EPS))));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(t, _mm_set1_ps(rayMax)));
+
+    _mm_store_ps(tHit, t);
+    _mm_store_ps(b1, u);
+    _mm_store_ps(b2, v);
+    return _mm_movemask_ps(mask);
+}
+
+// Parameters for parallel BVH construction
+static const int kParallelChunkSize = 16384;
+static const int kParallelBuildThreshold = 4096;
+static const double kMortonScale = 1024.0;
+
+// Run func(chunkIndex, s, e) for the chunks [s, e) of [start, end) in parallel.
+static void parallelForChunks(int start, int end,
+                              const std::function<void(int, int, int)>& func) {
+    const int nChunks = (end - start + kParallelChunkSize - 1) / kParallelChunkSize;
+    parallel_for(0, nChunks, [&](int c) {
+        const int s = start + c * kParallelChunkSize;
+        func(c, s, std::min(s + kParallelChunkSize, end));
+    });
+}
+
+// Interleave the lower 10 bits of x with two zero bits.
+inline uint32_t leftShift3(uint32_t x) {
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x <<  8)) & 0x0300f00f;
+    x = (x | (x <<  4)) & 0x030c30c3;
+    x = (x | (x <<  2)) & 0x09249249;
+    return x;
+}
+
+inline uint32_t encodeMorton3(uint32_t x, uint32_t y, uint32_t z) {
+    return (leftShift3(z) << 2) | (leftShift3(y) << 1) | leftShift3(x);
+}
+
+// Sort 30-bit Morton codes in 5 passes of 6 bits.
+static void radixSort(std::vector<MortonPrimitive>* v) {
+    static const int bitsPerPass = 6;
+    static const int nBits = 30;
+    static const int nPasses = nBits / bitsPerPass;
+    static const int nBuckets = 1 << bitsPerPass;
+    static const uint32_t bitMask = nBuckets - 1;
+
+    std::vector<MortonPrimitive> tempVector(v->size());
+    for (int pass = 0; pass < nPasses; pass++) {
+        const int lowBit = pass * bitsPerPass;
+        std::vector<MortonPrimitive>& in  = (pass & 1) ? tempVector : *v;
+        std::vector<MortonPrimitive>& out = (pass & 1) ? *v : tempVector;
+
+        int bucketCount[nBuckets] = { 0 };
+        for (const MortonPrimitive& mp : in) {
+            bucketCount[(mp.mortonCode >> lowBit) & bitMask]++;
+        }
+
+        int outIndex[nBuckets];
+        outIndex[0] = 0;
+        for (int i = 1; i < nBuckets; i++) {
+            outIndex[i] = outIndex[i - 1] + bucketCount[i - 1];
+        }
+
+        for (const MortonPrimitive& mp : in) {
+            const int b = (mp.mortonCode >> lowBit) & bitMask;
+            out[outIndex[b]++] = mp;
+        }
+    }
+
+    if (nPasses & 1) {
+        std::swap(*v, tempVector);
+    }
+}
+
+// The 8-wide BVH is compiled for AVX2 regardless of the build options, and
+// it is used only when the CPU supports AVX2 at runtime.
+#if defined(__GNUC__) || defined(__clang__)
+#define SPICA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SPICA_TARGET_AVX2
+#endif
+
+static bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+// Test the eight child bounds of a 8-wide BVH node at once. The entry
+// distances are stored in "tNear" and the hit mask is returned.
+SPICA_TARGET_AVX2
+static int test_AABB8(const float bboxes[2][3][8], const __m256 org[3],
+                      const __m256 invDir[3], const int dirIsNeg[3],
+                      float rayMax, float tNear[8]) {
+    const __m256 scale = _mm256_set1_ps(tMaxScale);
+    __m256 tmin = _mm256_setzero_ps();
+    __m256 tmax = _mm256_set1_ps(rayMax);
+    for (int a = 0; a < 3; a++) {
+        const __m256 lo = _mm256_load_ps(bboxes[    dirIsNeg[a]][a]);
+        const __m256 hi = _mm256_load_ps(bboxes[1 - dirIsNeg[a]][a]);
+        const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(lo, org[a]), invDir[a]);
+        const __m256 t1 = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(hi, org[a]), invDir[a]), scale);
+        // NaN (0 * inf) in t0 or t1 leaves tmin and tmax unchanged.
+        tmin = _mm256_max_ps(t0, tmin);
+        tmax = _mm256_min_ps(t1, tmax);
+    }
+    _mm256_store_ps(tNear, tmin);
+    return _mm256_movemask_ps(_mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ));
 }
 
 struct BVHAccel::BucketInfo {
     int count;
-    Bounds3d bounds;
+    Bounds3 bounds;
     BucketInfo()
         : count(0)
         , bounds() {
@@ -69,9 +340,9 @@ struct BVHAccel::ComparePoint {
 
 struct BVHAccel::CompareToBucket {
     int splitBucket, nBuckets, dim;
-    const Bounds3d& centroidBounds;
+    const Bounds3& centroidBounds;
 
-    CompareToBucket(int split, int num, int d, const Bounds3d& b)
+    CompareToBucket(int split, int num, int d, const Bounds3& b)
         : splitBucket(split)
         , nBuckets(num)
         , dim(d)
@@ -79,6 +350,11 @@ struct BVHAccel::CompareToBucket {
     }
 
     bool operator()(const BVHPrimitiveInfo& p) const {
+        return bucketIndex(p, nBuckets, dim, centroidBounds) <= splitBucket;
+    }
+
+    static int bucketIndex(const BVHPrimitiveInfo& p, int nBuckets, int dim,
+                           const Bounds3& centroidBounds) {
         const double cmin = centroidBounds.posMin()[dim];
         const double cmax = centroidBounds.posMax()[dim];
         const double inv = (1.0) / (std::abs(cmax - cmin) + EPS);
@@ -87,7 +363,7 @@ struct BVHAccel::CompareToBucket {
         if (b >= nBuckets) {
             b = nBuckets - 1;
         }
-        return b <= splitBucket;
+        return b;
     }
 };
 
@@ -106,143 +382,642 @@ struct BVHAccel::SIMDBVHNode {
     int axis_top;
     int axis_left;
     int axis_right;
-    int reserved;
+    uint8_t nPrims[4];  // # of primitives in each leaf child
+};
+
+struct alignas(32) BVHAccel::SIMD8BVHNode {
+    float bboxes[2][3][8];  // [min/max][x/y/z][child]
+    Children children[8];
+    uint8_t nPrims[8];      // # of primitives in each leaf child
+};
+
+/**
+ * Four triangles of a leaf packed in the SoA layout.
+ */
+struct alignas(16) BVHAccel::Triangle4 {
+    float p0[3][4];  // [x/y/z][lane]
+    float e1[3][4];  // p1 - p0
+    float e2[3][4];  // p2 - p0
+    int primIdx[4];  // index of "primitives_", -1 for empty lanes
 };
 
 BVHAccel::BVHAccel(const std::vector<std::shared_ptr<Primitive>>& prims,
-                   bool useSIMD)
+                   bool useSIMD, bool useLinearBVH, int maxPrimsInNode,
+                   BuildMethod method, int simdWidth)
     : Accelerator{prims}
     , root_{nullptr}
+    , nodes_{}
+    , totalNodes_{0}
     , simdNodes_{}
-    , useSIMD_{useSIMD} {
+    , simd8Nodes_{}
+    , orderedPrims_{}
+    , triangle4s_{}
+    , leafTriangle4s_{}
+    , linearNodes_{nullptr}
+    , totalLinearNodes_{0}
+    , maxPrimsInNode_{clamp(maxPrimsInNode, 1, 255)}
+    , method_{method}
+    , useSIMD_{useSIMD}
+    , useAVX_{false}
+    , useLinearBVH_{useLinearBVH && !useSIMD} {
     // Construct standard BVH
     construct();
-    if (useSIMD) {
+    if (root_ == nullptr) {
+        useSIMD_ = useLinearBVH_ = false;
+        return;
+    }
+
+    // Pack the triangles in the leaves for the SIMD intersection
+    packTriangles();
+
+    if (simdWidth != 4 && simdWidth != 8) {
+        Warning("SIMD width must be 4 or 8: width = %d", simdWidth);
+        simdWidth = 4;
+    }
+
+    if (useSIMD_ && simdWidth == 8 && !cpuSupportsAVX2()) {
+        Warning("AVX2 is not supported. 4-wide BVH is used instead.");
+        simdWidth = 4;
+    }
+
+    if (useSIMD_ && simdWidth == 8) {
+        // Construct 8-wide BVH
+        MsgInfo("BVH: 8-wide SIMD (AVX2) accleration enabled!");
+        useAVX_ = true;
+        collapse2OBVH(root_);
+    } else if (useSIMD_) {
         // Construct QBVH
         MsgInfo("BVH: SIMD accleration enabled!");
         collapse2QBVH(root_);
+    } else if (useLinearBVH_) {
+        MsgInfo("BVH: Linearized layout enabled!");
     }
+
+    // Flatten the tree into depth-first order. The linearized layout is
+    // also used by the packet traversal of ray batches.
+    linearNodes_ = static_cast<LinearBVHNode*>(
+        align_alloc(sizeof(LinearBVHNode) * nodes_.size(), 32));
+    Assertion(linearNodes_ != nullptr, "allocation failed !!");
+
+    int offset = 0;
+    flattenBVH(root_, &offset);
+    totalLinearNodes_ = offset;
 }
 
 BVHAccel::BVHAccel(const std::vector<std::shared_ptr<Primitive>> &prims,
                    RenderParams &params)
-    : BVHAccel{prims, params.getBool("useSIMD", false, true)} {
+    : BVHAccel{prims, params.getBool("useSIMD", false, true),
+               params.getBool("useLinearBVH", false, true),
+               params.getInt("maxPrimsInNode", 4, true),
+               parseBuildMethod(params.getString("bvhBuilder", "sah", true)),
+               params.getInt("simdWidth", 4, true)} {
 }
 
 BVHAccel::~BVHAccel() {
+    release();
+}
+
+BVHAccel::BuildMethod BVHAccel::parseBuildMethod(const std::string& name) {
+    if (name == "sah") return BuildMethod::SAH;
+    if (name == "hlbvh" || name == "lbvh") return BuildMethod::HLBVH;
+
+    Warning("Unknown BVH builder \"%s\" is specified. SAH is used instead.", name.c_str());
+    return BuildMethod::SAH;
 }
 
-Bounds3d BVHAccel::worldBound() const {
-    return nodes_.empty() ? Bounds3d() : nodes_[0]->bounds;
+Bounds3 BVHAccel::worldBound() const {
+    return root_ != nullptr ? root_->bounds : Bounds3();
 }
 
 void BVHAccel::construct() {
     if (primitives_.empty()) return;
-        
-    std::vector<BVHPrimitiveInfo> primitiveInfo(primitives_.size());
-    for (int i = 0; i < primitives_.size(); i++) {
-        primitiveInfo[i] = { i, primitives_[i]->worldBound() };
+
+    Timer timer;
+    timer.start();
+
+    const int nPrims = static_cast<int>(primitives_.size());
+    std::vector<BVHPrimitiveInfo> primitiveInfo(nPrims);
+    parallelForChunks(0, nPrims, [&](int, int s, int e) {
+        for (int i = s; i < e; i++) {
+            primitiveInfo[i] = { i, primitives_[i]->worldBound() };
+        }
+    });
+
+    // A binary tree with at most "nPrims" leaves has less than 2 * nPrims nodes.
+    // All the nodes are allocated at once and handed out to the builder threads.
+    nodes_.resize(2 * nPrims - 1);
+    totalNodes_ = 0;
+    orderedPrims_.assign(nPrims, -1);
+    if (method_ == BuildMethod::HLBVH) {
+        root_ = constructHLBVH(primitiveInfo);
+    } else {
+        root_ = constructRec(primitiveInfo, 0, nPrims);
+    }
+    nodes_.resize(totalNodes_);
+
+    MsgInfo("BVH: built with %s in %.3f sec",
+            method_ == BuildMethod::HLBVH ? "HLBVH" : "SAH", timer.stop());
+    reportBuildQuality();
+}
+
+BVHNode* BVHAccel::allocateNode() {
+    const int index = totalNodes_++;
+    Assertion(index < static_cast<int>(nodes_.size()), "Too many BVH nodes are allocated !!");
+    return &nodes_[index];
+}
+
+void BVHAccel::computeBounds(const std::vector<BVHPrimitiveInfo>& buildData,
+                             int start, int end, Bounds3* bounds,
+                             Bounds3* centroidBounds) {
+    if (end - start < kParallelChunkSize * 2) {
+        for (int i = start; i < end; i++) {
+            bounds->merge(buildData[i].bounds);
+            centroidBounds->merge(buildData[i].centroid);
+        }
+        return;
     }
 
-    root_ = constructRec(primitiveInfo, 0, primitives_.size());
+    const int nChunks = (end - start + kParallelChunkSize - 1) / kParallelChunkSize;
+    std::vector<Bounds3> chunkBounds(nChunks), chunkCentroidBounds(nChunks);
+    parallelForChunks(start, end, [&](int c, int s, int e) {
+        for (int i = s; i < e; i++) {
+            chunkBounds[c].merge(buildData[i].bounds);
+            chunkCentroidBounds[c].merge(buildData[i].centroid);
+        }
+    });
+
+    for (int c = 0; c < nChunks; c++) {
+        bounds->merge(chunkBounds[c]);
+        centroidBounds->merge(chunkCentroidBounds[c]);
+    }
 }
 
 BVHNode* BVHAccel::constructRec(std::vector<BVHPrimitiveInfo>& buildData,
-                        int start, int end) {
+                                int start, int end) {
     if (start == end) return nullptr;
 
-    BVHNode* node = new BVHNode();
-    nodes_.emplace_back(node);
+    BVHNode* node = allocateNode();
 
-    Bounds3d bounds;
-    for (int i = start; i < end; i++) {
-        bounds = Bounds3d::merge(bounds, buildData[i].bounds);
-    }
+    Bounds3 bounds, centroidBounds;
+    computeBounds(buildData, start, end, &bounds, &centroidBounds);
 
-    int nprims = end - start;
-    if (nprims == 1) {
-        // Leaf node
-        node->initLeaf(bounds, buildData[start].primIdx);
-    } else {
-        // Fork node
-        Bounds3d centroidBounds;
+    // Since "buildData" is partitioned in place, the primitives of a leaf
+    // are stored in the same range of the ordered primitive list.
+    auto makeLeaf = [&]() {
         for (int i = start; i < end; i++) {
-            centroidBounds.merge(buildData[i].centroid);
+            orderedPrims_[i] = buildData[i].primIdx;
         }
+        node->initLeaf(bounds, start, end - start);
+        return node;
+    };
 
-        int splitAxis = centroidBounds.maximumExtent();
-        int mid = (start + end) / 2;
-        if (nprims <= 8) {
-            std::nth_element(buildData.begin() + start,
-                                buildData.begin() + mid,
-                                buildData.begin() + end,
-                                ComparePoint(splitAxis));
-        } else {
-            // Seperate with SAH (surface area heuristics)
-            const int nBuckets = 16;
-            BucketInfo buckets[nBuckets];
-
-            const double cmin = centroidBounds.posMin()[splitAxis];
-            const double cmax = centroidBounds.posMax()[splitAxis];
-            const double idenom = 1.0 / (std::abs(cmax - cmin) + EPS);
-            for (int i = start; i < end; i++) {
-                const double numer = buildData[i].centroid[splitAxis] -
-                                        centroidBounds.posMin()[splitAxis];
-                int b = static_cast<int>(nBuckets * std::abs(numer) * idenom);
-                if (b == nBuckets) {
-                    b = nBuckets - 1;
-                }
+    const int nprims = end - start;
+    if (nprims == 1) {
+        return makeLeaf();
+    }
 
-                buckets[b].count++;
-                buckets[b].bounds = Bounds3d::merge(buckets[b].bounds, buildData[i].bounds);
-            }
+    int splitAxis = centroidBounds.maximumExtent();
+    const double maxExtent = centroidBounds.posMax()[splitAxis] -
+                             centroidBounds.posMin()[splitAxis];
 
-            double bucketCost[nBuckets - 1] = {0};
-            for (int i = 0; i < nBuckets - 1; i++) {
-                Bounds3d b0, b1;
-                int cnt0 = 0, cnt1 = 0;
-                for (int j = 0; j <= i; j++) {
-                    b0 = Bounds3d::merge(b0, buckets[j].bounds);
-                    cnt0 += buckets[j].count;
-                }
-                for (int j = i + 1; j < nBuckets; j++) {
-                    b1 = Bounds3d::merge(b1, buckets[j].bounds);
-                    cnt1 += buckets[j].count;
+    int mid = (start + end) / 2;
+    if (maxExtent <= 0.0) {
+        // All the centroids are at the same position
+        if (nprims <= maxPrimsInNode_) {
+            return makeLeaf();
+        }
+    } else {
+        // Seperate with SAH (surface area heuristics), evaluated with binning
+        // along all the three axes. Large ranges are binned in parallel.
+        const int nBuckets = 16;
+        BucketInfo buckets[3][nBuckets];
+        auto binPrimitives = [&](int s, int e, BucketInfo* bins) {
+            for (int i = s; i < e; i++) {
+                for (int axis = 0; axis < 3; axis++) {
+                    const int b = CompareToBucket::bucketIndex(buildData[i], nBuckets,
+                                                               axis, centroidBounds);
+                    bins[axis * nBuckets + b].count++;
+                    bins[axis * nBuckets + b].bounds.merge(buildData[i].bounds);
                 }
-                bucketCost[i] += 0.125 + (cnt0 * b0.area() + cnt1 * b1.area()) / bounds.area();
             }
+        };
 
-            double minCost = bucketCost[0];
-            int minCostSplit = 0;
-            for (int i = 1; i < nBuckets - 1; i++) {
-                if (minCost > bucketCost[i]) {
-                    minCost = bucketCost[i];
-                    minCostSplit = i;
+        if (nprims < kParallelChunkSize * 2) {
+            binPrimitives(start, end, &buckets[0][0]);
+        } else {
+            const int nChunks = (nprims + kParallelChunkSize - 1) / kParallelChunkSize;
+            std::vector<BucketInfo> chunkBuckets(nChunks * 3 * nBuckets);
+            parallelForChunks(start, end, [&](int c, int s, int e) {
+                binPrimitives(s, e, &chunkBuckets[c * 3 * nBuckets]);
+            });
+
+            for (int c = 0; c < nChunks; c++) {
+                for (int k = 0; k < 3 * nBuckets; k++) {
+                    const BucketInfo& bin = chunkBuckets[c * 3 * nBuckets + k];
+                    buckets[k / nBuckets][k % nBuckets].count += bin.count;
+                    buckets[k / nBuckets][k % nBuckets].bounds.merge(bin.bounds);
                 }
             }
+        }
+
+        double minCost = INFTY;
+        int minCostSplit = -1;
+        for (int axis = 0; axis < 3; axis++) {
+            const double extent = centroidBounds.posMax()[axis] -
+                                  centroidBounds.posMin()[axis];
+            if (extent <= 0.0) continue;
+
+            int split;
+            const double cost = findBucketSplit(buckets[axis], nBuckets, bounds, &split);
+            if (cost < minCost) {
+                minCost = cost;
+                minCostSplit = split;
+                splitAxis = axis;
+            }
+        }
+
+        // Create a leaf if it is cheaper than splitting.
+        const double leafCost = nprims;
+        if (nprims <= maxPrimsInNode_ && (minCostSplit < 0 || leafCost <= minCost)) {
+            return makeLeaf();
+        }
+
+        if (minCostSplit >= 0) {
+            auto it = std::partition(buildData.begin() + start,
+                                     buildData.begin() + end,
+                                     CompareToBucket(minCostSplit, nBuckets, splitAxis, centroidBounds));
+            mid = it - buildData.begin();
+        }
+
+        if (mid == start || mid == end) {
+            mid = (start + end) / 2;
+            std::nth_element(buildData.begin() + start,
+                             buildData.begin() + mid,
+                             buildData.begin() + end,
+                             ComparePoint(splitAxis));
+        }
+    }
+
+    // Subtrees are built in parallel while they are large enough.
+    BVHNode* children[2];
+    if (nprims >= kParallelBuildThreshold) {
+        const int ranges[3] = { start, mid, end };
+        parallel_for(0, 2, [&](int i) {
+            children[i] = constructRec(buildData, ranges[i], ranges[i + 1]);
+        });
+    } else {
+        children[0] = constructRec(buildData, start, mid);
+        children[1] = constructRec(buildData, mid, end);
+    }
+    node->initFork(bounds, children[0], children[1], splitAxis);
+    return node;
+}
+
+BVHNode* BVHAccel::constructHLBVH(const std::vector<BVHPrimitiveInfo>& buildData) {
+    const int nPrims = static_cast<int>(buildData.size());
+    Bounds3 bounds, centroidBounds;
+    computeBounds(buildData, 0, nPrims, &bounds, &centroidBounds);
+
+    // Compute Morton codes of the centroids quantized to 10 bits per axis
+    std::vector<MortonPrimitive> mortonPrims(nPrims);
+    const Point3 cmin = centroidBounds.posMin();
+    const Vector3 extent = centroidBounds.posMax() - cmin;
+    parallelForChunks(0, nPrims, [&](int, int s, int e) {
+        for (int i = s; i < e; i++) {
+            uint32_t q[3];
+            for (int k = 0; k < 3; k++) {
+                const double t = extent[k] > 0.0 ? (buildData[i].centroid[k] - cmin[k]) / extent[k] : 0.0;
+                q[k] = static_cast<uint32_t>(clamp(t * kMortonScale, 0.0, kMortonScale - 1.0));
+            }
+            mortonPrims[i].primIdx = i;
+            mortonPrims[i].mortonCode = encodeMorton3(q[0], q[1], q[2]);
+        }
+    });
+    radixSort(&mortonPrims);
+
+    // Group the primitives into treelets sharing the upper 12 bits of the
+    // Morton codes, and build the treelets in parallel.
+    struct Treelet {
+        int start, nPrims;
+        BVHNode* root;
+    };
+    std::vector<Treelet> treelets;
+    const uint32_t mask = 0x3ffc0000;
+    for (int start = 0, end = 1; end <= nPrims; end++) {
+        if (end == nPrims ||
+            (mortonPrims[start].mortonCode & mask) != (mortonPrims[end].mortonCode & mask)) {
+            treelets.push_back({ start, end - start, nullptr });
+            start = end;
+        }
+    }
+
+    std::atomic<int> orderedPrimsOffset(0);
+    parallel_for(0, static_cast<int>(treelets.size()), [&](int i) {
+        Treelet& tr = treelets[i];
+        const int firstBitIndex = 29 - 12;
+        tr.root = emitLBVH(buildData, &mortonPrims[tr.start], tr.nPrims,
+                           &orderedPrimsOffset, firstBitIndex);
+    });
+
+    // Build the upper levels over the treelets with SAH
+    std::vector<BVHNode*> treeletRoots;
+    for (const Treelet& tr : treelets) {
+        treeletRoots.push_back(tr.root);
+    }
+    return buildUpperSAH(treeletRoots, 0, static_cast<int>(treeletRoots.size()));
+}
+
+BVHNode* BVHAccel::emitLBVH(const std::vector<BVHPrimitiveInfo>& buildData,
+                            const MortonPrimitive* mortonPrims, int nPrims,
+                            std::atomic<int>* orderedPrimsOffset, int bitIndex) {
+    auto makeLeaf = [&]() {
+        BVHNode* node = allocateNode();
+        const int offset = orderedPrimsOffset->fetch_add(nPrims);
+        Bounds3 bounds;
+        for (int i = 0; i < nPrims; i++) {
+            const BVHPrimitiveInfo& info = buildData[mortonPrims[i].primIdx];
+            orderedPrims_[offset + i] = info.primIdx;
+            bounds.merge(info.bounds);
+        }
+        node->initLeaf(bounds, offset, nPrims);
+        return node;
+    };
+
+    if (nPrims <= maxPrimsInNode_) {
+        return makeLeaf();
+    }
+
+    // Find the first primitive whose Morton code has "bitIndex" bit set
+    int splitOffset = nPrims / 2;
+    int axis = 0;
+    for (; bitIndex >= 0; bitIndex--) {
+        const uint32_t bitMask = 1u << bitIndex;
+        if ((mortonPrims[0].mortonCode & bitMask) ==
+            (mortonPrims[nPrims - 1].mortonCode & bitMask)) {
+            continue;
+        }
 
-            if (minCost < nprims) {
-                auto it = std::partition(buildData.begin() + start,
-                                         buildData.begin() + end,
-                                         CompareToBucket(minCostSplit, nBuckets, splitAxis, centroidBounds));
-                mid = it - buildData.begin();
+        int lo = 0, hi = nPrims - 1;
+        while (lo + 1 != hi) {
+            const int m = (lo + hi) / 2;
+            if ((mortonPrims[lo].mortonCode & bitMask) ==
+                (mortonPrims[m].mortonCode & bitMask)) {
+                lo = m;
+            } else {
+                hi = m;
             }
         }
+        splitOffset = hi;
+        axis = bitIndex % 3;
+        break;
+    }
+
+    // The primitives sharing the same Morton code are more than a leaf
+    // holds, and are split in the middle.
+    BVHNode* node = allocateNode();
+    BVHNode* left  = emitLBVH(buildData, mortonPrims, splitOffset,
+                              orderedPrimsOffset, bitIndex - 1);
+    BVHNode* right = emitLBVH(buildData, &mortonPrims[splitOffset], nPrims - splitOffset,
+                              orderedPrimsOffset, bitIndex - 1);
+    node->initFork(Bounds3::merge(left->bounds, right->bounds), left, right, axis);
+    return node;
+}
+
+BVHNode* BVHAccel::buildUpperSAH(std::vector<BVHNode*>& treeletRoots,
+                                 int start, int end) {
+    const int nNodes = end - start;
+    if (nNodes == 1) return treeletRoots[start];
+
+    BVHNode* node = allocateNode();
+    Bounds3 bounds, centroidBounds;
+    for (int i = start; i < end; i++) {
+        const Bounds3& b = treeletRoots[i]->bounds;
+        bounds.merge(b);
+        centroidBounds.merge((b.posMin() + b.posMax()) * 0.5);
+    }
+
+    const int dim = centroidBounds.maximumExtent();
+    const double cmin = centroidBounds.posMin()[dim];
+    const double cmax = centroidBounds.posMax()[dim];
+    auto centroidOf = [dim](const BVHNode* n) {
+        return (n->bounds.posMin()[dim] + n->bounds.posMax()[dim]) * 0.5;
+    };
+
+    int mid = (start + end) / 2;
+    if (cmax > cmin) {
+        // Split with binned SAH along the largest extent
+        const int nBuckets = 12;
+        auto bucketOf = [&](const BVHNode* n) {
+            const int b = static_cast<int>(nBuckets * (centroidOf(n) - cmin) / (cmax - cmin));
+            return std::min(b, nBuckets - 1);
+        };
+
+        BucketInfo buckets[nBuckets];
+        for (int i = start; i < end; i++) {
+            const int b = bucketOf(treeletRoots[i]);
+            buckets[b].count++;
+            buckets[b].bounds.merge(treeletRoots[i]->bounds);
+        }
+
+        int minCostSplit = 0;
+        findBucketSplit(buckets, nBuckets, bounds, &minCostSplit);
+
+        auto it = std::partition(treeletRoots.begin() + start,
+                                 treeletRoots.begin() + end,
+                                 [&](const BVHNode* n) { return bucketOf(n) <= minCostSplit; });
+        mid = it - treeletRoots.begin();
+    }
+
+    if (mid == start || mid == end) {
+        mid = (start + end) / 2;
+        std::nth_element(treeletRoots.begin() + start,
+                         treeletRoots.begin() + mid,
+                         treeletRoots.begin() + end,
+                         [&](const BVHNode* a, const BVHNode* b) {
+                             return centroidOf(a) < centroidOf(b);
+                         });
+    }
+
+    BVHNode* left  = buildUpperSAH(treeletRoots, start, mid);
+    BVHNode* right = buildUpperSAH(treeletRoots, mid, end);
+    node->initFork(bounds, left, right, dim);
+    return node;
+}
+
+// Find the cheapest split between the buckets "split" and "split + 1", and
+// return its SAH cost. INFTY is returned if no split separates the buckets.
+double BVHAccel::findBucketSplit(const BucketInfo* buckets, int nBuckets,
+                                 const Bounds3& bounds, int* split) {
+    Assertion(nBuckets <= kMaxBuckets, "Too many buckets: %d", nBuckets);
+
+    // Sweep from the both sides to compute costs in O(#buckets)
+    double areaBelow[kMaxBuckets - 1];
+    int countBelow[kMaxBuckets - 1];
+    Bounds3 b0;
+    int cnt0 = 0;
+    for (int i = 0; i < nBuckets - 1; i++) {
+        b0.merge(buckets[i].bounds);
+        cnt0 += buckets[i].count;
+        areaBelow[i] = cnt0 > 0 ? b0.area() : 0.0;
+        countBelow[i] = cnt0;
+    }
+
+    double minCost = INFTY;
+    Bounds3 b1;
+    int cnt1 = 0;
+    for (int i = nBuckets - 1; i >= 1; i--) {
+        b1.merge(buckets[i].bounds);
+        cnt1 += buckets[i].count;
+        if (countBelow[i - 1] == 0 || cnt1 == 0) continue;
+
+        const double cost = kTraversalCost +
+            (countBelow[i - 1] * areaBelow[i - 1] + cnt1 * b1.area()) / bounds.area();
+        if (cost < minCost) {
+            minCost = cost;
+            *split = i - 1;
+        }
+    }
+    return minCost;
+}
+
+void BVHAccel::reportBuildQuality() const {
+    if (root_ == nullptr) return;
+
+    // SAH cost of the tree, normalized by the surface area of the root.
+    const double rootArea = root_->bounds.area();
+    double sahCost = 0.0;
+    int maxDepth = 0;
+    int nLeaves = 0;
+    std::vector<int> leafHistogram(maxPrimsInNode_ + 1, 0);
+
+    std::function<void(const BVHNode*, int)> traverse =
+        [&](const BVHNode* node, int depth) {
+            maxDepth = std::max(maxDepth, depth);
+            const double relArea = rootArea > 0.0 ? node->bounds.area() / rootArea : 1.0;
+            if (node->isLeaf()) {
+                sahCost += node->nPrims * relArea;
+                nLeaves++;
+                leafHistogram[node->nPrims]++;
+            } else {
+                sahCost += kTraversalCost * relArea;
+                traverse(node->left,  depth + 1);
+                traverse(node->right, depth + 1);
+            }
+        };
+    traverse(root_, 0);
 
-        BVHNode* left  = constructRec(buildData, start, mid);
-        BVHNode* right = constructRec(buildData, mid, end);
-        node->initFork(bounds, left, right, splitAxis);
+    MsgInfo("BVH: %d nodes, %d leaves, max depth %d, SAH cost %.3f",
+            (int)nodes_.size(), nLeaves, maxDepth, sahCost);
+    for (int i = 1; i <= maxPrimsInNode_; i++) {
+        if (leafHistogram[i] != 0) {
+            MsgInfo("BVH:   leaves with %d prims: %d", i, leafHistogram[i]);
+        }
     }
-    return std::move(node);
 }
 
 void BVHAccel::release() {
     for (int i = 0; i < simdNodes_.size(); i++) {
         align_free(simdNodes_[i]);
     }
-    
+    for (SIMD8BVHNode* node : simd8Nodes_) {
+        align_free(node);
+    }
+    align_free(linearNodes_);
+
     root_ = nullptr;
+    triangle4s_.clear();
+    leafTriangle4s_.clear();
     simdNodes_.clear();
+    simd8Nodes_.clear();
+    linearNodes_ = nullptr;
+    totalLinearNodes_ = 0;
+}
+
+int BVHAccel::collapse2OBVH(const BVHNode* node) {
+    // Gather up to eight descendants by repeatedly opening the interior
+    // child with the largest surface area.
+    const BVHNode* c[8] = {0};
+    int nChildren = 0;
+    if (node->isLeaf()) {
+        c[nChildren++] = node;
+    } else {
+        c[nChildren++] = node->left;
+        c[nChildren++] = node->right;
+    }
+
+    while (nChildren < 8) {
+        int best = -1;
+        double bestArea = -1.0;
+        for (int i = 0; i < nChildren; i++) {
+            if (!c[i]->isLeaf() && c[i]->bounds.area() > bestArea) {
+                best = i;
+                bestArea = c[i]->bounds.area();
+            }
+        }
+        if (best < 0) break;
+
+        const BVHNode* opened = c[best];
+        c[best] = opened->left;
+        c[nChildren++] = opened->right;
+    }
+
+    SIMD8BVHNode* n =
+        static_cast<SIMD8BVHNode*>(align_alloc(sizeof(SIMD8BVHNode), 32));
+    Assertion(n != nullptr, "allocation failed !!");
+
+    const int index = static_cast<int>(simd8Nodes_.size());
+    simd8Nodes_.push_back(n);
+
+    const float inf = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < 8; i++) {
+        n->nPrims[i] = 0;
+        if (c[i] == nullptr) {
+            // Empty bounds never intersect with rays.
+            for (int j = 0; j < 3; j++) {
+                n->bboxes[0][j][i] =  inf;
+                n->bboxes[1][j][i] = -inf;
+            }
+            n->children[i].node.isLeaf = 1;
+            n->children[i].node.index  = -1;
+            continue;
+        }
+
+        for (int j = 0; j < 3; j++) {
+            n->bboxes[0][j][i] = roundDown(c[i]->bounds.posMin()[j]);
+            n->bboxes[1][j][i] = roundUp(c[i]->bounds.posMax()[j]);
+        }
+
+        if (!c[i]->isLeaf()) {
+            n->children[i].node.isLeaf = 0;
+            n->children[i].node.index  = collapse2OBVH(c[i]);
+        } else {
+            n->children[i].node.isLeaf = 1;
+            n->children[i].node.index  = c[i]->primOffset;
+            n->nPrims[i] = static_cast<uint8_t>(c[i]->nPrims);
+        }
+    }
+    return index;
+}
+
+int BVHAccel::flattenBVH(BVHNode* node, int* offset) {
+    LinearBVHNode* linearNode = &linearNodes_[*offset];
+    for (int i = 0; i < 3; i++) {
+        linearNode->posMin[i] = roundDown(node->bounds.posMin()[i]);
+        linearNode->posMax[i] = roundUp(node->bounds.posMax()[i]);
+    }
+
+    const int myOffset = (*offset)++;
+    if (node->isLeaf()) {
+        linearNode->primitivesOffset = node->primOffset;
+        linearNode->nPrimitives = static_cast<uint16_t>(node->nPrims);
+        linearNode->axis = 0;
+    } else {
+        linearNode->axis = static_cast<uint8_t>(node->splitAxis);
+        linearNode->nPrimitives = 0;
+        flattenBVH(node->left, offset);
+        linearNode->secondChildOffset = flattenBVH(node->right, offset);
+    }
+    return myOffset;
 }
 
 void BVHAccel::collapse2QBVH(BVHNode* node) {
@@ -258,6 +1033,11 @@ void BVHAccel::collapse2QBVH(BVHNode* node) {
     n->axis_left = n->axis_right = 0;
     
     BVHNode* c[4] = {0};
+    if (node->isLeaf()) {
+        // The root can be a leaf when there are only a few primitives.
+        c[0] = node;
+    }
+
     if (lc != nullptr) {
         n->axis_left = lc->splitAxis;
         if (!lc->isLeaf()) {
@@ -278,12 +1058,18 @@ void BVHAccel::collapse2QBVH(BVHNode* node) {
         }
     }
     
+    // Bounds are rounded outward to float, and empty children are given
+    // inverted bounds that never intersect with rays.
+    const float inf = std::numeric_limits<float>::infinity();
     alignas(16) float bboxes[2][3][4];
     for (int j = 0; j < 3; j++) {
         for (int k = 0; k < 4; k++) {
             if (c[k] != nullptr) {
-                bboxes[0][j][k] = c[k]->bounds.posMin()[j];
-                bboxes[1][j][k] = c[k]->bounds.posMax()[j];
+                bboxes[0][j][k] = roundDown(c[k]->bounds.posMin()[j]);
+                bboxes[1][j][k] = roundUp(c[k]->bounds.posMax()[j]);
+            } else {
+                bboxes[0][j][k] =  inf;
+                bboxes[1][j][k] = -inf;
             }
         }
     }
@@ -295,6 +1081,7 @@ void BVHAccel::collapse2QBVH(BVHNode* node) {
     }
     
     for (int i = 0; i < 4; i++) {
+        n->nPrims[i] = 0;
         if (c[i] == nullptr) {
             n->children[i].node.isLeaf = 1;
             n->children[i].node.index = -1;
@@ -305,235 +1092,631 @@ void BVHAccel::collapse2QBVH(BVHNode* node) {
                 collapse2QBVH(c[i]);
             } else {
                 n->children[i].node.isLeaf = 1;
-                n->children[i].node.index  = c[i]->primIdx;
+                n->children[i].node.index  = c[i]->primOffset;
+                n->nPrims[i] = static_cast<uint8_t>(c[i]->nPrims);
             }
         }
     }
     return;
 }
 
+void BVHAccel::packTriangles() {
+    // Only the leaves that consist of mesh triangles are packed.
+    leafTriangle4s_.assign(orderedPrims_.size(), -1);
+    int nPacked = 0;
+    for (const BVHNode& node : nodes_) {
+        if (!node.isLeaf()) continue;
+
+        std::vector<const MeshTriangle*> tris;
+        for (int i = 0; i < node.nPrims; i++) {
+            const auto* tri = dynamic_cast<const MeshTriangle*>(
+                primitives_[orderedPrims_[node.primOffset + i]].get());
+            if (tri == nullptr) break;
+            tris.push_back(tri);
+        }
+        if (static_cast<int>(tris.size()) != node.nPrims) continue;
+
+        leafTriangle4s_[node.primOffset] = static_cast<int>(triangle4s_.size());
+        for (int i = 0; i < node.nPrims; i += 4) {
+            Triangle4 block;
+            for (int k = 0; k < 4; k++) {
+                block.primIdx[k] = -1;
+                Point3 p0, p1, p2;
+                if (i + k < node.nPrims) {
+                    const MeshTriangle* tri = tris[i + k];
+                    block.primIdx[k] = orderedPrims_[node.primOffset + i + k];
+                    p0 = tri->mesh()->vertex(tri->face(), 0);
+                    p1 = tri->mesh()->vertex(tri->face(), 1);
+                    p2 = tri->mesh()->vertex(tri->face(), 2);
+                }
+
+                const Vector3 e1 = p1 - p0;
+                const Vector3 e2 = p2 - p0;
+                for (int a = 0; a < 3; a++) {
+                    block.p0[a][k] = static_cast<float>(p0[a]);
+                    block.e1[a][k] = static_cast<float>(e1[a]);
+                    block.e2[a][k] = static_cast<float>(e2[a]);
+                }
+            }
+            triangle4s_.push_back(block);
+        }
+        nPacked += node.nPrims;
+    }
+
+    if (nPacked == 0) {
+        leafTriangle4s_.clear();
+    } else {
+        MsgInfo("BVH: %d triangles are packed into %d SIMD blocks",
+                nPacked, (int)triangle4s_.size());
+    }
+}
+
+bool BVHAccel::intersectLeaf(int offset, int nPrims, Ray& ray,
+                             HitRecord* hit) const {
+    const int block = leafTriangle4s_.empty() ? -1 : leafTriangle4s_[offset];
+    if (block < 0) {
+        bool isHit = false;
+        for (int i = 0; i < nPrims; i++) {
+            if (primitives_[orderedPrims_[offset + i]]->hitTest(ray, hit)) {
+                isHit = true;
+            }
+        }
+        return isHit;
+    }
+
+    __m128 org[3], dir[3];
+    for (int a = 0; a < 3; a++) {
+        org[a] = _mm_set1_ps(static_cast<float>(ray.org()[a]));
+        dir[a] = _mm_set1_ps(static_cast<float>(ray.dir()[a]));
+    }
+
+    float tBest = static_cast<float>(ray.maxDist());
+    bool isHit = false;
+    for (int b = 0; b < (nPrims + 3) / 4; b++) {
+        const Triangle4& tris = triangle4s_[block + b];
+        alignas(16) float tHit[4], b1[4], b2[4];
+        const int hitMask = test_Triangle4(tris.p0, tris.e1, tris.e2, org, dir,
+                                           tBest, tHit, b1, b2);
+        for (int k = 0; k < 4; k++) {
+            if ((hitMask & (1 << k)) == 0 || tHit[k] > tBest) continue;
+            tBest = tHit[k];
+            hit->primitive = primitives_[tris.primIdx[k]].get();
+            hit->b1 = b1[k];
+            hit->b2 = b2[k];
+            isHit = true;
+        }
+    }
+
+    if (isHit) {
+        ray.setMaxDist(tBest);
+        hit->t = tBest;
+    }
+    return isHit;
+}
+
+bool BVHAccel::intersectLeaf(int offset, int nPrims, Ray& ray) const {
+    const int block = leafTriangle4s_.empty() ? -1 : leafTriangle4s_[offset];
+    if (block < 0) {
+        for (int i = 0; i < nPrims; i++) {
+            const auto& prim = primitives_[orderedPrims_[offset + i]];
+            if (prim->intersect(ray)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    __m128 org[3], dir[3];
+    for (int a = 0; a < 3; a++) {
+        org[a] = _mm_set1_ps(static_cast<float>(ray.org()[a]));
+        dir[a] = _mm_set1_ps(static_cast<float>(ray.dir()[a]));
+    }
+
+    const float rayMax = static_cast<float>(ray.maxDist());
+    for (int b = 0; b < (nPrims + 3) / 4; b++) {
+        const Triangle4& tris = triangle4s_[block + b];
+        alignas(16) float tHit[4], b1[4], b2[4];
+        if (test_Triangle4(tris.p0, tris.e1, tris.e2, org, dir,
+                           rayMax, tHit, b1, b2) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool BVHAccel::intersect(Ray& ray, SurfaceInteraction* isect) const {
-    if (useSIMD_) {
-        return intersectQBVH(ray, isect);
+    HitRecord hit;
+    if (!hitTest(ray, &hit)) return false;
+    computeSurfaceInteraction(ray, hit, isect);
+    return true;
+}
+
+bool BVHAccel::hitTest(Ray& ray, HitRecord* hit) const {
+    if (root_ == nullptr) return false;
+
+    if (useAVX_) {
+        return intersectOBVH(ray, hit);
+    } else if (useSIMD_) {
+        return intersectQBVH(ray, hit);
+    } else if (useLinearBVH_) {
+        return intersectLinearBVH(ray, hit);
     } else {
-        return intersectBVH(ray, isect);
+        return intersectBVH(ray, hit);
     }
 }
 
 bool BVHAccel::intersect(Ray &ray) const {
-    if (useSIMD_) {
+    if (root_ == nullptr) return false;
+
+    if (useAVX_) {
+        return intersectOBVH(ray);
+    } else if (useSIMD_) {
         return intersectQBVH(ray);
+    } else if (useLinearBVH_) {
+        return intersectLinearBVH(ray);
     } else {
         return intersectBVH(ray);
     }
 }
 
-bool BVHAccel::intersectBVH(Ray &ray, SurfaceInteraction *isect) const{
-    std::stack<BVHNode*> nodeStack;
-    nodeStack.push(root_);
+bool BVHAccel::intersectBVH(Ray& ray, HitRecord* hit) const {
+    // Nodes are pushed with the entry distances of their bounds, so that
+    // those behind the closest hit found so far are skipped.
+    struct StackItem {
+        const BVHNode* node;
+        double tmin;
+    };
+    StackItem nodeStack[64];
+    int todoNode = 0;
+
+    const int dirIsNeg[3] = { ray.dir().x() < 0.0, ray.dir().y() < 0.0, ray.dir().z() < 0.0 };
 
-    bool hit = false;
-    int cnt = 0;
-    while (!nodeStack.empty()) {
-        BVHNode* node = nodeStack.top();
-        nodeStack.pop();
+    double tmin, tmax;
+    if (!root_->bounds.intersect(ray, &tmin, &tmax)) return false;
+    nodeStack[todoNode++] = { root_, tmin };
 
+    bool isHit = false;
+    while (todoNode > 0) {
+        const StackItem item = nodeStack[--todoNode];
+        if (item.tmin > ray.maxDist()) continue;
+
+        const BVHNode* node = item.node;
         if (node->isLeaf()) {
             // Leaf
-            const auto& prim = primitives_[node->primIdx];
-            SurfaceInteraction temp;
-            if (prim->intersect(ray, &temp)) {
-                *isect = temp;
-                isect->setPrimitive(prim.get());
-                hit = true;
+            if (intersectLeaf(node->primOffset, node->nPrims, ray, hit)) {
+                isHit = true;
             }
         } else {
-            // Fork
-            double tmin = INFTY, tmax = INFTY;
-            if (node->bounds.intersect(ray, &tmin, &tmax)) {
-                if (node->left ) nodeStack.push(node->left);
-                if (node->right) nodeStack.push(node->right);
+            // Fork: push the farther child first to visit the nearer one first
+            const BVHNode* nearChild = dirIsNeg[node->splitAxis] ? node->right : node->left;
+            const BVHNode* farChild  = dirIsNeg[node->splitAxis] ? node->left  : node->right;
+            if (farChild->bounds.intersect(ray, &tmin, &tmax)) {
+                nodeStack[todoNode++] = { farChild, tmin };
+            }
+            if (nearChild->bounds.intersect(ray, &tmin, &tmax)) {
+                nodeStack[todoNode++] = { nearChild, tmin };
             }
         }
     }
-    return hit;
+    return isHit;
 }
 
 bool BVHAccel::intersectBVH(Ray& ray) const {
-    std::stack<BVHNode*> nodeStack;
-    nodeStack.push(root_);
+    const BVHNode* nodeStack[64];
+    int todoNode = 0;
+
+    const int dirIsNeg[3] = { ray.dir().x() < 0.0, ray.dir().y() < 0.0, ray.dir().z() < 0.0 };
 
-    bool hit = false;
-    while (!nodeStack.empty()) {
-        BVHNode* node = nodeStack.top();
-        nodeStack.pop();
+    if (!root_->bounds.intersect(ray)) return false;
+    nodeStack[todoNode++] = root_;
 
+    while (todoNode > 0) {
+        const BVHNode* node = nodeStack[--todoNode];
         if (node->isLeaf()) {
             // Leaf
-            const auto& prim = primitives_[node->primIdx];
-            if (prim->intersect(ray)) {
+            if (intersectLeaf(node->primOffset, node->nPrims, ray)) {
                 return true;
             }
         } else {
             // Fork
-            double tmin = INFTY, tmax = INFTY;
-            if (node->bounds.intersect(ray, &tmin, &tmax)) {
-                if (node->left ) nodeStack.push(node->left);
-                if (node->right) nodeStack.push(node->right);
+            const BVHNode* nearChild = dirIsNeg[node->splitAxis] ? node->right : node->left;
+            const BVHNode* farChild  = dirIsNeg[node->splitAxis] ? node->left  : node->right;
+            if (farChild->bounds.intersect(ray)) {
+                nodeStack[todoNode++] = farChild;
+            }
+            if (nearChild->bounds.intersect(ray)) {
+                nodeStack[todoNode++] = nearChild;
             }
         }
     }
-    return false;    
+    return false;
 }
 
-bool BVHAccel::intersectQBVH(Ray& ray, SurfaceInteraction* isect) const {
-    // ray for SIMD arthimetic
-    __m128 simdOrig[3];  // origin
-    __m128 simdIdir[3];  // inverse direction
-    int sgn[3];          // signs of ray direction (pos -> 0, neg -> 1)
-    
-    float orgx = static_cast<float>(ray.org().x());
-    float orgy = static_cast<float>(ray.org().y());
-    float orgz = static_cast<float>(ray.org().z());
-    
-    alignas(16) float orgxs[4] = { orgx, orgx, orgx, orgx };
-    alignas(16) float orgys[4] = { orgy, orgy, orgy, orgy };
-    alignas(16) float orgzs[4] = { orgz, orgz, orgz, orgz };
-    
-    float idirx = ray.dir().x() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().x());
-    float idiry = ray.dir().y() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().y());
-    float idirz = ray.dir().z() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().z());
-    
-    alignas(16) float idirxs[4] = { idirx, idirx, idirx, idirx };
-    alignas(16) float idirys[4] = { idiry, idiry, idiry, idiry };
-    alignas(16) float idirzs[4] = { idirz, idirz, idirz, idirz };
+bool BVHAccel::intersectQBVH(Ray& ray, HitRecord* hit) const {
+    const SIMDRay simdRay(ray);
 
-    simdOrig[0] = _mm_load_ps(orgxs);
-    simdOrig[1] = _mm_load_ps(orgys);
-    simdOrig[2] = _mm_load_ps(orgzs);
-    
-    simdIdir[0] = _mm_load_ps(idirxs);
-    simdIdir[1] = _mm_load_ps(idirys);
-    simdIdir[2] = _mm_load_ps(idirzs);
-    
-    sgn[0] = idirx >= 0.0f ? 0 : 1;
-    sgn[1] = idiry >= 0.0f ? 0 : 1;
-    sgn[2] = idirz >= 0.0f ? 0 : 1;
-    
-    Children nodeStack[40];
+    // Children are pushed with their entry distances, and the running
+    // closest-hit distance "tMax" prunes those behind the hits found so far.
+    struct StackItem {
+        Children child;
+        int nPrims;
+        float tmin;
+    };
+    StackItem nodeStack[128];
     int todoNode = 0;
-    nodeStack[0].raw = 0;
-    
-    bool hit = false;
-    while (todoNode >= 0) {
-        Children item = nodeStack[todoNode--];
-        
-        if (item.node.isLeaf == 0) {
+    nodeStack[todoNode].child.raw = 0;
+    nodeStack[todoNode].nPrims = 0;
+    nodeStack[todoNode].tmin = 0.0f;
+    todoNode++;
+
+    float tMax = static_cast<float>(ray.maxDist());
+    bool isHit = false;
+    while (todoNode > 0) {
+        const StackItem item = nodeStack[--todoNode];
+        if (item.tmin > tMax) continue;
+
+        if (item.child.node.isLeaf == 0) {
             // Fork
-            const SIMDBVHNode& node = *(simdNodes_[item.node.index]);
-            const float tHitf = static_cast<float>(ray.maxDist());
-            alignas(16) float now_distance_f[4] = { tHitf, tHitf, tHitf, tHitf };
-            __m128 now_distance = _mm_load_ps(now_distance_f);
-            const int hitMask = test_AABB(node.bboxes, simdOrig, simdIdir, sgn, simdZero, now_distance);
-            
-            if (hitMask != 0) {
-                const int nodeIdx = (sgn[node.axis_top] << 2) | (sgn[node.axis_left] << 1) | (sgn[node.axis_right]);
-                int bboxOrder = orderTable[hitMask * 8 + nodeIdx];
-                
-                for (int i = 0; i < 4; i++) {
-                    if (bboxOrder & 0x04) break;
-                    nodeStack[++todoNode] = node.children[bboxOrder & 0x03];
-                    bboxOrder >>= 4;
-                }
+            const SIMDBVHNode& node = *(simdNodes_[item.child.node.index]);
+            alignas(16) float tNear[4];
+            const int hitMask = test_AABB(node.bboxes, simdRay, tMax, tNear);
+            if (hitMask == 0) continue;
+
+            const int* sgn = simdRay.dirIsNeg;
+            const int nodeIdx = (sgn[node.axis_top] << 2) | (sgn[node.axis_left] << 1) | (sgn[node.axis_right]);
+            int bboxOrder = orderTable[hitMask * 8 + nodeIdx];
+            for (int i = 0; i < 4; i++) {
+                if (bboxOrder & 0x04) break;
+                const int c = bboxOrder & 0x03;
+                nodeStack[todoNode].child  = node.children[c];
+                nodeStack[todoNode].nPrims = node.nPrims[c];
+                nodeStack[todoNode].tmin   = tNear[c];
+                todoNode++;
+                bboxOrder >>= 4;
             }
         } else {
             // Leaf
-            if (item.node.index >= 0) {
-                const auto& prim = primitives_[item.node.index];
-                SurfaceInteraction temp;
-                if (primitives_[item.node.index]->intersect(ray, &temp)) {
-                    *isect = temp;
-                    isect->setPrimitive(prim.get());
-                    hit = true;
-                }
+            if (intersectLeaf(item.child.node.index, item.nPrims, ray, hit)) {
+                tMax = static_cast<float>(ray.maxDist());
+                isHit = true;
             }
         }
     }
-    return hit;
+    return isHit;
 }
 
 bool BVHAccel::intersectQBVH(Ray& ray) const {
-    // ray for SIMD arthimetic
-    __m128 simdOrig[3];  // origin
-    __m128 simdIdir[3];  // inverse direction
-    int sgn[3];          // signs of ray direction (pos -> 0, neg -> 1)
-    
-    float orgx = static_cast<float>(ray.org().x());
-    float orgy = static_cast<float>(ray.org().y());
-    float orgz = static_cast<float>(ray.org().z());
-    
-    alignas(16) float orgxs[4] = { orgx, orgx, orgx, orgx };
-    alignas(16) float orgys[4] = { orgy, orgy, orgy, orgy };
-    alignas(16) float orgzs[4] = { orgz, orgz, orgz, orgz };
-    
-    float idirx = ray.dir().x() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().x());
-    float idiry = ray.dir().y() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().y());
-    float idirz = ray.dir().z() == 0.0 ? (float)1.0e20 : (float)(1.0 / ray.dir().z());
-    
-    alignas(16) float idirxs[4] = { idirx, idirx, idirx, idirx };
-    alignas(16) float idirys[4] = { idiry, idiry, idiry, idiry };
-    alignas(16) float idirzs[4] = { idirz, idirz, idirz, idirz };
+    const SIMDRay simdRay(ray);
+    const float tMax = static_cast<float>(ray.maxDist());
 
-    simdOrig[0] = _mm_load_ps(orgxs);
-    simdOrig[1] = _mm_load_ps(orgys);
-    simdOrig[2] = _mm_load_ps(orgzs);
-    
-    simdIdir[0] = _mm_load_ps(idirxs);
-    simdIdir[1] = _mm_load_ps(idirys);
-    simdIdir[2] = _mm_load_ps(idirzs);
-    
-    sgn[0] = idirx >= 0.0f ? 0 : 1;
-    sgn[1] = idiry >= 0.0f ? 0 : 1;
-    sgn[2] = idirz >= 0.0f ? 0 : 1;
-    
-    Children nodeStack[40];
+    Children nodeStack[128];
+    int nPrimsStack[128];
     int todoNode = 0;
-    nodeStack[0].raw = 0;
-    
-    while (todoNode >= 0) {
-        Children item = nodeStack[todoNode--];
-        
+    nodeStack[todoNode].raw = 0;
+    nPrimsStack[todoNode] = 0;
+    todoNode++;
+
+    while (todoNode > 0) {
+        todoNode--;
+        const Children item = nodeStack[todoNode];
+        const int nPrims = nPrimsStack[todoNode];
+
         if (item.node.isLeaf == 0) {
             // Fork
             const SIMDBVHNode& node = *(simdNodes_[item.node.index]);
-            const float tHitf = static_cast<float>(ray.maxDist());
-            alignas(16) float now_distance_f[4] = { tHitf, tHitf, tHitf, tHitf };
-            __m128 now_distance = _mm_load_ps(now_distance_f);
-            const int hitMask = test_AABB(node.bboxes, simdOrig, simdIdir, sgn, simdZero, now_distance);
-            
-            if (hitMask != 0) {
-                const int nodeIdx = (sgn[node.axis_top] << 2) | (sgn[node.axis_left] << 1) | (sgn[node.axis_right]);
-                int bboxOrder = orderTable[hitMask * 8 + nodeIdx];
-                
-                for (int i = 0; i < 4; i++) {
-                    if (bboxOrder & 0x04) break;
-                    nodeStack[++todoNode] = node.children[bboxOrder & 0x03];
-                    bboxOrder >>= 4;
+            alignas(16) float tNear[4];
+            const int hitMask = test_AABB(node.bboxes, simdRay, tMax, tNear);
+            if (hitMask == 0) continue;
+
+            const int* sgn = simdRay.dirIsNeg;
+            const int nodeIdx = (sgn[node.axis_top] << 2) | (sgn[node.axis_left] << 1) | (sgn[node.axis_right]);
+            int bboxOrder = orderTable[hitMask * 8 + nodeIdx];
+            for (int i = 0; i < 4; i++) {
+                if (bboxOrder & 0x04) break;
+                nodeStack[todoNode]   = node.children[bboxOrder & 0x03];
+                nPrimsStack[todoNode] = node.nPrims[bboxOrder & 0x03];
+                todoNode++;
+                bboxOrder >>= 4;
+            }
+        } else {
+            // Leaf
+            if (intersectLeaf(item.node.index, nPrims, ray)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+SPICA_TARGET_AVX2
+bool BVHAccel::intersectOBVH(Ray& ray, HitRecord* hit) const {
+    __m256 simdOrg[3], simdInvDir[3];
+    int dirIsNeg[3];
+    for (int i = 0; i < 3; i++) {
+        const float invDir = static_cast<float>(ray.invdir()[i]);
+        simdOrg[i]    = _mm256_set1_ps(static_cast<float>(ray.org()[i]));
+        simdInvDir[i] = _mm256_set1_ps(invDir);
+        dirIsNeg[i]   = invDir < 0.0f ? 1 : 0;
+    }
+
+    // Children are pushed with their entry distances, so that those behind
+    // the closest hit found so far are skipped.
+    struct StackItem {
+        Children child;
+        int nPrims;
+        float tmin;
+    };
+    StackItem nodeStack[256];
+    int todoNode = 0;
+    nodeStack[todoNode].child.raw = 0;
+    nodeStack[todoNode].nPrims = 0;
+    nodeStack[todoNode].tmin = 0.0f;
+    todoNode++;
+
+    bool isHit = false;
+    while (todoNode > 0) {
+        const StackItem item = nodeStack[--todoNode];
+        if (item.tmin > ray.maxDist()) continue;
+
+        if (item.child.node.isLeaf == 0) {
+            // Fork
+            const SIMD8BVHNode& node = *simd8Nodes_[item.child.node.index];
+            alignas(32) float tNear[8];
+            const int hitMask = test_AABB8(node.bboxes, simdOrg, simdInvDir, dirIsNeg,
+                                           static_cast<float>(ray.maxDist()), tNear);
+            if (hitMask == 0) continue;
+
+            // Sort the hit children by descending entry distance, and push
+            // them so that the nearest one is popped first.
+            int order[8];
+            int nHits = 0;
+            for (int i = 0; i < 8; i++) {
+                if ((hitMask & (1 << i)) == 0) continue;
+                int j = nHits++;
+                while (j > 0 && tNear[order[j - 1]] < tNear[i]) {
+                    order[j] = order[j - 1];
+                    j--;
                 }
+                order[j] = i;
+            }
+
+            for (int k = 0; k < nHits; k++) {
+                const int i = order[k];
+                nodeStack[todoNode].child  = node.children[i];
+                nodeStack[todoNode].nPrims = node.nPrims[i];
+                nodeStack[todoNode].tmin   = tNear[i];
+                todoNode++;
+            }
+        } else {
+            // Leaf
+            if (intersectLeaf(item.child.node.index, item.nPrims, ray, hit)) {
+                isHit = true;
+            }
+        }
+    }
+    return isHit;
+}
+
+SPICA_TARGET_AVX2
+bool BVHAccel::intersectOBVH(Ray& ray) const {
+    __m256 simdOrg[3], simdInvDir[3];
+    int dirIsNeg[3];
+    for (int i = 0; i < 3; i++) {
+        const float invDir = static_cast<float>(ray.invdir()[i]);
+        simdOrg[i]    = _mm256_set1_ps(static_cast<float>(ray.org()[i]));
+        simdInvDir[i] = _mm256_set1_ps(invDir);
+        dirIsNeg[i]   = invDir < 0.0f ? 1 : 0;
+    }
+
+    Children nodeStack[256];
+    int nPrimsStack[256];
+    int todoNode = 0;
+    nodeStack[todoNode].raw = 0;
+    nPrimsStack[todoNode] = 0;
+    todoNode++;
+
+    while (todoNode > 0) {
+        todoNode--;
+        const Children item = nodeStack[todoNode];
+        const int nPrims = nPrimsStack[todoNode];
+
+        if (item.node.isLeaf == 0) {
+            // Fork: any hit terminates the traversal, so children are not sorted.
+            const SIMD8BVHNode& node = *simd8Nodes_[item.node.index];
+            alignas(32) float tNear[8];
+            const int hitMask = test_AABB8(node.bboxes, simdOrg, simdInvDir, dirIsNeg,
+                                           static_cast<float>(ray.maxDist()), tNear);
+            for (int i = 0; i < 8; i++) {
+                if ((hitMask & (1 << i)) == 0) continue;
+                nodeStack[todoNode]   = node.children[i];
+                nPrimsStack[todoNode] = node.nPrims[i];
+                todoNode++;
             }
         } else {
             // Leaf
-            if (item.node.index >= 0) {
-                const auto& prim = primitives_[item.node.index];
-                if (prim->intersect(ray)) {
+            if (intersectLeaf(item.node.index, nPrims, ray)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool BVHAccel::intersectLinearBVH(Ray& ray, HitRecord* hit) const {
+    float org[3], invDir[3];
+    int dirIsNeg[3];
+    for (int i = 0; i < 3; i++) {
+        org[i]      = static_cast<float>(ray.org()[i]);
+        invDir[i]   = static_cast<float>(ray.invdir()[i]);
+        dirIsNeg[i] = invDir[i] < 0.0f ? 1 : 0;
+    }
+
+    int nodesToVisit[64];
+    int toVisitOffset = 0;
+    int currentNodeIndex = 0;
+
+    bool isHit = false;
+    for (;;) {
+        const LinearBVHNode& node = linearNodes_[currentNodeIndex];
+        const float rayMax = static_cast<float>(ray.maxDist());
+        if (intersectLinearNode(node, org, invDir, dirIsNeg, rayMax)) {
+            if (node.nPrimitives > 0) {
+                // Leaf
+                if (intersectLeaf(node.primitivesOffset, node.nPrimitives, ray, hit)) {
+                    isHit = true;
+                }
+                if (toVisitOffset == 0) break;
+                currentNodeIndex = nodesToVisit[--toVisitOffset];
+            } else {
+                // Fork: visit the nearer child first
+                if (dirIsNeg[node.axis]) {
+                    nodesToVisit[toVisitOffset++] = currentNodeIndex + 1;
+                    currentNodeIndex = node.secondChildOffset;
+                } else {
+                    nodesToVisit[toVisitOffset++] = node.secondChildOffset;
+                    currentNodeIndex = currentNodeIndex + 1;
+                }
+            }
+        } else {
+            if (toVisitOffset == 0) break;
+            currentNodeIndex = nodesToVisit[--toVisitOffset];
+        }
+    }
+    return isHit;
+}
+
+bool BVHAccel::intersectLinearBVH(Ray& ray) const {
+    float org[3], invDir[3];
+    int dirIsNeg[3];
+    for (int i = 0; i < 3; i++) {
+        org[i]      = static_cast<float>(ray.org()[i]);
+        invDir[i]   = static_cast<float>(ray.invdir()[i]);
+        dirIsNeg[i] = invDir[i] < 0.0f ? 1 : 0;
+    }
+
+    int nodesToVisit[64];
+    int toVisitOffset = 0;
+    int currentNodeIndex = 0;
+
+    const float rayMax = static_cast<float>(ray.maxDist());
+    for (;;) {
+        const LinearBVHNode& node = linearNodes_[currentNodeIndex];
+        if (intersectLinearNode(node, org, invDir, dirIsNeg, rayMax)) {
+            if (node.nPrimitives > 0) {
+                // Leaf
+                if (intersectLeaf(node.primitivesOffset, node.nPrimitives, ray)) {
                     return true;
                 }
+                if (toVisitOffset == 0) break;
+                currentNodeIndex = nodesToVisit[--toVisitOffset];
+            } else {
+                // Fork
+                if (dirIsNeg[node.axis]) {
+                    nodesToVisit[toVisitOffset++] = currentNodeIndex + 1;
+                    currentNodeIndex = node.secondChildOffset;
+                } else {
+                    nodesToVisit[toVisitOffset++] = node.secondChildOffset;
+                    currentNodeIndex = currentNodeIndex + 1;
+                }
             }
+        } else {
+            if (toVisitOffset == 0) break;
+            currentNodeIndex = nodesToVisit[--toVisitOffset];
         }
     }
     return false;
 }
 
+void BVHAccel::intersect(RayBatch& rays, HitBatch& hits) const {
+    hits.reset(rays.size());
+    if (root_ == nullptr) return;
+
+    for (int i = 0; i < rays.size(); i += 4) {
+        intersectPacket(rays, i, hits);
+    }
+}
+
+void BVHAccel::occluded(RayBatch& rays, bool* occluded) const {
+    std::fill(occluded, occluded + rays.size(), false);
+    if (root_ == nullptr) return;
+
+    for (int i = 0; i < rays.size(); i += 4) {
+        occludedPacket(rays, i, occluded);
+    }
+}
+
+void BVHAccel::intersectPacket(RayBatch& rays, int start, HitBatch& hits) const {
+    // Each node is pushed with the lanes of the rays which hit its parent
+    struct StackItem {
+        int node;
+        int mask;
+    };
+    StackItem nodesToVisit[64];
+    int toVisitOffset = 0;
+
+    RayPacket4 packet(rays, start);
+    nodesToVisit[toVisitOffset++] = { 0, packet.mask };
+    while (toVisitOffset > 0) {
+        const StackItem item = nodesToVisit[--toVisitOffset];
+        const LinearBVHNode& node = linearNodes_[item.node];
+        const int mask = item.mask & test_RayPacket4(node, packet);
+        if (mask == 0) continue;
+
+        if (node.nPrimitives > 0) {
+            // Leaf: the rays are tested one by one
+            for (int k = 0; k < 4; k++) {
+                if ((mask & (1 << k)) == 0) continue;
+                Ray& ray = rays[start + k];
+                if (intersectLeaf(node.primitivesOffset, node.nPrimitives, ray, &hits[start + k])) {
+                    packet.rayMax[k] = static_cast<float>(ray.maxDist());
+                }
+            }
+        } else {
+            // Fork: visit the nearer child for the first ray first
+            if (packet.dirIsNeg[node.axis]) {
+                nodesToVisit[toVisitOffset++] = { item.node + 1, mask };
+                nodesToVisit[toVisitOffset++] = { node.secondChildOffset, mask };
+            } else {
+                nodesToVisit[toVisitOffset++] = { node.secondChildOffset, mask };
+                nodesToVisit[toVisitOffset++] = { item.node + 1, mask };
+            }
+        }
+    }
+}
+
+void BVHAccel::occludedPacket(RayBatch& rays, int start, bool* occluded) const {
+    struct StackItem {
+        int node;
+        int mask;
+    };
+    StackItem nodesToVisit[64];
+    int toVisitOffset = 0;
+
+    RayPacket4 packet(rays, start);
+    int active = packet.mask;
+    nodesToVisit[toVisitOffset++] = { 0, active };
+    while (toVisitOffset > 0 && active != 0) {
+        const StackItem item = nodesToVisit[--toVisitOffset];
+        const LinearBVHNode& node = linearNodes_[item.node];
+        const int mask = item.mask & active & test_RayPacket4(node, packet);
+        if (mask == 0) continue;
+
+        if (node.nPrimitives > 0) {
+            // Leaf: the occluded rays leave the packet
+            for (int k = 0; k < 4; k++) {
+                if ((mask & (1 << k)) == 0) continue;
+                if (intersectLeaf(node.primitivesOffset, node.nPrimitives, rays[start + k])) {
+                    occluded[start + k] = true;
+                    active &= ~(1 << k);
+                }
+            }
+        } else {
+            nodesToVisit[toVisitOffset++] = { node.secondChildOffset, mask };
+            nodesToVisit[toVisitOffset++] = { item.node + 1, mask };
+        }
+    }
+}
+
 std::vector<Triangle> BVHAccel::triangulate() const {
     std::vector<Triangle> tris;
     for (const auto& p : primitives_) {
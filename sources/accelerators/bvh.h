@@ -6,6 +6,9 @@
 #define _SPICA_BBVH_ACCEL_H_
 
 #include <memory>
+#include <atomic>
+#include <string>
+#include <cstdint>
 
 #include "core/accelerator.h"
 #include "core/renderparams.h"
@@ -14,10 +17,10 @@ namespace spica {
 
 struct BVHPrimitiveInfo {
     int primIdx;
-    Point3d centroid;
-    Bounds3d bounds;
+    Point3 centroid;
+    Bounds3 bounds;
     BVHPrimitiveInfo() {}
-    BVHPrimitiveInfo(int pid, const Bounds3d& b)
+    BVHPrimitiveInfo(int pid, const Bounds3& b)
         : primIdx(pid)
         , centroid()
         , bounds(b) {
@@ -25,73 +28,176 @@ struct BVHPrimitiveInfo {
     }
 };
 
+struct MortonPrimitive {
+    int primIdx;
+    uint32_t mortonCode;
+};
+
 struct BVHNode {
-    Bounds3d bounds;
+    Bounds3 bounds;
     BVHNode* left;
     BVHNode* right;
     int splitAxis;
-    int primIdx;
+    int primOffset;
+    int nPrims;
 
-    void initLeaf(const Bounds3d& b, int pid) {
+    void initLeaf(const Bounds3& b, int offset, int n) {
         this->bounds = b;
+        this->left = this->right = nullptr;
         this->splitAxis = 0;
-        this->primIdx = pid;
+        this->primOffset = offset;
+        this->nPrims = n;
     }
 
-    void initFork(const Bounds3d& b, BVHNode* l, BVHNode* r, int axis) {
+    void initFork(const Bounds3& b, BVHNode* l, BVHNode* r, int axis) {
         this->bounds = b;
         this->left  = l;
         this->right = r;
         this->splitAxis = axis;
-        this->primIdx = -1;
+        this->primOffset = -1;
+        this->nPrims = 0;
     }
 
     bool isLeaf() const {
-        return primIdx >= 0;
+        return nPrims > 0;
     }
 };
 
+/**
+ * BVH node in the linearized (depth-first ordered) layout.
+ * @details
+ * The first child of an interior node is placed just after the node, and
+ * the offset to the second child is stored in the node. A leaf node refers
+ * to "nPrimitives" primitives starting from "primitivesOffset" in the
+ * ordered primitive index list. The bounds are rounded outward to float, so
+ * that a node fits in 32 bytes.
+ */
+struct alignas(32) LinearBVHNode {
+    float posMin[3];
+    float posMax[3];
+    union {
+        int primitivesOffset;   // leaf
+        int secondChildOffset;  // interior
+    };
+    uint16_t nPrimitives;       // 0 -> interior node
+    uint8_t axis;
+    uint8_t pad[1];
+};
+
+static_assert(sizeof(LinearBVHNode) == 32, "LinearBVHNode must be 32 bytes!!");
+
 /** Binary BVH accelerator class
  *  @ingroup accel_module
  */
 class SPICA_EXPORTS BVHAccel : public Accelerator {
 public:
+    /**
+     * Tree construction algorithms.
+     * @details
+     *   - SAH: top-down binned SAH. Large subtrees are built in parallel.
+     *   - HLBVH: Morton code based LBVH treelets joined by SAH at the top.
+     *            It is much faster to build, but the tree is less efficient.
+     */
+    enum class BuildMethod {
+        SAH,
+        HLBVH
+    };
+
     explicit BVHAccel(const std::vector<std::shared_ptr<Primitive>> &prims,
-                      bool useSIMD = false);
+                      bool useSIMD = false, bool useLinearBVH = false,
+                      int maxPrimsInNode = 4,
+                      BuildMethod method = BuildMethod::SAH,
+                      int simdWidth = 4);
     BVHAccel(const std::vector<std::shared_ptr<Primitive>> &prims,
              RenderParams &params);
     virtual ~BVHAccel();
 
-    Bounds3d worldBound() const override;
+    Bounds3 worldBound() const override;
     void construct() override;
     virtual bool intersect(Ray& ray, SurfaceInteraction* isect) const override;
     virtual bool intersect(Ray& ray) const override;
+    bool hitTest(Ray& ray, HitRecord* hit) const override;
     std::vector<Triangle> triangulate() const override;
 
+    /**
+     * Trace the rays in the batch as packets of four rays over the
+     * linearized BVH. The bounds of a node are fetched once for a packet
+     * and are tested against the four rays with SIMD instructions.
+     */
+    void intersect(RayBatch& rays, HitBatch& hits) const override;
+    void occluded(RayBatch& rays, bool* occluded) const override;
+
 private:
     // Private internal classes
     union Children;
     struct BucketInfo;
     struct SIMDBVHNode;
+    struct SIMD8BVHNode;
+    struct Triangle4;
     struct ComparePoint;
     struct CompareToBucket;
 
     // Private methods
-    bool intersectBVH(Ray &ray, SurfaceInteraction *isect) const;
+    bool intersectBVH(Ray &ray, HitRecord *hit) const;
     bool intersectBVH(Ray &ray) const;
-    bool intersectQBVH(Ray &ray, SurfaceInteraction *isect) const;
+    bool intersectQBVH(Ray &ray, HitRecord *hit) const;
     bool intersectQBVH(Ray &ray) const;
+    bool intersectOBVH(Ray &ray, HitRecord *hit) const;
+    bool intersectOBVH(Ray &ray) const;
+    bool intersectLinearBVH(Ray &ray, HitRecord *hit) const;
+    bool intersectLinearBVH(Ray &ray) const;
+    void intersectPacket(RayBatch &rays, int start, HitBatch &hits) const;
+    void occludedPacket(RayBatch &rays, int start, bool *occluded) const;
+    bool intersectLeaf(int offset, int nPrims, Ray &ray, HitRecord *hit) const;
+    bool intersectLeaf(int offset, int nPrims, Ray &ray) const;
     
+    static BuildMethod parseBuildMethod(const std::string& name);
+    static void computeBounds(const std::vector<BVHPrimitiveInfo>& buildData,
+                              int start, int end, Bounds3* bounds,
+                              Bounds3* centroidBounds);
+
+    BVHNode* allocateNode();
     BVHNode* constructRec(std::vector<BVHPrimitiveInfo>& buildData,
-                            int start, int end);
+                          int start, int end);
+    BVHNode* constructHLBVH(const std::vector<BVHPrimitiveInfo>& buildData);
+    BVHNode* emitLBVH(const std::vector<BVHPrimitiveInfo>& buildData,
+                      const MortonPrimitive* mortonPrims, int nPrims,
+                      std::atomic<int>* orderedPrimsOffset, int bitIndex);
+    BVHNode* buildUpperSAH(std::vector<BVHNode*>& treeletRoots,
+                           int start, int end);
+    static double findBucketSplit(const BucketInfo* buckets, int nBuckets,
+                                  const Bounds3& bounds, int* split);
+    void reportBuildQuality() const;
     void release();
     void collapse2QBVH(BVHNode* node);
+    int collapse2OBVH(const BVHNode* node);
+    void packTriangles();
+    int flattenBVH(BVHNode* node, int* offset);
 
     // Private fields
     BVHNode* root_;
-    std::vector<std::unique_ptr<BVHNode>> nodes_;
+    std::vector<BVHNode> nodes_;
+    std::atomic<int> totalNodes_;
     std::vector<SIMDBVHNode*> simdNodes_;
+    std::vector<SIMD8BVHNode*> simd8Nodes_;
+    std::vector<int> orderedPrims_;
+    std::vector<Triangle4> triangle4s_;
+    std::vector<int> leafTriangle4s_;  // first block of the leaf starting at each offset, or -1
+    LinearBVHNode* linearNodes_;
+    int totalLinearNodes_;
+    int maxPrimsInNode_;
+    BuildMethod method_;
     bool useSIMD_;
+    bool useAVX_;
+    bool useLinearBVH_;
+
+    // Cost of traversing a node relative to that of a primitive intersection.
+    // A node visit (box test and stack push) costs about as much as a
+    // triangle test, esp. since leaf triangles are tested four at a time.
+    static constexpr double kTraversalCost = 1.0;
+
+    // Maximum number of the buckets of the binned SAH
+    static constexpr int kMaxBuckets = 16;
 };
 
 SPICA_EXPORT_ACCEL_PLUGIN(BVHAccel, "Standard bounding volume hierarchy");
@@ -79,7 +79,7 @@ namespace spica {
 //        return node;
 //    }
 //
-//    Bounds3d bounds;
+//    Bounds3 bounds;
 //    for (int i = start; i < end; i++) {
 //        bounds.merge(triangles[i].tri.worldBound());
 //    }
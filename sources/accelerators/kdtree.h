@@ -21,7 +21,7 @@ namespace spica {
 //class SPICA_EXPORTS KdTreeAccel : public Accelerator {
 //private:
 //    struct KdTreeNode {
-//        Bounds3d bbox;
+//        Bounds3 bbox;
 //        IndexedTriangle triangle;
 //        KdTreeNode* left;
 //        KdTreeNode* right;
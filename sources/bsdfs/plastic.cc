@@ -29,10 +29,10 @@ public:
     }
     
     
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override {
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override {
         const double Fo = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
 
-        if (vect::dot(wi, Vector3d(-wi.x(), -wi.y(), wi.z())) > 1.0 - EPS) {
+        if (vect::dot(wi, Vector3(-wi.x(), -wi.y(), wi.z())) > 1.0 - EPS) {
             // Specular reflection
             return Fo * Ks_ / std::abs(vect::cosTheta(wi));
         } else {
@@ -45,7 +45,7 @@ public:
         }
     }
 
-    Spectrum sample(const Vector3d& wo, Vector3d* wi,
+    Spectrum sample(const Vector3& wo, Vector3* wi,
                     const Point2d& rands, double* pdf,
                     BxDFType* sampledType) const override {
         const double Fo = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
@@ -53,7 +53,7 @@ public:
                                     (Fo * specularSamplingWeight_ + (1.0 - Fo) * (1.0 - specularSamplingWeight_));
         if (random.get1D() < probSpecular) {
             // Specular reflection
-            *wi = Vector3d(-wo.x(), -wo.y(), wo.z());
+            *wi = Vector3(-wo.x(), -wo.y(), wo.z());
             *pdf = probSpecular;
             return Ks_ * Fo / std::abs(vect::cosTheta(*wi));
         } else {
@@ -68,12 +68,12 @@ public:
         }
     }
 
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override {
+    double pdf(const Vector3& wo, const Vector3& wi) const override {
         const double Fo = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
         const double probSpecular = (Fo * specularSamplingWeight_) /
                                     (Fo * specularSamplingWeight_ + (1.0 - Fo) * (1.0 - specularSamplingWeight_));
 
-        if (vect::dot(wi, Vector3d(-wi.x(), -wi.y(), wi.z())) > 1.0 - EPS) {
+        if (vect::dot(wi, Vector3(-wi.x(), -wi.y(), wi.z())) > 1.0 - EPS) {
             // Specular reflection
             return probSpecular;
         } else {
@@ -32,26 +32,26 @@ public:
         specularSamplingWeight_ = Ks_.gray() / (Kd_.gray() + Ks_.gray());
     }
 
-    Spectrum f(const Vector3d& wo,
-               const Vector3d& wi) const override {
+    Spectrum f(const Vector3& wo,
+               const Vector3& wi) const override {
         const double cosThetaO = vect::cosTheta(wo);
         const double cosThetaI = vect::cosTheta(wi);
         if (cosThetaO == 0.0 || cosThetaI == 0.0) return Spectrum(0.0);
         if (!vect::sameHemisphere(wo, wi)) return Spectrum(0.0);
 
-        const Vector3d wh = vect::normalize(wi + wo);
+        const Vector3 wh = vect::normalize(wi + wo);
         const double F = FrDielectric(vect::dot(wo, wh), etaA_, etaB_);
         Spectrum spec = Ks_ * F * distrib_->D(wh) * distrib_->G(wo, wi, wh) / (4.0 * cosThetaO * cosThetaI);
         Spectrum diff = Kd_ * (1.0 - F) * INV_PI;
         return spec + diff;
     }
 
-    Spectrum sample(const Vector3d& wo, Vector3d* wi,
+    Spectrum sample(const Vector3& wo, Vector3* wi,
                     const Point2d& rands, double* pdf,
                     BxDFType* sampledType) const override {
         if (wo.z() == 0.0) return Spectrum(0.0);
 
-        const Vector3d wh = distrib_->sample(wo, rands);
+        const Vector3 wh = distrib_->sample(wo, rands);
         const double Fo = FrDielectric(vect::dot(wo, wh), etaA_, etaB_);
         const double probSpecular = (Fo * specularSamplingWeight_) /
                                     (Fo * specularSamplingWeight_ + (1.0 - Fo) * (1.0 - specularSamplingWeight_));
@@ -79,11 +79,11 @@ public:
         }
     }
 
-    double pdf(const Vector3d& wo,
-               const Vector3d& wi) const override {
+    double pdf(const Vector3& wo,
+               const Vector3& wi) const override {
         if (!vect::sameHemisphere(wo, wi)) return 0.0;
         
-        const Vector3d wh = vect::normalize(wi + wo);
+        const Vector3 wh = vect::normalize(wi + wo);
         const double F = FrDielectric(vect::dot(wo, wh), etaA_, etaB_);
         const double specPDF = F * distrib_->pdf(wo, wh) / (4.0 * vect::absDot(wo, wh));
         const double diffPDF = (1.0 - F) * std::abs(vect::cosTheta((wi))) * INV_PI;
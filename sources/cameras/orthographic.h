@@ -35,12 +35,12 @@ public:
     Spectrum We(const Ray& ray, Point2d* pRaster = nullptr) const override;
     void pdfWe(const Ray& ray, double* pdfPos, double* pdfDir) const override;
     Spectrum sampleWi(const Interaction& ref, const Point2d& rand,
-                      Vector3d* wi, double* pdf, Point2d* pRaster,
+                      Vector3* wi, double* pdf, Point2d* pRaster,
                       VisibilityTester* vis) const override;
 
 private:
     // Private fields
-    Vector3d uCamera_, vCamera_;
+    Vector3 uCamera_, vCamera_;
     double areaWorld_;
 
 };  // class OrthographicCamera
@@ -0,0 +1,21 @@
+#define SPICA_API_EXPORT
+#include "accelerator.h"
+
+#include "core/raybatch.h"
+
+namespace spica {
+
+void Accelerator::intersect(RayBatch &rays, HitBatch &hits) const {
+    hits.reset(rays.size());
+    for (int i = 0; i < rays.size(); i++) {
+        hitTest(rays[i], &hits[i]);
+    }
+}
+
+void Accelerator::occluded(RayBatch &rays, bool *occluded) const {
+    for (int i = 0; i < rays.size(); i++) {
+        occluded[i] = intersect(rays[i]);
+    }
+}
+
+}  // namespace spica
@@ -33,7 +33,23 @@ public:
 
     virtual ~Accelerator() {}
     virtual void construct() = 0;
-    virtual Bounds3d worldBound() const override {
+
+    using Aggregate::intersect;
+
+    /**
+     * Find the closest hits of the rays in the batch.
+     * The default implementation tests the rays one by one with "hitTest".
+     */
+    virtual void intersect(RayBatch &rays, HitBatch &hits) const;
+
+    /**
+     * Test if the rays in the batch hit anything, and store the results to
+     * "occluded", which must have as many elements as the rays.
+     * The default implementation tests the rays one by one.
+     */
+    virtual void occluded(RayBatch &rays, bool *occluded) const;
+
+    virtual Bounds3 worldBound() const override {
         return worldBound_;
     }
 
@@ -48,7 +64,7 @@ protected:
 
     // Protected fields
     std::vector<std::shared_ptr<Primitive>> primitives_;
-    Bounds3d   worldBound_;
+    Bounds3   worldBound_;
 };
 
 }  // namespace spica
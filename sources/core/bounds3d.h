@@ -20,7 +20,7 @@ public:
     Bounds3_(const Point3_<T>& posMin, const Point3_<T>& posMax);
     Bounds3_(const Bounds3_<T>& b);
 
-    virtual ~Bounds3_();
+    ~Bounds3_();
 
     Bounds3_<T>& operator=(const Bounds3_<T>& b);
     bool operator==(const Bounds3_<T>& b) const;
@@ -57,6 +57,7 @@ private:
 using Bounds3i = Bounds3_<int>;
 using Bounds3f = Bounds3_<float>;
 using Bounds3d = Bounds3_<double>;
+using Bounds3 = Bounds3_<Float>;  // Precision of the geometry
 
 }  // namespace spica
 
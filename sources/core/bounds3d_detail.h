@@ -107,10 +107,10 @@ bool Bounds3_<T>::inside(const Point3_<T>& p) const {
 template <class T>
 T Bounds3_<T>::area() const {
     Vector3_<T> diff = posMax_ - posMin_;
-    const double xy = std::abs(diff.x() * diff.y());
-    const double yz = std::abs(diff.y() * diff.z());
-    const double zx = std::abs(diff.z() * diff.x());
-    return 2.0 * (xy + yz + zx);
+    const T xy = std::abs(diff.x() * diff.y());
+    const T yz = std::abs(diff.y() * diff.z());
+    const T zx = std::abs(diff.z() * diff.x());
+    return 2 * (xy + yz + zx);
 }
 
 }  // namespace spica
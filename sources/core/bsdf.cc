@@ -35,21 +35,21 @@ int BSDF::numComponents(BxDFType type) const {
     return ret;
 }
 
-Vector3d BSDF::worldToLocal(const Vector3d& v) const {
+Vector3 BSDF::worldToLocal(const Vector3& v) const {
     double x = vect::dot(tangent_, v);
     double y = vect::dot(binormal_, v);
     double z = vect::dot(normal_, v);
     return { x, y, z };
 }
 
-Vector3d BSDF::localToWorld(const Vector3d& v) const {
-    return v.x() * tangent_ + v.y() * binormal_ + v.z() * Vector3d(normal_);
+Vector3 BSDF::localToWorld(const Vector3& v) const {
+    return v.x() * tangent_ + v.y() * binormal_ + v.z() * Vector3(normal_);
 }
 
-Spectrum BSDF::f(const Vector3d& woWorld, const Vector3d& wiWorld,
+Spectrum BSDF::f(const Vector3& woWorld, const Vector3& wiWorld,
                  BxDFType type) const {
-    Vector3d wo = worldToLocal(woWorld);
-    Vector3d wi = worldToLocal(wiWorld);
+    Vector3 wo = worldToLocal(woWorld);
+    Vector3 wi = worldToLocal(wiWorld);
     bool reflect = vect::dot(wiWorld, normal_) * vect::dot(woWorld, normal_) > 0.0;
     Spectrum ret(0.0);
     for (int i = 0; i < nBxDFs_; i++) {
@@ -62,7 +62,7 @@ Spectrum BSDF::f(const Vector3d& woWorld, const Vector3d& wiWorld,
     return ret;
 }
 
-Spectrum BSDF::sample(const Vector3d& woWorld, Vector3d* wiWorld,
+Spectrum BSDF::sample(const Vector3& woWorld, Vector3* wiWorld,
                       const Point2d& rands, double* pdf, BxDFType type,
                       BxDFType* sampledType) const {
     int matchComps = numComponents(type);
@@ -85,7 +85,7 @@ Spectrum BSDF::sample(const Vector3d& woWorld, Vector3d* wiWorld,
     Assertion(bxdf, "BxDF not found!!");
 
     Point2d uRemapped(std::min(rands[0] * matchComps - comp, 1.0 - EPS), rands[1]);
-    Vector3d wi, wo = worldToLocal(woWorld).normalized();
+    Vector3 wi, wo = worldToLocal(woWorld).normalized();
     if (wo.z() == 0.0) return Spectrum(0.0);
 
     *pdf = 0.0;
@@ -121,9 +121,9 @@ Spectrum BSDF::sample(const Vector3d& woWorld, Vector3d* wiWorld,
     return ret;
 }
 
-double BSDF::pdf(const Vector3d& woWorld, const Vector3d& wiWorld, BxDFType type) const {
+double BSDF::pdf(const Vector3& woWorld, const Vector3& wiWorld, BxDFType type) const {
     if (nBxDFs_ == 0) return 0.0;
-    Vector3d wo = worldToLocal(woWorld), wi = worldToLocal(wiWorld);
+    Vector3 wo = worldToLocal(woWorld), wi = worldToLocal(wiWorld);
     double pdf = 0.0;
     int matchComps = 0;
     for (int i = 0; i < nBxDFs_; i++) {
@@ -25,13 +25,13 @@ public:
     void add(BxDF* b);
     int numComponents(BxDFType type = BxDFType::All) const;
     
-    Spectrum f(const Vector3d& woWorld, const Vector3d& wiWorld,
+    Spectrum f(const Vector3& woWorld, const Vector3& wiWorld,
                BxDFType type = BxDFType::All) const;
 
-    Spectrum sample(const Vector3d& woWorld, Vector3d* wiWorld, const Point2d& rands,
+    Spectrum sample(const Vector3& woWorld, Vector3* wiWorld, const Point2d& rands,
                     double* pdf, BxDFType type = BxDFType::All,
                     BxDFType* sampledType = nullptr) const;
-    double pdf(const Vector3d& wo, const Vector3d& wi,
+    double pdf(const Vector3& wo, const Vector3& wi,
                BxDFType type = BxDFType::All) const;
 
     bool hasType(BxDFType type) const;
@@ -40,13 +40,13 @@ public:
 
 private:
     // Private methods
-    Vector3d worldToLocal(const Vector3d& v) const;
-    Vector3d localToWorld(const Vector3d& v) const;
+    Vector3 worldToLocal(const Vector3& v) const;
+    Vector3 localToWorld(const Vector3& v) const;
 
     // Private fields
     const double eta_;
-    const Normal3d normal_;
-    const Vector3d tangent_, binormal_;
+    const Normal3 normal_;
+    const Vector3 tangent_, binormal_;
     int nBxDFs_ = 0;
     static constexpr int maxBxDFs_ = 8;
     std::array<BxDF*, maxBxDFs_> bxdfs_;
@@ -13,7 +13,7 @@ template <class T>
 class BSphere_ {
 public:
     BSphere_();
-    BSphere_(const Point3d &center, double radius);
+    BSphere_(const Point3_<T> &center, T radius);
     BSphere_(const BSphere_ &sph);
 
     BSphere_ & operator=(const BSphere_ &sph);
@@ -29,7 +29,7 @@ private:
                   "Template type must be floating point type!");
 };
 
-using BSphere = BSphere_<double>;
+using BSphere = BSphere_<Float>;
 
 }  // namespace spica
 
@@ -14,7 +14,7 @@ BSphere_<T>::BSphere_()
 }
 
 template <class T>
-BSphere_<T>::BSphere_(const Point3d &center, double radius)
+BSphere_<T>::BSphere_(const Point3_<T> &center, T radius)
     : center_{center}
     , radius_{radius} {
 }
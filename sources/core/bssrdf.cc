@@ -150,7 +150,7 @@ SeparableBSSRDF::SeparableBSSRDF(const SurfaceInteraction& po,
 }
 
 Spectrum SeparableBSSRDF::S(const SurfaceInteraction& pi,
-                            const Vector3d& wi) const {
+                            const Vector3& wi) const {
     const double Ft = FrDielectric(vect::cosTheta(po_.wo()), 1.0, eta_);
     return (1.0 - Ft) * Sp(pi) * Sw(wi);
 }
@@ -162,7 +162,7 @@ Spectrum SeparableBSSRDF::sample(const Scene& scene, double rand1,
     if (!sp.isBlack()) {
         pi->setBSDF(arena.allocate<BSDF>(*pi));
         pi->bsdf()->add(arena.allocate<SeparableBSSRDFAdapter>(this));
-        pi->wo_ = Vector3d(pi->normal());
+        pi->wo_ = Vector3(pi->normal());
     }
     return sp;
 }
@@ -171,19 +171,19 @@ Spectrum SeparableBSSRDF::sampleSp(const Scene& scene, double rand1,
                                  const Point2d& rand2, MemoryArena& arena,
                                  SurfaceInteraction* pi, double* pdf) const {
     // Choose coordinate system for sampling
-    Vector3d xAxis, yAxis, zAxis;
+    Vector3 xAxis, yAxis, zAxis;
     if (rand1 < 0.5) {
         xAxis = tangent_;
         yAxis = binormal_;
-        zAxis = Vector3d(normal_);
+        zAxis = Vector3(normal_);
         rand1 *= 2.0;
     } else if (rand1 < 0.75) {
         xAxis = binormal_;
-        yAxis = Vector3d(normal_);
+        yAxis = Vector3(normal_);
         zAxis = tangent_;
         rand1 = (rand1 - 0.5) * 4.0;
     } else {
-        xAxis = Vector3d(normal_);
+        xAxis = Vector3(normal_);
         yAxis = tangent_;
         zAxis = binormal_;
         rand1 = (rand1 - 0.75) * 4.0;
@@ -204,11 +204,11 @@ Spectrum SeparableBSSRDF::sampleSp(const Scene& scene, double rand1,
     const double zCoord = std::sqrt(rMax * rMax - r * r);
 
     // Compute sampling ray
-    Point3d pFrom =
+    Point3 pFrom =
         po_.pos() + (xAxis * std::cos(phi) + yAxis * std::sin(phi)) * r -
         zCoord * zAxis;
-    Point3d pTo   = pFrom + 2.0 * zCoord * zAxis;
-    Vector3d dir = pTo - pFrom;
+    Point3 pTo   = pFrom + 2.0 * zCoord * zAxis;
+    Vector3 dir = pTo - pFrom;
     Ray ray(pFrom, dir, std::max(0.0, dir.norm() - EPS));
 
     // Compute intersection candidates
@@ -245,12 +245,12 @@ Spectrum SeparableBSSRDF::sampleSp(const Scene& scene, double rand1,
 }
 
 double SeparableBSSRDF::pdfSp(const SurfaceInteraction& pi) const {
-    Vector3d d = po_.pos() - pi.pos();
-    Vector3d dLocal(vect::dot(tangent_, d), vect::dot(binormal_, d),
-                    vect::dot(normal_, d));
-    Normal3d nLocal(vect::dot(tangent_, pi.normal()),
-                    vect::dot(binormal_, pi.normal()),
-                    vect::dot(normal_, pi.normal()));
+    Vector3 d = po_.pos() - pi.pos();
+    Vector3 dLocal(vect::dot(tangent_, d), vect::dot(binormal_, d),
+                   vect::dot(normal_, d));
+    Normal3 nLocal(vect::dot(tangent_, pi.normal()),
+                   vect::dot(binormal_, pi.normal()),
+                   vect::dot(normal_, pi.normal()));
 
     double rProj[3] = { std::sqrt(dLocal.y() * dLocal.y() + dLocal.z() * dLocal.z()),
                         std::sqrt(dLocal.z() * dLocal.z() + dLocal.x() * dLocal.x()),
@@ -271,7 +271,7 @@ Spectrum SeparableBSSRDF::Sp(const SurfaceInteraction& pi) const {
     return Sr((po_.pos() - pi.pos()).norm());
 }
 
-Spectrum SeparableBSSRDF::Sw(const Vector3d& wi) const {
+Spectrum SeparableBSSRDF::Sw(const Vector3& wi) const {
     double c = 1.0 - 2.0 * FresnelMoment1(1.0 / eta_);
     double Ft = FrDielectric(vect::cosTheta(wi), 1.0, eta_);
     return Spectrum((1.0 - Ft) / (c * PI));
@@ -378,7 +378,7 @@ DiffusionReflectance::DiffusionReflectance(double eta)
     : eta_{ eta } {
 }
 
-double DiffusionReflectance::Ft(const Vector3d& w) const {
+double DiffusionReflectance::Ft(const Vector3& w) const {
     return FrDielectric(vect::cosTheta(w), 1.0, eta_);
 }
 
@@ -403,8 +403,8 @@ DipoleDiffusionReflectance::DipoleDiffusionReflectance(const Spectrum &sigma_a,
     zneg_     = -zpos_ * (1.0 + (4.0 / 3.0) * A_);
 }
 
-Spectrum DipoleDiffusionReflectance::operator()(const Point3d& po,
-                                                const Point3d& pi) const {
+Spectrum DipoleDiffusionReflectance::operator()(const Point3& po,
+                                                const Point3& pi) const {
     const double d2 = (po - pi).squaredNorm();
     Spectrum dpos = Spectrum::sqrt(d2 + zpos_ * zpos_);
     Spectrum dneg = Spectrum::sqrt(d2 + zneg_ * zneg_);
@@ -458,7 +458,7 @@ SeparableBSSRDFAdapter::SeparableBSSRDFAdapter(const SeparableBSSRDF* bssrdf)
     , bssrdf_{ bssrdf } {
 }
 
-Spectrum SeparableBSSRDFAdapter::f(const Vector3d& wo, const Vector3d& wi) const {
+Spectrum SeparableBSSRDFAdapter::f(const Vector3& wo, const Vector3& wi) const {
     Spectrum f = bssrdf_->Sw(wi);
     // TODO: Should the transport mode be considered??
     return f;
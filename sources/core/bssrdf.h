@@ -27,7 +27,7 @@ public:
     BSSRDF(const SurfaceInteraction& po, double eta);
 
     virtual Spectrum S(const SurfaceInteraction& pi,
-                       const Vector3d& wi) const = 0;
+                       const Vector3& wi) const = 0;
     virtual Spectrum sample(const Scene& scene, double rand1, const Point2d& rand2,
                             MemoryArena& arena, SurfaceInteraction* po,
                             double* pdf) const = 0;
@@ -45,7 +45,7 @@ public:
     // Public methods
     SeparableBSSRDF(const SurfaceInteraction& po, double eta,
                     const SubsurfaceMaterial* material);
-    Spectrum S(const SurfaceInteraction& pi, const Vector3d& wi) const override;
+    Spectrum S(const SurfaceInteraction& pi, const Vector3& wi) const override;
     Spectrum sample(const Scene& scene, double rand1, const Point2d& rand2,
                     MemoryArena& arena, SurfaceInteraction* po,
                     double* pdf) const override;
@@ -57,7 +57,7 @@ public:
 
 protected:
     // Protected methods
-    Spectrum Sw(const Vector3d& w) const;
+    Spectrum Sw(const Vector3& w) const;
     Spectrum sampleSp(const Scene& scene, double rand1, const Point2d& rand2,
                       MemoryArena& arena, SurfaceInteraction* pi,
                       double* pdf) const;
@@ -69,8 +69,8 @@ protected:
 
 private:
     // Private fields
-    const Normal3d normal_;
-    const Vector3d tangent_, binormal_;
+    const Normal3 normal_;
+    const Vector3 tangent_, binormal_;
     const SubsurfaceMaterial* material_;
 
     // Friend
@@ -111,7 +111,7 @@ class SeparableBSSRDFAdapter : public BxDF {
 public:
     explicit SeparableBSSRDFAdapter(const SeparableBSSRDF* bssrdf);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     const SeparableBSSRDF* bssrdf_;
@@ -120,9 +120,9 @@ private:
 class SPICA_EXPORTS DiffusionReflectance {
 public:
     DiffusionReflectance(double eta);
-    virtual Spectrum operator()(const Point3d& po, const Point3d& pi) const = 0;
+    virtual Spectrum operator()(const Point3& po, const Point3& pi) const = 0;
 
-    double Ft(const Vector3d& w) const;
+    double Ft(const Vector3& w) const;
     double Fdr() const;
 
 protected:
@@ -134,7 +134,7 @@ public:
     DipoleDiffusionReflectance(const Spectrum &sigma_a, const Spectrum &sigmap_s,
                                float eta);
 
-    Spectrum operator()(const Point3d& po, const Point3d& pi) const override;
+    Spectrum operator()(const Point3& po, const Point3& pi) const override;
 
 private:
     double A_;
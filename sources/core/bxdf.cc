@@ -13,7 +13,7 @@ namespace spica {
 
 namespace {
 
-inline double absCosTheta(const Vector3d& w) { return std::abs(w.z()); }
+inline double absCosTheta(const Vector3& w) { return std::abs(w.z()); }
 
 static thread_local Random random;
 static const double deltaEps = 1.0e-4;
@@ -31,7 +31,7 @@ BxDF::BxDF(BxDFType type)
 BxDF::~BxDF() {
 }
 
-Spectrum BxDF::sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+Spectrum BxDF::sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                       double* pdf, BxDFType* type) const {
     *wi = sampleCosineHemisphere(rands);
     if (wo.z() < 0.0) wi->zRef() *= -1.0;
@@ -39,7 +39,7 @@ Spectrum BxDF::sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
     return f(wo, *wi);
 }
 
-double BxDF::pdf(const Vector3d& wo, const Vector3d& wi) const {
+double BxDF::pdf(const Vector3& wo, const Vector3& wi) const {
     return wo.z() * wi.z() > 0.0 ? absCosTheta(wi) * INV_PI : 0.0;
 }
 
@@ -53,7 +53,7 @@ LambertianReflection::LambertianReflection(const Spectrum& ref)
     this->ref_ = ref;
 }
 
-Spectrum LambertianReflection::f(const Vector3d& wo, const Vector3d& wi) const {
+Spectrum LambertianReflection::f(const Vector3& wo, const Vector3& wi) const {
     return ref_ * INV_PI;
 }
 
@@ -67,8 +67,8 @@ LambertianTransmission::LambertianTransmission(const Spectrum& tr)
     this->tr_ = tr;
 }
 
-Spectrum LambertianTransmission::f(const Vector3d& wo,
-                                   const Vector3d& wi) const {
+Spectrum LambertianTransmission::f(const Vector3& wo,
+                                   const Vector3& wi) const {
     return tr_ * INV_PI;
 }
 
@@ -83,25 +83,25 @@ SpecularReflection::SpecularReflection(const Spectrum& ref, Fresnel* fresnel)
     this->fresnel_ = fresnel;
 }
 
-Spectrum SpecularReflection::f(const Vector3d& wo, const Vector3d& wi) const {
-    if (vect::dot(Vector3d(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
+Spectrum SpecularReflection::f(const Vector3& wo, const Vector3& wi) const {
+    if (vect::dot(Vector3(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
         return ref_ / std::abs(vect::cosTheta(wi));
     }
     return Spectrum(0.0);    
 }
 
-Spectrum SpecularReflection::sample(const Vector3d& wo, Vector3d* wi,
+Spectrum SpecularReflection::sample(const Vector3& wo, Vector3* wi,
                                     const Point2d& rands, double* pdf,
                                     BxDFType* type) const {
-    *wi = Vector3d(-wo.x(), -wo.y(), wo.z());
+    *wi = Vector3(-wo.x(), -wo.y(), wo.z());
     *pdf = 1.0;
 
     const double cosTheta = vect::cosTheta(*wi);
     return fresnel_->evaluate(cosTheta) * ref_ / std::abs(cosTheta);
 }
 
-double SpecularReflection::pdf(const Vector3d& wo, const Vector3d& wi) const {
-    if (vect::dot(Vector3d(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
+double SpecularReflection::pdf(const Vector3& wo, const Vector3& wi) const {
+    if (vect::dot(Vector3(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
         return 1.0;
     }
     return 0.0;
@@ -121,18 +121,18 @@ SpecularTransmission::SpecularTransmission(const Spectrum& tr, double etaA,
     , fresnel_{ std::make_unique<FresnelDielectric>(etaA_, etaB_) } {
 }
 
-Spectrum SpecularTransmission::f(const Vector3d& wo, const Vector3d& wi) const {
+Spectrum SpecularTransmission::f(const Vector3& wo, const Vector3& wi) const {
     return Spectrum(0.0);    
 }
 
-Spectrum SpecularTransmission::sample(const Vector3d& wo, Vector3d* wi,
+Spectrum SpecularTransmission::sample(const Vector3& wo, Vector3* wi,
                                       const Point2d& rands, double* pdf,
                                       BxDFType* sampledType) const {
     bool entering = vect::cosTheta(wo) > 0.0;
     double etaI = entering ? etaA_ : etaB_;
     double etaT = entering ? etaB_ : etaA_;
 
-    if (!vect::refract(wo, Vector3d(vect::faceforward(Normal3d(0.0, 0.0, 1.0), wo)),
+    if (!vect::refract(wo, Vector3(vect::faceforward(Normal3(0.0, 0.0, 1.0), wo)),
         etaI / etaT, wi)) {
         return Spectrum(0.0);
     }
@@ -144,7 +144,7 @@ Spectrum SpecularTransmission::sample(const Vector3d& wo, Vector3d* wi,
     return ft / std::abs(vect::cosTheta(*wi));
 }
 
-double SpecularTransmission::pdf(const Vector3d& wo, const Vector3d& wi) const {
+double SpecularTransmission::pdf(const Vector3& wo, const Vector3& wi) const {
     return 0.0;
 }
 
@@ -168,10 +168,10 @@ FresnelSpecular::FresnelSpecular(const Spectrum& ref, const Spectrum& tr,
     this->etaB_ = etaB;
 }
 
-Spectrum FresnelSpecular::f(const Vector3d& wo, const Vector3d& wi) const {
+Spectrum FresnelSpecular::f(const Vector3& wo, const Vector3& wi) const {
     const double F = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
     if (vect::sameHemisphere(wo, wi)) {
-        if (vect::dot(Vector3d(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
+        if (vect::dot(Vector3(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
             return ref_ * F / std::abs(vect::cosTheta(wi));
         }
     } else {
@@ -179,8 +179,8 @@ Spectrum FresnelSpecular::f(const Vector3d& wo, const Vector3d& wi) const {
         double etaI = entering ? etaA_ : etaB_;
         double etaT = entering ? etaB_ : etaA_;
 
-        Vector3d wt;
-        if (!vect::refract(wo, Vector3d(vect::faceforward(Normal3d(0.0, 0.0, 1.0), wo)), etaI / etaT, &wt)) {
+        Vector3 wt;
+        if (!vect::refract(wo, Vector3(vect::faceforward(Normal3(0.0, 0.0, 1.0), wo)), etaI / etaT, &wt)) {
             return Spectrum(0.0);
         }
 
@@ -191,13 +191,13 @@ Spectrum FresnelSpecular::f(const Vector3d& wo, const Vector3d& wi) const {
     return Spectrum(0.0);
 }
 
-Spectrum FresnelSpecular::sample(const Vector3d& wo, Vector3d* wi,
+Spectrum FresnelSpecular::sample(const Vector3& wo, Vector3* wi,
                                  const Point2d& rands, double* pdf,
                                  BxDFType* sampledType) const {
     const double F = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
     if (rands[0] < F) {
         // Reflection
-        *wi = Vector3d(-wo.x(), -wo.y(), wo.z());
+        *wi = Vector3(-wo.x(), -wo.y(), wo.z());
         if (sampledType) {
             *sampledType = BxDFType::Specular | BxDFType::Reflection;
         }
@@ -209,7 +209,7 @@ Spectrum FresnelSpecular::sample(const Vector3d& wo, Vector3d* wi,
         double etaI = entering ? etaA_ : etaB_;
         double etaT = entering ? etaB_ : etaA_;
 
-        if (!vect::refract(wo, Vector3d(vect::faceforward(Normal3d(0.0, 0.0, 1.0), wo)), etaI / etaT, wi)) {
+        if (!vect::refract(wo, Vector3(vect::faceforward(Normal3(0.0, 0.0, 1.0), wo)), etaI / etaT, wi)) {
             return Spectrum(0.0);
         }
 
@@ -224,10 +224,10 @@ Spectrum FresnelSpecular::sample(const Vector3d& wo, Vector3d* wi,
     }
 }
 
-double FresnelSpecular::pdf(const Vector3d& wo, const Vector3d& wi) const {
+double FresnelSpecular::pdf(const Vector3& wo, const Vector3& wi) const {
     const double F = FrDielectric(vect::cosTheta(wo), etaA_, etaB_);
     if (vect::sameHemisphere(wo, wi)) {
-        if (vect::dot(Vector3d(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
+        if (vect::dot(Vector3(-wo.x(), -wo.y(), wo.z()), wi) > 1.0 - deltaEps) {
             return F;
         }
     } else {
@@ -235,8 +235,8 @@ double FresnelSpecular::pdf(const Vector3d& wo, const Vector3d& wi) const {
         double etaI = entering ? etaA_ : etaB_;
         double etaT = entering ? etaB_ : etaA_;
 
-        Vector3d wt;
-        if (!vect::refract(wo, Vector3d(vect::faceforward(Normal3d(0.0, 0.0, 1.0), wo)), etaI / etaT, &wt)) {
+        Vector3 wt;
+        if (!vect::refract(wo, Vector3(vect::faceforward(Normal3(0.0, 0.0, 1.0), wo)), etaI / etaT, &wt)) {
             return 0.0;
         }
 
@@ -261,10 +261,10 @@ MicrofacetReflection::MicrofacetReflection(const Spectrum& ref,
     , fresnel_{ fresnel } {
 }
 
-Spectrum MicrofacetReflection::f(const Vector3d& wo, const Vector3d& wi) const {
+Spectrum MicrofacetReflection::f(const Vector3& wo, const Vector3& wi) const {
     const double cosThetaO = std::abs(vect::cosTheta(wo));
     const double cosThetaI = std::abs(vect::cosTheta(wi));
-    Vector3d wh = wi + wo;
+    Vector3 wh = wi + wo;
 
     // Degenerate case
     if (cosThetaI == 0.0 || cosThetaO == 0.0) return Spectrum(0.0);
@@ -277,12 +277,12 @@ Spectrum MicrofacetReflection::f(const Vector3d& wo, const Vector3d& wi) const {
     return ret;
 }
 
-Spectrum MicrofacetReflection::sample(const Vector3d& wo, Vector3d* wi,
+Spectrum MicrofacetReflection::sample(const Vector3& wo, Vector3* wi,
                                       const Point2d& rands, double* pdf,
                                       BxDFType* sampledType) const {
     if (wo.z() == 0.0) return Spectrum(0.0);
 
-    Vector3d wh = distrib_->sample(wo, rands);
+    Vector3 wh = distrib_->sample(wo, rands);
     *wi = vect::reflect(wo, wh);
     if (!vect::sameHemisphere(wo, *wi)) return Spectrum(0.0);
 
@@ -290,9 +290,9 @@ Spectrum MicrofacetReflection::sample(const Vector3d& wo, Vector3d* wi,
     return f(wo, *wi);
 }
 
-double MicrofacetReflection::pdf(const Vector3d& wo, const Vector3d& wi) const {
+double MicrofacetReflection::pdf(const Vector3& wo, const Vector3& wi) const {
     if (!vect::sameHemisphere(wo, wi)) return 0.0;
-    Vector3d wh = vect::normalize(wo + wi);
+    Vector3 wh = vect::normalize(wo + wi);
     return distrib_->pdf(wo, wh) / (4.0 * vect::dot(wo, wh));
 }
 
@@ -312,13 +312,13 @@ MicrofacetTransmission::MicrofacetTransmission(const Spectrum &re, const Spectru
     , etaB_{ etaB } {
 }
 
-Spectrum MicrofacetTransmission::f(const Vector3d& wo,
-                                   const Vector3d& wi) const {
+Spectrum MicrofacetTransmission::f(const Vector3& wo,
+                                   const Vector3& wi) const {
     double cosThetaO = vect::cosTheta(wo);
     double cosThetaI = vect::cosTheta(wi);
     if (cosThetaO == 0.0 || cosThetaI == 0.0) return Spectrum(0.0);
 
-    Vector3d wh;
+    Vector3 wh;
     if (vect::sameHemisphere(wo, wi)) {
         // Reflection        
         wh = vect::normalize(wo + wi);
@@ -330,7 +330,7 @@ Spectrum MicrofacetTransmission::f(const Vector3d& wo,
     return f(wo, wi, wh.z() >= 0.0 ? wh : -wh);
 }
 
-Spectrum MicrofacetTransmission::f(const Vector3d &wo, const Vector3d &wi, const Vector3d &wh) const {
+Spectrum MicrofacetTransmission::f(const Vector3 &wo, const Vector3 &wi, const Vector3 &wh) const {
     double cosThetaO = vect::cosTheta(wo);
     double cosThetaI = vect::cosTheta(wi);
     if (cosThetaO == 0.0 || cosThetaI == 0.0) return Spectrum(0.0);
@@ -353,12 +353,12 @@ Spectrum MicrofacetTransmission::f(const Vector3d &wo, const Vector3d &wi, const
     }    
 }
 
-Spectrum MicrofacetTransmission::sample(const Vector3d& wo, Vector3d* wi,
+Spectrum MicrofacetTransmission::sample(const Vector3& wo, Vector3* wi,
                                         const Point2d& rands, double* pdf,
                                         BxDFType* sampledType) const {
     if (wo.z() == 0.0) return Spectrum(0.0);
 
-    Vector3d wh = distrib_->sample(wo, rands);
+    Vector3 wh = distrib_->sample(wo, rands);
     const double cosThetaO = vect::dot(wo, wh.z() > 0.0 ? wh : -wh);
     const double F = FrDielectric(cosThetaO, etaA_, etaB_);
     if (random.get1D() < F) {
@@ -391,9 +391,9 @@ Spectrum MicrofacetTransmission::sample(const Vector3d& wo, Vector3d* wi,
     return f(wo, *wi, wh.z() >= 0.0 ? wh : -wh);
 }
 
-double MicrofacetTransmission::pdf(const Vector3d& wo,
-                                   const Vector3d& wi) const {
-    Vector3d wh;
+double MicrofacetTransmission::pdf(const Vector3& wo,
+                                   const Vector3& wi) const {
+    Vector3 wh;
     if (vect::sameHemisphere(wo, wi)) {
         // Reflection
         wh = vect::normalize(wi + wo);
@@ -405,7 +405,7 @@ double MicrofacetTransmission::pdf(const Vector3d& wo,
     return pdf(wo, wi, wh.z() >= 0.0 ? wh : -wh);
 }
 
-double MicrofacetTransmission::pdf(const Vector3d& wo, const Vector3d& wi, const Vector3d &wh) const {
+double MicrofacetTransmission::pdf(const Vector3& wo, const Vector3& wi, const Vector3 &wh) const {
     if (wo.z() * vect::dot(wo, wh) <= 0.0) return 0.0;
     if (wi.z() * vect::dot(wi, wh) <= 0.0) return 0.0;
 
@@ -48,11 +48,11 @@ public:
     explicit BxDF(BxDFType type = BxDFType::None);
     virtual ~BxDF();
 
-    virtual Spectrum f(const Vector3d& wo, const Vector3d& wi) const = 0;
-    virtual Spectrum sample(const Vector3d& wo, Vector3d* wi,
+    virtual Spectrum f(const Vector3& wo, const Vector3& wi) const = 0;
+    virtual Spectrum sample(const Vector3& wo, Vector3* wi,
                             const Point2d& rands, double* pdf,
                             BxDFType* sampledType = nullptr) const;
-    virtual double pdf(const Vector3d& wo, const Vector3d& wi) const;
+    virtual double pdf(const Vector3& wo, const Vector3& wi) const;
 
     inline BxDFType type() const { return type_; }
 
@@ -68,7 +68,7 @@ class SPICA_EXPORTS LambertianReflection : public BxDF {
 public:
     explicit LambertianReflection(const Spectrum& ref);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     Spectrum ref_;
@@ -81,7 +81,7 @@ class SPICA_EXPORTS LambertianTransmission : public BxDF {
 public:
     explicit LambertianTransmission(const Spectrum& tr);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     Spectrum tr_;
@@ -95,10 +95,10 @@ public:
     // Public methods
     SpecularReflection(const Spectrum& ref, Fresnel* fresnel);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
-    Spectrum sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
+    Spectrum sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                     double* pdf, BxDFType* sampledType) const override;
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override;
+    double pdf(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     // Private fields
@@ -114,10 +114,10 @@ public:
     // Public methods
     SpecularTransmission(const Spectrum& tr, double etaA, double etaB);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
-    Spectrum sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
+    Spectrum sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                     double* pdf, BxDFType* sampledType) const override;
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override;
+    double pdf(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     // Private fields
@@ -136,10 +136,10 @@ public:
     FresnelSpecular();
     FresnelSpecular(const Spectrum& ref, const Spectrum& tr, double etaA, double etaB);
 
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
-    Spectrum sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
+    Spectrum sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                     double* pdf, BxDFType* sampledType) const override;
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override;
+    double pdf(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     // Private fields
@@ -156,10 +156,10 @@ class SPICA_EXPORTS MicrofacetReflection : public BxDF {
 public:
     MicrofacetReflection(const Spectrum& ref,
                          MicrofacetDistribution* distrib, Fresnel* fresnel);
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
-    Spectrum sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
+    Spectrum sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                     double* pdf, BxDFType* sampledType) const override;
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override;
+    double pdf(const Vector3& wo, const Vector3& wi) const override;
 
 private:
     const Spectrum ref_;
@@ -176,12 +176,12 @@ public:
     MicrofacetTransmission(const Spectrum &re, const Spectrum& tr,
                            MicrofacetDistribution* distrib, double etaA,
                            double etaB);
-    Spectrum f(const Vector3d& wo, const Vector3d& wi) const override;
-    Spectrum f(const Vector3d &wo, const Vector3d &wi, const Vector3d &wh) const;
-    Spectrum sample(const Vector3d& wo, Vector3d* wi, const Point2d& rands,
+    Spectrum f(const Vector3& wo, const Vector3& wi) const override;
+    Spectrum f(const Vector3 &wo, const Vector3 &wi, const Vector3 &wh) const;
+    Spectrum sample(const Vector3& wo, Vector3* wi, const Point2d& rands,
                     double* pdf, BxDFType* sampledType) const override;
-    double pdf(const Vector3d& wo, const Vector3d& wi) const override;
-    double pdf(const Vector3d &wo, const Vector3d &wi, const Vector3d &wh) const;
+    double pdf(const Vector3& wo, const Vector3& wi) const override;
+    double pdf(const Vector3 &wo, const Vector3 &wi, const Vector3 &wh) const;
 
 private:
     // Private fields
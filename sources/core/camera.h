@@ -35,7 +35,7 @@ public:
     virtual Spectrum We(const Ray& ray, Point2d* pRaster = nullptr) const = 0;
     virtual void pdfWe(const Ray& ray, double* pdfPos, double* pdfDir) const = 0;
     virtual Spectrum sampleWi(const Interaction& ref, const Point2d& rand,
-                              Vector3d* wi, double* pdf, Point2d* pRaster,
+                              Vector3* wi, double* pdf, Point2d* pRaster,
                               VisibilityTester* vis) const = 0;
 
     inline std::shared_ptr<Film> film() const { return film_; }
@@ -0,0 +1,143 @@
+#define SPICA_API_EXPORT
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "core/renderparams.h"
+#include "core/sampler.h"
+
+namespace spica {
+
+namespace {
+
+const char kCheckpointMagic[8] = "SPCKPT2";
+
+}  // anonymous namespace
+
+// -----------------------------------------------------------------------------
+// CheckpointWriter method definitions
+// -----------------------------------------------------------------------------
+
+CheckpointWriter::CheckpointWriter(const std::string &filename,
+                                   const std::string &tag)
+    : filename_{ filename }
+    , tempname_{ filename + ".tmp" }
+    , ofs_{ tempname_.c_str(), std::ios::out | std::ios::binary } {
+    if (!ofs_.is_open()) {
+        throw RuntimeException("Failed to open file: %s", tempname_.c_str());
+    }
+
+    const uint32_t tagLength = static_cast<uint32_t>(tag.size());
+    write(kCheckpointMagic, sizeof(kCheckpointMagic));
+    write(tagLength);
+    write(tag.c_str(), tagLength);
+}
+
+void CheckpointWriter::commit() {
+    ofs_.close();
+    if (ofs_.fail()) {
+        throw RuntimeException("Failed to write file: %s", tempname_.c_str());
+    }
+
+    // Replace the previous checkpoint
+    std::remove(filename_.c_str());
+    if (std::rename(tempname_.c_str(), filename_.c_str()) != 0) {
+        throw RuntimeException("Failed to rename file: %s", tempname_.c_str());
+    }
+    MsgInfo("Checkpoint: %s", filename_.c_str());
+}
+
+// -----------------------------------------------------------------------------
+// CheckpointReader method definitions
+// -----------------------------------------------------------------------------
+
+CheckpointReader::CheckpointReader(const std::string &filename,
+                                   const std::string &tag)
+    : ifs_{ filename.c_str(), std::ios::in | std::ios::binary } {
+    if (!ifs_.is_open()) return;
+
+    char magic[sizeof(kCheckpointMagic)];
+    uint32_t tagLength = 0;
+    ifs_.read(magic, sizeof(magic));
+    ifs_.read(reinterpret_cast<char*>(&tagLength), sizeof(tagLength));
+    if (!ifs_.good() || std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0 ||
+        tagLength != tag.size()) {
+        return;
+    }
+
+    std::string fileTag(tagLength, '\0');
+    ifs_.read(&fileTag[0], tagLength);
+    valid_ = ifs_.good() && fileTag == tag;
+}
+
+// -----------------------------------------------------------------------------
+// Checkpointer method definitions
+// -----------------------------------------------------------------------------
+
+Checkpointer::Checkpointer(RenderParams &params, const std::string &tag)
+    : filename_{ params.getString("checkpointFile", std::string()) }
+    , tag_{ tag }
+    , interval_{ params.getDouble("checkpointInterval", 0.0) }
+    , resume_{ params.getBool("resume", false, false) }
+    , last_{ std::chrono::steady_clock::now() } {
+}
+
+std::unique_ptr<CheckpointReader> Checkpointer::resume() const {
+    if (filename_.empty() || !resume_) return nullptr;
+
+    auto reader = std::make_unique<CheckpointReader>(filename_, tag_);
+    if (!reader->valid()) {
+        Warning("No checkpoint to resume: %s", filename_.c_str());
+        return nullptr;
+    }
+    MsgInfo("Resume from: %s", filename_.c_str());
+    return reader;
+}
+
+bool Checkpointer::due(bool always) {
+    if (filename_.empty() || interval_ <= 0.0) return false;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!always && std::chrono::duration<double>(now - last_).count() < interval_) {
+        return false;
+    }
+    last_ = now;
+    return true;
+}
+
+std::unique_ptr<CheckpointWriter> Checkpointer::writer() const {
+    return std::make_unique<CheckpointWriter>(filename_, tag_);
+}
+
+// -----------------------------------------------------------------------------
+// Sampler state functions
+// -----------------------------------------------------------------------------
+
+void saveSamplers(CheckpointWriter &writer,
+                  const std::vector<std::unique_ptr<Sampler>> &samplers) {
+    const int numSamplers = static_cast<int>(samplers.size());
+    writer.write(numSamplers);
+    for (const auto &sampler : samplers) {
+        sampler->saveState(writer);
+    }
+}
+
+bool loadSamplers(CheckpointReader &reader, const Sampler &sampler,
+                  std::vector<std::unique_ptr<Sampler>> *samplers) {
+    int numSamplers;
+    reader.read(&numSamplers);
+    if (numSamplers != static_cast<int>(samplers->size())) {
+        Warning("Samplers of %d threads are not resumed by %d threads.",
+                numSamplers, static_cast<int>(samplers->size()));
+        return false;
+    }
+
+    for (auto &s : *samplers) {
+        s = sampler.clone();
+        s->loadState(reader);
+    }
+    return true;
+}
+
+}  // namespace spica
@@ -0,0 +1,134 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_CHECKPOINT_H_
+#define _SPICA_CHECKPOINT_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <type_traits>
+
+#include "core/common.h"
+#include "core/uncopyable.h"
+#include "core/exception.h"
+#include "core/render.hpp"
+
+namespace spica {
+
+/**
+ * Binary writer of a checkpoint.
+ * @details
+ * The file starts with a magic number and the tag of the integrator, which
+ * is followed by the values written by the integrator. The values are
+ * written to a temporary file, which replaces the previous checkpoint only
+ * when "commit" is called, so that an interrupted write never destroys it.
+ */
+class SPICA_EXPORTS CheckpointWriter : Uncopyable {
+public:
+    CheckpointWriter(const std::string &filename, const std::string &tag);
+
+    template <class T>
+    void write(const T &value) {
+        write(&value, 1);
+    }
+
+    template <class T>
+    void write(const T *values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be written!!");
+        ofs_.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+    }
+
+    void commit();
+
+private:
+    std::string filename_;
+    std::string tempname_;
+    std::ofstream ofs_;
+};
+
+/**
+ * Binary reader of a checkpoint written by "CheckpointWriter".
+ * The values must be read in the order they were written.
+ */
+class SPICA_EXPORTS CheckpointReader : Uncopyable {
+public:
+    CheckpointReader(const std::string &filename, const std::string &tag);
+
+    //! Whether the file exists and was written for the tag.
+    inline bool valid() const { return valid_; }
+
+    template <class T>
+    void read(T *value) {
+        read(value, 1);
+    }
+
+    template <class T>
+    void read(T *values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be read!!");
+        ifs_.read(reinterpret_cast<char*>(values), sizeof(T) * count);
+        if (!ifs_.good()) {
+            throw RuntimeException("Checkpoint file is truncated!!");
+        }
+    }
+
+private:
+    std::ifstream ifs_;
+    bool valid_ = false;
+};
+
+/**
+ * Periodic checkpointing of a render.
+ * @details
+ * The following parameters are used.
+ *   - checkpointFile: the file of the checkpoint. Empty disables it.
+ *   - checkpointInterval: seconds between checkpoints.
+ *   - resume: restore the state from the file at the start of the render.
+ */
+class SPICA_EXPORTS Checkpointer : Uncopyable {
+public:
+    Checkpointer(RenderParams &params, const std::string &tag);
+
+    /**
+     * Open the checkpoint to resume the render from.
+     * Returns nullptr if resuming is not requested or no valid file exists.
+     */
+    std::unique_ptr<CheckpointReader> resume() const;
+
+    /**
+     * Check if the interval has elapsed since the last checkpoint. With
+     * "always", e.g., for the state which is resumable only from the last
+     * pass, it is due whenever checkpointing is enabled.
+     */
+    bool due(bool always = false);
+
+    std::unique_ptr<CheckpointWriter> writer() const;
+
+private:
+    std::string filename_;
+    std::string tag_;
+    double interval_;
+    bool resume_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+//! Write the states of the samplers of the threads.
+SPICA_EXPORTS void saveSamplers(CheckpointWriter &writer,
+                                const std::vector<std::unique_ptr<Sampler>> &samplers);
+
+/**
+ * Restore the samplers written by "saveSamplers" into the clones of
+ * "sampler". If they were written for another number of threads, the
+ * samplers are left as they are and false is returned.
+ */
+SPICA_EXPORTS bool loadSamplers(CheckpointReader &reader, const Sampler &sampler,
+                                std::vector<std::unique_ptr<Sampler>> *samplers);
+
+}  // namespace spica
+
+#endif  // _SPICA_CHECKPOINT_H_
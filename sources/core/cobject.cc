@@ -31,20 +31,20 @@ PluginManager &PluginManager::getInstance() {
 
 void PluginManager::initModule(const std::string &moduleName) {
     ModuleHandle hModule = LoadModule(moduleName);
-    Assertion(hModule != NULL, "Failed to load module: %s", moduleName.c_str());
+    SPICA_CHECK(hModule != NULL, "Failed to load module: %s", moduleName.c_str());
 
     ObjectInitializer initializer = (ObjectInitializer)GetSymbol(hModule, "createInstance");
-    Assertion(initializer != NULL,
+    SPICA_CHECK(initializer != NULL,
         "The method \"createInstance\" is not defined for module: %s", moduleName.c_str());
     registerInitializer(moduleName, initializer);
 }
 
 void PluginManager::initAccelerator(const std::string &moduleName) {
     ModuleHandle hModule = LoadModule(moduleName);
-    Assertion(hModule != NULL, "Failed to load module: %s", moduleName.c_str());
+    SPICA_CHECK(hModule != NULL, "Failed to load module: %s", moduleName.c_str());
 
     AcceleratorInitializer initializer = (AcceleratorInitializer)GetSymbol(hModule, "createInstance");
-    Assertion(initializer != NULL,
+    SPICA_CHECK(initializer != NULL,
         "The method \"createInstance\" is not defined for module: %s", moduleName.c_str());
     registerInitializer(moduleName, initializer);
 }
@@ -59,7 +59,7 @@ void PluginManager::registerInitializer(const std::string &name, AcceleratorInit
 
 CObject *PluginManager::createObject(const std::string &name, RenderParams &params) const {
     auto it = initializers_.find(name);
-    Assertion(it != initializers_.cend(),
+    SPICA_CHECK(it != initializers_.cend(),
         "The method \"createInstance\" is not defined for module: %s", name.c_str());
 
     return (*it->second)(params);
@@ -69,7 +69,7 @@ Accelerator *PluginManager::createAccelerator(const std::string &name,
                                               const std::vector<std::shared_ptr<Primitive>> &primitives,
                                               RenderParams &params) const {
     auto it = accelInitializers_.find(name);
-    Assertion(it != accelInitializers_.cend(),
+    SPICA_CHECK(it != accelInitializers_.cend(),
         "The method \"createInstance\" is not defined for module: %s", name.c_str());
 
     return (*it->second)(primitives, params);
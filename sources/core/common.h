@@ -54,6 +54,19 @@ static const double INV_PI = 1.0 / PI;
 static const double INFTY = 1.0e32;
 static const double EPS = 1.0e-12;
 
+// ----------------------------------------------------------------------------
+// Floating point type for geometry, spectra, images and films
+// ----------------------------------------------------------------------------
+namespace spica {
+
+#ifdef SPICA_USE_FLOAT
+using Float = float;
+#else
+using Float = double;
+#endif
+
+}  // namespace spica
+
 // -----------------------------------------------------------------------------
 // Assertion with message
 // -----------------------------------------------------------------------------
@@ -66,9 +79,21 @@ static const double EPS = 1.0e-12;
     #endif
 #endif
 
-#undef NDEBUG
-#ifndef NDEBUG
-#define Assertion(PREDICATE, ...) \
+// Checks are tiered by SPICA_ASSERT_LEVEL:
+//   0 (off)      : only SPICA_CHECK, which validates user input.
+//   1 (cheap)    : SPICA_DCHECK (and "Assertion") for internal invariants.
+//   2 (paranoid) : SPICA_PARANOID_CHECK for numerical sanity in inner loops.
+// The level defaults to "off" when NDEBUG is defined and "cheap" otherwise.
+// CMake builds with SPICA_BUILD_TESTS default to "cheap" for the death tests.
+#ifndef SPICA_ASSERT_LEVEL
+#   ifdef NDEBUG
+#       define SPICA_ASSERT_LEVEL 0
+#   else
+#       define SPICA_ASSERT_LEVEL 1
+#   endif
+#endif
+
+#define SPICA_CHECK(PREDICATE, ...) \
 do { \
     if (!(PREDICATE)) { \
         std::cerr << "Asssertion \"" \
@@ -81,15 +106,25 @@ do { \
         std::abort(); \
     } \
 } while (false)
-#else  // NDEBUG
-#define Assertion(PREDICATE, ...) do {} while (false)
-#endif  // NDEBUG
+
+#if SPICA_ASSERT_LEVEL >= 1
+#define SPICA_DCHECK(PREDICATE, ...) SPICA_CHECK(PREDICATE, __VA_ARGS__)
+#else
+#define SPICA_DCHECK(PREDICATE, ...) do { (void)sizeof(PREDICATE); } while (false)
+#endif
+
+#if SPICA_ASSERT_LEVEL >= 2
+#define SPICA_PARANOID_CHECK(PREDICATE, ...) SPICA_CHECK(PREDICATE, __VA_ARGS__)
+#else
+#define SPICA_PARANOID_CHECK(PREDICATE, ...) do { (void)sizeof(PREDICATE); } while (false)
+#endif
+
+#define Assertion(PREDICATE, ...) SPICA_DCHECK(PREDICATE, __VA_ARGS__)
 
 // -----------------------------------------------------------------------------
 // Message handlers
 // -----------------------------------------------------------------------------
 
-#ifndef NDEBUG
 #define MsgInfo(...) \
 do { \
     std::cout << "[INFO] "; \
@@ -102,10 +137,6 @@ do { \
     fprintf(stderr, __VA_ARGS__); \
     std::cerr << std::endl; \
 } while (false);
-#else
-#define SpicaInfo(...)
-#define SpicaWarn(...)
-#endif
 #define FatalError(...) \
 do { \
     std::cerr << "[ERROR] "; \
@@ -5,6 +5,8 @@
 #ifndef _SPICA_CORE_HPP_
 #define _SPICA_CORE_HPP_
 
+#include "common.h"
+
 namespace spica {
 
 // Core module
@@ -15,6 +17,8 @@ class TriangleData;
 class Accelerator;
 class Primitive;
 class GeometricPrimitive;
+class TriangleMesh;
+struct HitRecord;
 
 class Distribution1D;
 class Distribution2D;
@@ -38,6 +42,7 @@ class Bounds3_;
 using Bounds3i = Bounds3_<int>;
 using Bounds3f = Bounds3_<float>;
 using Bounds3d = Bounds3_<double>;
+using Bounds3 = Bounds3_<Float>;
 
 // Image module
 class Image;
@@ -57,6 +62,7 @@ class Vector3_;
 using Vector3i = Vector3_<int>;
 using Vector3f = Vector3_<float>;
 using Vector3d = Vector3_<double>;
+using Vector3 = Vector3_<Float>;
 
 template <class T>
 class Point2_;
@@ -69,16 +75,20 @@ class Point3_;
 using Point3i = Point3_<int>;
 using Point3f = Point3_<float>;
 using Point3d = Point3_<double>;
+using Point3 = Point3_<Float>;
 
 template <class T>
 class Normal3_;
 using Normal3f = Normal3_<float>;
 using Normal3d = Normal3_<double>;
+using Normal3 = Normal3_<Float>;
 
 class Matrix4x4;
 class Transform;
 
 class Ray;
+class RayBatch;
+class HitBatch;
 
 }  // namespace spica
 
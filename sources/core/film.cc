@@ -1,10 +1,160 @@
 #define SPICA_API_EXPORT
 #include "film.h"
 
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <condition_variable>
+
 #include "core/tmo.h"
+#include "core/memory.h"
+#include "core/checkpoint.h"
 
 namespace spica {
 
+// -----------------------------------------------------------------------------
+// FilmTile method definitions
+// -----------------------------------------------------------------------------
+
+FilmTile::FilmTile(const std::shared_ptr<Filter> &filter, bool variance)
+    : filter_{ filter }
+    , bounds_{}
+    , pixels_{}
+    , variance_{ variance } {
+}
+
+void FilmTile::reset(const Bounds2i &bounds) {
+    bounds_ = bounds;
+    pixels_.assign(std::max(0, bounds.width() * bounds.height()), FilmTilePixel());
+}
+
+void FilmTile::addPixel(const Point2i& pixel, const Point2d& pInPixel,
+                        const Spectrum& color) {
+    const double dx = pInPixel.x() - 0.5;
+    const double dy = pInPixel.y() - 0.5;
+    const double weight = filter_->evaluate(Point2d(dx, dy));
+
+    FilmTilePixel &p = pixels_[pixelIndex(pixel.x(), pixel.y())];
+    p.contribSum      += weight * color;
+    p.filterWeightSum += weight;
+    p.samples         += 1;
+
+    if (!variance_) return;
+    const double lum = color.gray();
+    const double delta = lum - p.lumMean;
+    p.lumMean += delta / p.samples;
+    p.lumM2   += delta * (lum - p.lumMean);
+}
+
+// -----------------------------------------------------------------------------
+// Film method definitions
+// -----------------------------------------------------------------------------
+
+namespace {
+
+//! Header of the accumulation file, which is followed by the pixels.
+struct alignas(64) FilmFileHeader {
+    char magic[8];
+    int32_t width;
+    int32_t height;
+    int32_t pixelSize;
+    int32_t passes;  // Completed passes in the file, or -1 during a pass
+};
+
+const char kFilmFileMagic[8] = "SPFILM2";
+
+inline FilmFileHeader *fileHeader(const MappedFile &file) {
+    return static_cast<FilmFileHeader*>(file.data());
+}
+
+//! Lower bound of the luminance dividing the error, which keeps the
+//! relative error of almost black pixels from blowing up.
+const double kRelativeErrorFloor = 1.0e-3;
+
+}  // anonymous namespace
+
+/**
+ * Background thread which writes the saved images.
+ * @details
+ * The images are double-buffered. While one image is being written, the
+ * next one waits in the pending slot, and it is replaced if a newer image
+ * arrives before the writer takes it. Destroying the writer drops the
+ * pending image, since the film which writes it may be half destroyed.
+ */
+class Film::ImageWriter : Uncopyable {
+public:
+    explicit ImageWriter(const Film *film)
+        : film_{ film } {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~ImageWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            exit_ = true;
+        }
+        cond_.notify_all();
+        thread_.join();
+    }
+
+    void push(Image &&image, Image &&variance, int id) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (hasPending_) {
+                MsgInfo("Image %d is skipped since the writer is busy.", pendingId_);
+            }
+            pending_    = std::move(image);
+            pendingVariance_ = std::move(variance);
+            pendingId_  = id;
+            hasPending_ = true;
+        }
+        cond_.notify_all();
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return !hasPending_ && !writing_; });
+    }
+
+private:
+    void run() {
+        Image image, variance;
+        for (;;) {
+            int id;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]() { return hasPending_ || exit_; });
+                if (exit_) break;
+
+                image       = std::move(pending_);
+                variance    = std::move(pendingVariance_);
+                id          = pendingId_;
+                hasPending_ = false;
+                writing_    = true;
+            }
+
+            film_->writeImage(image, variance, id);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writing_ = false;
+            }
+            cond_.notify_all();
+        }
+    }
+
+    const Film *film_;
+    Image pending_;
+    Image pendingVariance_;
+    int pendingId_ = 0;
+    bool hasPending_ = false;
+    bool writing_ = false;
+    bool exit_ = false;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread thread_;
+};
+
 Film::Film(const Point2i& resolution,
            const std::shared_ptr<Filter> &filter,
            const std::string& filename,
@@ -12,54 +162,315 @@ Film::Film(const Point2i& resolution,
     : resolution_{ resolution }
     , filter_{ filter }
     , filename_{ filename }
-    , image_{ resolution.x(), resolution.y() }
-    , weights_{}
-    , saveCallback_{ callback } {
-    image_.fill(RGBSpectrum(0.0, 0.0, 0.0));
-    weights_.assign(resolution_.x(), std::vector<double>(resolution_.y(), 0.0));
-    samples_.assign(resolution_.x(), std::vector<int>(resolution_.y(), 0));
+    , storage_{ std::make_unique<FilmPixel[]>(resolution.x() * resolution.y()) }
+    , saveCallback_{ callback }
+    , lastSave_{ std::chrono::steady_clock::now() } {
+    pixels_ = storage_.get();
+}
+
+Film::~Film() {
 }
 
 void Film::save(int id) const {
-    Image res = image_;
-    for (int y = 0; y < image_.height(); y++) {
-        for (int x = 0; x < image_.width(); x++) {
-            res.pixel(x, y) /= (weights_[x][y] + EPS);
+    if (mapped_) {
+        saveStreamed(1.0, false, id);
+        return;
+    }
+
+    if (!writer_) writer_ = std::make_unique<ImageWriter>(this);
+    writer_->push(develop(1.0, false), developVariance(), id);
+}
+
+void Film::saveMLT(double scale, int id) const {
+    if (mapped_) {
+        saveStreamed(scale, true, id);
+        return;
+    }
+
+    if (!writer_) writer_ = std::make_unique<ImageWriter>(this);
+    writer_->push(develop(scale, true), developVariance(), id);
+}
+
+void Film::setAccumulationFile(const std::string &filename, bool resume) {
+    const int numPixels = resolution_.x() * resolution_.y();
+    const size_t size = sizeof(FilmFileHeader) + sizeof(FilmPixel) * numPixels;
+    auto mapped = std::make_unique<MappedFile>(filename, size, resume);
+
+    auto *header = fileHeader(*mapped);
+    auto *pixels = reinterpret_cast<FilmPixel*>(header + 1);
+    const bool resumed = mapped->reused() &&
+                         std::memcmp(header->magic, kFilmFileMagic, sizeof(kFilmFileMagic)) == 0 &&
+                         header->width == resolution_.x() &&
+                         header->height == resolution_.y() &&
+                         header->pixelSize == static_cast<int32_t>(sizeof(FilmPixel));
+    if (resumed) {
+        MsgInfo("Resume accumulation from: %s", filename.c_str());
+    } else {
+        // A newly created file is filled with zeros, which already is an
+        // empty pixel. Only a file of another film has to be cleared.
+        if (mapped->reused()) {
+            for (int i = 0; i < numPixels; i++) {
+                new (&pixels[i]) FilmPixel();
+            }
         }
+        std::memcpy(header->magic, kFilmFileMagic, sizeof(kFilmFileMagic));
+        header->width     = resolution_.x();
+        header->height    = resolution_.y();
+        header->pixelSize = static_cast<int32_t>(sizeof(FilmPixel));
+        header->passes    = 0;
     }
 
+    pixels_ = pixels;
+    storage_.reset();
+    mapped_ = std::move(mapped);
+}
+
+void Film::setSaveInterval(int passes, double seconds) {
+    savePasses_  = std::max(0, passes);
+    saveSeconds_ = std::max(0.0, seconds);
+}
+
+bool Film::saveDue(int pass, bool final) {
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - lastSave_).count();
+
+    bool due = final;
+    if (savePasses_ > 0 && pass % savePasses_ == 0) due = true;
+    if (saveSeconds_ > 0.0 && elapsed >= saveSeconds_) due = true;
+    if (due) lastSave_ = now;
+    return due;
+}
+
+void Film::flush() const {
+    if (writer_) writer_->flush();
+}
+
+void Film::close() const {
+    flush();
+    writer_.reset();
+}
+
+void Film::beginPass(int pass) {
+    if (!mapped_) return;
+
+    FilmFileHeader *header = fileHeader(*mapped_);
+    if (header->passes != pass) {
+        throw RuntimeException("Accumulation file holds %d passes before the pass %d!!",
+                               header->passes, pass);
+    }
+    header->passes = -1;
+}
+
+void Film::endPass(int passes) {
+    if (!mapped_) return;
+    fileHeader(*mapped_)->passes = passes;
+}
+
+void Film::saveState(CheckpointWriter &writer) const {
+    const int width  = resolution_.x();
+    const int height = resolution_.y();
+    const int32_t mapped = mapped_ ? 1 : 0;
+    const int32_t variance = hasVariance() ? 1 : 0;
+    writer.write(width);
+    writer.write(height);
+    writer.write(mapped);
+    writer.write(variance);
+    if (variance) {
+        writer.write(variance_.data(), variance_.size());
+    }
+
+    if (mapped_) {
+        mapped_->sync();
+        writer.write(fileHeader(*mapped_)->passes);
+        return;
+    }
+
+    std::vector<Float> sums(width * 7);
+    std::vector<int> samples(width);
+    for (int y = 0; y < height; y++) {
+        const FilmPixel *row = &pixels_[y * width];
+        for (int x = 0; x < width; x++) {
+            const FilmPixel &p = row[x];
+            for (int ch = 0; ch < 3; ch++) {
+                sums[x * 7 + ch]     = p.contribSum[ch];
+                sums[x * 7 + ch + 4] = static_cast<Float>(p.splatSum[ch]);
+            }
+            sums[x * 7 + 3] = p.filterWeightSum;
+            samples[x] = p.samples;
+        }
+        writer.write(sums.data(), sums.size());
+        writer.write(samples.data(), samples.size());
+    }
+}
+
+void Film::loadState(CheckpointReader &reader) {
+    int width, height;
+    int32_t mapped, variance;
+    reader.read(&width);
+    reader.read(&height);
+    reader.read(&mapped);
+    reader.read(&variance);
+    if (width != resolution_.x() || height != resolution_.y()) {
+        throw RuntimeException("Checkpoint is for the film of %dx%d!!", width, height);
+    }
+
+    if (variance) {
+        enableVariance();
+        reader.read(variance_.data(), variance_.size());
+    } else if (saveVariance_) {
+        enableVariance();
+    } else {
+        variance_.clear();
+    }
+
+    if (mapped) {
+        if (!mapped_) {
+            throw RuntimeException("Checkpoint needs the accumulation file of the film!!");
+        }
+
+        // Samples added after the checkpoint would be counted twice.
+        int32_t passes;
+        reader.read(&passes);
+        if (fileHeader(*mapped_)->passes != passes) {
+            throw RuntimeException("Accumulation file does not hold the %d passes of the checkpoint!!",
+                                   passes);
+        }
+        return;
+    }
+
+    std::vector<Float> sums(width * 7);
+    std::vector<int> samples(width);
+    for (int y = 0; y < height; y++) {
+        reader.read(sums.data(), sums.size());
+        reader.read(samples.data(), samples.size());
+        FilmPixel *row = &pixels_[y * width];
+        for (int x = 0; x < width; x++) {
+            FilmPixel &p = row[x];
+            for (int ch = 0; ch < 3; ch++) {
+                p.contribSum[ch] = sums[x * 7 + ch];
+                p.splatSum[ch]   = sums[x * 7 + ch + 4];
+            }
+            p.filterWeightSum = sums[x * 7 + 3];
+            p.samples = samples[x];
+        }
+    }
+}
+
+void Film::enableVariance() {
+    variance_.assign(resolution_.x() * resolution_.y(), PixelVariance());
+}
+
+double Film::relativeError(const Point2i &pixel) const {
+    if (!hasVariance()) return INFTY;
+
+    const PixelVariance &v = variance_[pixel.y() * resolution_.x() + pixel.x()];
+    if (v.samples < 2) return INFTY;
+
+    const double stdError = std::sqrt(v.m2 / ((v.samples - 1.0) * v.samples));
+    return stdError / std::max(v.mean, kRelativeErrorFloor);
+}
+
+void Film::setSaveVariance(bool enable) {
+    saveVariance_ = enable;
+    if (enable && !hasVariance()) {
+        enableVariance();
+    }
+}
+
+Image Film::developVariance() const {
+    if (!saveVariance_ || !hasVariance()) return Image();
+
+    Image res(resolution_.x(), resolution_.y());
+    for (int y = 0; y < resolution_.y(); y++) {
+        for (int x = 0; x < resolution_.x(); x++) {
+            const PixelVariance &v = variance_[y * resolution_.x() + x];
+            const double var = v.samples < 2 ? 0.0 : v.m2 / ((v.samples - 1.0) * v.samples);
+            res.pixel(x, y) = RGBSpectrum(var, var, var);
+        }
+    }
+    return res;
+}
+
+void Film::writeVariance(const Image &variance, const char *savefile) const {
+    const std::string outfile = std::string(savefile) + "_variance.hdr";
+    variance.save(outfile);
+    MsgInfo("Save: %s", outfile.c_str());
+}
+
+Image Film::develop(double scale, bool scaleBySamples) const {
+    Image res(resolution_.x(), resolution_.y());
+    for (int y = 0; y < resolution_.y(); y++) {
+        developRow(y, scale, scaleBySamples, &res.pixel(0, y));
+    }
+    return res;
+}
+
+void Film::developRow(int y, double scale, bool scaleBySamples,
+                      RGBSpectrum *out) const {
+    const FilmPixel *row = &pixels_[y * resolution_.x()];
+    for (int x = 0; x < resolution_.x(); x++) {
+        const FilmPixel &p = row[x];
+        const double ns = scaleBySamples ? p.samples : 1;
+        const double invWeight = scale * ns / (p.filterWeightSum + EPS);
+        out[x] = RGBSpectrum(
+            p.contribSum[0] * invWeight + scale * static_cast<Float>(p.splatSum[0]),
+            p.contribSum[1] * invWeight + scale * static_cast<Float>(p.splatSum[1]),
+            p.contribSum[2] * invWeight + scale * static_cast<Float>(p.splatSum[2]));
+    }
+}
+
+void Film::saveStreamed(double scale, bool scaleBySamples, int id) const {
+    // Keep the accumulation file consistent for resuming the render
+    mapped_->sync();
+
     char savefile[512];
     const char* format = filename_.c_str();
     sprintf(savefile, format, id);
+    saveScanlines(savefile, [&](int y, RGBSpectrum *row) {
+        developRow(y, scale, scaleBySamples, row);
+    });
 
-    saveImage(savefile, res);
-
-    if (saveCallback_) {
-        (*saveCallback_)(res);
+    if (saveVariance_) {
+        writeVariance(developVariance(), savefile);
     }
 }
 
-void Film::saveMLT(double scale, int id) const {
-    Image res = image_;
-    for (int y = 0; y < image_.height(); y++) {
-        for (int x = 0; x < image_.width(); x++) {
-            res.pixel(x, y) *= scale * samples_[x][y] / (weights_[x][y] + EPS);
-        }
+void Film::saveScanlines(const std::string &filename,
+                         const std::function<void(int, RGBSpectrum*)> &developRow) const {
+    Image image(resolution_.x(), resolution_.y());
+    for (int y = 0; y < resolution_.y(); y++) {
+        developRow(y, &image.pixel(0, y));
     }
+    saveImage(filename, image);
+}
 
+void Film::writeImage(const Image &image, const Image &variance, int id) const {
     char savefile[512];
     const char* format = filename_.c_str();
     sprintf(savefile, format, id);
-    saveImage(savefile, res);
+    saveImage(savefile, image);
+    if (variance.width() > 0) {
+        writeVariance(variance, savefile);
+    }
 
     if (saveCallback_) {
-        (*saveCallback_)(res);
+        (*saveCallback_)(image);
     }
 }
 
 void Film::setImage(const Image& image) {
-    this->image_ = image;
-    weights_.assign(resolution_.x(), std::vector<double>(resolution_.y(), 1.0));
+    for (int y = 0; y < resolution_.y(); y++) {
+        for (int x = 0; x < resolution_.x(); x++) {
+            const RGBSpectrum &c = image(x, y);
+            FilmPixel &p = filmPixel(x, y);
+            for (int ch = 0; ch < 3; ch++) {
+                p.contribSum[ch] = c[ch];
+                p.splatSum[ch]   = 0;
+            }
+            p.filterWeightSum = 1;
+            p.samples = 0;
+        }
+    }
 }
 
 void Film::addPixel(const Point2i& pixel, const Point2d& pInPixel, 
@@ -68,9 +479,51 @@ void Film::addPixel(const Point2i& pixel, const Point2d& pInPixel,
     const double dy = pInPixel.y() - 0.5;
     const double weight = filter_->evaluate(Point2d(dx, dy));
 
-    image_.pixel(pixel.x(), pixel.y()) += weight * color;
-    weights_[pixel.x()][pixel.y()]     += weight;
-    samples_[pixel.x()][pixel.y()]     += 1;
+    FilmPixel &p = filmPixel(pixel.x(), pixel.y());
+    for (int ch = 0; ch < 3; ch++) {
+        p.contribSum[ch] += weight * color[ch];
+    }
+    p.filterWeightSum += weight;
+    p.samples         += 1;
+
+    if (hasVariance()) {
+        PixelVariance &v = variance_[pixel.y() * resolution_.x() + pixel.x()];
+        const double lum = color.gray();
+        const double delta = lum - v.mean;
+        v.samples += 1;
+        v.mean    += delta / v.samples;
+        v.m2      += delta * (lum - v.mean);
+    }
+}
+
+std::unique_ptr<FilmTile> Film::filmTile() const {
+    return std::make_unique<FilmTile>(filter_, hasVariance());
+}
+
+void Film::mergeFilmTile(const FilmTile &tile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Bounds2i &b = tile.bounds();
+    for (int y = b.posMin().y(); y < b.posMax().y(); y++) {
+        for (int x = b.posMin().x(); x < b.posMax().x(); x++) {
+            const FilmTile::FilmTilePixel &tp = tile.pixels_[tile.pixelIndex(x, y)];
+            FilmPixel &p = filmPixel(x, y);
+            for (int ch = 0; ch < 3; ch++) {
+                p.contribSum[ch] += tp.contribSum[ch];
+            }
+            p.filterWeightSum += tp.filterWeightSum;
+            p.samples         += tp.samples;
+
+            // Combine the running statistics (Chan et al.)
+            if (tile.variance() && hasVariance() && tp.samples > 0) {
+                PixelVariance &v = variance_[y * resolution_.x() + x];
+                const int n = v.samples + tp.samples;
+                const double delta = tp.lumMean - v.mean;
+                v.m2   += tp.lumM2 + delta * delta * v.samples * tp.samples / n;
+                v.mean += delta * tp.samples / n;
+                v.samples = n;
+            }
+        }
+    }
 }
 
 void Film::addPixel(const Point2d& pixel, const Spectrum& color) {
@@ -79,4 +532,15 @@ void Film::addPixel(const Point2d& pixel, const Spectrum& color) {
     addPixel(p, pd, color);
 }
 
+void Film::addSplat(const Point2d& pixel, const Spectrum& color) {
+    const int x = static_cast<int>(pixel.x());
+    const int y = static_cast<int>(pixel.y());
+    if (x < 0 || y < 0 || x >= resolution_.x() || y >= resolution_.y()) return;
+
+    FilmPixel &p = filmPixel(x, y);
+    for (int ch = 0; ch < 3; ch++) {
+        p.splatSum[ch].add(color[ch]);
+    }
+}
+
 }  // namespace spica
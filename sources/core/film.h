@@ -8,18 +8,76 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <chrono>
 #include <functional>
 
 #include "core/core.hpp"
 #include "core/common.h"
 #include "core/uncopyable.h"
 #include "core/point2d.h"
+#include "core/bounds2d.h"
 #include "core/image.h"
 #include "core/filter.h"
 #include "core/cobject.h"
+#include "core/parallel.h"
 
 namespace spica {
 
+class MappedFile;
+class CheckpointWriter;
+class CheckpointReader;
+
+/**
+ * Accumulation buffer for a rectangular region of the film.
+ * @details
+ * Each rendering thread accumulates its samples into its own tile, and the
+ * tile is merged into the film with Film::mergeFilmTile when it is finished.
+ * The storage is reused when the tile is reset to another region. The
+ * running statistics of the luminance are only updated when "variance" is
+ * true, i.e., the film estimates the variance.
+ */
+class SPICA_EXPORTS FilmTile : Uncopyable {
+public:
+    // Public methods
+    explicit FilmTile(const std::shared_ptr<Filter> &filter, bool variance = false);
+    ~FilmTile() = default;
+
+    /**
+     * Reset the tile to the region [posMin, posMax) and clear its pixels.
+     */
+    void reset(const Bounds2i &bounds);
+
+    void addPixel(const Point2i& pixel, const Point2d& pInPixel,
+                  const Spectrum& color);
+
+    inline const Bounds2i &bounds() const { return bounds_; }
+    inline bool variance() const { return variance_; }
+
+private:
+    // Private methods
+    struct FilmTilePixel {
+        Spectrum contribSum = Spectrum(0.0);
+        double filterWeightSum = 0.0;
+        int samples = 0;
+        double lumMean = 0.0;  //!< Running mean of the sample luminance
+        double lumM2 = 0.0;    //!< Running sum of squared deviations
+    };
+
+    inline int pixelIndex(int x, int y) const {
+        return (y - bounds_.posMin().y()) * bounds_.width() + (x - bounds_.posMin().x());
+    }
+
+    // Private fields
+    std::shared_ptr<Filter> filter_;
+    Bounds2i bounds_;
+    std::vector<FilmTilePixel> pixels_;
+    bool variance_;
+
+    friend class Film;
+
+};  // class FilmTile
+
 class SPICA_EXPORTS Film : public CObject, Uncopyable {
 public:
     // Public methods
@@ -28,7 +86,7 @@ public:
          const std::string& filename,
          const std::shared_ptr<std::function<void(const Image&)>> &callback = nullptr);
 
-    ~Film() = default;
+    virtual ~Film();
 
     inline Point2i resolution() const { return resolution_; }
     inline double aspect() const {
@@ -38,15 +96,20 @@ public:
     /**
      * Save the result by dividing sum(w * I) by sum(w).
      * This method is typically used for SamplerIntegrator, which take the same
-     * number of samples for each pixel.
+     * number of samples for each pixel. Splats are added as they are.
+     * @details
+     * The image is developed on the calling thread, and is written by a
+     * background thread. When the writer falls behind, the image waiting to
+     * be written is replaced by the new one.
      *
      * @param[in] id: The ID used for naming the image file.
      */
     void save(int id = 0) const;
 
     /**
-     * Save the result by computing, (sum(w * I) * ns / (sum(w)), where ns is
-     * number of samples generated for a pixel.
+     * Save the result by computing, scale * (sum(w * I) * ns / sum(w) + S),
+     * where ns is number of samples generated for a pixel, and S is the sum
+     * of splats.
      * This method is typically used for MLT-like algorithms, which take
      * different number of samples for each pixel.
      *
@@ -54,15 +117,143 @@ public:
      */
     void saveMLT(double scale, int id = 0) const;
 
+    /**
+     * Set how often the progress is saved. Zero disables the criterion.
+     *
+     * @param[in] passes: Save every "passes" passes.
+     * @param[in] seconds: Save when "seconds" have elapsed since the last save.
+     */
+    void setSaveInterval(int passes, double seconds);
+
+    /**
+     * Check if the image after the pass should be saved according to the
+     * save interval. The final pass is always saved.
+     */
+    bool saveDue(int pass, bool final);
+
+    /**
+     * Wait until all the saved images are written.
+     */
+    void flush() const;
+
+    /**
+     * Write the saved images and stop the background writer. The owner
+     * calls it when the rendering ends, and derived films call it in their
+     * destructors, because the writer calls "saveImage". The images still
+     * pending when the film is destroyed without "close" are dropped.
+     * Saving after "close" starts a new writer.
+     */
+    void close() const;
+
+    /**
+     * Place the accumulation buffer in a memory-mapped file.
+     * @details
+     * Only the pages of the pixels in use are kept in memory, which allows
+     * resolutions whose buffer does not fit in the physical memory. Saving
+     * the film then develops and writes the image one scanline at a time
+     * on the calling thread, and the save callback is not called. The file
+     * is truncated unless "resume" is true, in which case the samples of a
+     * film of the same resolution are kept to be resumed by the checkpoint.
+     */
+    void setAccumulationFile(const std::string &filename, bool resume = false);
+
+    /**
+     * Mark the start and the end of a pass.
+     * @details
+     * The header of the accumulation file records the number of the passes
+     * whose samples it holds, and a pass in progress is marked as such, so
+     * that the file is resumed only by the checkpoint of the same passes.
+     * "beginPass" throws if the file holds other passes than "pass". They
+     * do nothing unless the buffer is memory-mapped.
+     */
+    void beginPass(int pass);
+    void endPass(int passes);
+
+    /**
+     * Write the accumulated samples to the checkpoint. A memory-mapped
+     * buffer is only synchronized with its file, which keeps the samples,
+     * and the number of its passes is written instead.
+     */
+    void saveState(CheckpointWriter &writer) const;
+
+    /**
+     * Restore the accumulated samples written by "saveState". It throws if
+     * the accumulation file does not hold the passes of the checkpoint.
+     */
+    void loadState(CheckpointReader &reader);
+
+    //! Whether the accumulation buffer is memory-mapped.
+    inline bool mapped() const { return mapped_ != nullptr; }
+
+    /**
+     * Start estimating the variance of the pixels.
+     * @details
+     * The running mean and variance of the sample luminance are updated with
+     * Welford's algorithm when samples are added or tiles are merged. The
+     * estimate is kept in memory even when the accumulation buffer is
+     * memory-mapped. Samples added before this call are not taken into
+     * account.
+     */
+    void enableVariance();
+
+    inline bool hasVariance() const { return !variance_.empty(); }
+
+    /**
+     * Save the variance of the pixels as an AOV together with the image.
+     * The variance of the mean luminance of each pixel is written to the
+     * HDR image named with the suffix "_variance".
+     */
+    void setSaveVariance(bool enable);
+
+    //! Number of the samples added to the pixel.
+    inline int samples(const Point2i &pixel) const {
+        return pixels_[pixel.y() * resolution_.x() + pixel.x()].samples;
+    }
+
+    /**
+     * Relative standard error of the pixel value, i.e., the standard error
+     * of the mean luminance divided by the mean. INFTY is returned while the
+     * pixel has less than two samples or the variance is not estimated.
+     */
+    double relativeError(const Point2i &pixel) const;
+
     void setImage(const Image& image);
+
+    /**
+     * Add the sample to the pixel.
+     * Samples for the same pixel must not be added from multiple threads.
+     */
     void addPixel(const Point2i& pixel, const Point2d& pInPixel,
                   const Spectrum& color);
     void addPixel(const Point2d& pixel, const Spectrum& color);
 
+    /**
+     * Add the sample to the pixel at the continuous film position.
+     * @details
+     * Splats are accumulated with atomic operations separately from
+     * "addPixel", so that MLT chains and the light tracing strategies of
+     * BDPT can splat to any pixel from multiple threads without locking.
+     * Splats are not weighted by the filter.
+     */
+    void addSplat(const Point2d& pixel, const Spectrum& color);
+
+    /**
+     * Create an empty tile which accumulates samples with the film's filter.
+     * The tile tracks the variance if the film estimates it at this point.
+     */
+    std::unique_ptr<FilmTile> filmTile() const;
+
+    /**
+     * Add the samples accumulated in the tile to the film.
+     * This method can be called from multiple threads at the same time.
+     */
+    void mergeFilmTile(const FilmTile &tile);
+
     inline void setFilename(const std::string filename) {
         this->filename_ = filename;
     }
 
+    //! The callback is called from the writer thread.
     inline void setSaveCallback(std::unique_ptr<std::function<void(const Image&)>>&& callback) {
         this->saveCallback_ = std::move(callback);
     }
@@ -73,15 +264,73 @@ public:
 
     virtual void saveImage(const std::string &filename,  const Image &image) const = 0;
 
+protected:
+    /**
+     * Save the image given one scanline at a time by "developRow", which is
+     * used when the accumulation buffer is memory-mapped. The default
+     * implementation develops the whole image and calls "saveImage".
+     */
+    virtual void saveScanlines(const std::string &filename,
+                               const std::function<void(int, RGBSpectrum*)> &developRow) const;
+
 private:
+    // Private methods
+#ifdef SPICA_USE_FLOAT
+    using AtomicAccum = AtomicFloat;
+#else
+    using AtomicAccum = AtomicDouble;
+#endif
+
+    /**
+     * Accumulated values of a pixel.
+     * A pixel fills a 64-byte cache line when "Float" is double, and half
+     * of it when "Float" is float.
+     */
+    struct alignas(8 * sizeof(Float)) FilmPixel {
+        Float contribSum[3] = { 0, 0, 0 };
+        Float filterWeightSum = 0;
+        AtomicAccum splatSum[3];
+        int samples = 0;
+    };
+    static_assert(sizeof(FilmPixel) == 8 * sizeof(Float),
+                  "FilmPixel must fill its alignment!!");
+
+    //! Running statistics of the sample luminance of a pixel.
+    struct PixelVariance {
+        double mean = 0.0;
+        double m2 = 0.0;
+        int samples = 0;
+    };
+
+    inline FilmPixel &filmPixel(int x, int y) {
+        return pixels_[y * resolution_.x() + x];
+    }
+
+    Image develop(double scale, bool scaleBySamples) const;
+    void developRow(int y, double scale, bool scaleBySamples, RGBSpectrum *out) const;
+    Image developVariance() const;
+    void writeImage(const Image &image, const Image &variance, int id) const;
+    void writeVariance(const Image &variance, const char *savefile) const;
+    void saveStreamed(double scale, bool scaleBySamples, int id) const;
+
+    class ImageWriter;
+
     // Private fields
     Point2i resolution_;
     std::shared_ptr<Filter> filter_;
     std::string filename_;
-    Image image_;
-    std::vector<std::vector<double>> weights_;
-    std::vector<std::vector<int>> samples_;
+    FilmPixel *pixels_ = nullptr;
+    std::unique_ptr<FilmPixel[]> storage_;
+    std::unique_ptr<MappedFile> mapped_;
+    std::vector<PixelVariance> variance_;
+    bool saveVariance_ = false;
     std::shared_ptr<std::function<void(const Image&)>> saveCallback_;
+    std::mutex mutex_;
+
+    int savePasses_ = 1;
+    double saveSeconds_ = 0.0;
+    std::chrono::steady_clock::time_point lastSave_;
+    mutable std::unique_ptr<ImageWriter> writer_;
 
 };  // class Film
 
@@ -1,47 +1,109 @@
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef _SPICA_FLOAT_H_
-#define _SPICA_FLOAT_H_
-
-#include <cmath>
-#include <cstring>
-
-inline decltype(auto) floatToBits(double d) {
-    unsigned long long ret;
-    memcpy(&ret, &d, sizeof(double));
-    return ret;
-}
-
-inline decltype(auto) bitsToFloat(unsigned long long bits) {
-    double ret;
-    memcpy(&ret, &bits, sizeof(double));
-    return ret;
-}
-
-inline decltype(auto) nextFloatUp(double d) {
-    if (std::isinf(d) && d > 0.0) return d;
-    if (d == -0.0f) d = 0.0f;
-    auto ui = floatToBits(d);
-    if (d > 0.0) {
-        ui++;
-    } else {
-        ui--;
-    }
-    return bitsToFloat(ui);
-}
-
-inline decltype(auto) nextFloatDown(double d) {
-    if (std::isinf(d) && d > 0.0) return d;
-    if (d == -0.0f) d = 0.0f;
-    auto ui = floatToBits(d);
-    if (d > 0.0) {
-        ui--;
-    } else {
-        ui++;
-    }
-    return bitsToFloat(ui);    
-}
-
-#endif  // _SPICA_FLOAT_H_
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_FLOAT_H_
+#define _SPICA_FLOAT_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "common.h"
+
+inline decltype(auto) floatToBits(double d) {
+    unsigned long long ret;
+    memcpy(&ret, &d, sizeof(double));
+    return ret;
+}
+
+inline decltype(auto) floatToBits(float f) {
+    uint32_t ret;
+    memcpy(&ret, &f, sizeof(float));
+    return ret;
+}
+
+inline decltype(auto) bitsToFloat(unsigned long long bits) {
+    double ret;
+    memcpy(&ret, &bits, sizeof(double));
+    return ret;
+}
+
+inline decltype(auto) bitsToFloat(uint32_t bits) {
+    float ret;
+    memcpy(&ret, &bits, sizeof(float));
+    return ret;
+}
+
+/**
+ * The next floating point number toward +inf. Both of the zeros step to the
+ * smallest positive denormal.
+ */
+inline decltype(auto) nextFloatUp(double d) {
+    if (std::isinf(d) && d > 0.0) return d;
+    if (d == -0.0) d = 0.0;
+    auto ui = floatToBits(d);
+    if (d >= 0.0) {
+        ui++;
+    } else {
+        ui--;
+    }
+    return bitsToFloat(ui);
+}
+
+inline decltype(auto) nextFloatUp(float f) {
+    if (std::isinf(f) && f > 0.0f) return f;
+    if (f == -0.0f) f = 0.0f;
+    auto ui = floatToBits(f);
+    if (f >= 0.0f) {
+        ui++;
+    } else {
+        ui--;
+    }
+    return bitsToFloat(ui);
+}
+
+/**
+ * The next floating point number toward -inf. Both of the zeros step to the
+ * largest negative denormal.
+ */
+inline decltype(auto) nextFloatDown(double d) {
+    if (std::isinf(d) && d < 0.0) return d;
+    if (d == 0.0) d = -0.0;
+    auto ui = floatToBits(d);
+    if (d > 0.0) {
+        ui--;
+    } else {
+        ui++;
+    }
+    return bitsToFloat(ui);
+}
+
+inline decltype(auto) nextFloatDown(float f) {
+    if (std::isinf(f) && f < 0.0f) return f;
+    if (f == 0.0f) f = -0.0f;
+    auto ui = floatToBits(f);
+    if (f > 0.0f) {
+        ui--;
+    } else {
+        ui++;
+    }
+    return bitsToFloat(ui);
+}
+
+namespace spica {
+
+/**
+ * Error bound of "n" successive floating point operations in "T",
+ * i.e., gamma(n) in "Physically Based Rendering".
+ */
+template <class T = Float>
+inline constexpr T gamma(int n) {
+    constexpr T machineEps = std::numeric_limits<T>::epsilon() * static_cast<T>(0.5);
+    return (n * machineEps) / (1 - n * machineEps);
+}
+
+}  // namespace spica
+
+#endif  // _SPICA_FLOAT_H_
@@ -23,15 +23,15 @@ public:
     void construct(std::vector<T>& points, const int imageW = -1, const int imageH = -1);
 
     //! Initialize grid
-    void init(const int hashSize, const double hashScale, const Bounds3d& bbox);
+    void init(const int hashSize, const double hashScale, const Bounds3& bbox);
 
     //! Set point data for the cells inside the specifed bounding box
-    void add(const T& p, const Point3d& boxMin, const Point3d& boxMax);
+    void add(const T& p, const Point3& boxMin, const Point3& boxMax);
 
     //! Clear grid data
     void clear();
 
-    const std::vector<T>& operator[](const Point3d& v) const;
+    const std::vector<T>& operator[](const Point3& v) const;
 
 private:
     // Private methods
@@ -39,7 +39,7 @@ private:
 
     // Private fields
     int _hashSize;
-    Bounds3d _bbox;
+    Bounds3 _bbox;
     double _hashScale;
     std::vector<std::vector<T> > _data;
 
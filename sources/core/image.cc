@@ -107,7 +107,7 @@ Image::Image() {
 Image::Image(int width, int height)
     : width_{width}
     , height_{height} {
-    Assertion(width >= 0 && height >= 0, "Image size must be positive");
+    SPICA_CHECK(width >= 0 && height >= 0, "Image size must be positive");
     pixels_ = std::make_unique<RGBSpectrum[]>(width_ * height_);
 }
 
@@ -388,50 +388,10 @@ void Image::loadHdr(const std::string& filename) {
 }
 
 void Image::saveHdr(const std::string& filename) const {
-    std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary);
-    if (!ofs.is_open()) {
-        throw RuntimeException("Failed to open file: %s", filename.c_str());
-    }
-
-    char buffer[256];
-    unsigned char ret = 0x0a;
-    sprintf(buffer, "#?RADIANCE%c", ret);
-    ofs.write(buffer, strlen(buffer));
-    sprintf(buffer, "# Made with 100%% pure HDR Shop%c", ret);
-    ofs.write(buffer, strlen(buffer));
-    sprintf(buffer, "FORMAT=32-bit_rle_rgbe%c", ret);
-    ofs.write(buffer, strlen(buffer));
-    sprintf(buffer, "EXPOSURE=1.0000000000000%c%c", ret, ret);
-    ofs.write(buffer, strlen(buffer));
-
-    sprintf(buffer, "-Y %u +X %u%c", height_, width_, ret);
-    ofs.write(buffer, strlen(buffer));
-
-    std::vector<unsigned char> pixbuf;
+    HdrScanlineWriter writer(filename, width_, height_);
     for (int i = 0; i < height_; i++) {
-        std::vector<HDRPixel> line;
-        for (int j = 0; j < width_; j++) {
-            RGBSpectrum color = this->operator()(j, i);
-            line.push_back(HDRPixel(color));
-        }
-        pixbuf.push_back(0x02);
-        pixbuf.push_back(0x02);
-        pixbuf.push_back((width_ >> 8) & 0xff);
-        pixbuf.push_back(width_ & 0xff);
-        for (int c = 0; c < 4; c++) {
-            for (unsigned int cursor = 0; cursor < width_;) {
-                const int cursor_move = std::min((unsigned int)127, width_ - cursor);
-                pixbuf.push_back(cursor_move);
-                for (int j = cursor; j < cursor + cursor_move; j++) {
-                    pixbuf.push_back(line[j].get(c));
-                }
-                cursor += cursor_move;
-            }
-        }
+        writer.writeScanline(&pixels_[i * width_]);
     }
-    ofs.write((char*)&pixbuf[0], pixbuf.size());
-
-    ofs.close();
 }
 
 void Image::loadPng(const std::string& filename) {
@@ -479,4 +439,54 @@ uint8_t Image::toByte(double d) {
     return static_cast<uint8_t>(255.0 * d);
 }
 
+HdrScanlineWriter::HdrScanlineWriter(const std::string& filename, int width, int height)
+    : ofs_{ filename.c_str(), std::ios::out | std::ios::binary }
+    , width_{ width }
+    , height_{ height } {
+    if (!ofs_.is_open()) {
+        throw RuntimeException("Failed to open file: %s", filename.c_str());
+    }
+
+    char buffer[256];
+    unsigned char ret = 0x0a;
+    sprintf(buffer, "#?RADIANCE%c", ret);
+    ofs_.write(buffer, strlen(buffer));
+    sprintf(buffer, "# Made with 100%% pure HDR Shop%c", ret);
+    ofs_.write(buffer, strlen(buffer));
+    sprintf(buffer, "FORMAT=32-bit_rle_rgbe%c", ret);
+    ofs_.write(buffer, strlen(buffer));
+    sprintf(buffer, "EXPOSURE=1.0000000000000%c%c", ret, ret);
+    ofs_.write(buffer, strlen(buffer));
+
+    sprintf(buffer, "-Y %u +X %u%c", height_, width_, ret);
+    ofs_.write(buffer, strlen(buffer));
+}
+
+void HdrScanlineWriter::writeScanline(const RGBSpectrum* line) {
+    Assertion(written_ < height_, "Too many scanlines are written!!");
+
+    std::vector<HDRPixel> pixels(width_);
+    for (int j = 0; j < width_; j++) {
+        pixels[j] = HDRPixel(line[j]);
+    }
+
+    buffer_.clear();
+    buffer_.push_back(0x02);
+    buffer_.push_back(0x02);
+    buffer_.push_back((width_ >> 8) & 0xff);
+    buffer_.push_back(width_ & 0xff);
+    for (int c = 0; c < 4; c++) {
+        for (int cursor = 0; cursor < width_;) {
+            const int cursor_move = std::min(127, width_ - cursor);
+            buffer_.push_back(cursor_move);
+            for (int j = cursor; j < cursor + cursor_move; j++) {
+                buffer_.push_back(pixels[j].get(c));
+            }
+            cursor += cursor_move;
+        }
+    }
+    ofs_.write((char*)&buffer_[0], buffer_.size());
+    written_++;
+}
+
 }  // namespace spica
@@ -7,6 +7,8 @@
 
 #include <string>
 #include <memory>
+#include <fstream>
+#include <vector>
 
 #include "spectrum.h"
 
@@ -70,6 +72,26 @@ private:
     std::unique_ptr<RGBSpectrum[]> pixels_ = nullptr;
 };
 
+/**
+ * Radiance HDR writer which takes the image one scanline at a time.
+ * @details
+ * Scanlines are written from the top, so that the whole image never has
+ * to be kept in memory.
+ */
+class SPICA_EXPORTS HdrScanlineWriter {
+public:
+    HdrScanlineWriter(const std::string& filename, int width, int height);
+
+    void writeScanline(const RGBSpectrum* line);
+
+private:
+    std::ofstream ofs_;
+    int width_;
+    int height_;
+    int written_ = 0;
+    std::vector<unsigned char> buffer_;
+};
+
 }  // namespace spica
 
 #endif  // SPICA_IMAGE_H
@@ -1,6 +1,10 @@
 #define SPICA_API_EXPORT
 #include "integrator.h"
 
+#include <chrono>
+#include <algorithm>
+#include <typeinfo>
+
 #include "core/memory.h"
 #include "core/parallel.h"
 #include "core/renderparams.h"
@@ -13,9 +17,77 @@
 
 #include "core/camera.h"
 #include "core/film.h"
+#include "core/checkpoint.h"
+#include "core/samplemap.h"
 
 namespace spica {
 
+namespace {
+
+uint32_t mortonCode2D(uint32_t x, uint32_t y) {
+    auto separateBits = [](uint32_t v) {
+        v &= 0x0000ffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+    return (separateBits(y) << 1) | separateBits(x);
+}
+
+/**
+ * Split the image into tiles and sort them in the order to be rendered.
+ * @details
+ * "morton" visits the tiles along the Z-order curve, and "spiral" visits
+ * them from the center of the image outward. Otherwise, the tiles are
+ * visited in scanline order.
+ */
+std::vector<Bounds2i> generateTiles(int width, int height, int tileSize,
+                                    const std::string &order) {
+    const int nTilesX = (width  + tileSize - 1) / tileSize;
+    const int nTilesY = (height + tileSize - 1) / tileSize;
+
+    std::vector<Point2i> tileIndices;
+    for (int ty = 0; ty < nTilesY; ty++) {
+        for (int tx = 0; tx < nTilesX; tx++) {
+            tileIndices.emplace_back(tx, ty);
+        }
+    }
+
+    if (order == "morton") {
+        std::stable_sort(tileIndices.begin(), tileIndices.end(),
+            [](const Point2i &t1, const Point2i &t2) {
+                return mortonCode2D(t1.x(), t1.y()) < mortonCode2D(t2.x(), t2.y());
+            });
+    } else if (order == "spiral") {
+        const double cx = 0.5 * (nTilesX - 1);
+        const double cy = 0.5 * (nTilesY - 1);
+        auto ring = [&](const Point2i &t) {
+            return (int)std::max(std::abs(t.x() - cx), std::abs(t.y() - cy));
+        };
+        auto angle = [&](const Point2i &t) {
+            return std::atan2(t.y() - cy, t.x() - cx);
+        };
+        std::stable_sort(tileIndices.begin(), tileIndices.end(),
+            [&](const Point2i &t1, const Point2i &t2) {
+                if (ring(t1) != ring(t2)) return ring(t1) < ring(t2);
+                return angle(t1) < angle(t2);
+            });
+    }
+
+    std::vector<Bounds2i> tiles;
+    for (const auto &t : tileIndices) {
+        const int x0 = t.x() * tileSize;
+        const int y0 = t.y() * tileSize;
+        tiles.emplace_back(x0, y0, std::min(x0 + tileSize, width),
+                                   std::min(y0 + tileSize, height));
+    }
+    return tiles;
+}
+
+}  // anonymous namespace
+
 // -----------------------------------------------------------------------------
 // Integrator method definitions
 // -----------------------------------------------------------------------------
@@ -55,49 +127,146 @@ void SamplerIntegrator::render(const std::shared_ptr<const Camera> &camera,
     const int height = camera->film()->resolution().y();
 
     const int numThreads = numSystemThreads();
-    auto samplers = std::vector<std::unique_ptr<Sampler>>(numThreads);
-    auto arenas   = std::vector<MemoryArena>(numThreads);
+    auto samplers  = std::vector<std::unique_ptr<Sampler>>(numThreads);
+    auto arenas    = std::vector<MemoryArena>(numThreads);
+    auto filmTiles = std::vector<std::unique_ptr<FilmTile>>(numThreads);
 
-    // Trace rays
+    // Split the image into tiles
+    const int tileSize = std::max(1, params.getInt("tileSize", 16));
+    const std::string tileOrder = params.getString("tileOrder", std::string("morton"));
+    const std::vector<Bounds2i> tiles = generateTiles(width, height, tileSize, tileOrder);
+
+    // Termination criteria
+    // "sampleCount" is the number of samples taken for each pixel unless
+    // the render is stopped earlier by the time budget or the pixel
+    // converges to "targetError". The sample map decides which pixels are
+    // sampled in each pass of the adaptive render.
     const int numPixels  = width * height;
     const int numSamples = params.getInt("sampleCount");
-    for (int i = 0; i < numSamples; i++) {
+    const double timeBudget  = params.getDouble("timeBudget", 0.0);
+    const double targetError = params.getDouble("targetError", 0.0);
+    const bool adaptive = targetError > 0.0;
+    SampleMap sampleMap(camera->film()->resolution(), tiles);
+    if (adaptive) {
+        sampleMap.setAdaptive(params.getInt("adaptiveMinSamples", 16), targetError,
+                              params.getInt("adaptiveTopK", 0));
+        if (!camera->film()->hasVariance()) {
+            camera->film()->enableVariance();
+        }
+    }
+
+    // Resume from the checkpoint
+    Checkpointer checkpointer(params, typeid(*this).name());
+    int startPass = 0;
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    bool samplersLoaded = false;
+    if (auto reader = checkpointer.resume()) {
+        reader->read(&startPass);
+        reader->read(&seed);
+        camera->film()->loadState(*reader);
+        if (adaptive && !camera->film()->hasVariance()) {
+            camera->film()->enableVariance();
+        }
+        samplersLoaded = loadSamplers(*reader, *sampler_, &samplers);
+    }
+
+    // The tiles track the variance if the film estimates it.
+    for (int t = 0; t < numThreads; t++) {
+        filmTiles[t] = camera->film()->filmTile();
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    double passSeconds = 0.0;
+    int numPasses = startPass;
+    int lastSaved = startPass;
+
+    // Trace rays
+    for (int i = startPass; ; i++) {
+        // Check the termination criteria
+        const double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+        if (timeBudget > 0.0 && i > startPass && elapsed + passSeconds > timeBudget) {
+            MsgInfo("Time budget of %.1f sec is exhausted.", timeBudget);
+            break;
+        }
+
+        int numActive = 0;
+        if (adaptive) {
+            numActive = sampleMap.update(*camera->film(), numSamples);
+        } else if (i < numSamples) {
+            numActive = numPixels;
+        }
+
+        if (numActive == 0) break;
+
+        const std::vector<int> &activeTiles = sampleMap.activeTiles();
+        const int numActiveTiles = static_cast<int>(activeTiles.size());
+        int numTilePixels = 0;
+        for (int k : activeTiles) {
+            numTilePixels += tiles[k].width() * tiles[k].height();
+        }
+
         // Before loop computations
         loopStarted(camera, scene, params, *initSampler);
 
         // Prepare samplers
-        if (i % numThreads == 0) {
+        if (i % numThreads == 0 || (i == startPass && !samplersLoaded)) {
             for (int t = 0; t < numThreads; t++) {
-                auto seed = static_cast<unsigned int>(time(0) + t);
-                samplers[t] = sampler_->clone(seed);
+                samplers[t] = sampler_->clone(seed + i * numThreads + t);
             }
         }
 
+        camera->film()->beginPass(i);
+        const auto passStart = std::chrono::steady_clock::now();
         std::atomic<int> proc(0);
-        parallel_for(0, numPixels, [&](int pid) {
+        parallel_for(0, numActiveTiles, [&](int k) {
             const int threadID = getThreadID();
             const auto &sampler = samplers[threadID];
-            sampler->startPixel();
-
-            const int y = pid / width;
-            const int x = pid % width;
-            const Point2d randFilm = sampler->get2D();
-            const Point2d randLens = sampler->get2D();
-            const Ray ray = camera->spawnRay(Point2i(x, y), randFilm, randLens);
-
-            const Point2i pixel(width - x - 1, y);
-            camera->film()->addPixel(pixel, randFilm,
-                                      Li(scene, params, ray, *sampler, arenas[threadID]));
-
-            proc++;
-            if (proc % 1000 == 0 || proc == numPixels) {
-                printf("\r[ %d / %d ] %6.2f %% processed...", i + 1, numSamples, 100.0 * proc / numPixels);
-                fflush(stdout);
+            FilmTile &filmTile = *filmTiles[threadID];
+
+            // The image is flipped horizontally, so that the ray for (x, y)
+            // contributes to the film pixel (width - x - 1, y).
+            const Bounds2i &tile = tiles[activeTiles[k]];
+            filmTile.reset(tile);
+            for (int y = tile.posMin().y(); y < tile.posMax().y(); y++) {
+                for (int x = tile.posMin().x(); x < tile.posMax().x(); x++) {
+                    const int spp = sampleMap.samples(x, y);
+                    for (int s = 0; s < spp; s++) {
+                        sampler->startPixel();
+
+                        const Point2d randFilm = sampler->get2D();
+                        const Point2d randLens = sampler->get2D();
+                        const Ray ray = camera->spawnRay(Point2i(width - x - 1, y), randFilm, randLens);
+
+                        filmTile.addPixel(Point2i(x, y), randFilm,
+                                          Li(scene, params, ray, *sampler, arenas[threadID]));
+                    }
+                }
+            }
+            camera->film()->mergeFilmTile(filmTile);
+
+            const int done = (proc += tile.width() * tile.height());
+            if (adaptive) {
+                printf("\r[ %d ] %6.2f %% processed (%6.2f %% pixels active)...",
+                       i + 1, 100.0 * done / numTilePixels, 100.0 * numActive / numPixels);
+            } else {
+                printf("\r[ %d / %d ] %6.2f %% processed...", i + 1, numSamples, 100.0 * done / numPixels);
             }
+            fflush(stdout);
         });
         printf("\n");
+        passSeconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - passStart).count();
+        camera->film()->endPass(i + 1);
 
-        camera->film()->save(i + 1);
+        // The last pass of the adaptive or time-budgeted render is known
+        // only after it finishes, and is saved after the loop.
+        const bool final = !adaptive && timeBudget <= 0.0 && i + 1 == numSamples;
+        if (camera->film()->saveDue(i + 1, final)) {
+            camera->film()->save(i + 1);
+            lastSaved = i + 1;
+        }
+        numPasses = i + 1;
 
         for (int t = 0; t < numThreads; t++) {
             arenas[t].reset();
@@ -105,7 +274,22 @@ void SamplerIntegrator::render(const std::shared_ptr<const Camera> &camera,
 
         // After loop computations
         loopFinished(camera, scene, params, *initSampler);
+
+        // Save the checkpoint. The accumulation file can only be resumed
+        // by the checkpoint of its last pass.
+        if (checkpointer.due(camera->film()->mapped())) {
+            auto writer = checkpointer.writer();
+            writer->write(numPasses);
+            writer->write(seed);
+            camera->film()->saveState(*writer);
+            saveSamplers(*writer, samplers);
+            writer->commit();
+        }
+    }
+    if (numPasses > lastSaved) {
+        camera->film()->save(numPasses);
     }
+    camera->film()->close();
     printf("Finish!!\n");
 }
 
@@ -116,12 +300,12 @@ Spectrum SamplerIntegrator::specularReflect(const Scene& scene,
                                             Sampler& sampler,
                                             MemoryArena& arena,
                                             int depth) const {
-    Vector3d wi, wo = isect.wo();
+    Vector3 wi, wo = isect.wo();
     double pdf;
     BxDFType type = BxDFType::Reflection | BxDFType::Specular;
     Spectrum f = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf, type);
     
-    const Normal3d nrm = isect.normal();
+    const Normal3 nrm = isect.normal();
     if (pdf > 0.0 && !f.isBlack() && vect::absDot(wi, nrm) != 0.0) {
         Ray r = isect.spawnRay(wi);
         return f * Li(scene, params, r, sampler, arena, depth + 1) *
@@ -137,10 +321,10 @@ Spectrum SamplerIntegrator::specularTransmit(const Scene& scene,
                                              Sampler& sampler,
                                              MemoryArena& arena,
                                              int depth) const {
-    Vector3d wi;
+    Vector3 wi;
     double pdf;
-    const Vector3d &wo = isect.wo();
-    const Normal3d &nrm = isect.normal();
+    const Vector3 &wo = isect.wo();
+    const Normal3 &nrm = isect.normal();
     BxDFType type = BxDFType::Transmission | BxDFType::Specular;
     Spectrum f = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf, type);
     if (pdf > 0.0 && !f.isBlack() && vect::absDot(wi, nrm) != 0.0) {
@@ -13,12 +13,14 @@ namespace spica {
 
 namespace {
 
-Point3d offsetRayOrigin(const Point3d& p, const Normal3d& n, const Vector3d& w) {
-    Vector3d offset = Vector3d(n) * 1.0e-3;
+Point3 offsetRayOrigin(const Point3& p, const Normal3& n, const Vector3& w) {
+    Vector3 offset = Vector3(n) * 1.0e-3;
     if (vect::dot(w, n) < 0.0) offset = -offset;
 
-    Point3d po = p + offset;
-    double ret[3];
+    // The geometry is stored in "Float", so the origin is rounded to the
+    // next value of that precision to stay on the offset side of the surface.
+    Point3 po = p + offset;
+    Float ret[3];
     for (int i = 0; i < 3; i++) {
         if (offset[i] > 0.0) {
             ret[i] = nextFloatUp(po[i]);
@@ -26,7 +28,7 @@ Point3d offsetRayOrigin(const Point3d& p, const Normal3d& n, const Vector3d& w)
             ret[i] = nextFloatDown(po[i]);
         }
     }
-    return Point3d(ret[0], ret[1], ret[2]);
+    return Point3(ret[0], ret[1], ret[2]);
 }
 
 }  // anonymous namespace
@@ -42,15 +44,15 @@ Interaction::Interaction()
     , mediumInterface_{} {
 }
 
-Interaction::Interaction(const Point3d& p, const Normal3d& n,
-                         const Vector3d& wo)
+Interaction::Interaction(const Point3& p, const Normal3& n,
+                         const Vector3& wo)
     : pos_{ p }
     , normal_{ n }
     , wo_{ wo }
     , mediumInterface_{} {
 }
 
-Interaction::Interaction(const Point3d& p, const Vector3d& wo,
+Interaction::Interaction(const Point3& p, const Vector3& wo,
                          const MediumInterface& mediumInterface)
     : pos_{ p }
     , normal_{}
@@ -74,21 +76,21 @@ Interaction& Interaction::operator=(const Interaction& intr) {
     return *this;
 }
 
-Ray Interaction::spawnRay(const Vector3d& wi) const {
-    Point3d origin = offsetRayOrigin(pos_, normal_, wi);
+Ray Interaction::spawnRay(const Vector3& wi) const {
+    Point3 origin = offsetRayOrigin(pos_, normal_, wi);
     return Ray(origin, wi, INFTY, getMedium(wi));
 }
 
-Ray Interaction::spawnRayTo(const Point3d& p) const {
-    Vector3d d = p - pos_;
-    Point3d origin = offsetRayOrigin(pos_, normal_, d);
+Ray Interaction::spawnRayTo(const Point3& p) const {
+    Vector3 d = p - pos_;
+    Point3 origin = offsetRayOrigin(pos_, normal_, d);
     return Ray(origin, d, d.norm(), getMedium(d));
 }
 
 Ray Interaction::spawnRayTo(const Interaction& intr) const {
-    Point3d origin = offsetRayOrigin(pos_, normal_, intr.pos_ - pos_);
-    Point3d target = offsetRayOrigin(intr.pos_, intr.normal_, origin - intr.pos_);
-    Vector3d d = target - origin;
+    Point3 origin = offsetRayOrigin(pos_, normal_, intr.pos_ - pos_);
+    Point3 target = offsetRayOrigin(intr.pos_, intr.normal_, origin - intr.pos_);
+    Vector3 d = target - origin;
     return Ray(origin, d, d.norm(), getMedium(d));
 }
 
@@ -107,13 +109,13 @@ SurfaceInteraction::SurfaceInteraction()
     , bsdf_{} {
 }
 
-SurfaceInteraction::SurfaceInteraction(const Point3d& pos,
+SurfaceInteraction::SurfaceInteraction(const Point3& pos,
                                        const Point2d& uv,
-                                       const Vector3d& wo,
-                                       const Vector3d& dpdu, const Vector3d& dpdv,
-                                       const Normal3d& dndu, const Normal3d& dndv,
+                                       const Vector3& wo,
+                                       const Vector3& dpdu, const Vector3& dpdv,
+                                       const Normal3& dndu, const Normal3& dndv,
                                        const Shape* shape)
-    : Interaction{ pos, Normal3d(vect::normalize(vect::cross(dpdu, dpdv))), wo }
+    : Interaction{ pos, Normal3(vect::normalize(vect::cross(dpdu, dpdv))), wo }
     , uv_{ uv }
     , dpdu_{ dpdu }
     , dpdv_{ dpdv }
@@ -156,7 +158,7 @@ void SurfaceInteraction::computeDifferentials(const Ray& ray) {
     //} else {
     dudx_ = dvdx_ = 0.0;
     dudy_ = dvdy_ = 0.0;
-    dpdx_ = dpdy_ = Vector3d(0.0, 0.0, 0.0);
+    dpdx_ = dpdy_ = Vector3(0.0, 0.0, 0.0);
     //}
 }
 
@@ -165,16 +167,16 @@ void SurfaceInteraction::setScatterFuncs(const Ray& ray, MemoryArena& arena) {
     primitive_->setScatterFuncs(this, arena);
 }
 
-void SurfaceInteraction::setShadingGeometry(const Vector3d &dpdu, const Vector3d &dpdv,
-                                            const Normal3d &dndu, const Normal3d &dndv) {
-    shading.n = Normal3d(vect::normalize(vect::cross(dpdu, dpdv)));
+void SurfaceInteraction::setShadingGeometry(const Vector3 &dpdu, const Vector3 &dpdv,
+                                            const Normal3 &dndu, const Normal3 &dndv) {
+    shading.n = Normal3(vect::normalize(vect::cross(dpdu, dpdv)));
     shading.dpdu = dpdu;
     shading.dpdv = dpdv;
     shading.dndu = dndu;
     shading.dndv = dndv;
 }
 
-Spectrum SurfaceInteraction::Le(const Vector3d& w) const {
+Spectrum SurfaceInteraction::Le(const Vector3& w) const {
     const Light* area = primitive_->light();
     return area ? area->L(*this, w) : Spectrum(0.0);
 }
@@ -187,7 +189,7 @@ MediumInteraction::MediumInteraction()
     : phase_{ nullptr } {
 }
 
-MediumInteraction::MediumInteraction(const Point3d& p, const Vector3d& wo,
+MediumInteraction::MediumInteraction(const Point3& p, const Vector3& wo,
                                      const Medium* medium,
                                      const PhaseFunction* phase)
     : Interaction{ p, wo, MediumInterface(medium) }
@@ -23,28 +23,28 @@ namespace spica {
 class SPICA_EXPORTS Interaction {
 public:
     Interaction();
-    explicit Interaction(const Point3d& pos, const Normal3d& normal = Normal3d(),
-                         const Vector3d& wo = Vector3d());
-    Interaction(const Point3d& pos, const Vector3d& wo,
+    explicit Interaction(const Point3& pos, const Normal3& normal = Normal3(),
+                         const Vector3& wo = Vector3());
+    Interaction(const Point3& pos, const Vector3& wo,
                 const MediumInterface& mediumInterface);
     Interaction(const Interaction& intr);
     virtual ~Interaction();
 
     Interaction& operator=(const Interaction& intr);
 
-    virtual Ray spawnRay(const Vector3d& wi) const;
-    virtual Ray spawnRayTo(const Point3d& p) const;
+    virtual Ray spawnRay(const Vector3& wi) const;
+    virtual Ray spawnRayTo(const Point3& p) const;
     virtual Ray spawnRayTo(const Interaction& intr) const;
 
     inline virtual bool isSurfaceInteraction() const { return false; }
-    inline const Point3d&  pos()    const { return pos_; }
-    inline const Normal3d& normal() const { return normal_; }
-    inline const Vector3d& wo()     const { return wo_; }
+    inline const Point3&  pos()    const { return pos_; }
+    inline const Normal3& normal() const { return normal_; }
+    inline const Vector3& wo()     const { return wo_; }
     inline void setMediumInterface(const MediumInterface& mediumInterface) {
         mediumInterface_ = mediumInterface;
     }
 
-    inline const Medium* getMedium(const Vector3d& w) const {
+    inline const Medium* getMedium(const Vector3& w) const {
         return vect::dot(w, normal_) > 0.0 ? mediumInterface_.outside()
                                            : mediumInterface_.inside(); 
     }
@@ -56,9 +56,9 @@ public:
     }
 
 protected:
-    Point3d  pos_;
-    Normal3d normal_;
-    Vector3d wo_;
+    Point3  pos_;
+    Normal3 normal_;
+    Vector3 wo_;
     MediumInterface mediumInterface_;
 
 private:
@@ -68,10 +68,10 @@ private:
 class SPICA_EXPORTS SurfaceInteraction : public Interaction {
 public:
     SurfaceInteraction();
-    SurfaceInteraction(const Point3d& p,
-                       const Point2d& uv, const Vector3d& wo,
-                       const Vector3d& dpdu, const Vector3d& dpdv,
-                       const Normal3d& dndu, const Normal3d& dndv,
+    SurfaceInteraction(const Point3& p,
+                       const Point2d& uv, const Vector3& wo,
+                       const Vector3& dpdu, const Vector3& dpdv,
+                       const Normal3& dndu, const Normal3& dndv,
                        const Shape* shape);
     SurfaceInteraction(const SurfaceInteraction& intr);
     virtual ~SurfaceInteraction();
@@ -80,19 +80,19 @@ public:
 
     void computeDifferentials(const Ray& ray);
     void setScatterFuncs(const Ray& ray, MemoryArena& arena);
-    void setShadingGeometry(const Vector3d &dpdu, const Vector3d &dpdv,
-                            const Normal3d &dndu, const Normal3d &dndv);
-    Spectrum Le(const Vector3d& w) const;
+    void setShadingGeometry(const Vector3 &dpdu, const Vector3 &dpdv,
+                            const Normal3 &dndu, const Normal3 &dndv);
+    Spectrum Le(const Vector3& w) const;
     
     inline bool isSurfaceInteraction() const override { return true; }
     inline const Point2d& uv() const { return uv_; }
-    inline const Vector3d& dpdu() const { return dpdu_; }
-    inline const Vector3d& dpdv() const { return dpdv_; }
-    inline const Normal3d& dndu() const { return dndu_; }
-    inline const Normal3d& dndv() const { return dndv_; }
-    inline const Normal3d& ns() const { return shading.n; }
-    inline const Vector3d& ts() const { return shading.dpdu; }
-    inline const Vector3d& bs() const { return shading.dpdv; }
+    inline const Vector3& dpdu() const { return dpdu_; }
+    inline const Vector3& dpdv() const { return dpdv_; }
+    inline const Normal3& dndu() const { return dndu_; }
+    inline const Normal3& dndv() const { return dndv_; }
+    inline const Normal3& ns() const { return shading.n; }
+    inline const Vector3& ts() const { return shading.dpdu; }
+    inline const Vector3& bs() const { return shading.dpdv; }
     inline double dudx() const { return dudx_; }
     inline double dudy() const { return dudy_; }
     inline double dvdx() const { return dvdx_; }
@@ -107,13 +107,13 @@ public:
     
 private:
     Point2d uv_;
-    Vector3d dpdu_, dpdv_;
-    Normal3d dndu_, dndv_;
-    Vector3d dpdx_, dpdy_;
+    Vector3 dpdu_, dpdv_;
+    Normal3 dndu_, dndv_;
+    Vector3 dpdx_, dpdy_;
     struct {
-        Normal3d n;
-        Vector3d dpdu, dpdv;
-        Normal3d dndu, dndv;
+        Normal3 n;
+        Vector3 dpdu, dpdv;
+        Normal3 dndu, dndv;
     } shading;
 
     double dudx_ = 0.0, dudy_ = 0.0, dvdx_ = 0.0, dvdy_ = 0.0;
@@ -126,7 +126,7 @@ private:
 class SPICA_EXPORTS MediumInteraction : public Interaction {
 public:
     MediumInteraction();
-    MediumInteraction(const Point3d& p, const Vector3d& wo,
+    MediumInteraction(const Point3& p, const Vector3& wo,
                       const Medium* medium,
                       const PhaseFunction* phase);
     bool isValid() const;
@@ -158,7 +158,7 @@ namespace spica {
     }
 
     template <>
-    inline double KdTree<Vector3d>::distance(const Vector3d& p1, const Vector3d& p2) {
+    inline double KdTree<Vector3>::distance(const Vector3& p1, const Vector3& p2) {
         return (p1 - p2).norm();    
     }
 
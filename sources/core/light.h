@@ -21,9 +21,9 @@ namespace spica {
 
     class SPICA_EXPORTS LightSample {
     private:
-        Point3d  _pos{0.0, 0.0, 0.0};  /** Position.      */
-        Normal3d _nrm{0.0, 0.0, 0.0};  /** Normal.        */
-        Vector3d _dir{0.0, 0.0, 0.0};  /** Out direction. */
+        Point3  _pos{0.0, 0.0, 0.0};  /** Position.      */
+        Normal3 _nrm{0.0, 0.0, 0.0};  /** Normal.        */
+        Vector3 _dir{0.0, 0.0, 0.0};  /** Out direction. */
         Spectrum _emt{0.0, 0.0, 0.0};  /** Emission.      */
         double   _pdf = 0.0;           /** Sample PDF.    */
 
@@ -31,7 +31,7 @@ namespace spica {
         LightSample() {
         }
 
-        LightSample(const Point3d& p, const Normal3d& n, const Vector3d& dir,
+        LightSample(const Point3& p, const Normal3& n, const Vector3& dir,
                     const Spectrum& e, double pdf)
             : _pos{ p }
             , _nrm{ n }
@@ -57,9 +57,9 @@ namespace spica {
             return *this;
         }
 
-        inline Point3d  position() const { return _pos; }
-        inline Normal3d normal()   const { return _nrm; }
-        inline Vector3d dir()      const { return _dir; }
+        inline Point3  position() const { return _pos; }
+        inline Normal3 normal()   const { return _nrm; }
+        inline Vector3 dir()      const { return _dir; }
         inline Spectrum Le()       const { return _emt; }
         inline double   pdf()      const { return _pdf; }
     };
@@ -84,7 +84,7 @@ namespace spica {
 
         LightType type() const;
 
-        virtual Spectrum L(const Interaction& pLight, const Vector3d& dir) const;
+        virtual Spectrum L(const Interaction& pLight, const Vector3& dir) const;
 
         /**
          * Sample incident radiance (Li) at the intersecting point.
@@ -93,7 +93,7 @@ namespace spica {
          * @return Sampled incident randiance.
          */
         virtual Spectrum sampleLi(const Interaction& pObj, const Point2d& rands,
-                                  Vector3d* dir, double* pdf, VisibilityTester* vis) const = 0;
+                                  Vector3* dir, double* pdf, VisibilityTester* vis) const = 0;
 
         /**
          * Compute PDF for the incident direction.
@@ -101,13 +101,13 @@ namespace spica {
          * @param[in] inDir: Incident direction.
          * @return PDF (probability density).
          */
-        virtual double pdfLi(const Interaction& pObj, const Vector3d& dir) const = 0;
+        virtual double pdfLi(const Interaction& pObj, const Vector3& dir) const = 0;
 
         virtual Spectrum Le(const Ray& ray) const;
         virtual Spectrum sampleLe(const Point2d& rand1, const Point2d& rand2,
-                                  Ray* ray, Normal3d* nLight, double* pdfPos,
+                                  Ray* ray, Normal3* nLight, double* pdfPos,
                                   double *pdfDir) const = 0;
-        virtual void pdfLe(const Ray& ray, const Normal3d& nLight,
+        virtual void pdfLe(const Ray& ray, const Normal3& nLight,
                            double* pdfPos, double* pdfDir) const = 0;
 
         virtual Spectrum power() const = 0;
@@ -4,6 +4,18 @@
 #include <cstdlib>
 #include <algorithm>
 
+#if defined(_WIN32) || defined(__WIN32__)
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "core/exception.h"
+
 namespace spica {
 
 MemoryArena::MemoryArena(size_t blockSize)
@@ -68,4 +80,96 @@ size_t MemoryArena::totalAllocated() const {
     return total;
 }
 
-}  // namespace spica
\ No newline at end of file
+#if defined(_WIN32) || defined(__WIN32__)
+
+MappedFile::MappedFile(const std::string &filename, size_t size, bool keep)
+    : filename_{ filename }
+    , size_{ size } {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw RuntimeException("Failed to open file: %s", filename.c_str());
+    }
+
+    LARGE_INTEGER current;
+    GetFileSizeEx(file, &current);
+    reused_ = keep && static_cast<size_t>(current.QuadPart) == size;
+    if (!reused_) {
+        // Truncate first, so that the whole file is filled with zeros
+        LARGE_INTEGER zero = {};
+        LARGE_INTEGER length;
+        length.QuadPart = static_cast<LONGLONG>(size);
+        SetFilePointerEx(file, zero, NULL, FILE_BEGIN);
+        SetEndOfFile(file);
+        SetFilePointerEx(file, length, NULL, FILE_BEGIN);
+        SetEndOfFile(file);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                                        static_cast<DWORD>(size >> 32),
+                                        static_cast<DWORD>(size & 0xffffffff), NULL);
+    if (mapping == NULL) {
+        CloseHandle(file);
+        throw RuntimeException("Failed to map file: %s", filename.c_str());
+    }
+
+    data_ = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data_ == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw RuntimeException("Failed to map file: %s", filename.c_str());
+    }
+    file_    = file;
+    mapping_ = mapping;
+}
+
+MappedFile::~MappedFile() {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+}
+
+void MappedFile::sync() {
+    FlushViewOfFile(data_, size_);
+    FlushFileBuffers(file_);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &filename, size_t size, bool keep)
+    : filename_{ filename }
+    , size_{ size } {
+    fd_ = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw RuntimeException("Failed to open file: %s", filename.c_str());
+    }
+
+    struct stat st;
+    reused_ = keep && fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == size;
+    if (!reused_) {
+        // Truncate first, so that the whole file is filled with zeros
+        if (ftruncate(fd_, 0) != 0 || ftruncate(fd_, size) != 0) {
+            close(fd_);
+            throw RuntimeException("Failed to resize file: %s", filename.c_str());
+        }
+    }
+
+    data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        close(fd_);
+        throw RuntimeException("Failed to map file: %s", filename.c_str());
+    }
+}
+
+MappedFile::~MappedFile() {
+    munmap(data_, size_);
+    close(fd_);
+}
+
+void MappedFile::sync() {
+    msync(data_, size_, MS_SYNC);
+}
+
+#endif
+
+}  // namespace spica
@@ -6,6 +6,7 @@
 #define _SPICA_MEMORY_H_
 
 #include <list>
+#include <string>
 
 #include "../core/common.h"
 #include "../core/uncopyable.h"
@@ -51,6 +52,41 @@ private:
     std::list<std::pair<size_t, unsigned char*>> usedBlocks_, availableBlocks_;
 };  // class MemoryArena
 
+/**
+ * File mapped to the memory.
+ * @details
+ * The contents are paged in and out by the operating system, so that a
+ * buffer larger than the physical memory only keeps the pages in use
+ * resident. The file is created, or truncated and zero-filled to "size".
+ * Only when "keep" is true and the file already has the size, the contents
+ * are kept, which can be checked by "reused".
+ */
+class SPICA_EXPORTS MappedFile : private Uncopyable {
+public:
+    MappedFile(const std::string &filename, size_t size, bool keep = true);
+    ~MappedFile();
+
+    //! Write the modified pages back to the file.
+    void sync();
+
+    inline void* data() const { return data_; }
+    inline size_t size() const { return size_; }
+    inline bool reused() const { return reused_; }
+
+private:
+    // Private fields
+    std::string filename_;
+    size_t size_ = 0;
+    void* data_ = nullptr;
+    bool reused_ = false;
+#if defined(_WIN32) || defined(__WIN32__)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};  // class MappedFile
+
 }  // namespace spica
 
 #endif  // _SPICA_MEMORY_H_
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <tuple>
 
 #include <experimental/filesystem>
 namespace fs = std::experimental::filesystem;
@@ -13,7 +15,7 @@ namespace fs = std::experimental::filesystem;
 
 #include "core/common.h"
 #include "core/triplet.h"
-#include "core/triangle.h"
+#include "core/trimesh.h"
 #include "core/vector2d.h"
 #include "core/point3d.h"
 #include "core/image.h"
@@ -27,17 +29,17 @@ namespace spica {
 // ----------------------------------------------------------------------------
 
 ShapeGroup::ShapeGroup()
-    : shapes_{} {
+    : mesh_{} {
 }
 
 ShapeGroup::~ShapeGroup() {
 }
 
 ShapeGroup::ShapeGroup(
-    const std::vector<std::shared_ptr<Shape>>& shapes,
+    const std::shared_ptr<TriangleMesh>& mesh,
     const std::shared_ptr<Texture<Spectrum>>& mapKd,
     const std::shared_ptr<Texture<double>> & bumpMap)
-    : shapes_{ shapes }
+    : mesh_{ mesh }
     , mapKd_{ mapKd }
     , bumpMap_{ bumpMap } {
 }
@@ -53,14 +55,14 @@ ShapeGroup::ShapeGroup(ShapeGroup&& sg)
 }
 
 ShapeGroup& ShapeGroup::operator=(const ShapeGroup& sg) {
-    this->shapes_  = sg.shapes_;
+    this->mesh_    = sg.mesh_;
     this->mapKd_   = sg.mapKd_;
     this->bumpMap_ = sg.bumpMap_;
     return *this;
 }
 
 ShapeGroup& ShapeGroup::operator=(ShapeGroup&& sg) {
-    this->shapes_  = std::move(sg.shapes_);
+    this->mesh_    = std::move(sg.mesh_);
     this->mapKd_   = std::move(sg.mapKd_);
     this->bumpMap_ = std::move(sg.bumpMap_);
     return *this;
@@ -89,10 +91,11 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
     int numFaces = 0;
 
     std::getline(ifs, format);
-    Assertion(format == "ply", "Invalid format identifier");
+    SPICA_CHECK(format == "ply", "Invalid format identifier");
 
     bool isBody = false;
-    std::vector<std::shared_ptr<Shape>> tris;
+    std::vector<Point3> vertices;
+    std::vector<int> indices;
     while(!ifs.eof()) {
         if (!isBody) {
             std::getline(ifs, line);
@@ -102,7 +105,7 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
             ss >> key;
             if (key == "format") {
                 ss >> name >> val;
-                Assertion(name == "binary_little_endian", "PLY must be binary little endian format!");
+                SPICA_CHECK(name == "binary_little_endian", "PLY must be binary little endian format!");
             } else if (key == "property") {
                 ss >> name >> val;
             } else if (key == "element") {
@@ -112,7 +115,7 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
                 } else if (name == "face") {
                     ss >> numFaces;
                 } else {
-                    Assertion(false, "Invalid element indentifier");
+                    SPICA_CHECK(false, "Invalid element indentifier");
                 }
             } else if (key == "end_header") {
                 isBody = true;
@@ -131,11 +134,11 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
                 continue;
             }
         } else {
-            Assertion(numVerts > 0 && numFaces > 0, "numVerts and numFaces must be positive");
+            SPICA_CHECK(numVerts > 0 && numFaces > 0, "numVerts and numFaces must be positive");
 
             float ff[3];
             //float tt[2];
-            std::vector<Point3d> vertices;
+            vertices.reserve(numVerts);
             for (size_t i = 0; i < numVerts; i++) {
                 ifs.read((char*)ff, sizeof(float) * 3);
                 vertices.emplace_back(ff[0], ff[1], ff[2]);
@@ -148,10 +151,11 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
 
             unsigned char vs;
             int ii[3];
+            indices.reserve(numFaces * 3);
             for (size_t i = 0; i < numFaces; i++) {
                 ifs.read((char*)&vs, sizeof(unsigned char));
                 ifs.read((char*)ii, sizeof(int) * 3);
-                tris.emplace_back(new Triangle(vertices[ii[0]], vertices[ii[1]], vertices[ii[2]], objectToWorld));
+                indices.insert(indices.end(), ii, ii + 3);
                 if (vs > 3) {
                     Warning("[WARNING] mesh contains non-triangle polygon (%d vertices) !!", (int)vs);
                     ifs.seekg(sizeof(int) * (vs - 3), std::ios_base::cur);
@@ -162,8 +166,12 @@ std::vector<ShapeGroup> loadPLY(const std::string& filename,
     }
     ifs.close();
 
+    auto mesh = std::make_shared<TriangleMesh>(vertices, indices,
+                                               std::vector<Normal3>(),
+                                               std::vector<Point2d>(),
+                                               objectToWorld);
     std::vector<ShapeGroup> ret;
-    ret.emplace_back(tris, nullptr, nullptr);
+    ret.emplace_back(mesh, nullptr, nullptr);
 
     return std::move(ret);
 }
@@ -187,27 +195,40 @@ std::vector<ShapeGroup> loadOBJ(const std::string& filename,
     // Prepare return object.
     std::vector<ShapeGroup> groups;
     for (const auto &s : shapes) {
-        std::vector<Point3d> positions;
-        std::vector<Normal3d> normals;
+        // Vertices are shared by the faces which refer to the same
+        // combination of position, normal and texcoord indices.
+        std::map<std::tuple<int, int, int>, int> vertexIds;
+        std::vector<Point3> positions;
+        std::vector<Normal3> normals;
         std::vector<Point2d> texcoords;
+        std::vector<int> indices;
+        indices.reserve(s.mesh.indices.size());
 
         bool hasNormal = true;
         bool hasTexcoord = true;
         for (const auto &index : s.mesh.indices) {
-            Point3d position;
-            Normal3d normal;
+            const auto key = std::make_tuple(index.vertex_index, index.normal_index,
+                                             index.texcoord_index);
+            auto it = vertexIds.find(key);
+            if (it != vertexIds.end()) {
+                indices.push_back(it->second);
+                continue;
+            }
+
+            Point3 position;
+            Normal3 normal;
             Point2d texcoord;
         
             if (index.vertex_index >= 0) {
-                position = Point3d(attrib.vertices[index.vertex_index * 3 + 0],
-                                   attrib.vertices[index.vertex_index * 3 + 1],
-                                   attrib.vertices[index.vertex_index * 3 + 2]);
+                position = Point3(attrib.vertices[index.vertex_index * 3 + 0],
+                                  attrib.vertices[index.vertex_index * 3 + 1],
+                                  attrib.vertices[index.vertex_index * 3 + 2]);
             }
 
             if (index.normal_index >= 0) {
-                normal = Normal3d(attrib.normals[index.normal_index * 3 + 0],
-                                  attrib.normals[index.normal_index * 3 + 1],
-                                  attrib.normals[index.normal_index * 3 + 2]);
+                normal = Normal3(attrib.normals[index.normal_index * 3 + 0],
+                                 attrib.normals[index.normal_index * 3 + 1],
+                                 attrib.normals[index.normal_index * 3 + 2]);
             } else {
                 hasNormal = false;
             }
@@ -219,31 +240,28 @@ std::vector<ShapeGroup> loadOBJ(const std::string& filename,
                 hasTexcoord = false;
             }
 
+            const int id = static_cast<int>(positions.size());
+            vertexIds[key] = id;
+            indices.push_back(id);
             positions.push_back(position);
             normals.push_back(normal);
             texcoords.push_back(texcoord);
         }
 
-        std::vector<std::shared_ptr<Shape>> tris;
-        for (int i = 0; i < positions.size(); i += 3) {
-            std::shared_ptr<Shape> tri;
-            if (hasNormal && hasTexcoord) {
-                tri = std::make_shared<Triangle>(positions[i + 0], positions[i + 1], positions[i + 2],
-                                                 normals[i + 0], normals[i + 1], normals[i + 2],
-                                                 texcoords[i + 0], texcoords[i + 1], texcoords[i + 2], objectToWorld);
-            } else if (hasNormal) {
-                tri = std::make_shared<Triangle>(positions[i + 0], positions[i + 1], positions[i + 2],
-                                                 normals[i + 0], normals[i + 1], normals[i + 2], objectToWorld);
-            } else {
-                tri = std::make_shared<Triangle>(positions[i + 0], positions[i + 1], positions[i + 2], objectToWorld);
-            }
-            tris.push_back(tri);
+        // Texcoords without normals are ignored as before.
+        if (!hasNormal) {
+            normals.clear();
+            texcoords.clear();
+        } else if (!hasTexcoord) {
+            texcoords.clear();
         }
+        auto mesh = std::make_shared<TriangleMesh>(positions, indices, normals,
+                                                   texcoords, objectToWorld);
 
         //TODO: Load textures and other material data from .mtl file
         std::shared_ptr<Texture<Spectrum>> mapKd = nullptr;
         std::shared_ptr<Texture<double>> bumpMap = nullptr;
-        groups.emplace_back(tris, mapKd, bumpMap);
+        groups.emplace_back(mesh, mapKd, bumpMap);
     }
 
     return std::move(groups);
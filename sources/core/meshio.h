@@ -12,17 +12,18 @@
 #include "core/common.h"
 #include "core/uncopyable.h"
 #include "core/transform.h"
+#include "core/trimesh.h"
 
 namespace spica {
 
 /**
- * Shape with materials.
+ * Triangle mesh with materials.
  */
 class SPICA_EXPORTS ShapeGroup {
 public:
     ShapeGroup();
     explicit ShapeGroup(
-        const std::vector<std::shared_ptr<Shape>>& shapes,
+        const std::shared_ptr<TriangleMesh>& mesh,
         const std::shared_ptr<Texture<Spectrum>>& mapKd = nullptr,
         const std::shared_ptr<Texture<double>> & bumpMap = nullptr);
 
@@ -34,8 +35,8 @@ public:
     ShapeGroup& operator=(const ShapeGroup& sg);
     ShapeGroup& operator=(ShapeGroup&& sg);
 
-    inline const std::vector<std::shared_ptr<Shape>>& shapes() const {
-        return shapes_;
+    inline const std::shared_ptr<TriangleMesh>& mesh() const {
+        return mesh_;
     }
 
     inline const std::shared_ptr<Texture<Spectrum>>& mapKd() const {
@@ -47,7 +48,7 @@ public:
     }
 
 private:
-    std::vector<std::shared_ptr<Shape>> shapes_;
+    std::shared_ptr<TriangleMesh> mesh_ = nullptr;
     std::shared_ptr<Texture<Spectrum>> mapKd_ = nullptr;
     std::shared_ptr<Texture<double>> bumpMap_ = nullptr;
 };
@@ -36,8 +36,8 @@ void sampleTrowbridgeReitz11(double cosTheta,
     double slopex1 = B * tmp - D;
     double slopex2 = B * tmp + D;
     *slopex = (A < 0.0 || slopex2 > 1.0 / tanTheta) ? slopex1 : slopex2;
-    Assertion(!std::isinf(*slopex), "slopex is infinity.");
-    Assertion(!std::isnan(*slopex), "slopex is NaN.");
+    SPICA_PARANOID_CHECK(!std::isinf(*slopex), "slopex is infinity.");
+    SPICA_PARANOID_CHECK(!std::isnan(*slopex), "slopex is NaN.");
 
     double S, U;
     if (rands[1] > 0.5) {
@@ -51,15 +51,15 @@ void sampleTrowbridgeReitz11(double cosTheta,
     double z = (U * (U * (U * 0.27385 - 0.73369) + 0.46341)) /
                (U * (U * (U * 0.093073 + 0.309420) - 1.0) + 0.597999);
     *slopey = S * z * std::sqrt(1.0 + (*slopex) * (*slopex));
-    Assertion(!std::isinf(*slopey), "slopey is infinity.");
-    Assertion(!std::isnan(*slopey), "slopey is NaN");
+    SPICA_PARANOID_CHECK(!std::isinf(*slopey), "slopey is infinity.");
+    SPICA_PARANOID_CHECK(!std::isnan(*slopey), "slopey is NaN");
 }
 
-static Vector3d sampleTrowbridgeReitz(const Vector3d& wi,
+static Vector3 sampleTrowbridgeReitz(const Vector3& wi,
                                double alphax, double alphay,
                                const Point2d& rands) {
-    Vector3d wiStretched =
-        Vector3d(alphax * wi.x(), alphay * wi.y(), wi.z()).normalized();
+    Vector3 wiStretched =
+        Vector3(alphax * wi.x(), alphay * wi.y(), wi.z()).normalized();
 
     double slopex, slopey;
     sampleTrowbridgeReitz11(vect::cosTheta(wiStretched), rands, &slopex, &slopey);
@@ -74,7 +74,7 @@ static Vector3d sampleTrowbridgeReitz(const Vector3d& wi,
     slopex = slopex * alphax;
     slopey = slopey * alphay;
 
-    return Vector3d(-slopex, -slopey, 1.0).normalized();
+    return Vector3(-slopex, -slopey, 1.0).normalized();
 }
 
 static void beckmannSample11(const double cosThetaI, double U1, double U2, double *slopex, double *slopey) {
@@ -132,12 +132,12 @@ static void beckmannSample11(const double cosThetaI, double U1, double U2, doubl
     *slopey = math::erfinv(2.0 * std::max(U2, 1.0e-6) - 1.0);
 }
 
-static Vector3d beckmannSample(const Vector3d &wi, double alphax, double alphay, double U1, double U2) {
+static Vector3 beckmannSample(const Vector3 &wi, double alphax, double alphay, double U1, double U2) {
     // Sampling strategy in Algorithm 4 of [Heitz et al. 2014]
     // "Importance Sampling Microfacet-Based BSDFs using the Distribution of Visible Normals"
 
     // 1. Stretch wi
-    Vector3d wiStretched = vect::normalize(Vector3d(alphax * wi.x(), alphay * wi.y(), wi.z()));
+    Vector3 wiStretched = vect::normalize(Vector3(alphax * wi.x(), alphay * wi.y(), wi.z()));
 
     // 2. Simulate P22_{wi}(x_slope, y_slope, 1, 1)
     double slopex, slopey;
@@ -153,7 +153,7 @@ static Vector3d beckmannSample(const Vector3d &wi, double alphax, double alphay,
     slopey *= alphay;
 
     // 5. Compute normal
-    return vect::normalize(Vector3d(-slopex, -slopey, 1.0));
+    return vect::normalize(Vector3(-slopex, -slopey, 1.0));
 }
 
 }  // anonymous namespace
@@ -171,12 +171,12 @@ MicrofacetDistribution::MicrofacetDistribution(double alphax, double alphay, boo
 MicrofacetDistribution::~MicrofacetDistribution() {
 }
 
-double MicrofacetDistribution::G1(const Vector3d &w, const Vector3d &wh) const {
+double MicrofacetDistribution::G1(const Vector3 &w, const Vector3 &wh) const {
     if (w.z() * vect::dot(w, wh) <= 0.0) return 0.0;
     return 1.0 / (1.0 + lambda(w));
 }
 
-double MicrofacetDistribution::G(const Vector3d& wo, const Vector3d& wi, const Vector3d &wh) const {
+double MicrofacetDistribution::G(const Vector3& wo, const Vector3& wi, const Vector3 &wh) const {
     // Height corelated shadowing-masking function
     // Note that another form G1(wi) * G1(wo) is used in Mitsuba.
     if (wi.z() * vect::dot(wi, wh) <= 0.0) return 0.0;
@@ -184,7 +184,7 @@ double MicrofacetDistribution::G(const Vector3d& wo, const Vector3d& wi, const V
     return 1.0 / (1.0 + lambda(wo) + lambda(wi));
 }
 
-double MicrofacetDistribution::pdf(const Vector3d& wo, const Vector3d& wh) const {
+double MicrofacetDistribution::pdf(const Vector3& wo, const Vector3& wh) const {
     if (sampleVisibleArea_) {
         return D(wh) * G1(wo, wh) * vect::absDot(wo, wh) / std::abs(vect::cosTheta(wo));
     } else {
@@ -202,7 +202,7 @@ TrowbridgeReitzDistribution::TrowbridgeReitzDistribution(double alphax,
     : MicrofacetDistribution{alphax, alphay, samplevis} {
 }
 
-double TrowbridgeReitzDistribution::D(const Vector3d& wh) const {
+double TrowbridgeReitzDistribution::D(const Vector3& wh) const {
     double tan2Theta = vect::tan2Theta(wh);
     if (std::isinf(tan2Theta)) return 0.0;
 
@@ -212,9 +212,9 @@ double TrowbridgeReitzDistribution::D(const Vector3d& wh) const {
     return 1.0 / (PI * alphax_ * alphay_ * cos4Theta * (1.0 + e) * (1.0 + e));
 }
 
-Vector3d TrowbridgeReitzDistribution::sample(const Vector3d& wo,
-                                             const Point2d& rands) const {
-    Vector3d wh;
+Vector3 TrowbridgeReitzDistribution::sample(const Vector3& wo,
+                                            const Point2d& rands) const {
+    Vector3 wh;
     if (!sampleVisibleArea_) {
         double cosTheta = 0.0;
         double phi = (2.0 * PI) * rands[1];
@@ -236,9 +236,9 @@ Vector3d TrowbridgeReitzDistribution::sample(const Vector3d& wo,
             cosTheta = 1.0 / std::sqrt(1.0 + tanTheta2);
         }
         double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
-        wh = Vector3d(std::cos(phi) * sinTheta,
-                      std::sin(phi) * sinTheta,
-                      cosTheta);
+        wh = Vector3(std::cos(phi) * sinTheta,
+                     std::sin(phi) * sinTheta,
+                     cosTheta);
         if (!vect::sameHemisphere(wo, wh)) wh = -wh;
     } else {
         bool flip = wo.z() < 0.0;
@@ -254,7 +254,7 @@ double TrowbridgeReitzDistribution::roughnessToAlpha(double rough) {
     return 1.62142 + x * (0.819955 + x * (0.1734 +  x * (0.0171201 + 0.000640711 * x)));
 }
 
-double TrowbridgeReitzDistribution::lambda(const Vector3d& w) const {
+double TrowbridgeReitzDistribution::lambda(const Vector3& w) const {
     double absTanTheta = std::abs(vect::tanTheta(w));
     if (std::isinf(absTanTheta)) return 0.0;
 
@@ -274,7 +274,7 @@ BeckmannDistribution::BeckmannDistribution(double alphax, double alphay, bool sa
     : MicrofacetDistribution{alphax, alphay, sampleVis} {
 }
 
-double BeckmannDistribution::D(const Vector3d &wh) const {
+double BeckmannDistribution::D(const Vector3 &wh) const {
     // See P.15 of [Heitz et al. 2014]
     // "Understanding the Masking-Shadowing Function in Micorfacet-Based BRDFs"
     const double tan2Theta = vect::tan2Theta(wh);
@@ -287,7 +287,7 @@ double BeckmannDistribution::D(const Vector3d &wh) const {
     return std::exp(-tan2Theta * alpha_b_2) / (PI * alphax_ * alphay_ * cos4Theta);
 }
 
-Vector3d BeckmannDistribution::sample(const Vector3d &wo, const Point2d &rands) const {
+Vector3 BeckmannDistribution::sample(const Vector3 &wo, const Point2d &rands) const {
     if (!sampleVisibleArea_) {
         double tan2Theta, phi;
         if (alphax_ == alphay_) {
@@ -295,14 +295,14 @@ Vector3d BeckmannDistribution::sample(const Vector3d &wo, const Point2d &rands)
             // See Eq.(28) and (29) of [Walter et al. 2007].
             // "Microfacet Models for Refraction through Rough Surfaces"
             const double logSample = std::log(1 - rands[0]);
-            Assertion(!std::isinf(logSample), "Invalid log sample detected!");
+            SPICA_PARANOID_CHECK(!std::isinf(logSample), "Invalid log sample detected!");
 
             tan2Theta = -alphax_ * alphax_ * logSample;
             phi = 2.0 * PI * rands[1];
         } else {
             // Sample theta_m and phi_m on the anisotropic rough surface.
             const double logSample = std::log(1 - rands[0]);
-            Assertion(!std::isinf(logSample), "Invalid log sample detected!");
+            SPICA_PARANOID_CHECK(!std::isinf(logSample), "Invalid log sample detected!");
 
             // Derived from the equation on P.15 of [Heitz et al. 2014]
             phi = std::atan(alphay_ / alphax_ * std::tan(2.0 * PI * rands[1] + 0.5 * PI));
@@ -321,11 +321,11 @@ Vector3d BeckmannDistribution::sample(const Vector3d &wo, const Point2d &rands)
         const double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
         const double cosPhi = std::cos(phi);
         const double sinPhi = std::sin(phi);
-        Vector3d wh(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
+        Vector3 wh(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
         if (!vect::sameHemisphere(wo, wh)) wh = -wh;
         return wh;
     } else {
-        Vector3d wh;
+        Vector3 wh;
         bool flip = wo.z() < 0.0;
         wh = beckmannSample(flip ? -wo : wo, alphax_, alphay_, rands[0], rands[1]);
         if (flip) wh = -wh;
@@ -339,7 +339,7 @@ double BeckmannDistribution::roughnessToAlpha(double rough) {
     return 1.62142 + x * (0.819955 + x * (0.1734 +  x * (0.0171201 + 0.000640711 * x)));
 }
 
-double BeckmannDistribution::lambda(const Vector3d &w) const {
+double BeckmannDistribution::lambda(const Vector3 &w) const {
     const double absTanTheta = std::abs(vect::tanTheta(w));
     if (std::isinf(absTanTheta)) {
         return 0.0;
@@ -17,15 +17,15 @@ class SPICA_EXPORTS MicrofacetDistribution {
 public:
     MicrofacetDistribution(double alphax, double alphay, bool sampleVisibleArea);
     virtual ~MicrofacetDistribution();
-    virtual double D(const Vector3d& wh) const = 0;
-    virtual double lambda(const Vector3d& w) const = 0;
-    double G1(const Vector3d& w, const Vector3d &wh) const;
-    double G(const Vector3d& wo, const Vector3d& wi, const Vector3d &wh) const;
+    virtual double D(const Vector3& wh) const = 0;
+    virtual double lambda(const Vector3& w) const = 0;
+    double G1(const Vector3& w, const Vector3 &wh) const;
+    double G(const Vector3& wo, const Vector3& wi, const Vector3 &wh) const;
 
     //! Sample half-vector wh
-    virtual Vector3d sample(const Vector3d &wo, const Point2d& rands) const = 0;
+    virtual Vector3 sample(const Vector3 &wo, const Point2d& rands) const = 0;
 
-    double pdf(const Vector3d& wo, const Vector3d& wh) const;
+    double pdf(const Vector3& wo, const Vector3& wh) const;
     inline double alphax() const { return alphax_; }
     inline double alphay() const { return alphay_; }
 
@@ -42,14 +42,14 @@ public:
     TrowbridgeReitzDistribution(double alphax, double alphay,
                                 bool samplevis = true);
 
-    double D(const Vector3d& wh) const override;
-    Vector3d sample(const Vector3d& wo, const Point2d& rands) const override;
+    double D(const Vector3& wh) const override;
+    Vector3 sample(const Vector3& wo, const Point2d& rands) const override;
 
     static double roughnessToAlpha(double rough);
 
 private:
     // Private methods
-    double lambda(const Vector3d& w) const override;
+    double lambda(const Vector3& w) const override;
 };
 
 /**
@@ -59,14 +59,14 @@ class SPICA_EXPORTS BeckmannDistribution : public MicrofacetDistribution {
 public:
     BeckmannDistribution(double alphax, double alphay, bool sampleVis = true);
     
-    double D(const Vector3d &wh) const override;
-    Vector3d sample(const Vector3d &wo, const Point2d &rands) const override;
+    double D(const Vector3 &wh) const override;
+    Vector3 sample(const Vector3 &wo, const Point2d &rands) const override;
 
     static double roughnessToAlpha(double rough);
 
 private:
     // Private methods
-    double lambda(const Vector3d &w) const override;
+    double lambda(const Vector3 &w) const override;
 };
  
 }  // namespace spica
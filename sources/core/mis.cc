@@ -45,7 +45,7 @@ Spectrum estimateDirectLight(const Interaction& intr,
     Spectrum Ld(0.0);
 
     // Sample light with multiple importance sampling
-    Vector3d wi;
+    Vector3 wi;
     VisibilityTester vis;
     double lightPdf = 0.0, bsdfPdf = 0.0;
     Spectrum Li = light.sampleLi(intr, randLight, &wi, &lightPdf, &vis);
@@ -75,10 +75,10 @@ Spectrum estimateDirectLight(const Interaction& intr,
 
             if (!Li.isBlack()) {
                 if (light.isDelta()) {
-                    Ld += f * Li / lightPdf;
+                    Ld = Spectrum::fma(f * Li, 1.0 / lightPdf, Ld);
                 } else {
                     const double weight = powerHeuristic(1, lightPdf, 1, bsdfPdf);
-                    Ld += f * Li * weight / lightPdf;
+                    Ld = Spectrum::fma(f * Li, weight / lightPdf, Ld);
                 }
             }
         }
@@ -128,7 +128,7 @@ Spectrum estimateDirectLight(const Interaction& intr,
             }
 
             if (!Li.isBlack()) {
-                Ld += f * Li * Tr * weight / bsdfPdf;
+                Ld = Spectrum::fma(f * Li * Tr, weight / bsdfPdf, Ld);
             }
         }
     }
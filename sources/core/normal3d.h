@@ -37,8 +37,8 @@ public:
     inline T y() const { return y_; }
     inline T z() const { return z_; }
 
-    double norm() const;
-    double squaredNorm() const;
+    T norm() const;
+    T squaredNorm() const;
     Normal3_<T> normalized() const;
 
     std::string toString() const;
@@ -55,6 +55,7 @@ private:
 
 using Normal3f = Normal3_<float>;
 using Normal3d = Normal3_<double>;
+using Normal3 = Normal3_<Float>;  // Precision of the geometry
 
 }  // namespace spica
 
@@ -68,13 +69,13 @@ template <class T>
 spica::Normal3_<T> operator-(const spica::Normal3_<T>& n1, const spica::Normal3_<T>& n2);
 
 template <class T>
-spica::Normal3_<T> operator*(const spica::Normal3_<T>& n, T s);
+spica::Normal3_<T> operator*(const spica::Normal3_<T>& n, typename spica::Normal3_<T>::type s);
 
 template <class T>
-spica::Normal3_<T> operator*(T s, const spica::Normal3_<T>& n);
+spica::Normal3_<T> operator*(typename spica::Normal3_<T>::type s, const spica::Normal3_<T>& n);
 
 template <class T>
-spica::Normal3_<T> operator/(const spica::Normal3_<T>& n, T s);
+spica::Normal3_<T> operator/(const spica::Normal3_<T>& n, typename spica::Normal3_<T>::type s);
 
 
 #include "normal3d_detail.h"
@@ -119,12 +119,12 @@ namespace spica {
     }
 
     template <class T>
-    double Normal3_<T>::norm() const {
-        return sqrt(squaredNorm());
+    T Normal3_<T>::norm() const {
+        return std::sqrt(squaredNorm());
     }
 
     template <class T>
-    double Normal3_<T>::squaredNorm() const {
+    T Normal3_<T>::squaredNorm() const {
         return x_ * x_ + y_ * y_ + z_ * z_;
     }
 
@@ -156,21 +156,21 @@ spica::Normal3_<T> operator-(const spica::Normal3_<T>& n1, const spica::Normal3_
 }
 
 template <class T>
-spica::Normal3_<T> operator*(const spica::Normal3_<T>& n, T s) {
+spica::Normal3_<T> operator*(const spica::Normal3_<T>& n, typename spica::Normal3_<T>::type s) {
     spica::Normal3_<T> ret = n;
     ret *= s;
     return ret;
 }
 
 template <class T>
-spica::Normal3_<T> operator*(T s, const spica::Normal3_<T>& n) {
+spica::Normal3_<T> operator*(typename spica::Normal3_<T>::type s, const spica::Normal3_<T>& n) {
     spica::Normal3_<T> ret = n;
     ret *= s;
     return ret;
 }
 
 template <class T>
-spica::Normal3_<T> operator/(const spica::Normal3_<T>& n, T s) {
+spica::Normal3_<T> operator/(const spica::Normal3_<T>& n, typename spica::Normal3_<T>::type s) {
     spica::Normal3_<T> ret = n;
     ret /= s;
     return ret;
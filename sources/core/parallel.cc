@@ -2,12 +2,15 @@
 #include "parallel.h"
 
 #include <cstring>
+#include <memory>
 #include <vector>
-#include <queue>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 
+#include "core/float.h"
+
 static int numUserThreads = std::thread::hardware_concurrency();
 
 namespace spica {
@@ -45,123 +48,412 @@ void AtomicDouble::add(double v) {
     } while (!bits.compare_exchange_weak(oldBits, newBits));    
 }
 
+AtomicFloat::AtomicFloat(float v)
+    : bits(floatToBits(v)) {
+}
+
+AtomicFloat::operator float() const {
+    return bitsToFloat(bits.load());
+}
+
+float AtomicFloat::operator=(float v) {
+    bits.store(floatToBits(v));
+    return v;
+}
+
+void AtomicFloat::add(float v) {
+    uint32_t oldBits = bits.load();
+    uint32_t newBits;
+    do {
+        newBits = floatToBits(bitsToFloat(oldBits) + v);
+    } while (!bits.compare_exchange_weak(oldBits, newBits));
+}
+
 }  // namespace spica
 
+static thread_local int threadID = 0;
+
+namespace {
+
+/**
+ * Range of loop iterations [begin, end).
+ */
+struct WorkRange {
+    int begin, end;
+
+    int size() const { return end - begin; }
+};
+
+inline uint64_t packRange(const WorkRange& r) {
+    return ((uint64_t)(uint32_t)r.begin << 32) | (uint64_t)(uint32_t)r.end;
+}
+
+inline WorkRange unpackRange(uint64_t v) {
+    return { (int)(uint32_t)(v >> 32), (int)(uint32_t)(v & 0xffffffff) };
+}
+
+/**
+ * Chase-Lev work-stealing deque of iteration ranges.
+ * @details
+ * The owner thread pushes and pops at the bottom, and the other threads
+ * steal from the top. The capacity is fixed because ranges are split lazily
+ * and a deque rarely holds more than a few of them. When it is full, the
+ * owner simply keeps the range to itself.
+ */
+class WorkStealingQueue {
+public:
+    static const int kCapacity = 64;
+
+    WorkStealingQueue() {
+    }
+
+    bool empty() const {
+        return bottom_.load() <= top_.load();
+    }
+
+    bool push(const WorkRange& r) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= kCapacity) return false;
+
+        buffer_[b % kCapacity].store(packRange(r), std::memory_order_relaxed);
+        bottom_.store(b + 1);
+        return true;
+    }
+
+    bool pop(WorkRange* r) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b);
+        int64_t t = top_.load();
+
+        bool success = false;
+        if (t <= b) {
+            *r = unpackRange(buffer_[b % kCapacity].load(std::memory_order_relaxed));
+            success = true;
+            if (t == b) {
+                // The last item may also be taken by a thief.
+                success = top_.compare_exchange_strong(t, t + 1);
+                bottom_.store(b + 1);
+            }
+        } else {
+            bottom_.store(b + 1);
+        }
+        return success;
+    }
+
+    bool steal(WorkRange* r) {
+        int64_t t = top_.load();
+        const int64_t b = bottom_.load();
+        if (t >= b) return false;
+
+        const uint64_t v = buffer_[t % kCapacity].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1)) return false;
+
+        *r = unpackRange(v);
+        return true;
+    }
+
+private:
+    // Owner and thieves update different ends, so keep them on separate lines.
+    alignas(64) std::atomic<int64_t> top_{ 0 };
+    alignas(64) std::atomic<int64_t> bottom_{ 0 };
+    std::atomic<uint64_t> buffer_[kCapacity];
+};
+
+}  // anonymous namespace
+
 class WorkerTask;
 
-static thread_local int threadID;
+static std::vector<std::thread> workerThreads;
+static bool shutdownWorkers = false;
+static WorkerTask* workerList = nullptr;
+static int numActiveTasks = 0;
+static std::atomic<int> numSleepingThreads(0);
 static std::mutex workerListMutex;
-static std::condition_variable condval;
-static WorkerTask* workerTask;
+static std::condition_variable workerListCondition;
+static std::mutex workerThreadsMutex;
+
+// Wakes up sleeping threads after new work becomes available.
+static void notifyWorkAvailable() {
+    if (numSleepingThreads.load() > 0) {
+        std::lock_guard<std::mutex> lock(workerListMutex);
+        workerListCondition.notify_all();
+    }
+}
 
+/**
+ * Loop iterations submitted by a single parallel_for call.
+ * @details
+ * Each participating thread owns one deque of the task, indexed by its thread
+ * ID. A thread runs the ranges in its own deque, and steals ranges from the
+ * other deques when its own one becomes empty. Tasks are kept in a linked list
+ * so that nested and concurrent calls share the same worker threads.
+ */
 class WorkerTask {
 public:
-    WorkerTask(const std::function<void(int)>& f, int csize, int tasks)
+    WorkerTask(const std::function<void(int)>& f, int start, int end,
+               ParallelSchedule sched, int nThreads, int slot)
         : func{ f }
-        , chunkSize{ csize }
-        , nTasks { tasks } {
+        , schedule{ sched }
+        , numSlots{ nThreads }
+        , queues{ new WorkStealingQueue[nThreads] }
+        , remaining{ end - start } {
+        if (schedule == ParallelSchedule::Static) {
+            // Equal blocks are placed in every deque, and split no more.
+            const int blockSize = (end - start + nThreads - 1) / nThreads;
+            for (int i = 0; i < nThreads; i++) {
+                const int blockStart = std::min(end, start + i * blockSize);
+                const int blockEnd   = std::min(end, blockStart + blockSize);
+                if (blockStart < blockEnd) {
+                    queues[i].push({ blockStart, blockEnd });
+                }
+            }
+        } else {
+            queues[slot].push({ start, end });
+        }
+    }
+
+    bool hasQueuedWork() const {
+        for (int i = 0; i < numSlots; i++) {
+            if (!queues[i].empty()) return true;
+        }
+        return false;
     }
 
     bool finished() const {
-        return currentIndex >= nTasks && activeWorkers == 0;
+        return remaining.load() == 0 && activeWorkers == 0;
+    }
+
+    // Runs the ranges in the deque of the slot, and then steals from the
+    // others until no range is left. Returns true if any work is done.
+    bool run(int slot) {
+        bool worked = false;
+        WorkRange r;
+        for (;;) {
+            while (queues[slot].pop(&r)) {
+                runRange(slot, r);
+                worked = true;
+            }
+
+            if (!steal(slot, &r)) break;
+            runRange(slot, r);
+            worked = true;
+        }
+        return worked;
     }
 
     const std::function<void(int)>& func;
-    const int chunkSize;
-    const int nTasks;
-    bool isWorking = false;
-    int currentIndex = 0;
+    const ParallelSchedule schedule;
+    const int numSlots;
+    std::unique_ptr<WorkStealingQueue[]> queues;
+    std::atomic<int> remaining;
     int activeWorkers = 0;
-};
+    WorkerTask* next = nullptr;
 
-class WorkerTaskManager {
-public:
-    WorkerTaskManager(const std::function<void(int)>& f,
-                      int chunkSize, int nTasks) {
-        if (workerTask == nullptr) {
-            workerTask = new WorkerTask(f, chunkSize, nTasks);
+private:
+    bool steal(int slot, WorkRange* r) {
+        // Victims are visited from a random position to spread the thieves.
+        static thread_local uint32_t seed = 0x9e3779b9u * (threadID + 1);
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        const int offset = seed % numSlots;
+        for (int i = 0; i < numSlots; i++) {
+            const int victim = (offset + i) % numSlots;
+            if (victim == slot) continue;
+
+            while (!queues[victim].empty()) {
+                if (queues[victim].steal(r)) return true;
+            }
         }
+        return false;
     }
 
-    ~WorkerTaskManager() {
-        delete workerTask;
-        workerTask = nullptr;
+    // Puts the range back to the deque so that the other threads can steal it.
+    bool share(int slot, const WorkRange& r) {
+        if (!queues[slot].push(r)) return false;
+        notifyWorkAvailable();
+        return true;
+    }
+
+    void runRange(int slot, WorkRange r) {
+        switch (schedule) {
+        case ParallelSchedule::Static:
+            break;
+
+        case ParallelSchedule::Dynamic:
+            // Lazy binary splitting: the upper half of the range is shared
+            // only when the deque is empty, i.e., its work has been stolen.
+            {
+                int count = 0;
+                for (; r.begin < r.end; r.begin++, count++) {
+                    if (r.size() > 1 && queues[slot].empty()) {
+                        const int mid = r.begin + r.size() / 2;
+                        if (share(slot, { mid, r.end })) {
+                            r.end = mid;
+                        }
+                    }
+                    func(r.begin);
+                }
+                remaining -= count;
+            }
+            return;
+
+        case ParallelSchedule::Guided:
+            // Chunk sizes decrease in proportion to the remaining iterations.
+            {
+                const int chunkSize = std::max(1, r.size() / numSlots);
+                if (r.size() > chunkSize && share(slot, { r.begin + chunkSize, r.end })) {
+                    r.end = r.begin + chunkSize;
+                }
+            }
+            break;
+        }
+
+        for (int i = r.begin; i < r.end; i++) {
+            func(i);
+        }
+        remaining -= r.size();
     }
 };
 
+static void removeWorkerTask(WorkerTask* task) {
+    WorkerTask** it = &workerList;
+    while (*it != nullptr) {
+        if (*it == task) {
+            *it = task->next;
+            return;
+        }
+        it = &(*it)->next;
+    }
+}
+
 static void workerThreadFunc(int threadIndex) {
     threadID = threadIndex;
     std::unique_lock<std::mutex> lock(workerListMutex);
-    while (!workerTask->finished()) {
-        if (!workerTask->isWorking) {
-            condval.wait(lock);
-        } else {
-            int indexStart = workerTask->currentIndex;
-            int indexEnd   = std::min(workerTask->nTasks, indexStart + workerTask->chunkSize);
-            workerTask->currentIndex = indexEnd;
-            if (workerTask->currentIndex == workerTask->nTasks) {
-                workerTask->isWorking = false;
-            }
-            workerTask->activeWorkers++;
+    while (!shutdownWorkers) {
+        bool worked = false;
+        for (WorkerTask* task = workerList; task != nullptr; task = task->next) {
+            // The task may be submitted before the workers are rebuilt.
+            if (threadIndex >= task->numSlots) continue;
+
+            task->activeWorkers++;
             lock.unlock();
 
-            for (int i = indexStart; i < indexEnd; i++) {
-                workerTask->func(i);
-            }
+            worked |= task->run(threadIndex);
+
             lock.lock();
+            task->activeWorkers--;
+            if (task->finished()) {
+                workerListCondition.notify_all();
+            }
+        }
 
-            workerTask->activeWorkers--;
-            if (workerTask->finished()) {
-                printf("OK!!");
-                condval.notify_all();
+        if (!worked) {
+            // Sleep until a task is submitted or a range is shared. The counter
+            // is raised before the deques are checked, so that a thread
+            // sharing a range meanwhile always sees it.
+            numSleepingThreads++;
+            bool hasWork = false;
+            for (WorkerTask* task = workerList; task != nullptr; task = task->next) {
+                hasWork |= task->hasQueuedWork();
+            }
+            if (!hasWork && !shutdownWorkers) {
+                workerListCondition.wait(lock);
             }
+            numSleepingThreads--;
+        }
+    }
+}
+
+static void startWorkerThreads(int nWorkers) {
+    shutdownWorkers = false;
+    for (int i = 0; i < nWorkers; i++) {
+        workerThreads.emplace_back(workerThreadFunc, i + 1);
+    }
+}
+
+static void stopWorkerThreads() {
+    {
+        std::lock_guard<std::mutex> lock(workerListMutex);
+        shutdownWorkers = true;
+    }
+    workerListCondition.notify_all();
+
+    for (auto& t : workerThreads) {
+        t.join();
+    }
+    workerThreads.clear();
+}
+
+// Worker threads are created on the first call of parallel_for and live until
+// the program exits (or the number of threads is changed).
+static struct WorkerThreadsCleanup {
+    ~WorkerThreadsCleanup() {
+        std::lock_guard<std::mutex> lock(workerThreadsMutex);
+        stopWorkerThreads();
+    }
+} workerThreadsCleanup;
+
+static int prepareWorkerThreads(int nThreads) {
+    std::lock_guard<std::mutex> lock(workerThreadsMutex);
+    if ((int)workerThreads.size() != nThreads - 1) {
+        // Worker threads are rebuilt only while no task is running, so that a
+        // nested call never tries to join the thread that is executing it.
+        bool idle;
+        {
+            std::lock_guard<std::mutex> listLock(workerListMutex);
+            idle = numActiveTasks == 0;
+        }
+
+        if (idle) {
+            stopWorkerThreads();
+            startWorkerThreads(nThreads - 1);
         }
     }
+    return (int)workerThreads.size() + 1;
 }
 
 void parallel_for(int start, int end, const std::function<void(int)>& func,
                   ParallelSchedule schedule) {
     const int nTasks = (end - start);
-    const int nThreads = numSystemThreads();
-    const int chunkSize = schedule == ParallelSchedule::Dynamic ? 1 : (nTasks + nThreads - 1) / nThreads;
-    WorkerTaskManager manager(func, chunkSize, nTasks);    
+    if (nTasks <= 0) return;
 
-    std::vector<std::thread> threads;
-    threadID = 0;
-    for (int i = 0; i < nThreads - 1; i++) {
-        threads.emplace_back(workerThreadFunc, i + 1);
+    if (numSystemThreads() == 1 || nTasks == 1) {
+        for (int i = start; i < end; i++) {
+            func(i);
+        }
+        return;
     }
 
-    workerListMutex.lock();
-    workerTask->isWorking = true;
-    workerListMutex.unlock();
+    const int nThreads = prepareWorkerThreads(numSystemThreads());
+    const int slot = getThreadID();
+    WorkerTask task(func, start, end, schedule, nThreads, slot);
 
-    {
-        std::unique_lock<std::mutex> lock(workerListMutex);
-        condval.notify_all();
-
-        while (!workerTask->finished()) {
-            int indexStart = workerTask->currentIndex;
-            int indexEnd   = std::min(workerTask->nTasks, indexStart + workerTask->chunkSize);
-            workerTask->currentIndex = indexEnd;
-            if (workerTask->currentIndex == workerTask->nTasks) {
-                workerTask->isWorking = false;
-            }
-            workerTask->activeWorkers++;
-            lock.unlock();
+    std::unique_lock<std::mutex> lock(workerListMutex);
+    task.next = workerList;
+    workerList = &task;
+    numActiveTasks++;
+    workerListCondition.notify_all();
 
-            for (int i = indexStart; i < indexEnd; i++) {
-                workerTask->func(i);
-            }
-            lock.lock();
-            workerTask->activeWorkers--;
-        }
-        condval.notify_all();
-    }
+    // The calling thread also processes its own task, and then waits for
+    // the other threads running the remaining ranges.
+    for (;;) {
+        lock.unlock();
+        task.run(slot);
+        lock.lock();
 
-    for (auto& t : threads) {
-        t.join();
+        if (task.finished()) break;
+
+        numSleepingThreads++;
+        if (!task.hasQueuedWork()) {
+            workerListCondition.wait(lock);
+        }
+        numSleepingThreads--;
     }
+    removeWorkerTask(&task);
+    numActiveTasks--;
 }
 
 int numSystemThreads() {
@@ -172,10 +464,12 @@ int getThreadID() {
     return threadID;
 }
 
-void setNumThreads(uint32_t n) {
+void setNumThreads(uint32_t n, bool oversubscribe) {
     if (n == 0) {
         numUserThreads = std::thread::hardware_concurrency();
+    } else if (oversubscribe) {
+        numUserThreads = n;
     } else {
         numUserThreads = std::min(n, std::thread::hardware_concurrency()); 
     }
-}
\ No newline at end of file
+}
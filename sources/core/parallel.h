@@ -24,18 +24,56 @@ private:
     std::atomic<uint64_t> bits;
 };
 
+class SPICA_EXPORTS AtomicFloat {
+public:
+    explicit AtomicFloat(float v = 0.0f);
+    explicit operator float() const;
+    float operator=(float v);
+    void add(float v);
+
+private:
+    std::atomic<uint32_t> bits;
+};
+
 }  // namespace spica
 
+/**
+ * Scheduling strategies of parallel_for.
+ * @details
+ * Every worker thread has its own work-stealing deque of iteration ranges,
+ * and an idle thread steals ranges from the others.
+ *   - Static: the range is split into equal blocks, one for each thread.
+ *   - Dynamic: the range is split in halves whenever the work of a thread
+ *              has been stolen (down to a single iteration).
+ *   - Guided: iterations are taken in chunks whose sizes decrease
+ *             proportionally to the number of remaining iterations.
+ */
 enum class ParallelSchedule {
     Static = 0x01,
-    Dynamic = 0x02
+    Dynamic = 0x02,
+    Guided = 0x03
 };
 
+/**
+ * Run func(i) for i in [start, end) on the worker threads.
+ * @details
+ * Worker threads are created at the first call and reused by the following
+ * calls. parallel_for can be called from inside another parallel_for, and from
+ * several threads at the same time. The calling thread also runs iterations
+ * and keeps its own ID returned by getThreadID().
+ */
 SPICA_EXPORTS void parallel_for(int start, int end, const std::function<void(int)>& func,
                                 ParallelSchedule schedule = ParallelSchedule::Dynamic);
 
 SPICA_EXPORTS int numSystemThreads();
 SPICA_EXPORTS int getThreadID();
-SPICA_EXPORTS void setNumThreads(uint32_t n);
+/**
+ * Set the number of the threads used by parallel_for. Zero uses all the
+ * hardware threads.
+ * @details
+ * The number is limited to the hardware threads unless "oversubscribe" is
+ * true, which is for testing the scheduling with more threads than cores.
+ */
+SPICA_EXPORTS void setNumThreads(uint32_t n, bool oversubscribe = false);
 
 #endif  // _SPICA_PARALLEL_H_
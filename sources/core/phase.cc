@@ -23,11 +23,11 @@ HenyeyGreenstein::HenyeyGreenstein(double g)
     : g_{ g } {
 }
 
-double HenyeyGreenstein::p(const Vector3d& wo, const Vector3d& wi) const {
+double HenyeyGreenstein::p(const Vector3& wo, const Vector3& wi) const {
     return phase::hg(vect::dot(wo, wi), g_);
 }
 
-double HenyeyGreenstein::sample(const Vector3d& wo, Vector3d* wi,
+double HenyeyGreenstein::sample(const Vector3& wo, Vector3* wi,
                                 const Point2d& rands) const {
     double cosTheta;
     if (std::abs(g_) < EPS) {
@@ -39,7 +39,7 @@ double HenyeyGreenstein::sample(const Vector3d& wo, Vector3d* wi,
 
     double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
     double phi = 2.0 * PI * rands[1];
-    Vector3d u, v;
+    Vector3 u, v;
     vect::coordinateSystem(wo, &u, &v);
 
     *wi = cos(phi) * sinTheta * u + sin(phi) * sinTheta * v -
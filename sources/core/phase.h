@@ -18,16 +18,16 @@ SPICA_EXPORTS double hg(double cosTheta, double g);
 
 class PhaseFunction {
 public:
-    virtual double p(const Vector3d& wo, const Vector3d& wi) const = 0;
-    virtual double sample(const Vector3d& wo, Vector3d* wi,
+    virtual double p(const Vector3& wo, const Vector3& wi) const = 0;
+    virtual double sample(const Vector3& wo, Vector3* wi,
                           const Point2d& rands) const = 0;
 };
 
 class HenyeyGreenstein : public PhaseFunction {
 public:
     explicit HenyeyGreenstein(double g);
-    double p(const Vector3d& wo, const Vector3d& wi) const;
-    double sample(const Vector3d& wo, Vector3d* wi,
+    double p(const Vector3& wo, const Vector3& wi) const;
+    double sample(const Vector3& wo, Vector3* wi,
                   const Point2d& rands) const;
 
 private:
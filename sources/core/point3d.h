@@ -54,6 +54,7 @@ namespace spica {
     using Point3i = Point3_<int>;
     using Point3f = Point3_<float>;
     using Point3d = Point3_<double>;
+    using Point3 = Point3_<Float>;  // Precision of the geometry
 
 }  // namespace spica
 
@@ -73,13 +74,13 @@ template <class T>
 spica::Vector3_<T> operator-(const spica::Point3_<T>& p1, const spica::Point3_<T>& p2);
 
 template <class T>
-spica::Point3_<T> operator*(const spica::Point3_<T>& p, T s);
+spica::Point3_<T> operator*(const spica::Point3_<T>& p, typename spica::Point3_<T>::type s);
 
 template <class T>
-spica::Point3_<T> operator*(T s, const spica::Point3_<T>& p);
+spica::Point3_<T> operator*(typename spica::Point3_<T>::type s, const spica::Point3_<T>& p);
 
 template <class T>
-spica::Point3_<T> operator/(const spica::Point3_<T>& p, T s);
+spica::Point3_<T> operator/(const spica::Point3_<T>& p, typename spica::Point3_<T>::type s);
 
 #include "point3d_detail.h"
 
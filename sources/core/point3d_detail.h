@@ -157,21 +157,21 @@ spica::Vector3_<T> operator-(const spica::Point3_<T>& p1, const spica::Point3_<T
 }
 
 template <class T>
-spica::Point3_<T> operator*(const spica::Point3_<T>& p, T s) {
+spica::Point3_<T> operator*(const spica::Point3_<T>& p, typename spica::Point3_<T>::type s) {
     spica::Point3_<T> ret = p;
     ret *= s;
     return ret;
 }
 
 template <class T>
-spica::Point3_<T> operator*(T s, const spica::Point3_<T>& p) {
+spica::Point3_<T> operator*(typename spica::Point3_<T>::type s, const spica::Point3_<T>& p) {
     spica::Point3_<T> ret = p;
     ret *= s;
     return ret;
 }
 
 template <class T>
-spica::Point3_<T> operator/(const spica::Point3_<T>& p, T s) {
+spica::Point3_<T> operator/(const spica::Point3_<T>& p, typename spica::Point3_<T>::type s) {
     spica::Point3_<T> ret = p;
     ret /= s;
     return ret;
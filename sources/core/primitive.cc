@@ -12,6 +12,12 @@ namespace spica {
 // Primitive method definitions
 // -----------------------------------------------------------------------------
 
+void Aggregate::computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                          SurfaceInteraction* isect) const {
+    // The hit record refers to the primitive that is actually hit.
+    hit.primitive->computeSurfaceInteraction(ray, hit, isect);
+}
+
 const Light* Aggregate::light() const {
     Warning("Deprecated function!!");
     return nullptr;
@@ -42,14 +48,31 @@ GeometricPrimitive::GeometricPrimitive(const std::shared_ptr<Shape>& shape,
     , mediumInterface_{ mediumInterface } {
 }
 
-Bounds3d GeometricPrimitive::worldBound() const {
+Bounds3 GeometricPrimitive::worldBound() const {
     return shape_->worldBound();
 }
 
 bool GeometricPrimitive::intersect(Ray& ray, SurfaceInteraction* isect) const {
-    double tHit;
-    if (!shape_->intersect(ray, &tHit, isect)) return false;
+    HitRecord hit;
+    if (!hitTest(ray, &hit)) return false;
+    computeSurfaceInteraction(ray, hit, isect);
+    return true;
+}
+
+bool GeometricPrimitive::hitTest(Ray& ray, HitRecord* hit) const {
+    double tHit, b1, b2;
+    if (!shape_->hitTest(ray, &tHit, &b1, &b2)) return false;
     ray.setMaxDist(tHit);
+    hit->t = tHit;
+    hit->primitive = this;
+    hit->b1 = b1;
+    hit->b2 = b2;
+    return true;
+}
+
+void GeometricPrimitive::computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                                   SurfaceInteraction* isect) const {
+    shape_->computeSurfaceInteraction(ray, hit.t, hit.b1, hit.b2, isect);
     isect->setPrimitive(this);
 
     if (mediumInterface_ && mediumInterface_->isMediumTransition()) {
@@ -57,8 +80,6 @@ bool GeometricPrimitive::intersect(Ray& ray, SurfaceInteraction* isect) const {
     } else {
         isect->setMediumInterface(MediumInterface(ray.medium()));
     }
-
-    return true;
 }
 
 bool GeometricPrimitive::intersect(Ray& ray) const {
@@ -16,12 +16,30 @@
 
 namespace spica {
 
+/**
+ * Lightweight record of a ray hit.
+ * @details
+ * Accelerators keep this record for the closest hit found so far, and the
+ * surface interaction is computed only once for the final hit.
+ */
+struct HitRecord {
+    double t = INFTY;
+    const Primitive* primitive = nullptr;  // primitive at the leaf level
+    double b1 = 0.0, b2 = 0.0;             // shape-specific (e.g., barycentrics)
+};
+
 class SPICA_EXPORTS Primitive : public CObject {
 public:
     virtual ~Primitive() {}
-    virtual Bounds3d worldBound() const = 0;
+    virtual Bounds3 worldBound() const = 0;
     virtual bool    intersect(Ray& ray, SurfaceInteraction* isect) const = 0;
     virtual bool    intersect(Ray& ray) const = 0;
+
+    //! Find the closest hit without computing its surface interaction.
+    //! "ray.maxDist()" is updated on hit as well as "intersect".
+    virtual bool    hitTest(Ray& ray, HitRecord* hit) const = 0;
+    virtual void    computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                              SurfaceInteraction* isect) const = 0;
     virtual const   Light* light() const = 0;
     virtual const   Material*  material()  const = 0;
     virtual std::vector<Triangle> triangulate() const = 0;
@@ -37,9 +55,12 @@ public:
                        const std::shared_ptr<Light>& areaLight = nullptr,
                        const std::shared_ptr<MediumInterface>& mediumInterface = nullptr);
 
-    virtual Bounds3d worldBound() const override;
+    virtual Bounds3 worldBound() const override;
     virtual bool intersect(Ray& ray, SurfaceInteraction* isect) const override;
     virtual bool intersect(Ray& ray) const override;
+    bool hitTest(Ray& ray, HitRecord* hit) const override;
+    void computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                   SurfaceInteraction* isect) const override;
 
     const Light* light() const override;
     const Material*  material()  const override;
@@ -58,6 +79,8 @@ private:
 
 class SPICA_EXPORTS Aggregate : public Primitive {
 public:
+    void computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                   SurfaceInteraction* isect) const override;
     const Light* light() const override;
     const Material*  material()  const override;
     void  setScatterFuncs(SurfaceInteraction* intr, 
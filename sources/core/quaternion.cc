@@ -23,7 +23,7 @@ namespace spica {
         , _w{w} {
     }
 
-    Quaternion::Quaternion(const Vector3d& v)
+    Quaternion::Quaternion(const Vector3& v)
         : Quaternion{v.x(), v.y(), v.z()} {
     }
 
@@ -57,23 +57,23 @@ namespace spica {
         return *this;
     }
 
-    Quaternion Quaternion::rotation(const Vector3d& axis, double theta) {
+    Quaternion Quaternion::rotation(const Vector3& axis, double theta) {
         double c = cos(theta * 0.5);
         double s = sin(theta * 0.5);
         return { axis.x() * s, axis.y() * s, axis.z() * s, c };
     }
 
-    Vector3d Quaternion::applyTo(const Vector3d& v) {
+    Vector3 Quaternion::applyTo(const Vector3& v) {
         Quaternion q{v};
         return ((*this) * q * (this->inverse())).toVector3d();
     }
 
-    Point3d Quaternion::applyTo(const Point3d& p) {
-        return Point3d(applyTo(Vector3d(p)));
+    Point3 Quaternion::applyTo(const Point3& p) {
+        return Point3(applyTo(Vector3(p)));
     }
 
-    Normal3d Quaternion::applyTo(const Normal3d& n) {
-        return Normal3d(applyTo(Vector3d(n)));
+    Normal3 Quaternion::applyTo(const Normal3& n) {
+        return Normal3(applyTo(Vector3(n)));
     }
 
     double Quaternion::squaredNorm() const {
@@ -90,8 +90,8 @@ namespace spica {
         return { -_x / sqnrm, -_y / sqnrm, -_z / sqnrm, _w / sqnrm };
     }
 
-    Vector3d Quaternion::toVector3d() const {
-        return Vector3d(_x, _y, _z);
+    Vector3 Quaternion::toVector3d() const {
+        return Vector3(_x, _y, _z);
     }
 
     std::string Quaternion::toString() const {
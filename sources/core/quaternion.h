@@ -36,7 +36,7 @@ namespace spica {
         /** The Quaternion constructor.
          *  @param v: The three-dimensional vector for imaginary parts.
          */
-        explicit Quaternion(const Vector3d& v);
+        explicit Quaternion(const Vector3& v);
 
         /** The Quaternion constructor (copy).
          */
@@ -58,13 +58,13 @@ namespace spica {
          *  @param axis: Rotation axis
          *  @param theta: Rotation angle by radii
          */
-        static Quaternion rotation(const Vector3d& axis, double theta);
+        static Quaternion rotation(const Vector3& axis, double theta);
 
         /** Apply transformation of quaternion to the vector.
          */
-        Vector3d applyTo(const Vector3d& v);
-        Point3d  applyTo(const Point3d& p);
-        Normal3d applyTo(const Normal3d& n);
+        Vector3 applyTo(const Vector3& v);
+        Point3  applyTo(const Point3& p);
+        Normal3 applyTo(const Normal3& n);
 
         /** Squared norm.
          */
@@ -80,7 +80,7 @@ namespace spica {
 
         /** Extract imaginary parts as a three-dimensional vector.
          */
-        Vector3d toVector3d() const;
+        Vector3 toVector3d() const;
 
         /** Convert to string
          */
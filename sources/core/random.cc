@@ -59,6 +59,7 @@ Thanks!
 #include "../core/common.h"
 
 #include "sampler.h"
+#include "checkpoint.h"
 
 namespace spica {
 
@@ -100,6 +101,16 @@ Point2d Random::get2D() {
     return Point2d(get1D(), get1D());
 }
 
+void Random::saveState(CheckpointWriter &writer) const {
+    writer.write(mt, N);
+    writer.write(mti);
+}
+
+void Random::loadState(CheckpointReader &reader) {
+    reader.read(mt, N);
+    reader.read(&mti);
+}
+
 /* initializes mt[N] with a seed */
 void Random::init_genrand(unsigned int s) {
     mt[0] = s & 0xffffffffU;
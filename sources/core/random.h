@@ -45,6 +45,12 @@ namespace spica {
         double get1D();
         Point2d get2D();
 
+        /** Write the state to the checkpoint. "loadState" continues the
+         *  sequence from it.
+         */
+        void saveState(CheckpointWriter &writer) const;
+        void loadState(CheckpointReader &reader);
+
     private:
         void init_genrand(unsigned int s);
         unsigned int genrand_int32(void);
@@ -9,7 +9,7 @@ namespace spica {
 Ray::Ray() {
 }
 
-Ray::Ray(const Point3d& origin, const Vector3d& direction, double maxDist,
+Ray::Ray(const Point3& origin, const Vector3& direction, double maxDist,
          const Medium* medium)
     : org_{ origin }
     , dir_{ direction.normalized() }
@@ -36,7 +36,7 @@ Ray& Ray::operator=(const Ray& ray) {
     return *this;
 }
 
-Point3d Ray::proceeded(double t) const {
+Point3 Ray::proceeded(double t) const {
     return org_ + t * dir_;
 }
 
@@ -25,7 +25,7 @@ class SPICA_EXPORTS Ray {
 public:
     // Public methods
     Ray();
-    Ray(const Point3d& origin, const Vector3d& direction, double maxDist = INFTY,
+    Ray(const Point3& origin, const Vector3& direction, double maxDist = INFTY,
         const Medium* medium = nullptr);
     Ray(const Ray& ray);
     virtual ~Ray();
@@ -33,11 +33,11 @@ public:
     Ray& operator=(const Ray& ray);
 
     //! Return the proceeded position of origin with distance "t".
-    Point3d proceeded(double t) const;
+    Point3 proceeded(double t) const;
 
-    inline Point3d  org()     const { return org_; }
-    inline Vector3d dir()     const { return dir_; }
-    inline Vector3d invdir()  const { return invdir_; }
+    inline Point3  org()     const { return org_; }
+    inline Vector3 dir()     const { return dir_; }
+    inline Vector3 invdir()  const { return invdir_; }
     inline double   maxDist() const { return maxDist_; }
     inline const Medium* medium() const { return medium_; }
     inline void     setMaxDist(double maxDist) { maxDist_ = maxDist; }
@@ -47,9 +47,9 @@ private:
     void calcInvdir();
 
     // Private fields
-    Point3d  org_     = { 0.0, 0.0, 0.0 };
-    Vector3d dir_     = { 0.0, 0.0, 0.0 };
-    Vector3d invdir_  = { INFTY, INFTY, INFTY };
+    Point3  org_     = { 0.0, 0.0, 0.0 };
+    Vector3 dir_     = { 0.0, 0.0, 0.0 };
+    Vector3 invdir_  = { INFTY, INFTY, INFTY };
     double   maxDist_ = INFTY;
     const Medium* medium_  = nullptr;
 };
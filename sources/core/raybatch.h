@@ -0,0 +1,63 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_RAYBATCH_H_
+#define _SPICA_RAYBATCH_H_
+
+#include <vector>
+
+#include "core/core.hpp"
+#include "core/common.h"
+#include "core/ray.h"
+#include "core/primitive.h"
+
+namespace spica {
+
+/**
+ * Rays which are traced together by "Accelerator::intersect" and
+ * "Accelerator::occluded".
+ * @details
+ * Accelerators may trace the consecutive rays of the batch as packets, so
+ * the rays should be coherent, e.g., sorted by their directions and
+ * origins. As the single ray tests, "maxDist" of the ray is updated on hit.
+ */
+class SPICA_EXPORTS RayBatch {
+public:
+    RayBatch() {}
+    explicit RayBatch(int capacity) { rays_.reserve(capacity); }
+
+    inline void clear() { rays_.clear(); }
+    inline void push(const Ray &ray) { rays_.push_back(ray); }
+
+    inline int size() const { return static_cast<int>(rays_.size()); }
+    inline Ray &operator[](int i) { return rays_[i]; }
+    inline const Ray &operator[](int i) const { return rays_[i]; }
+
+private:
+    std::vector<Ray> rays_;
+};
+
+/**
+ * Closest hits of the rays in a "RayBatch".
+ * The primitive of the hit record is nullptr if the ray hits nothing.
+ */
+class SPICA_EXPORTS HitBatch {
+public:
+    HitBatch() {}
+
+    //! Resize the batch and clear all the hit records.
+    inline void reset(int size) { hits_.assign(size, HitRecord()); }
+
+    inline int size() const { return static_cast<int>(hits_.size()); }
+    inline bool isHit(int i) const { return hits_[i].primitive != nullptr; }
+    inline HitRecord &operator[](int i) { return hits_[i]; }
+    inline const HitRecord &operator[](int i) const { return hits_[i]; }
+
+private:
+    std::vector<HitRecord> hits_;
+};
+
+}  // namespace spica
+
+#endif  // _SPICA_RAYBATCH_H_
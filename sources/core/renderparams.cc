@@ -1,10 +1,42 @@
 #define SPICA_API_EXPORT
 #include "renderparams.h"
 
+#include <mutex>
+
 #include "core/constant.h"
 
 namespace spica {
 
+namespace {
+
+// Shared lock for reading, or exclusive lock for writing (and removing).
+class ParamsLock {
+public:
+    ParamsLock(std::shared_mutex& mutex, bool exclusive)
+        : mutex_{ mutex }
+        , exclusive_{ exclusive } {
+        if (exclusive_) {
+            mutex_.lock();
+        } else {
+            mutex_.lock_shared();
+        }
+    }
+
+    ~ParamsLock() {
+        if (exclusive_) {
+            mutex_.unlock();
+        } else {
+            mutex_.unlock_shared();
+        }
+    }
+
+private:
+    std::shared_mutex& mutex_;
+    bool exclusive_;
+};
+
+}  // anonymous namespace
+
 RenderParams &RenderParams::getInstance() {
     static RenderParams instance;
     return instance;
@@ -22,6 +54,7 @@ RenderParams::RenderParams(RenderParams &&params)
 }
 
 RenderParams &RenderParams::operator=(RenderParams &&params) {
+    std::scoped_lock lock(mutex_, params.mutex_);
     this->bools = std::move(params.bools);
     this->ints = std::move(params.ints);
     this->doubles = std::move(params.doubles);
@@ -37,6 +70,7 @@ RenderParams &RenderParams::operator=(RenderParams &&params) {
 }
 
 void RenderParams::clear() {
+    ParamsLock lock(mutex_, true);
     bools.clear();
     ints.clear();
     doubles.clear();
@@ -52,77 +86,92 @@ void RenderParams::clear() {
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const bool &value) {
+    ParamsLock lock(mutex_, true);
     bools[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const int &value) {
+    ParamsLock lock(mutex_, true);
     ints[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const double &value) {
+    ParamsLock lock(mutex_, true);
     doubles[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const Point2d &value) {
+    ParamsLock lock(mutex_, true);
     point2ds[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const Vector2d &value) {
+    ParamsLock lock(mutex_, true);
     vector2ds[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const Bounds2d &value) {
+    ParamsLock lock(mutex_, true);
     bounds2ds[name] = value;
 }
 
 template <>
-void SPICA_EXPORTS RenderParams::add(const std::string &name, const Point3d &value) {
+void SPICA_EXPORTS RenderParams::add(const std::string &name, const Point3 &value) {
+    ParamsLock lock(mutex_, true);
     point3ds[name] = value;
 }
 
 template <>
-void SPICA_EXPORTS RenderParams::add(const std::string &name, const Vector3d &value) {
+void SPICA_EXPORTS RenderParams::add(const std::string &name, const Vector3 &value) {
+    ParamsLock lock(mutex_, true);
     vector3ds[name] = value;
 }
 
 template <>
-void SPICA_EXPORTS RenderParams::add(const std::string &name, const Bounds3d &value) {
+void SPICA_EXPORTS RenderParams::add(const std::string &name, const Bounds3 &value) {
+    ParamsLock lock(mutex_, true);
     bounds3ds[name] = value;
 }
 
 template <>
-void SPICA_EXPORTS RenderParams::add(const std::string &name, const Normal3d &value) {
+void SPICA_EXPORTS RenderParams::add(const std::string &name, const Normal3 &value) {
+    ParamsLock lock(mutex_, true);
     normals[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const Spectrum &value) {
+    ParamsLock lock(mutex_, true);
     spectrums[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const Transform &value) {
+    ParamsLock lock(mutex_, true);
     transforms[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const std::string &value) {
+    ParamsLock lock(mutex_, true);
     strings[name] = value;
 }
 
 template <>
 void SPICA_EXPORTS RenderParams::add(const std::string &name, const std::shared_ptr<CObject> &value) {
+    ParamsLock lock(mutex_, true);
     objects[name] = value;
 }
  
 bool RenderParams::getBool(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = bools.find(name);
-    Assertion(it != bools.cend(), "Bool not found: name = %s", name.c_str());
+    SPICA_CHECK(it != bools.cend(), "Bool not found: name = %s", name.c_str());
 
     if (remove) {
         bool ret = it->second;
@@ -133,6 +182,7 @@ bool RenderParams::getBool(const std::string &name, bool remove) {
 }
 
 bool RenderParams::getBool(const std::string &name, bool value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = bools.find(name);
     if (it != bools.cend()) {
         if (remove) {
@@ -140,13 +190,15 @@ bool RenderParams::getBool(const std::string &name, bool value, bool remove) {
             bools.erase(it);
             return ret;
         }
+        return it->second;
     }
     return value;
 }
 
 int RenderParams::getInt(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = ints.find(name);
-    Assertion(it != ints.cend(), "Int not found: name = %s", name.c_str());
+    SPICA_CHECK(it != ints.cend(), "Int not found: name = %s", name.c_str());
 
     if (remove) {
         const int ret = it->second;
@@ -157,6 +209,7 @@ int RenderParams::getInt(const std::string &name, bool remove) {
 }
 
 int RenderParams::getInt(const std::string &name, int value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = ints.find(name);
     if (it != ints.cend()) {
         if (remove) {
@@ -171,8 +224,9 @@ int RenderParams::getInt(const std::string &name, int value, bool remove) {
 }
 
 double RenderParams::getDouble(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = doubles.find(name);
-    Assertion(it != doubles.cend(), "Double not found: name = %s", name.c_str());
+    SPICA_CHECK(it != doubles.cend(), "Double not found: name = %s", name.c_str());
 
     if (remove) {
         const double ret = it->second;
@@ -183,6 +237,7 @@ double RenderParams::getDouble(const std::string &name, bool remove) {
 }
 
 double RenderParams::getDouble(const std::string &name, double value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = doubles.find(name);
     if (it != doubles.cend()) {
         if (remove) {
@@ -197,8 +252,9 @@ double RenderParams::getDouble(const std::string &name, double value, bool remov
 }
 
 std::string RenderParams::getString(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = strings.find(name);
-    Assertion(it != strings.cend(), "String not found: name = %s", name.c_str());
+    SPICA_CHECK(it != strings.cend(), "String not found: name = %s", name.c_str());
 
     if (remove) {
         const std::string ret = it->second;
@@ -209,10 +265,11 @@ std::string RenderParams::getString(const std::string &name, bool remove) {
 }
 
 std::string RenderParams::getString(const std::string &name, const std::string &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = strings.find(name);
     if (it != strings.cend()) {
         if (remove) {
-            const std::string &ret = it->second;
+            const std::string ret = it->second;
             strings.erase(it);
             return ret;
         }
@@ -223,11 +280,12 @@ std::string RenderParams::getString(const std::string &name, const std::string &
 }
 
 Point2d RenderParams::getPoint2d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = point2ds.find(name);
-    Assertion(it != point2ds.cend(), "Point2d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != point2ds.cend(), "Point2d not found: name = %s", name.c_str());
 
     if (remove) {
-        const Point2d &ret = it->second;
+        const Point2d ret = it->second;
         point2ds.erase(it);
         return ret;
     }
@@ -235,11 +293,12 @@ Point2d RenderParams::getPoint2d(const std::string &name, bool remove) {
 }
 
 Vector2d RenderParams::getVector2d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = vector2ds.find(name);
-    Assertion(it != vector2ds.cend(), "Vector2d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != vector2ds.cend(), "Vector2d not found: name = %s", name.c_str());
 
     if (remove) {
-        const Vector2d &ret = it->second;
+        const Vector2d ret = it->second;
         vector2ds.erase(it);
         return ret;
     }
@@ -247,34 +306,37 @@ Vector2d RenderParams::getVector2d(const std::string &name, bool remove) {
 }
 
 Bounds2d RenderParams::getBounds2d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = bounds2ds.find(name);
-    Assertion(it != bounds2ds.cend(), "Bounds2d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != bounds2ds.cend(), "Bounds2d not found: name = %s", name.c_str());
 
     if (remove) {
-        const Bounds2d &ret = it->second;
+        const Bounds2d ret = it->second;
         bounds2ds.erase(it);
         return ret;
     }
     return it->second;
 }
 
-Point3d RenderParams::getPoint3d(const std::string &name, bool remove) {
+Point3 RenderParams::getPoint3d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = point3ds.find(name);
-    Assertion(it != point3ds.cend(), "Point3d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != point3ds.cend(), "Point3 not found: name = %s", name.c_str());
 
     if (remove) {
-        const Point3d &ret = it->second;
+        const Point3 ret = it->second;
         point3ds.erase(it);
         return ret;
     }
     return it->second;
 }
 
-Point3d RenderParams::getPoint3d(const std::string &name, const Point3d &value, bool remove) {
+Point3 RenderParams::getPoint3d(const std::string &name, const Point3 &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = point3ds.find(name);
     if (it != point3ds.cend()) {
         if (remove) {
-            const Point3d &ret = it->second;
+            const Point3 ret = it->second;
             point3ds.erase(it);
             return ret;
         }
@@ -283,36 +345,39 @@ Point3d RenderParams::getPoint3d(const std::string &name, const Point3d &value,
     return value;
 }
 
-Vector3d RenderParams::getVector3d(const std::string &name, bool remove) {
+Vector3 RenderParams::getVector3d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = vector3ds.find(name);
-    Assertion(it != vector3ds.cend(), "Vector3d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != vector3ds.cend(), "Vector3 not found: name = %s", name.c_str());
 
     if (remove) {
-        const Vector3d &ret = it->second;
+        const Vector3 ret = it->second;
         vector3ds.erase(it);
         return ret;
     }
     return it->second;
 }
 
-Bounds3d RenderParams::getBounds3d(const std::string &name, bool remove) {
+Bounds3 RenderParams::getBounds3d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = bounds3ds.find(name);
-    Assertion(it != bounds3ds.cend(), "Bounds3d not found: name = %s", name.c_str());
+    SPICA_CHECK(it != bounds3ds.cend(), "Bounds3 not found: name = %s", name.c_str());
 
     if (remove) {
-        const Bounds3d &ret = it->second;
+        const Bounds3 ret = it->second;
         bounds3ds.erase(it);
         return ret;
     }
     return it->second;
 }
 
-Normal3d RenderParams::getNormal3d(const std::string &name, bool remove) {
+Normal3 RenderParams::getNormal3d(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = normals.find(name);
-    Assertion(it != normals.cend(), "Normal not found: name = %s", name.c_str());
+    SPICA_CHECK(it != normals.cend(), "Normal not found: name = %s", name.c_str());
 
     if (remove) {
-        const Normal3d &ret = it->second;
+        const Normal3 ret = it->second;
         normals.erase(it);
         return ret;
     }
@@ -320,11 +385,12 @@ Normal3d RenderParams::getNormal3d(const std::string &name, bool remove) {
 }
 
 Spectrum RenderParams::getSpectrum(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = spectrums.find(name);
-    Assertion(it != spectrums.cend(), "Spectrum not found: name = %s", name.c_str());
+    SPICA_CHECK(it != spectrums.cend(), "Spectrum not found: name = %s", name.c_str());
 
     if (remove) {
-        const Spectrum &ret = it->second;
+        const Spectrum ret = it->second;
         spectrums.erase(it);
         return ret;
     }
@@ -332,10 +398,11 @@ Spectrum RenderParams::getSpectrum(const std::string &name, bool remove) {
 }
 
 Spectrum RenderParams::getSpectrum(const std::string &name, const Spectrum &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = spectrums.find(name);
     if (it != spectrums.cend()) {
         if (remove) {
-            const Spectrum &ret = it->second;
+            const Spectrum ret = it->second;
             spectrums.erase(it);
             return ret;
         }
@@ -346,8 +413,9 @@ Spectrum RenderParams::getSpectrum(const std::string &name, const Spectrum &valu
 }
 
 Transform RenderParams::getTransform(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = transforms.find(name);
-    Assertion(it != transforms.cend(), "Transform not found: name = %s", name.c_str());
+    SPICA_CHECK(it != transforms.cend(), "Transform not found: name = %s", name.c_str());
 
     if (remove) {
         const auto ret = it->second;
@@ -358,6 +426,7 @@ Transform RenderParams::getTransform(const std::string &name, bool remove) {
 }
 
 Transform RenderParams::getTransform(const std::string &name, const Transform &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = transforms.find(name);
     if (it != transforms.cend()) {
         if (remove) {
@@ -372,6 +441,7 @@ Transform RenderParams::getTransform(const std::string &name, const Transform &v
 }
 
 std::shared_ptr<CObject> RenderParams::getTexture(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = objects.find(name);
     if (it != objects.cend()) {
         if (remove) {
@@ -404,6 +474,7 @@ std::shared_ptr<CObject> RenderParams::getTexture(const std::string &name, bool
 }
 
 std::shared_ptr<CObject> RenderParams::getTexture(const std::string &name, const Spectrum &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = objects.find(name);
     if (it != objects.cend()) {
         if (remove) {
@@ -436,8 +507,9 @@ std::shared_ptr<CObject> RenderParams::getTexture(const std::string &name, const
 }
 
 std::shared_ptr<CObject> RenderParams::getObject(const std::string &name, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = objects.find(name);
-    Assertion(it != objects.cend(), "Object not found: name = %s", name.c_str());
+    SPICA_CHECK(it != objects.cend(), "Object not found: name = %s", name.c_str());
 
     if (remove) {
         const auto ret = it->second;
@@ -448,6 +520,7 @@ std::shared_ptr<CObject> RenderParams::getObject(const std::string &name, bool r
 }
 
 std::shared_ptr<CObject> RenderParams::getObject(const std::string &name, const std::shared_ptr<CObject> &value, bool remove) {
+    ParamsLock lock(mutex_, remove);
     const auto it = objects.find(name);
     if (it != objects.cend()) {
         if (remove) {
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <memory>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "common.h"
@@ -24,6 +25,13 @@ namespace spica {
 
 class CObject;
 
+/**
+ * Named rendering parameters.
+ * @details
+ * Getters and setters can be called from multiple threads at once. Reading
+ * a parameter still hashes its name, so per-ray code should resolve the
+ * parameters it needs beforehand, e.g., with "ParamHandle".
+ */
 class SPICA_EXPORTS RenderParams {
 public:
     static RenderParams &getInstance();
@@ -49,11 +57,11 @@ public:
     Point2d getPoint2d(const std::string &name, bool remove = false);
     Vector2d getVector2d(const std::string &name, bool remove = false);
     Bounds2d getBounds2d(const std::string &name, bool remove = false);
-    Point3d getPoint3d(const std::string &name, bool remove = false);
-    Point3d getPoint3d(const std::string &name, const Point3d &value, bool remove = false);
-    Vector3d getVector3d(const std::string &name, bool remove = false);
-    Bounds3d getBounds3d(const std::string &name, bool remove = false);
-    Normal3d getNormal3d(const std::string &name, bool remove = false);
+    Point3 getPoint3d(const std::string &name, bool remove = false);
+    Point3 getPoint3d(const std::string &name, const Point3 &value, bool remove = false);
+    Vector3 getVector3d(const std::string &name, bool remove = false);
+    Bounds3 getBounds3d(const std::string &name, bool remove = false);
+    Normal3 getNormal3d(const std::string &name, bool remove = false);
     Spectrum getSpectrum(const std::string &name, bool remove = false);
     Spectrum getSpectrum(const std::string &name, const Spectrum &value, bool remove = false);
     Transform getTransform(const std::string &name, bool remove = false);
@@ -70,22 +78,63 @@ private:
     
 private:
     // Private fields
+    mutable std::shared_mutex mutex_;
     std::unordered_map<std::string, bool> bools;
     std::unordered_map<std::string, int> ints;
     std::unordered_map<std::string, double> doubles;
     std::unordered_map<std::string, Point2d> point2ds;
     std::unordered_map<std::string, Vector2d> vector2ds;
     std::unordered_map<std::string, Bounds2d> bounds2ds;
-    std::unordered_map<std::string, Point3d> point3ds;
-    std::unordered_map<std::string, Vector3d> vector3ds;
-    std::unordered_map<std::string, Bounds3d> bounds3ds;
-    std::unordered_map<std::string, Normal3d> normals;
+    std::unordered_map<std::string, Point3> point3ds;
+    std::unordered_map<std::string, Vector3> vector3ds;
+    std::unordered_map<std::string, Bounds3> bounds3ds;
+    std::unordered_map<std::string, Normal3> normals;
     std::unordered_map<std::string, Spectrum> spectrums;
     std::unordered_map<std::string, Transform> transforms;
     std::unordered_map<std::string, std::string> strings;
     std::unordered_map<std::string, std::shared_ptr<CObject>> objects;
 };
 
+/**
+ * Typed parameter resolved once from "RenderParams".
+ * @details
+ * Integrators keep handles as members and resolve them at construction,
+ * so that reading a parameter in per-ray code is a plain load.
+ */
+template <class T>
+class ParamHandle {
+public:
+    //! Fixed value which is not read from parameters.
+    ParamHandle(const T& value = T{})
+        : value_{ value } {
+    }
+
+    //! Required parameter. Missing parameter is an error.
+    ParamHandle(RenderParams& params, const std::string& name)
+        : value_{ lookup(params, name, static_cast<T*>(nullptr)) } {
+    }
+
+    //! Optional parameter with the default value.
+    ParamHandle(RenderParams& params, const std::string& name, const T& value)
+        : value_{ lookup(params, name, value) } {
+    }
+
+    inline const T& get() const { return value_; }
+    inline operator const T&() const { return value_; }
+
+private:
+    static int lookup(RenderParams& p, const std::string& n, int*) { return p.getInt(n); }
+    static int lookup(RenderParams& p, const std::string& n, const int& v) { return p.getInt(n, v, false); }
+    static bool lookup(RenderParams& p, const std::string& n, bool*) { return p.getBool(n); }
+    static bool lookup(RenderParams& p, const std::string& n, const bool& v) { return p.getBool(n, v, false); }
+    static double lookup(RenderParams& p, const std::string& n, double*) { return p.getDouble(n); }
+    static double lookup(RenderParams& p, const std::string& n, const double& v) { return p.getDouble(n, v, false); }
+    static std::string lookup(RenderParams& p, const std::string& n, std::string*) { return p.getString(n); }
+    static std::string lookup(RenderParams& p, const std::string& n, const std::string& v) { return p.getString(n, v, false); }
+
+    T value_;
+};
+
 }  // namespace spica
 
 #endif  // _SPICA_RENDER_PARAMETERS_H_
@@ -0,0 +1,113 @@
+#define SPICA_API_EXPORT
+#include "samplemap.h"
+
+#include <algorithm>
+
+#include "core/film.h"
+
+namespace spica {
+
+namespace {
+
+/**
+ * Upper bound of the samples taken for a pixel in a pass, which keeps the
+ * passes short when only a few pixels remain noisy.
+ */
+const int kMaxPassSamples = 16;
+
+}  // anonymous namespace
+
+SampleMap::SampleMap(const Point2i &resolution, const std::vector<Bounds2i> &tiles)
+    : resolution_{ resolution }
+    , tiles_{ tiles }
+    , pixelSamples_(resolution.x() * resolution.y(), 1)
+    , activeTiles_(tiles.size())
+    , tileErrors_(tiles.size(), 0.0) {
+    for (int i = 0; i < static_cast<int>(tiles.size()); i++) {
+        activeTiles_[i] = i;
+    }
+}
+
+void SampleMap::setAdaptive(int minSamples, double targetError, int topK) {
+    minSamples_  = std::max(2, minSamples);
+    targetError_ = targetError;
+    topK_        = std::max(0, topK);
+}
+
+int SampleMap::update(const Film &film, int maxSamples) {
+    const int width = resolution_.x();
+
+    // Find the pixels which are not converged yet. The error of a tile is
+    // the average error of such pixels in it.
+    activeTiles_.clear();
+    for (int i = 0; i < static_cast<int>(tiles_.size()); i++) {
+        const Bounds2i &tile = tiles_[i];
+        int numActive = 0;
+        double errorSum = 0.0;
+        for (int y = tile.posMin().y(); y < tile.posMax().y(); y++) {
+            for (int x = tile.posMin().x(); x < tile.posMax().x(); x++) {
+                const Point2i pixel(x, y);
+                const int taken = film.samples(pixel);
+                const double error = taken < minSamples_ ? INFTY : film.relativeError(pixel);
+                const bool active = taken < maxSamples && error >= targetError_;
+                pixelSamples_[y * width + x] = active ? 1 : 0;
+                if (active) {
+                    numActive++;
+                    errorSum += std::min(error, INFTY);
+                }
+            }
+        }
+
+        if (numActive > 0) {
+            tileErrors_[i] = errorSum / numActive;
+            activeTiles_.push_back(i);
+        }
+    }
+
+    // Keep the tiles of the largest error
+    if (topK_ > 0 && static_cast<int>(activeTiles_.size()) > topK_) {
+        std::stable_sort(activeTiles_.begin(), activeTiles_.end(), [&](int i, int j) {
+            return tileErrors_[i] > tileErrors_[j];
+        });
+        for (int k = topK_; k < static_cast<int>(activeTiles_.size()); k++) {
+            const Bounds2i &tile = tiles_[activeTiles_[k]];
+            for (int y = tile.posMin().y(); y < tile.posMax().y(); y++) {
+                int *row = pixelSamples_.data() + y * width;
+                std::fill(row + tile.posMin().x(), row + tile.posMax().x(), 0);
+            }
+        }
+        activeTiles_.resize(topK_);
+        std::sort(activeTiles_.begin(), activeTiles_.end());
+    }
+
+    int numActive = 0;
+    for (int i : activeTiles_) {
+        const Bounds2i &tile = tiles_[i];
+        for (int y = tile.posMin().y(); y < tile.posMax().y(); y++) {
+            for (int x = tile.posMin().x(); x < tile.posMax().x(); x++) {
+                numActive += pixelSamples_[y * width + x];
+            }
+        }
+    }
+
+    if (numActive == 0) return 0;
+
+    // Share the budget of the pass
+    const int numPixels = resolution_.x() * resolution_.y();
+    const int share = std::min(kMaxPassSamples, std::max(1, numPixels / numActive));
+    if (share > 1) {
+        for (int i : activeTiles_) {
+            const Bounds2i &tile = tiles_[i];
+            for (int y = tile.posMin().y(); y < tile.posMax().y(); y++) {
+                for (int x = tile.posMin().x(); x < tile.posMax().x(); x++) {
+                    int &spp = pixelSamples_[y * width + x];
+                    if (spp == 0) continue;
+                    spp = std::min(share, maxSamples - film.samples(Point2i(x, y)));
+                }
+            }
+        }
+    }
+    return numActive;
+}
+
+}  // namespace spica
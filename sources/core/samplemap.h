@@ -0,0 +1,74 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_SAMPLEMAP_H_
+#define _SPICA_SAMPLEMAP_H_
+
+#include <vector>
+
+#include "core/core.hpp"
+#include "core/common.h"
+#include "core/uncopyable.h"
+#include "core/point2d.h"
+#include "core/bounds2d.h"
+
+namespace spica {
+
+/**
+ * Allocation of the samples to the pixels in a pass of SamplerIntegrator.
+ * @details
+ * By default, every pixel takes one sample in every pass. In the adaptive
+ * mode, the map is updated from the variance estimated by the film before
+ * each pass, and the pixels which are converged are skipped. The budget of
+ * the pass, i.e., one sample per pixel of the film, is shared by the
+ * remaining pixels. When "topK" is positive, only the pixels in the "topK"
+ * tiles of the largest error are sampled in the pass.
+ */
+class SPICA_EXPORTS SampleMap : Uncopyable {
+public:
+    SampleMap(const Point2i &resolution, const std::vector<Bounds2i> &tiles);
+
+    /**
+     * Enable the adaptive sampling.
+     *
+     * @param[in] minSamples: Samples taken before the error is trusted.
+     * @param[in] targetError: Relative error at which the pixel is converged.
+     * @param[in] topK: Number of the tiles sampled in a pass. Zero samples
+     *                  all the tiles which have unconverged pixels.
+     */
+    void setAdaptive(int minSamples, double targetError, int topK = 0);
+
+    /**
+     * Allocate the samples of the next pass.
+     *
+     * @param[in] film: The film which estimates the variance of the pixels.
+     * @param[in] maxSamples: The maximum number of samples for a pixel.
+     * @return The number of the pixels sampled in the pass.
+     */
+    int update(const Film &film, int maxSamples);
+
+    //! Number of the samples taken for the pixel in the pass.
+    inline int samples(int x, int y) const {
+        return pixelSamples_[y * resolution_.x() + x];
+    }
+
+    //! Indices of the tiles which have pixels sampled in the pass.
+    inline const std::vector<int> &activeTiles() const { return activeTiles_; }
+
+private:
+    // Private fields
+    Point2i resolution_;
+    std::vector<Bounds2i> tiles_;
+    std::vector<int> pixelSamples_;
+    std::vector<int> activeTiles_;
+    std::vector<double> tileErrors_;
+    int minSamples_ = 0;
+    double targetError_ = 0.0;
+    int topK_ = 0;
+
+};  // class SampleMap
+
+}  // namespace spica
+
+#endif  // _SPICA_SAMPLEMAP_H_
@@ -14,10 +14,14 @@
 #include "core/common.h"
 #include "core/cobject.h"
 #include "core/uncopyable.h"
+#include "core/exception.h"
 #include "core/point2d.h"
 
 namespace spica {
 
+    class CheckpointWriter;
+    class CheckpointReader;
+
     /** Random sampler class.
      *  @ingroup random_module
      */
@@ -34,6 +38,56 @@ namespace spica {
         virtual void startPixel() { }
 
         virtual std::unique_ptr<Sampler> clone(unsigned int seed = 0) const = 0;
+
+        /** Start the sample of the pixel, whose numbers do not depend on
+         *  what the sampler drew before.
+         *  @details
+         *  With "dimension" and "setDimension", a path can be continued by
+         *  the sampler of another thread, as in the wavefront integrator.
+         *  Samplers which do not support it only call "startPixel", and
+         *  keep drawing their own sequence.
+         */
+        virtual void startPixelSample(const Point2i &pixel, int sampleIndex) {
+            startPixel();
+        }
+
+        //! Position in the current sample, which "setDimension" restores.
+        virtual int dimension() const { return 0; }
+        virtual void setDimension(int dimension) { }
+
+        /** Write the state of the sequence to the checkpoint.
+         *  @details
+         *  "loadState" of a clone of the sampler continues the sequence
+         *  where it was written. Samplers which do not support it throw.
+         */
+        virtual void saveState(CheckpointWriter &writer) const {
+            throw RuntimeException("The sampler does not support checkpoints!!");
+        }
+        virtual void loadState(CheckpointReader &reader) {
+            throw RuntimeException("The sampler does not support checkpoints!!");
+        }
+
+    protected:
+        /** Number in [0, 1) for the dimension of the sample of the pixel,
+         *  which only depends on them.
+         */
+        static double hashedSample(const Point2i &pixel, int sampleIndex, int dimension) {
+            // Finalizer of MurmurHash3
+            auto mix = [](uint64_t v) {
+                v ^= v >> 33;
+                v *= 0xff51afd7ed558ccdULL;
+                v ^= v >> 33;
+                v *= 0xc4ceb9fe1a85ec53ULL;
+                v ^= v >> 33;
+                return v;
+            };
+            // Each key is spread by a different odd constant before mixing
+            uint64_t v = mix((static_cast<uint64_t>(static_cast<uint32_t>(pixel.x())) << 32 |
+                              static_cast<uint32_t>(pixel.y())) + 0x9e3779b97f4a7c15ULL);
+            v = mix(v ^ (static_cast<uint64_t>(static_cast<uint32_t>(sampleIndex)) + 1) * 0xbf58476d1ce4e5b9ULL);
+            v = mix(v ^ (static_cast<uint64_t>(static_cast<uint32_t>(dimension)) + 1) * 0x94d049bb133111ebULL);
+            return (v >> 11) * 0x1p-53;
+        }
     };
 
 }  // namespace spica
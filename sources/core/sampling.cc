@@ -163,7 +163,7 @@ Point2d sampleConcentricDisk(const Point2d& rands) {
     return r * Point2d(std::cos(theta), std::sin(theta));
 }
 
-Vector3d sampleUniformSphere(const Point2d& rands) {
+Vector3 sampleUniformSphere(const Point2d& rands) {
     double z = 2.0 * rands[0] - 1.0;
     double cosTheta = sqrt(1.0 - z * z);
     double phi = 2.0 * PI * rands[1];
@@ -172,15 +172,15 @@ Vector3d sampleUniformSphere(const Point2d& rands) {
     return { x, y, z };
 }
 
-Vector3d sampleCosineHemisphere(const Point2d& rands) {
+Vector3 sampleCosineHemisphere(const Point2d& rands) {
     Point2d d = sampleConcentricDisk(rands);
     double z = sqrt(std::max(0.0, 1.0 - d.x() * d.x() - d.y() * d.y()));
-    return Vector3d{ d.x(), d.y(), z };
+    return Vector3{ d.x(), d.y(), z };
 }
 
-void sampleUniformHemisphere(const Normal3d& normal, Vector3d* direction, const Point2d& rands) {
-    Vector3d u, v, w;
-    w = static_cast<Vector3d>(normal);
+void sampleUniformHemisphere(const Normal3& normal, Vector3* direction, const Point2d& rands) {
+    Vector3 u, v, w;
+    w = static_cast<Vector3>(normal);
     vect::coordinateSystem(w, &u, &v);
 
     const double t = 2.0 * PI * rands[0];
@@ -189,7 +189,7 @@ void sampleUniformHemisphere(const Normal3d& normal, Vector3d* direction, const
     *direction = (u * cos(t) * z2s + v * sin(t) * z2s + w * sqrt(1.0 - z2)).normalized();        
 }
 
-void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
+void samplePoissonDisk(const Scene& scene, const Point3& pCamera,
                        double minDist, std::vector<Interaction>* points) {
     std::vector<Triangle> tris;
     for (const auto& p : scene.primitives()) {
@@ -204,9 +204,9 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
     Random rng(seed);
 
     // Sample random points on trimesh
-    Bounds3d bounds;
-    std::vector<Point3d> candPoints;
-    std::vector<Normal3d> candNormals;
+    Bounds3 bounds;
+    std::vector<Point3> candPoints;
+    std::vector<Normal3> candNormals;
     for (int i = 0; i < tris.size(); i++) {
         const Triangle& tri = tris[i];
         const double A = tri.area();
@@ -218,8 +218,8 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
                 u = 1.0 - u;
                 v = 1.0 - v;
             }
-            Point3d  p = (1.0 - u - v) * tri[0] + u * tri[1] + v * tri[2];
-            Normal3d n = (1.0 - u  -v) * tri.normal(0) + u * tri.normal(1) + 
+            Point3  p = (1.0 - u - v) * tri[0] + u * tri[1] + v * tri[2];
+            Normal3 n = (1.0 - u  -v) * tri.normal(0) + u * tri.normal(1) + 
                          v * tri.normal(2);
             candPoints.push_back(p);
             candNormals.push_back(n);
@@ -229,7 +229,7 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
 
     // Create hash grid
     const int numCands = static_cast<int>(candPoints.size());
-    Vector3d bsize = bounds.posMax() - bounds.posMin();
+    Vector3 bsize = bounds.posMax() - bounds.posMin();
     const double scale = 1.0 / (2.0 * minDist);
     const int numPoints = candPoints.size();
     HashGrid<int> hashgrid;
@@ -241,10 +241,10 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
     }
 
     std::vector<int> sampledIDs;
-    Vector3d margin(2.0 * minDist, 2.0 * minDist, 2.0 * minDist);
+    Vector3 margin(2.0 * minDist, 2.0 * minDist, 2.0 * minDist);
     while (!que.empty()) {
         int id = que.pop();
-        Point3d v = candPoints[id];
+        Point3 v = candPoints[id];
         const std::vector<int>& cellvs = hashgrid[v];
 
         bool accept = true;
@@ -256,8 +256,8 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
         }
 
         if (accept) {
-            Point3d boxMin = v - margin;
-            Point3d boxMax = v + margin;
+            Point3 boxMin = v - margin;
+            Point3 boxMax = v + margin;
             hashgrid.add(id, boxMin, boxMax);
             sampledIDs.push_back(id);
         }
@@ -271,7 +271,7 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
 }
 
 /*
-void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
+void samplePoissonDisk(const Scene& scene, const Point3& pCamera,
                        double minDist, std::vector<SurfaceInteraction>* points) {
     // Initialize utility variables in this method
     const auto seed = static_cast<unsigned int>(time(0));
@@ -282,12 +282,12 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
     const int pathTracePerIter = 20000;
 
     // Initialize hash grid
-    Bounds3d bounds = scene.worldBound();
-    Vector3d bsize = bounds.posMax() - bounds.posMin();
+    Bounds3 bounds = scene.worldBound();
+    Vector3 bsize = bounds.posMax() - bounds.posMin();
     const double scale = 1.0 / (2.0 * minDist);
     const int numPoints = pathTracePerIter * 5;
-    Vector3d margin(2.0 * minDist, 2.0 * minDist, 2.0 * minDist);
-    HashGrid<Point3d> hashgrid;
+    Vector3 margin(2.0 * minDist, 2.0 * minDist, 2.0 * minDist);
+    HashGrid<Point3> hashgrid;
     hashgrid.init(numPoints, scale, bounds);
 
     MemoryArena arena;
@@ -296,7 +296,7 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
         // Collect candidate intersections
         std::vector<SurfaceInteraction> candidates;
         for (int p = 0; p < pathTracePerIter; p++) {
-            Vector3d dir = sampleUniformSphere(rng.get2D());
+            Vector3 dir = sampleUniformSphere(rng.get2D());
             Ray ray(pCamera, dir);
             for (int depth = 0; depth < maxDepth; depth++) {
                 SurfaceInteraction isect;
@@ -308,7 +308,7 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
                     candidates.push_back(isect);                    
                 }
 
-                Vector3d dir = sampleUniformSphere(rng.get2D());
+                Vector3 dir = sampleUniformSphere(rng.get2D());
                 if (vect::dot(dir, isect.normal()) < 0.0) {
                     dir = -dir;
                 }
@@ -330,8 +330,8 @@ void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
 
             if (accept) {
                 repeatFails = 0;
-                Point3d boxMin = candidates[i].pos() - margin;
-                Point3d boxMax = candidates[i].pos() + margin;
+                Point3 boxMin = candidates[i].pos() - margin;
+                Point3 boxMax = candidates[i].pos() + margin;
                 hashgrid.add(candidates[i].pos(), boxMin, boxMax);
                 points->push_back(candidates[i]);                
             } else {
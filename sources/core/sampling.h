@@ -59,13 +59,13 @@ private:
 };  // class Distribution2D
 
 SPICA_EXPORTS Point2d  sampleConcentricDisk(const Point2d& rands);
-SPICA_EXPORTS Vector3d sampleUniformSphere(const Point2d& rands);
-SPICA_EXPORTS Vector3d sampleCosineHemisphere(const Point2d& rands);
+SPICA_EXPORTS Vector3 sampleUniformSphere(const Point2d& rands);
+SPICA_EXPORTS Vector3 sampleCosineHemisphere(const Point2d& rands);
 SPICA_EXPORTS inline double   cosineHemispherePdf(double cosTheta) { return cosTheta * INV_PI; }
-SPICA_EXPORTS void sampleUniformHemisphere(const Normal3d& normal, Vector3d* direction, const Point2d& rands);
+SPICA_EXPORTS void sampleUniformHemisphere(const Normal3& normal, Vector3* direction, const Point2d& rands);
 
 SPICA_EXPORTS
-void samplePoissonDisk(const Scene& scene, const Point3d& pCamera,
+void samplePoissonDisk(const Scene& scene, const Point3& pCamera,
                        double minDist, std::vector<Interaction>* points);
 
 }  // namespace spica
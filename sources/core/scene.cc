@@ -42,6 +42,23 @@ namespace spica {
         return aggregate_->intersect(ray);
     }
 
+    void Scene::intersect(RayBatch& rays, HitBatch& hits) const {
+        aggregate_->intersect(rays, hits);
+    }
+
+    void Scene::occluded(RayBatch& rays, bool* occluded) const {
+        aggregate_->occluded(rays, occluded);
+    }
+
+    bool Scene::hitTest(Ray& ray, HitRecord* hit) const {
+        return aggregate_->hitTest(ray, hit);
+    }
+
+    void Scene::computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                          SurfaceInteraction* isect) const {
+        aggregate_->computeSurfaceInteraction(ray, hit, isect);
+    }
+
     bool Scene::intersectTr(Ray& ray, Sampler& sampler,
                             SurfaceInteraction* isect, Spectrum* tr) const {
         *tr = Spectrum(1.0);
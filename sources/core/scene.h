@@ -33,10 +33,19 @@ public:
 
     bool intersect(Ray& ray, SurfaceInteraction* isect) const;
     bool intersect(Ray& ray) const;
+
+    //! Find the closest hits of the rays in the batch (see "RayBatch").
+    void intersect(RayBatch& rays, HitBatch& hits) const;
+    //! Test if the rays in the batch hit anything.
+    void occluded(RayBatch& rays, bool* occluded) const;
+
+    bool hitTest(Ray& ray, HitRecord* hit) const;
+    void computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                   SurfaceInteraction* isect) const;
     bool intersectTr(Ray& ray, Sampler& sampler, SurfaceInteraction* isect,
                      Spectrum* tr) const;
 
-    inline const Bounds3d& worldBound() const { return worldBound_; }
+    inline const Bounds3& worldBound() const { return worldBound_; }
     inline const std::vector<std::shared_ptr<Primitive>>& primitives() const {
         return aggregate_->primitives();
     }
@@ -47,7 +56,7 @@ public:
 private:
     std::shared_ptr<Accelerator> aggregate_;
     std::vector<std::shared_ptr<Light> > lights_;
-    Bounds3d worldBound_;
+    Bounds3 worldBound_;
 
 };  // class Scene
 
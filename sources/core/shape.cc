@@ -36,7 +36,7 @@ double Shape::pdf(const Interaction& pObj) const {
     return 1.0 / area();
 }
 
-double Shape::pdf(const Interaction& pObj, const Vector3d& wi) const {
+double Shape::pdf(const Interaction& pObj, const Vector3& wi) const {
     Ray ray = pObj.spawnRay(wi);
     double tHit;
     SurfaceInteraction isect;
@@ -51,7 +51,7 @@ Interaction Shape::sample(const Interaction& ref, const Point2d& rands) const {
     return sample(rands);
 }
 
-Bounds3d Shape::worldBound() const {
+Bounds3 Shape::worldBound() const {
     return objectToWorld_.apply(objectBound());
 }
 
@@ -51,14 +51,27 @@ public:
                            SurfaceInteraction* isect) const = 0;
     virtual bool intersect(const Ray& ray) const = 0;
 
+    /**
+     * Find the hit without computing its surface interaction.
+     * @details
+     * "b1" and "b2" store shape-specific parameters of the hit (barycentric
+     * coordinates of the 2nd and 3rd vertices for triangles), which are
+     * passed back to "computeSurfaceInteraction".
+     */
+    virtual bool hitTest(const Ray& ray, double* tHit,
+                         double* b1, double* b2) const = 0;
+    virtual void computeSurfaceInteraction(const Ray& ray, double tHit,
+                                           double b1, double b2,
+                                           SurfaceInteraction* isect) const = 0;
+
     virtual Interaction sample(const Point2d& rands) const = 0;
     virtual Interaction sample(const Interaction& isect,
                                const Point2d& rands) const;
     virtual double pdf(const Interaction& pObj) const;
-    virtual double pdf(const Interaction& pObj, const Vector3d& dir) const;
+    virtual double pdf(const Interaction& pObj, const Vector3& dir) const;
 
-    virtual Bounds3d worldBound() const;
-    virtual Bounds3d objectBound() const = 0;
+    virtual Bounds3 worldBound() const;
+    virtual Bounds3 objectBound() const = 0;
 
     virtual double area() const = 0;
     virtual std::vector<Triangle> triangulate() const = 0;
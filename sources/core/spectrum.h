@@ -7,26 +7,115 @@
 
 #include <iostream>
 #include <vector>
+#include <cmath>
+#include <immintrin.h>
 
 #include "common.h"
 
 namespace spica {
 
-    /** 
+namespace simd {
+
+/**
+ * Four lanes of "Float" in SIMD registers.
+ * @details
+ * Single precision uses one SSE register. Double precision uses one AVX
+ * register when AVX is enabled at compile time, and two SSE2 registers
+ * otherwise.
+ */
+#if defined(SPICA_USE_FLOAT)
+struct Float4 {
+    __m128 v;
+};
+
+inline Float4 load(const Float* p) { return { _mm_loadu_ps(p) }; }
+inline void store(Float* p, const Float4& a) { _mm_storeu_ps(p, a.v); }
+inline Float4 set(Float x, Float y, Float z, Float w) { return { _mm_setr_ps(x, y, z, w) }; }
+inline Float4 add(const Float4& a, const Float4& b) { return { _mm_add_ps(a.v, b.v) }; }
+inline Float4 sub(const Float4& a, const Float4& b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline Float4 mul(const Float4& a, const Float4& b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline Float4 div(const Float4& a, const Float4& b) { return { _mm_div_ps(a.v, b.v) }; }
+inline Float4 min(const Float4& a, const Float4& b) { return { _mm_min_ps(a.v, b.v) }; }
+inline Float4 max(const Float4& a, const Float4& b) { return { _mm_max_ps(a.v, b.v) }; }
+inline Float4 sqrt(const Float4& a) { return { _mm_sqrt_ps(a.v) }; }
+#if defined(__FMA__)
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) { return { _mm_fmadd_ps(a.v, b.v, c.v) }; }
+#else
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) { return add(mul(a, b), c); }
+#endif
+#elif defined(__AVX__)
+struct Float4 {
+    __m256d v;
+};
+
+inline Float4 load(const Float* p) { return { _mm256_loadu_pd(p) }; }
+inline void store(Float* p, const Float4& a) { _mm256_storeu_pd(p, a.v); }
+inline Float4 set(Float x, Float y, Float z, Float w) { return { _mm256_setr_pd(x, y, z, w) }; }
+inline Float4 add(const Float4& a, const Float4& b) { return { _mm256_add_pd(a.v, b.v) }; }
+inline Float4 sub(const Float4& a, const Float4& b) { return { _mm256_sub_pd(a.v, b.v) }; }
+inline Float4 mul(const Float4& a, const Float4& b) { return { _mm256_mul_pd(a.v, b.v) }; }
+inline Float4 div(const Float4& a, const Float4& b) { return { _mm256_div_pd(a.v, b.v) }; }
+inline Float4 min(const Float4& a, const Float4& b) { return { _mm256_min_pd(a.v, b.v) }; }
+inline Float4 max(const Float4& a, const Float4& b) { return { _mm256_max_pd(a.v, b.v) }; }
+inline Float4 sqrt(const Float4& a) { return { _mm256_sqrt_pd(a.v) }; }
+#if defined(__FMA__)
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) { return { _mm256_fmadd_pd(a.v, b.v, c.v) }; }
+#else
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) { return add(mul(a, b), c); }
+#endif
+#else
+struct Float4 {
+    __m128d lo, hi;
+};
+
+inline Float4 load(const Float* p) { return { _mm_loadu_pd(p), _mm_loadu_pd(p + 2) }; }
+inline void store(Float* p, const Float4& a) { _mm_storeu_pd(p, a.lo); _mm_storeu_pd(p + 2, a.hi); }
+inline Float4 set(Float x, Float y, Float z, Float w) { return { _mm_setr_pd(x, y), _mm_setr_pd(z, w) }; }
+inline Float4 add(const Float4& a, const Float4& b) { return { _mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi) }; }
+inline Float4 sub(const Float4& a, const Float4& b) { return { _mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi) }; }
+inline Float4 mul(const Float4& a, const Float4& b) { return { _mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi) }; }
+inline Float4 div(const Float4& a, const Float4& b) { return { _mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi) }; }
+inline Float4 min(const Float4& a, const Float4& b) { return { _mm_min_pd(a.lo, b.lo), _mm_min_pd(a.hi, b.hi) }; }
+inline Float4 max(const Float4& a, const Float4& b) { return { _mm_max_pd(a.lo, b.lo), _mm_max_pd(a.hi, b.hi) }; }
+inline Float4 sqrt(const Float4& a) { return { _mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi) }; }
+#if defined(__FMA__)
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) {
+    return { _mm_fmadd_pd(a.lo, b.lo, c.lo), _mm_fmadd_pd(a.hi, b.hi, c.hi) };
+}
+#else
+inline Float4 fmadd(const Float4& a, const Float4& b, const Float4& c) { return add(mul(a, b), c); }
+#endif
+#endif
+
+}  // namespace simd
+
+    /**
      * RGB spectrum.
+     * @details
+     * The channels are stored in four SIMD lanes. The last lane is padding
+     * and is kept zero by every operation.
      */
     class SPICA_EXPORTS RGBSpectrum {
     public:
         /** The RGBSpectrum constructor. */
-        RGBSpectrum();
-        explicit RGBSpectrum(double l);
-        
+        RGBSpectrum()
+            : c_{ 0, 0, 0, 0 } {
+        }
+
+        explicit RGBSpectrum(double l)
+            : c_{ static_cast<Float>(l), static_cast<Float>(l),
+                  static_cast<Float>(l), 0 } {
+        }
+
         /** The RGBSpectrum constructor.
          *  @param red: Red component.
          *  @param green: Green component.
          *  @param blue: Blue component.
          */
-        RGBSpectrum(double red, double green, double blue);
+        RGBSpectrum(double red, double green, double blue)
+            : c_{ static_cast<Float>(red), static_cast<Float>(green),
+                  static_cast<Float>(blue), 0 } {
+        }
 
         /** The RGBSpectrum constructor.
          */
@@ -34,87 +123,143 @@ namespace spica {
                     const std::vector<double>& values);
 
         /** The RGBSpectrum constructor (copy) */
-        RGBSpectrum(const RGBSpectrum& RGBSpectrum);
+        RGBSpectrum(const RGBSpectrum& RGBSpectrum) = default;
         /** The RGBSpectrum destructor */
-        ~RGBSpectrum();
+        ~RGBSpectrum() = default;
 
         /** Assignment operator */
-        RGBSpectrum& operator=(const RGBSpectrum& c);
+        RGBSpectrum& operator=(const RGBSpectrum& c) = default;
         /** Equal operator */
-        bool operator==(const RGBSpectrum& c) const;
+        inline bool operator==(const RGBSpectrum& c) const {
+            return c_[0] == c.c_[0] && c_[1] == c.c_[1] && c_[2] == c.c_[2];
+        }
         /** Not equal operator */
-        bool operator!=(const RGBSpectrum& c) const;
+        inline bool operator!=(const RGBSpectrum& c) const {
+            return !this->operator==(c);
+        }
         /** Plus operator */
-        RGBSpectrum& operator+=(const RGBSpectrum& c);
+        inline RGBSpectrum& operator+=(const RGBSpectrum& c) {
+            simd::store(c_, simd::add(lanes(), c.lanes()));
+            return *this;
+        }
         /** Plus operator.
          *  @details Add the same value x to each RGBSpectrum component.
          */
-        RGBSpectrum& operator+=(double x);
+        inline RGBSpectrum& operator+=(double x) {
+            return this->operator+=(RGBSpectrum(x));
+        }
         /** Minus operator. */
-        RGBSpectrum& operator-=(const RGBSpectrum& c);
+        inline RGBSpectrum& operator-=(const RGBSpectrum& c) {
+            simd::store(c_, simd::sub(lanes(), c.lanes()));
+            return *this;
+        }
         /** Minus operator.
-         *  @details Subtract the same value x from each RGBSpectrum component   
+         *  @details Subtract the same value x from each RGBSpectrum component
          */
-        RGBSpectrum& operator-=(double x);
+        inline RGBSpectrum& operator-=(double x) {
+            return this->operator-=(RGBSpectrum(x));
+        }
         /** Component-wise multiplication. */
-        RGBSpectrum& operator*=(const RGBSpectrum& c);
+        inline RGBSpectrum& operator*=(const RGBSpectrum& c) {
+            simd::store(c_, simd::mul(lanes(), c.lanes()));
+            return *this;
+        }
         /** Scalar multiplication. */
-        RGBSpectrum& operator*=(double s);
+        inline RGBSpectrum& operator*=(double s) {
+            return this->operator*=(RGBSpectrum(s));
+        }
         /** Component-wise division */
-        RGBSpectrum& operator/=(const RGBSpectrum& c);
+        inline RGBSpectrum& operator/=(const RGBSpectrum& c) {
+            Assertion(c.c_[0] != 0.0 && c.c_[1] != 0.0 && c.c_[2] != 0.0,
+                      "Zero division!!");
+            // The padding lane is divided by one to keep it zero.
+            const simd::Float4 d = simd::add(c.lanes(), simd::set(0, 0, 0, 1));
+            simd::store(c_, simd::div(lanes(), d));
+            return *this;
+        }
         /** Scalar division */
-        RGBSpectrum& operator/=(double s);
+        inline RGBSpectrum& operator/=(double s) {
+            Assertion(s != 0.0, "Zero division !!");
+            const Float fs = static_cast<Float>(s);
+            simd::store(c_, simd::div(lanes(), simd::set(fs, fs, fs, 1)));
+            return *this;
+        }
         /** Negation operator */
-        RGBSpectrum operator-() const;
+        inline RGBSpectrum operator-() const {
+            return RGBSpectrum(simd::sub(simd::set(0, 0, 0, 0), lanes()));
+        }
 
         static RGBSpectrum fromXYZ(double x, double y, double z);
 
-        static RGBSpectrum minimum(const RGBSpectrum& c1, const RGBSpectrum& c2);
-        static RGBSpectrum maximum(const RGBSpectrum& c1, const RGBSpectrum& c2);
+        static inline RGBSpectrum minimum(const RGBSpectrum& c1, const RGBSpectrum& c2) {
+            return RGBSpectrum(simd::min(c1.lanes(), c2.lanes()));
+        }
+        static inline RGBSpectrum maximum(const RGBSpectrum& c1, const RGBSpectrum& c2) {
+            return RGBSpectrum(simd::max(c1.lanes(), c2.lanes()));
+        }
+
+        /** Fused multiply-add: a * b + c */
+        static inline RGBSpectrum fma(const RGBSpectrum& a, const RGBSpectrum& b,
+                                      const RGBSpectrum& c) {
+            return RGBSpectrum(simd::fmadd(a.lanes(), b.lanes(), c.lanes()));
+        }
+        /** Fused multiply-add with a scalar: a * s + c */
+        static inline RGBSpectrum fma(const RGBSpectrum& a, double s,
+                                      const RGBSpectrum& c) {
+            const Float fs = static_cast<Float>(s);
+            return RGBSpectrum(simd::fmadd(a.lanes(), simd::set(fs, fs, fs, 0), c.lanes()));
+        }
 
         static RGBSpectrum sqrt(const RGBSpectrum& c);
         static RGBSpectrum exp(const RGBSpectrum& c);
         static RGBSpectrum log(const RGBSpectrum& c);
-        static RGBSpectrum clamp(const RGBSpectrum& c,
-                                 const RGBSpectrum& lo = RGBSpectrum(0.0, 0.0, 0.0),
-                                 const RGBSpectrum& hi = RGBSpectrum(INFTY, INFTY, INFTY));
+        static inline RGBSpectrum clamp(const RGBSpectrum& c,
+                                        const RGBSpectrum& lo = RGBSpectrum(0.0, 0.0, 0.0),
+                                        const RGBSpectrum& hi = RGBSpectrum(INFTY, INFTY, INFTY)) {
+            return RGBSpectrum::maximum(lo, RGBSpectrum::minimum(c, hi));
+        }
 
-        bool isBlack() const;
+        inline bool isBlack() const {
+            return c_[0] == 0.0 && c_[1] == 0.0 && c_[2] == 0.0;
+        }
         bool isInf() const;
         bool isNaN() const;
         bool isValid() const;
-        double dot(const RGBSpectrum& RGBSpectrum) const;
-        double norm() const;
-        double squaredNorm() const;
-        double gray() const;
+        inline double dot(const RGBSpectrum& c) const {
+            return c_[0] * c.c_[0] + c_[1] * c.c_[1] + c_[2] * c.c_[2];
+        }
+        inline double norm() const {
+            return std::sqrt(this->squaredNorm());
+        }
+        inline double squaredNorm() const {
+            return this->dot(*this);
+        }
+        inline double gray() const {
+            return 0.2126 * c_[0] + 0.7152 * c_[1] + 0.0722 * c_[2];
+        }
 
         /** Red component. */
-        inline double red()   const { return r_; }
+        inline double red()   const { return c_[0]; }
         /** Green component */
-        inline double green() const { return g_; }
+        inline double green() const { return c_[1]; }
         /** Blue component */
-        inline double blue()  const { return b_; }
+        inline double blue()  const { return c_[2]; }
 
         /** Element accessor. */
         inline double operator[](int i) const {
             Assertion(i >= 0 && i <= 2, "Index out of range!!");
-            if (i == 0) return r_;
-            if (i == 1) return g_;
-            if (i == 2) return b_;
-            return 0.0;
+            return c_[i];
         }
 
         /** Element accessor. */
-        inline double& ref(int i) {
+        inline Float& ref(int i) {
             Assertion(i >= 0 && i <= 2, "Index out of range!!");
-            if (i == 0) return r_;
-            if (i == 1) return g_;
-            return b_;            
+            return c_[i];
         }
 
         /** Convert to RGB spcetrum. */
         inline RGBSpectrum toRGB() const {
-            return { r_, g_, b_ };
+            return *this;
         }
 
         /** Covert to string. */
@@ -124,24 +269,87 @@ namespace spica {
         static const int channels = 3;
 
     private:
-        double r_, g_, b_;
+        explicit RGBSpectrum(const simd::Float4& v) {
+            simd::store(c_, v);
+        }
+
+        inline simd::Float4 lanes() const {
+            return simd::load(c_);
+        }
+
+        alignas(16) Float c_[4];
     };
 
     using Spectrum = RGBSpectrum;
 
 }  // namespace spica
 
-SPICA_EXPORTS spica::RGBSpectrum operator+(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2);
-SPICA_EXPORTS spica::RGBSpectrum operator+(double x, const spica::RGBSpectrum& c);
-SPICA_EXPORTS spica::RGBSpectrum operator+(const spica::RGBSpectrum& c, double x);
-SPICA_EXPORTS spica::RGBSpectrum operator-(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2);
-SPICA_EXPORTS spica::RGBSpectrum operator-(double x, const spica::RGBSpectrum& c);
-SPICA_EXPORTS spica::RGBSpectrum operator-(const spica::RGBSpectrum& c, double x);
-SPICA_EXPORTS spica::RGBSpectrum operator*(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2);
-SPICA_EXPORTS spica::RGBSpectrum operator*(const spica::RGBSpectrum& c1, double s);
-SPICA_EXPORTS spica::RGBSpectrum operator*(double s, const spica::RGBSpectrum& c2);
-SPICA_EXPORTS spica::RGBSpectrum operator/(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2);
-SPICA_EXPORTS spica::RGBSpectrum operator/(const spica::RGBSpectrum& c1, double s);
+inline spica::RGBSpectrum operator+(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2) {
+    spica::RGBSpectrum ret = c1;
+    ret += c2;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator+(double x, const spica::RGBSpectrum& c) {
+    spica::RGBSpectrum ret = c;
+    ret += x;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator+(const spica::RGBSpectrum& c, double x) {
+    spica::RGBSpectrum ret = c;
+    ret += x;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator-(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2) {
+    spica::RGBSpectrum ret = c1;
+    ret -= c2;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator-(double x, const spica::RGBSpectrum& c) {
+    spica::RGBSpectrum ret(x);
+    ret -= c;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator-(const spica::RGBSpectrum& c, double x) {
+    spica::RGBSpectrum ret = c;
+    ret -= x;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator*(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2) {
+    spica::RGBSpectrum ret = c1;
+    ret *= c2;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator*(const spica::RGBSpectrum& c, double s) {
+    spica::RGBSpectrum ret = c;
+    ret *= s;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator*(double s, const spica::RGBSpectrum& c) {
+    spica::RGBSpectrum ret = c;
+    ret *= s;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator/(const spica::RGBSpectrum& c1, const spica::RGBSpectrum& c2) {
+    spica::RGBSpectrum ret = c1;
+    ret /= c2;
+    return ret;
+}
+
+inline spica::RGBSpectrum operator/(const spica::RGBSpectrum& c, double s) {
+    spica::RGBSpectrum ret = c;
+    ret /= s;
+    return ret;
+}
+
 SPICA_EXPORTS std::ostream& operator<<(std::ostream& os, const spica::RGBSpectrum& c);
 
 #endif  // SPICA_RGBSpectrum_H_
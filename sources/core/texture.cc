@@ -15,7 +15,7 @@ UVMapping2D::UVMapping2D(double su, double sv, double du, double dv, bool invert
     , invertHorizontal_{invertHorizontal} {
 }
 
-Point2d UVMapping2D::map(const Point3d& p) const {
+Point2d UVMapping2D::map(const Point3& p) const {
     const double s = su_ * p[0] + du_;
     const double t = sv_ * p[1] + dv_;
     return Point2d(s, invertHorizontal_ ? 1.0 - t : t);
@@ -30,7 +30,7 @@ Point2d UVMapping2D::map(const SurfaceInteraction& intr,
     return Point2d(s, invertHorizontal_ ? 1.0 - t : t);
 }
 
-PlanarMapping2D::PlanarMapping2D(const Vector3d& vs, const Vector3d& vt,
+PlanarMapping2D::PlanarMapping2D(const Vector3& vs, const Vector3& vt,
                                  double ds, double dt) 
     : vs_{ vs }
     , vt_{ vt }
@@ -38,8 +38,8 @@ PlanarMapping2D::PlanarMapping2D(const Vector3d& vs, const Vector3d& vt,
     , dt_{ dt } {
 }
 
-Point2d PlanarMapping2D::map(const Point3d& p) const {
-    Vector3d vec(p);
+Point2d PlanarMapping2D::map(const Point3& p) const {
+    Vector3 vec(p);
     return Point2d(ds_ + vect::dot(vec, vs_), dt_ + vect::dot(vec, vt_));
 }
 
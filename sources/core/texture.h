@@ -21,7 +21,7 @@ class SPICA_EXPORTS TextureMapping2D {
 public:
     virtual ~TextureMapping2D() {}
 
-    virtual Point2d map(const Point3d& p) const = 0;
+    virtual Point2d map(const Point3& p) const = 0;
     virtual Point2d map(const SurfaceInteraction& intr,
                         Vector2d *dstdx = nullptr,
                         Vector2d *dstdy = nullptr) const = 0;
@@ -33,7 +33,7 @@ public:
                          double du = 0.0, double dv = 0.0,
                          bool invertHorizontal = true);
 
-    Point2d map(const Point3d& p) const override;
+    Point2d map(const Point3& p) const override;
     Point2d map(const SurfaceInteraction &intr,
                 Vector2d *dstdx = nullptr,
                 Vector2d *dstdy = nullptr) const override;
@@ -45,16 +45,16 @@ private:
 
 class SPICA_EXPORTS PlanarMapping2D : public TextureMapping2D {
 public:
-    PlanarMapping2D(const Vector3d& vs, const Vector3d& vt, double ds = 0.0,
+    PlanarMapping2D(const Vector3& vs, const Vector3& vt, double ds = 0.0,
                     double dt = 0.0);
 
-    Point2d map(const Point3d& p) const override;
+    Point2d map(const Point3& p) const override;
     Point2d map(const SurfaceInteraction& intr,
                 Vector2d* dstdx = nullptr,
                 Vector2d* dstdy = nullptr) const override;
 
 private:
-    const Vector3d vs_, vt_;
+    const Vector3 vs_, vt_;
     const double ds_, dt_;
 };
 
@@ -51,7 +51,7 @@ namespace spica {
     }
 
     Image GammaTmo::apply(const spica::Image& image) const {
-        Assertion(_gamma >= EPS, "Too small gamma is specified!!");
+        SPICA_CHECK(_gamma >= EPS, "Too small gamma is specified!!");
 
         const int width  = image.width();
         const int height = image.height();
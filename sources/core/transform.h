@@ -29,10 +29,10 @@ public:
     bool operator!=(const Transform& t);
     Transform& operator*=(const Transform& t);
 
-    Point3d  apply(const Point3d&  p) const;
-    Vector3d apply(const Vector3d& v) const;
-    Normal3d apply(const Normal3d& n) const;
-    Bounds3d  apply(const Bounds3d& b)  const;
+    Point3  apply(const Point3&  p) const;
+    Vector3 apply(const Vector3& v) const;
+    Normal3 apply(const Normal3& n) const;
+    Bounds3  apply(const Bounds3& b)  const;
 
     bool isIdentity() const;
 
@@ -43,11 +43,11 @@ public:
     inline const Matrix4x4& getInvMat() const { return mInv_; }
 
     // Public static methods
-    static Transform translate(const Vector3d& delta);
+    static Transform translate(const Vector3& delta);
     static Transform scale(double x, double y, double z);
-    static Transform rotate(double theta, const Vector3d& axis);
-    static Transform lookAt(const Point3d& eye, const Point3d& look,
-                            const Vector3d& up);
+    static Transform rotate(double theta, const Vector3& axis);
+    static Transform lookAt(const Point3& eye, const Point3& look,
+                            const Vector3& up);
     static Transform orthographic(double zNear, double zFar);
     static Transform perspective(double fov, double aspect, 
                                     double near, double far);
@@ -1,6 +1,7 @@
 #define SPICA_API_EXPORT
 #include "triangle.h"
 
+#include "core/float.h"
 #include "core/bounds3d.h"
 #include "core/interaction.h"
 
@@ -14,7 +15,7 @@ Triangle::Triangle()
     , faceNormal_{} {
 }
 
-Triangle::Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
+Triangle::Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
                    const Transform& objectToWorld)
     : Shape{ objectToWorld, ShapeType::Triangle }
     , points_{ objectToWorld.apply(p0),
@@ -24,49 +25,49 @@ Triangle::Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
     , uvs_{}
     , faceNormal_{} {
     // Compute face normals
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    faceNormal_ = Normal3d(Vector3d::cross(e1, e2).normalized());
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    faceNormal_ = Normal3(Vector3::cross(e1, e2).normalized());
     normals_ = { faceNormal_, faceNormal_, faceNormal_ };
 }
 
-Triangle::Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
-                   const Normal3d& n0, const Normal3d& n1, const Normal3d& n2,
+Triangle::Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
+                   const Normal3& n0, const Normal3& n1, const Normal3& n2,
                    const Transform& objectToWorld)
     : Shape{ objectToWorld, ShapeType::Triangle }
     , points_{ objectToWorld.apply(p0), 
                objectToWorld.apply(p1),
                objectToWorld.apply(p2) }
-    , normals_{ Normal3d(objectToWorld.apply(Vector3d(n0))).normalized(),
-                Normal3d(objectToWorld.apply(Vector3d(n1))).normalized(),
-                Normal3d(objectToWorld.apply(Vector3d(n2))).normalized() }
+    , normals_{ Normal3(objectToWorld.apply(Vector3(n0))).normalized(),
+                Normal3(objectToWorld.apply(Vector3(n1))).normalized(),
+                Normal3(objectToWorld.apply(Vector3(n2))).normalized() }
     , uvs_{} {
     // Compute normals
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    faceNormal_ = Normal3d(vect::cross(e1, e2));
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    faceNormal_ = Normal3(vect::cross(e1, e2));
     if (faceNormal_.norm() < EPS) {
         faceNormal_ = (normals_[0] + normals_[1] + normals_[2]) / 3.0;
     }
     faceNormal_ = vect::normalize(faceNormal_);
 }
 
-Triangle::Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
-                   const Normal3d& n0, const Normal3d& n1, const Normal3d& n2,
+Triangle::Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
+                   const Normal3& n0, const Normal3& n1, const Normal3& n2,
                    const Point2d& uv0, const Point2d& uv1, const Point2d& uv2,
                    const Transform& objectToWorld)
     : Shape{ objectToWorld, ShapeType::Triangle }
     , points_{ objectToWorld.apply(p0),
                objectToWorld.apply(p1),
                objectToWorld.apply(p2) }
-    , normals_{ Normal3d(objectToWorld.apply(Vector3d(n0))).normalized(),
-                Normal3d(objectToWorld.apply(Vector3d(n1))).normalized(),
-                Normal3d(objectToWorld.apply(Vector3d(n2))).normalized() }
+    , normals_{ Normal3(objectToWorld.apply(Vector3(n0))).normalized(),
+                Normal3(objectToWorld.apply(Vector3(n1))).normalized(),
+                Normal3(objectToWorld.apply(Vector3(n2))).normalized() }
     , uvs_{ uv0, uv1, uv2 } {
     // Compute normals
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    faceNormal_ = Normal3d(vect::cross(e1, e2));
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    faceNormal_ = Normal3(vect::cross(e1, e2));
     if (faceNormal_.norm() < EPS) {
         faceNormal_ = (normals_[0] + normals_[1] + normals_[2]) / 3.0;
     }
@@ -90,96 +91,113 @@ Triangle& Triangle::operator=(const Triangle& t) {
     return *this;
 }
 
-const Point3d& Triangle::operator[](int i) const {
+const Point3& Triangle::operator[](int i) const {
     Assertion(i >= 0 && i <= 2, "Index out of bounds!!");
     return points_[i];
 }
 
 bool Triangle::intersect(const Ray& ray, double* tHit,
                          SurfaceInteraction* isect) const {
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    Vector3d pVec = Vector3d::cross(ray.dir(), e2);
+    double b1, b2;
+    if (!hitTest(ray, tHit, &b1, &b2)) return false;
+    computeSurfaceInteraction(ray, *tHit, b1, b2, isect);
+    return true;
+}
 
-    double det = Vector3d::dot(e1, pVec);
+bool Triangle::hitTest(const Ray& ray, double* tHit,
+                       double* b1, double* b2) const {
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    Vector3 pVec = Vector3::cross(ray.dir(), e2);
+
+    double det = Vector3::dot(e1, pVec);
     if (det > -EPS && det <EPS) return false;
 
     double invdet = 1.0 / det;        
-    const Vector3d tVec = ray.org() - points_[0];
-    double u = Vector3d::dot(tVec, pVec) * invdet;
+    const Vector3 tVec = ray.org() - points_[0];
+    double u = Vector3::dot(tVec, pVec) * invdet;
     if (u < 0.0 || u > 1.0) return false;
 
-    const Vector3d qVec = Vector3d::cross(tVec, e1);
-    double v = Vector3d::dot(ray.dir(), qVec) * invdet;
+    const Vector3 qVec = Vector3::cross(tVec, e1);
+    double v = Vector3::dot(ray.dir(), qVec) * invdet;
     if (v < 0.0 || u + v > 1.0) return false;
 
-    *tHit = Vector3d::dot(e2, qVec) * invdet;
+    *tHit = Vector3::dot(e2, qVec) * invdet;
     if (*tHit <= EPS || *tHit > ray.maxDist()) return false;
 
-    Point3d  pos = ray.org() + (*tHit) * ray.dir();
+    *b1 = u;
+    *b2 = v;
+    return true;
+}
+
+void Triangle::computeSurfaceInteraction(const Ray& ray, double tHit,
+                                         double u, double v,
+                                         SurfaceInteraction* isect) const {
+    Point3  pos = ray.org() + tHit * ray.dir();
     Point2d  uv  = (1.0 - u - v) * uvs_[0] + u * uvs_[1] + v * uvs_[2];
 
     const Point2d duv01 = uvs_[1] - uvs_[0];
     const Point2d duv02 = uvs_[2] - uvs_[0];
     const double detUV = duv01.x() * duv02.y() - duv01.y() * duv02.x();
     
-    Vector3d dpdu, dpdv;
+    Vector3 dpdu, dpdv;
     if (detUV == 0.0) {
-        vect::coordinateSystem(Vector3d(faceNormal_), &dpdu, &dpdv);
+        vect::coordinateSystem(Vector3(faceNormal_), &dpdu, &dpdv);
     } else {
         const double invdet = 1.0 / detUV;
         const double invM[2][2] = { {  duv02.y() * invdet, -duv01.y() * invdet },
                                     { -duv02.x() * invdet,  duv01.x() * invdet } };
-        const Vector3d dp01 = points_[1]  - points_[0];
-        const Vector3d dp02 = points_[2]  - points_[0];
+        const Vector3 dp01 = points_[1]  - points_[0];
+        const Vector3 dp02 = points_[2]  - points_[0];
         dpdu = invM[0][0] * dp01 + invM[0][1] * dp02;
         dpdv = invM[1][0] * dp01 + invM[1][1] * dp02;
     }
-    *isect = SurfaceInteraction(pos, uv, -ray.dir(), dpdu, dpdv, Normal3d(), Normal3d(), this);
+    *isect = SurfaceInteraction(pos, uv, -ray.dir(), dpdu, dpdv, Normal3(), Normal3(), this);
 
     // Compute shading geometry
-    Normal3d ns = vect::normalize((1.0 - u - v) * normals_[0] + u * normals_[1] + v * normals_[2]);
-    if (std::abs(vect::dot(ns, faceNormal_)) < 1.0 - EPS) {
-        Normal3d ss = vect::normalize(vect::cross(ns, faceNormal_));
-        Normal3d ts = vect::normalize(vect::cross(ns, ss));
-
-        Normal3d dndu, dndv;
-        const Normal3d dn01 = normals_[1] - normals_[0];
-        const Normal3d dn02 = normals_[2] - normals_[0];
+    Normal3 ns = vect::normalize((1.0 - u - v) * normals_[0] + u * normals_[1] + v * normals_[2]);
+    // Leave the frame when the normals are parallel up to the rounding of
+    // "Float", or their cross product may vanish.
+    if (std::abs(vect::dot(ns, faceNormal_)) < 1.0 - std::max<double>(EPS, gamma(16))) {
+        Normal3 ss = vect::normalize(vect::cross(ns, faceNormal_));
+        Normal3 ts = vect::normalize(vect::cross(ns, ss));
+
+        Normal3 dndu, dndv;
+        const Normal3 dn01 = normals_[1] - normals_[0];
+        const Normal3 dn02 = normals_[2] - normals_[0];
         const double invdet = 1.0 / detUV;
         const double invM[2][2] = { {  duv02.y() * invdet, -duv01.y() * invdet },
                                     { -duv02.x() * invdet,  duv01.x() * invdet } };
         dndu = invM[0][0] * dn01 + invM[0][1] * dn02;
         dndv = invM[1][0] * dn01 + invM[1][1] * dn02;
-        isect->setShadingGeometry(Vector3d(ss), Vector3d(ts), dndu, dndv);
+        isect->setShadingGeometry(Vector3(ss), Vector3(ts), dndu, dndv);
     }
-    return true;
 }
 
 bool Triangle::intersect(const Ray& ray) const {
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    Vector3d pVec = Vector3d::cross(ray.dir(), e2);
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    Vector3 pVec = Vector3::cross(ray.dir(), e2);
 
-    double det = Vector3d::dot(e1, pVec);
+    double det = Vector3::dot(e1, pVec);
     if (det > -EPS && det <EPS) return false;
 
     double invdet = 1.0 / det;        
-    const Vector3d tVec = ray.org() - points_[0];
-    double u = Vector3d::dot(tVec, pVec) * invdet;
+    const Vector3 tVec = ray.org() - points_[0];
+    double u = Vector3::dot(tVec, pVec) * invdet;
     if (u < 0.0 || u > 1.0) return false;
 
-    const Vector3d qVec = Vector3d::cross(tVec, e1);
-    double v = Vector3d::dot(ray.dir(), qVec) * invdet;
+    const Vector3 qVec = Vector3::cross(tVec, e1);
+    double v = Vector3::dot(ray.dir(), qVec) * invdet;
     if (v < 0.0 || u + v > 1.0) return false;
 
-    const double tHit = Vector3d::dot(e2, qVec) * invdet;
+    const double tHit = Vector3::dot(e2, qVec) * invdet;
     return (tHit > EPS && tHit <= ray.maxDist());
 }
 
 Interaction Triangle::sample(const Point2d& rands) const {
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
 
     double u0, u1;
     if (rands[0] + rands[1] >= 1.0) {
@@ -190,29 +208,29 @@ Interaction Triangle::sample(const Point2d& rands) const {
         u1 = rands[1];
     }
 
-    Point3d  pos = points_[0] + u0 * e1 + u1 * e2;
-    Normal3d nrm = (1.0 - u0 - u1) * normals_[0] + u0 * normals_[1] +
+    Point3  pos = points_[0] + u0 * e1 + u1 * e2;
+    Normal3 nrm = (1.0 - u0 - u1) * normals_[0] + u0 * normals_[1] +
                    u1 * normals_[2];
     return Interaction{ pos, nrm };    
 }
 
-Bounds3d Triangle::worldBound() const {
-    Point3d posMin = Point3d::minimum(points_[0], Point3d::minimum(points_[1], points_[2]));
-    Point3d posMax = Point3d::maximum(points_[0], Point3d::maximum(points_[1], points_[2]));
-    return Bounds3d{ posMin, posMax };
+Bounds3 Triangle::worldBound() const {
+    Point3 posMin = Point3::minimum(points_[0], Point3::minimum(points_[1], points_[2]));
+    Point3 posMax = Point3::maximum(points_[0], Point3::maximum(points_[1], points_[2]));
+    return Bounds3{ posMin, posMax };
 }
 
-Bounds3d Triangle::objectBound() const {
-    Point3d posMin = Point3d::minimum(points_[0], Point3d::minimum(points_[1], points_[2]));
-    Point3d posMax = Point3d::maximum(points_[0], Point3d::maximum(points_[1], points_[2]));
-    return Bounds3d{ worldToObject_.apply(posMin),
+Bounds3 Triangle::objectBound() const {
+    Point3 posMin = Point3::minimum(points_[0], Point3::minimum(points_[1], points_[2]));
+    Point3 posMax = Point3::maximum(points_[0], Point3::maximum(points_[1], points_[2]));
+    return Bounds3{ worldToObject_.apply(posMin),
                      worldToObject_.apply(posMax) };
 }
 
 double Triangle::area() const {
-    const Vector3d e1 = points_[1] - points_[0];
-    const Vector3d e2 = points_[2] - points_[0];
-    return 0.5 * Vector3d::cross(e1, e2).norm();
+    const Vector3 e1 = points_[1] - points_[0];
+    const Vector3 e2 = points_[2] - points_[0];
+    return 0.5 * Vector3::cross(e1, e2).norm();
 }
 
 std::vector<Triangle> Triangle::triangulate() const {
@@ -220,7 +238,7 @@ std::vector<Triangle> Triangle::triangulate() const {
     return std::move(tris);
 }
 
-const Normal3d& Triangle::normal(int i) const {
+const Normal3& Triangle::normal(int i) const {
     Assertion(i >= 0 && i <= 2, "Index out of bounds: %d specified.", i);
     return normals_[i];
 }
@@ -230,7 +248,7 @@ const Point2d& Triangle::uv(int i) const {
     return uvs_[i];
 }
 
-Point3d Triangle::gravity() const {
+Point3 Triangle::gravity() const {
     return (points_[0] + points_[1] + points_[2]) / 3.0;
 }
 
@@ -21,13 +21,13 @@ class SPICA_EXPORTS Triangle : public Shape {
 public:
     // Public methods
     Triangle();
-    Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
+    Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
              const Transform& objectToWorld = Transform());
-    Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
-             const Normal3d& n0, const Normal3d& n1, const Normal3d& n2,
+    Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
+             const Normal3& n0, const Normal3& n1, const Normal3& n2,
              const Transform& objectToWorld = Transform());
-    Triangle(const Point3d& p0, const Point3d& p1, const Point3d& p2,
-             const Normal3d& n0, const Normal3d& n1, const Normal3d& n2,
+    Triangle(const Point3& p0, const Point3& p1, const Point3& p2,
+             const Normal3& n0, const Normal3& n1, const Normal3& n2,
              const Point2d& uv0, const Point2d& uv1, const Point2d& uv2,
              const Transform& objectToWorld = Transform());
     Triangle(const Triangle& t);
@@ -35,30 +35,35 @@ public:
     ~Triangle();
 
     Triangle& operator=(const Triangle& t);
-    const Point3d& operator[](int i) const;
+    const Point3& operator[](int i) const;
 
     bool intersect(const Ray& ray, double* tHit,
                    SurfaceInteraction* isect) const override;
     bool intersect(const Ray& ray) const override;
+    bool hitTest(const Ray& ray, double* tHit,
+                 double* b1, double* b2) const override;
+    void computeSurfaceInteraction(const Ray& ray, double tHit,
+                                   double b1, double b2,
+                                   SurfaceInteraction* isect) const override;
 
     Interaction sample(const Point2d& rands) const override;
 
-    Bounds3d worldBound()  const override;
-    Bounds3d objectBound() const override;
+    Bounds3 worldBound()  const override;
+    Bounds3 objectBound() const override;
 
     double area() const override;
     std::vector<Triangle> triangulate() const override;
 
-    Point3d gravity() const;
-    const Normal3d& normal(int i) const;
+    Point3 gravity() const;
+    const Normal3& normal(int i) const;
     const Point2d&  uv(int i) const;
 
 private:
     // Private fields
-    std::array<Point3d,  3> points_;
-    std::array<Normal3d, 3> normals_;
+    std::array<Point3,  3> points_;
+    std::array<Normal3, 3> normals_;
     std::array<Point2d,  3> uvs_;
-    Normal3d faceNormal_;
+    Normal3 faceNormal_;
 
 };  // class Triangle
 
@@ -0,0 +1,262 @@
+#define SPICA_API_EXPORT
+#include "trimesh.h"
+
+#include "core/triangle.h"
+#include "core/bounds3d.h"
+#include "core/float.h"
+#include "core/interaction.h"
+#include "core/material.h"
+
+namespace spica {
+
+// -----------------------------------------------------------------------------
+// TriangleMesh method definitions
+// -----------------------------------------------------------------------------
+
+TriangleMesh::TriangleMesh(const std::vector<Point3>& positions,
+                           const std::vector<int>& indices,
+                           const std::vector<Normal3>& normals,
+                           const std::vector<Point2d>& texcoords,
+                           const Transform& objectToWorld)
+    : positions_{}
+    , normals_{}
+    , texcoords_{ texcoords }
+    , indices_{ indices } {
+    SPICA_CHECK(indices.size() % 3 == 0, "# of indices must be a multiple of 3!!");
+    SPICA_CHECK(normals.empty() || normals.size() == positions.size(),
+              "# of normals must be equal to that of positions!!");
+    SPICA_CHECK(texcoords.empty() || texcoords.size() == positions.size(),
+              "# of texcoords must be equal to that of positions!!");
+
+    positions_.reserve(positions.size());
+    for (const auto& p : positions) {
+        positions_.push_back(objectToWorld.apply(p));
+    }
+
+    normals_.reserve(normals.size());
+    for (const auto& n : normals) {
+        normals_.push_back(Normal3(objectToWorld.apply(Vector3(n))).normalized());
+    }
+}
+
+TriangleMesh::~TriangleMesh() {
+}
+
+Bounds3 TriangleMesh::worldBound(int face) const {
+    const Point3& p0 = positions_[indices_[face * 3 + 0]];
+    const Point3& p1 = positions_[indices_[face * 3 + 1]];
+    const Point3& p2 = positions_[indices_[face * 3 + 2]];
+    Point3 posMin = Point3::minimum(p0, Point3::minimum(p1, p2));
+    Point3 posMax = Point3::maximum(p0, Point3::maximum(p1, p2));
+    return Bounds3{ posMin, posMax };
+}
+
+bool TriangleMesh::intersect(int face, const Ray& ray, double* tHit,
+                             SurfaceInteraction* isect) const {
+    double b1, b2;
+    if (!hitTest(face, ray, tHit, &b1, &b2)) return false;
+    computeInteraction(face, ray, *tHit, b1, b2, isect);
+    return true;
+}
+
+bool TriangleMesh::intersect(int face, const Ray& ray) const {
+    double tHit, b1, b2;
+    return hitTest(face, ray, &tHit, &b1, &b2);
+}
+
+bool TriangleMesh::hitTest(int face, const Ray& ray, double* tHit,
+                           double* b1, double* b2) const {
+    const Point3& p0 = vertex(face, 0);
+    const Vector3 e1 = vertex(face, 1) - p0;
+    const Vector3 e2 = vertex(face, 2) - p0;
+    Vector3 pVec = Vector3::cross(ray.dir(), e2);
+
+    double det = Vector3::dot(e1, pVec);
+    if (det > -EPS && det < EPS) return false;
+
+    double invdet = 1.0 / det;
+    const Vector3 tVec = ray.org() - p0;
+    double u = Vector3::dot(tVec, pVec) * invdet;
+    if (u < 0.0 || u > 1.0) return false;
+
+    const Vector3 qVec = Vector3::cross(tVec, e1);
+    double v = Vector3::dot(ray.dir(), qVec) * invdet;
+    if (v < 0.0 || u + v > 1.0) return false;
+
+    *tHit = Vector3::dot(e2, qVec) * invdet;
+    if (*tHit <= EPS || *tHit > ray.maxDist()) return false;
+
+    *b1 = u;
+    *b2 = v;
+    return true;
+}
+
+void TriangleMesh::computeInteraction(int face, const Ray& ray, double tHit,
+                                      double b1, double b2,
+                                      SurfaceInteraction* isect) const {
+    const int* v = &indices_[face * 3];
+    const Point3& p0 = positions_[v[0]];
+    const Vector3 e1 = positions_[v[1]] - p0;
+    const Vector3 e2 = positions_[v[2]] - p0;
+
+    const Normal3 faceNormal(vect::normalize(vect::cross(e1, e2)));
+    const Point2d uv0 = hasTexcoords() ? texcoords_[v[0]] : Point2d();
+    const Point2d uv1 = hasTexcoords() ? texcoords_[v[1]] : Point2d();
+    const Point2d uv2 = hasTexcoords() ? texcoords_[v[2]] : Point2d();
+
+    const double b0 = 1.0 - b1 - b2;
+    Point3 pos = ray.org() + tHit * ray.dir();
+    Point2d uv  = b0 * uv0 + b1 * uv1 + b2 * uv2;
+
+    const Point2d duv01 = uv1 - uv0;
+    const Point2d duv02 = uv2 - uv0;
+    const double detUV = duv01.x() * duv02.y() - duv01.y() * duv02.x();
+
+    Vector3 dpdu, dpdv;
+    double invM[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+    if (detUV == 0.0) {
+        vect::coordinateSystem(Vector3(faceNormal), &dpdu, &dpdv);
+    } else {
+        const double invdetUV = 1.0 / detUV;
+        invM[0][0] =  duv02.y() * invdetUV;
+        invM[0][1] = -duv01.y() * invdetUV;
+        invM[1][0] = -duv02.x() * invdetUV;
+        invM[1][1] =  duv01.x() * invdetUV;
+        dpdu = invM[0][0] * e1 + invM[0][1] * e2;
+        dpdv = invM[1][0] * e1 + invM[1][1] * e2;
+    }
+    *isect = SurfaceInteraction(pos, uv, -ray.dir(), dpdu, dpdv, Normal3(), Normal3(), nullptr);
+
+    // Compute shading geometry
+    if (!hasNormals()) return;
+
+    const Normal3& n0 = normals_[v[0]];
+    const Normal3& n1 = normals_[v[1]];
+    const Normal3& n2 = normals_[v[2]];
+    Normal3 ns = vect::normalize(b0 * n0 + b1 * n1 + b2 * n2);
+    if (std::abs(vect::dot(ns, faceNormal)) < 1.0 - std::max<double>(EPS, gamma(16))) {
+        Normal3 ss = vect::normalize(vect::cross(ns, faceNormal));
+        Normal3 ts = vect::normalize(vect::cross(ns, ss));
+
+        const Normal3 dn01 = n1 - n0;
+        const Normal3 dn02 = n2 - n0;
+        const Normal3 dndu = invM[0][0] * dn01 + invM[0][1] * dn02;
+        const Normal3 dndv = invM[1][0] * dn01 + invM[1][1] * dn02;
+        isect->setShadingGeometry(Vector3(ss), Vector3(ts), dndu, dndv);
+    }
+}
+
+Triangle TriangleMesh::triangle(int face) const {
+    Assertion(face >= 0 && face < numFaces(), "Face index out of bounds: %d specified.", face);
+
+    // Vertex attributes are already in the world space.
+    const int* v = &indices_[face * 3];
+    const Point3& p0 = positions_[v[0]];
+    const Point3& p1 = positions_[v[1]];
+    const Point3& p2 = positions_[v[2]];
+    if (!hasNormals()) {
+        return Triangle(p0, p1, p2);
+    }
+
+    const Normal3& n0 = normals_[v[0]];
+    const Normal3& n1 = normals_[v[1]];
+    const Normal3& n2 = normals_[v[2]];
+    if (!hasTexcoords()) {
+        return Triangle(p0, p1, p2, n0, n1, n2);
+    }
+
+    return Triangle(p0, p1, p2, n0, n1, n2,
+                    texcoords_[v[0]], texcoords_[v[1]], texcoords_[v[2]]);
+}
+
+std::vector<Triangle> TriangleMesh::triangulate() const {
+    std::vector<Triangle> tris;
+    tris.reserve(numFaces());
+    for (int i = 0; i < numFaces(); i++) {
+        tris.push_back(triangle(i));
+    }
+    return tris;
+}
+
+// -----------------------------------------------------------------------------
+// MeshTriangle method definitions
+// -----------------------------------------------------------------------------
+
+MeshTriangle::MeshTriangle(const std::shared_ptr<const SharedData>& data, int face)
+    : Primitive{}
+    , data_{ data }
+    , face_{ face } {
+}
+
+Bounds3 MeshTriangle::worldBound() const {
+    return data_->mesh->worldBound(face_);
+}
+
+bool MeshTriangle::intersect(Ray& ray, SurfaceInteraction* isect) const {
+    HitRecord hit;
+    if (!hitTest(ray, &hit)) return false;
+    computeSurfaceInteraction(ray, hit, isect);
+    return true;
+}
+
+bool MeshTriangle::hitTest(Ray& ray, HitRecord* hit) const {
+    double tHit, b1, b2;
+    if (!data_->mesh->hitTest(face_, ray, &tHit, &b1, &b2)) return false;
+    ray.setMaxDist(tHit);
+    hit->t = tHit;
+    hit->primitive = this;
+    hit->b1 = b1;
+    hit->b2 = b2;
+    return true;
+}
+
+void MeshTriangle::computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                             SurfaceInteraction* isect) const {
+    data_->mesh->computeInteraction(face_, ray, hit.t, hit.b1, hit.b2, isect);
+    isect->setPrimitive(this);
+
+    const auto& mi = data_->mediumInterface;
+    if (mi && mi->isMediumTransition()) {
+        isect->setMediumInterface(*mi);
+    } else {
+        isect->setMediumInterface(MediumInterface(ray.medium()));
+    }
+}
+
+bool MeshTriangle::intersect(Ray& ray) const {
+    return data_->mesh->intersect(face_, ray);
+}
+
+const Light* MeshTriangle::light() const {
+    return nullptr;
+}
+
+const Material* MeshTriangle::material() const {
+    return data_->material.get();
+}
+
+std::vector<Triangle> MeshTriangle::triangulate() const {
+    return std::vector<Triangle>(1, data_->mesh->triangle(face_));
+}
+
+void MeshTriangle::setScatterFuncs(SurfaceInteraction* isect, MemoryArena& arena) const {
+    if (data_->material) {
+        data_->material->setScatterFuncs(isect, arena);
+    }
+}
+
+std::vector<std::shared_ptr<Primitive>> MeshTriangle::createPrimitives(
+    const std::shared_ptr<TriangleMesh>& mesh,
+    const std::shared_ptr<Material>& material,
+    const std::shared_ptr<MediumInterface>& mediumInterface) {
+    auto data = std::make_shared<const SharedData>(SharedData{ mesh, material, mediumInterface });
+
+    std::vector<std::shared_ptr<Primitive>> prims;
+    prims.reserve(mesh->numFaces());
+    for (int i = 0; i < mesh->numFaces(); i++) {
+        prims.push_back(std::make_shared<MeshTriangle>(data, i));
+    }
+    return prims;
+}
+
+}  // namespace spica
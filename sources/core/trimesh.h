@@ -0,0 +1,121 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_TRIMESH_H_
+#define _SPICA_TRIMESH_H_
+
+#include <vector>
+#include <memory>
+
+#include "core/core.hpp"
+#include "core/common.h"
+#include "core/uncopyable.h"
+#include "core/point2d.h"
+#include "core/point3d.h"
+#include "core/normal3d.h"
+#include "core/transform.h"
+#include "core/primitive.h"
+#include "core/medium.h"
+
+#include "core/render.hpp"
+
+namespace spica {
+
+/**
+ * Indexed triangle mesh.
+ * @details
+ * Vertex attributes are shared by the faces, and each face refers to them
+ * with three vertex indices. Positions and normals are transformed to the
+ * world space when the mesh is constructed. Normals and texture coordinates
+ * are optional, and they are either empty or as many as the positions.
+ */
+class SPICA_EXPORTS TriangleMesh : private Uncopyable {
+public:
+    TriangleMesh(const std::vector<Point3>& positions,
+                 const std::vector<int>& indices,
+                 const std::vector<Normal3>& normals = {},
+                 const std::vector<Point2d>& texcoords = {},
+                 const Transform& objectToWorld = Transform());
+    ~TriangleMesh();
+
+    Bounds3 worldBound(int face) const;
+    bool intersect(int face, const Ray& ray, double* tHit,
+                   SurfaceInteraction* isect) const;
+    bool intersect(int face, const Ray& ray) const;
+
+    //! Test the face without filling an interaction. The barycentric
+    //! coordinates of the hit point for the 2nd and 3rd vertices are returned.
+    bool hitTest(int face, const Ray& ray, double* tHit,
+                 double* b1, double* b2) const;
+    void computeInteraction(int face, const Ray& ray, double tHit,
+                            double b1, double b2,
+                            SurfaceInteraction* isect) const;
+
+    //! Make a standalone triangle shape of the face (e.g., for area lights).
+    Triangle triangle(int face) const;
+    std::vector<Triangle> triangulate() const;
+
+    inline const Point3& vertex(int face, int i) const {
+        return positions_[indices_[face * 3 + i]];
+    }
+    inline int numFaces() const { return static_cast<int>(indices_.size() / 3); }
+    inline int numVerts() const { return static_cast<int>(positions_.size()); }
+    inline bool hasNormals()   const { return !normals_.empty(); }
+    inline bool hasTexcoords() const { return !texcoords_.empty(); }
+
+private:
+    std::vector<Point3>  positions_;
+    std::vector<Normal3> normals_;
+    std::vector<Point2d>  texcoords_;
+    std::vector<int>      indices_;
+};
+
+/**
+ * Primitive referring to a face of a triangle mesh.
+ * @details
+ * It only holds the mesh and the face index, and the material and the
+ * medium interface are shared by all the faces of the mesh. Emissive
+ * meshes should use GeometricPrimitive with the triangles given by
+ * TriangleMesh::triangle, because area lights sample their shapes.
+ */
+class SPICA_EXPORTS MeshTriangle : public Primitive {
+public:
+    struct SharedData {
+        std::shared_ptr<TriangleMesh> mesh;
+        std::shared_ptr<Material> material;
+        std::shared_ptr<MediumInterface> mediumInterface;
+    };
+
+    MeshTriangle(const std::shared_ptr<const SharedData>& data, int face);
+
+    Bounds3 worldBound() const override;
+    bool intersect(Ray& ray, SurfaceInteraction* isect) const override;
+    bool intersect(Ray& ray) const override;
+    bool hitTest(Ray& ray, HitRecord* hit) const override;
+    void computeSurfaceInteraction(const Ray& ray, const HitRecord& hit,
+                                   SurfaceInteraction* isect) const override;
+
+    const Light* light() const override;
+    const Material* material() const override;
+    std::vector<Triangle> triangulate() const override;
+    void setScatterFuncs(SurfaceInteraction* isect,
+                         MemoryArena& arena) const override;
+
+    inline const TriangleMesh* mesh() const { return data_->mesh.get(); }
+    inline int face() const { return face_; }
+
+    //! Create primitives for all the faces of the mesh.
+    static std::vector<std::shared_ptr<Primitive>> createPrimitives(
+        const std::shared_ptr<TriangleMesh>& mesh,
+        const std::shared_ptr<Material>& material,
+        const std::shared_ptr<MediumInterface>& mediumInterface = nullptr);
+
+private:
+    std::shared_ptr<const SharedData> data_;
+    int face_;
+};
+
+}  // namespace spica
+
+#endif  // _SPICA_TRIMESH_H_
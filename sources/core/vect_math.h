@@ -50,7 +50,7 @@ double sphericalPhi(const Vec& dir) {
 
 template <class Vec>
 double sphericalTheta(const Vec& dir) {
-    return std::acos(clamp(dir.z(), -1.0, 1.0));
+    return std::acos(clamp(static_cast<double>(dir.z()), -1.0, 1.0));
 }
 
 template <class Vec>
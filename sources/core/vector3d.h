@@ -43,19 +43,19 @@ public:
 
     /** The Vector3d destructor.
      */
-    virtual ~Vector3_();
+    ~Vector3_();
 
     Vector3_& operator=(const Vector3_& v);
     Vector3_& operator+=(const Vector3_& v);
-    Vector3_& operator+=(double x);
+    Vector3_& operator+=(T x);
     Vector3_& operator-=(const Vector3_& v);
-    Vector3_& operator-=(double x);
+    Vector3_& operator-=(T x);
     Vector3_  operator-() const;
 
     /** Element-wise multiplication.
      */
     Vector3_& operator*=(const Vector3_& v);
-    Vector3_& operator*=(double s);
+    Vector3_& operator*=(T s);
 
     /** Element-wise division
      *  @param v multiplied vector
@@ -65,7 +65,7 @@ public:
     /** Scalar multiplication
      *  @param s multiplied scalar
      */
-    Vector3_& operator/=(double s);
+    Vector3_& operator/=(T s);
 
     T operator[](int i) const;
 
@@ -78,8 +78,8 @@ public:
     Vector3_ cross(const Vector3_& v) const;
     static Vector3_ cross(const Vector3_& v1, const Vector3_& v2);
 
-    double norm() const;
-    double squaredNorm() const;
+    T norm() const;
+    T squaredNorm() const;
 
     Vector3_ normalized() const;
     static Vector3_ normalize(const Vector3_& v);
@@ -130,6 +130,7 @@ protected:
 using Vector3i = Vector3_<int>;
 using Vector3f = Vector3_<float>;
 using Vector3d = Vector3_<double>;
+using Vector3 = Vector3_<Float>;  // Precision of the geometry
 
 }  // namespace spica
 
@@ -165,11 +166,11 @@ operator*(const spica::Vector3_<T>& u, const spica::Vector3_<T>& v);
 
 template <class T>
 spica::Vector3_<T>
-operator*(const spica::Vector3_<T>& v, double s);
+operator*(const spica::Vector3_<T>& v, typename spica::Vector3_<T>::type s);
 
 template <class T>
 spica::Vector3_<T>
-operator*(double s, const spica::Vector3_<T>& v);
+operator*(typename spica::Vector3_<T>::type s, const spica::Vector3_<T>& v);
 
 /** Element-wise division
  */
@@ -179,7 +180,7 @@ operator/(const spica::Vector3_<T>& u, const spica::Vector3_<T>& v);
 
 template <class T>
 spica::Vector3_<T>
-operator/(const spica::Vector3_<T>& v, double s);
+operator/(const spica::Vector3_<T>& v, typename spica::Vector3_<T>::type s);
 
 template <class T>
 std::ostream& operator<<(std::ostream& os, const spica::Vector3_<T>& v);
@@ -74,7 +74,7 @@ Vector3_<T>::operator+=(const Vector3_<T>& v) {
 
 template <class T>
 Vector3_<T>&
-Vector3_<T>::operator+=(double x) {
+Vector3_<T>::operator+=(T x) {
     this->x_ += x;
     this->y_ += x;
     this->z_ += x;
@@ -90,7 +90,7 @@ Vector3_<T>::operator-=(const Vector3_<T>& v) {
 
 template <class T>
 Vector3_<T>&
-Vector3_<T>::operator-=(double x) {
+Vector3_<T>::operator-=(T x) {
     this->operator+=(-x);
     return *this;
 }
@@ -112,7 +112,7 @@ Vector3_<T>::operator*=(const Vector3_<T>& v) {
 
 template <class T>
 Vector3_<T>&
-Vector3_<T>::operator*=(double s) {
+Vector3_<T>::operator*=(T s) {
     this->x_ *= s;
     this->y_ *= s;
     this->z_ *= s;
@@ -131,9 +131,15 @@ Vector3_<T>::operator/=(const Vector3_<T>& v) {
 
 template <class T>
 Vector3_<T>&
-Vector3_<T>::operator/=(double s) {
-    Assertion(s != 0.0, "Zero division");
-    return this->operator*=(1.0 / s);
+Vector3_<T>::operator/=(T s) {
+    Assertion(s != 0, "Zero division");
+    if (std::is_floating_point<T>::value) {
+        return this->operator*=(T(1) / s);
+    }
+    this->x_ /= s;
+    this->y_ /= s;
+    this->z_ /= s;
+    return *this;
 }
 
 template <class T>
@@ -182,12 +188,12 @@ Vector3_<T>::cross(const Vector3_<T>& v1,
 }
 
 template <class T>
-double Vector3_<T>::norm() const {
-    return ::sqrt(this->squaredNorm());
+T Vector3_<T>::norm() const {
+    return std::sqrt(this->squaredNorm());
 }
 
 template <class T>
-double Vector3_<T>::squaredNorm() const {
+T Vector3_<T>::squaredNorm() const {
     return this->dot(*this);
 }
 
@@ -237,7 +243,7 @@ T Vector3_<T>::get(int d) const {
     if (d == 0) return x_;
     if (d == 1) return y_;
     if (d == 2) return z_;
-    return 0.0;
+    return 0;
 }
 
 template <class T>
@@ -306,7 +312,7 @@ operator*(const spica::Vector3_<T>& u,
 
 template <class T>
 spica::Vector3_<T>
-operator*(const spica::Vector3_<T>& v, double s) {
+operator*(const spica::Vector3_<T>& v, typename spica::Vector3_<T>::type s) {
     spica::Vector3_<T> ret = v;
     ret *= s;
     return ret;
@@ -314,7 +320,7 @@ operator*(const spica::Vector3_<T>& v, double s) {
 
 template <class T>
 spica::Vector3_<T>
-operator*(double s, const spica::Vector3_<T>& v) {
+operator*(typename spica::Vector3_<T>::type s, const spica::Vector3_<T>& v) {
     spica::Vector3_<T> ret = v;
     ret *= s;
     return ret;
@@ -331,7 +337,7 @@ operator/(const spica::Vector3_<T>& u,
 
 template <class T>
 spica::Vector3_<T>
-operator/(const spica::Vector3_<T>& v, double s) {
+operator/(const spica::Vector3_<T>& v, typename spica::Vector3_<T>::type s) {
     spica::Vector3_<T> ret = v;
     ret /= s;
     return ret;
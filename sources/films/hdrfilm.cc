@@ -16,6 +16,20 @@ HDRFilm::HDRFilm(RenderParams &params)
     : HDRFilm{Point2i(params.getInt("width", true), params.getInt("height", true)),
               std::static_pointer_cast<Filter>(params.getObject("rfilter", true)),
               params.getString("outputFile")} {
+    setSaveInterval(params.getInt("saveInterval", 1),
+                    params.getDouble("saveSeconds", 0.0));
+
+    const std::string accumFile = params.getString("accumulationFile", std::string());
+    if (!accumFile.empty()) {
+        setAccumulationFile(accumFile, params.getBool("resume", false, false));
+    }
+
+    setSaveVariance(params.getBool("saveVariance", false, false));
+}
+
+HDRFilm::~HDRFilm() {
+    // Images must be written while saveImage is still available.
+    close();
 }
 
 void HDRFilm::saveImage(const std::string &filename, const Image &image) const {
@@ -24,4 +38,19 @@ void HDRFilm::saveImage(const std::string &filename, const Image &image) const {
     MsgInfo("Save: %s", outfile.c_str());
 }
 
+void HDRFilm::saveScanlines(const std::string &filename,
+                            const std::function<void(int, RGBSpectrum*)> &developRow) const {
+    const std::string outfile = filename + ".hdr";
+    const int width  = resolution().x();
+    const int height = resolution().y();
+
+    HdrScanlineWriter writer(outfile, width, height);
+    std::vector<RGBSpectrum> row(width);
+    for (int y = 0; y < height; y++) {
+        developRow(y, row.data());
+        writer.writeScanline(row.data());
+    }
+    MsgInfo("Save: %s", outfile.c_str());
+}
+
 }  // namespace spica
\ No newline at end of file
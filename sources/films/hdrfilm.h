@@ -20,8 +20,12 @@ public:
 
     HDRFilm(RenderParams &params);
 
+    ~HDRFilm();
+
 protected:
     void saveImage(const std::string &filename, const Image &image) const override;
+    void saveScanlines(const std::string &filename,
+                       const std::function<void(int, RGBSpectrum*)> &developRow) const override;
 };
 
 SPICA_EXPORT_PLUGIN(HDRFilm, "High dynamic range film");
@@ -20,6 +20,20 @@ LDRFilm::LDRFilm(RenderParams &params)
               std::static_pointer_cast<Filter>(params.getObject("rfilter", true)),
               params.getString("outputFile", "image"),
               params.getDouble("gamma", 2.2)} {
+    setSaveInterval(params.getInt("saveInterval", 1),
+                    params.getDouble("saveSeconds", 0.0));
+
+    const std::string accumFile = params.getString("accumulationFile", std::string());
+    if (!accumFile.empty()) {
+        setAccumulationFile(accumFile, params.getBool("resume", false, false));
+    }
+
+    setSaveVariance(params.getBool("saveVariance", false, false));
+}
+
+LDRFilm::~LDRFilm() {
+    // Images must be written while saveImage is still available.
+    close();
 }
 
 void LDRFilm::saveImage(const std::string &filename, const Image &image) const {
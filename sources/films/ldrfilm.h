@@ -20,6 +20,8 @@ public:
 
     LDRFilm(RenderParams &params);
 
+    ~LDRFilm();
+
 protected:
     void saveImage(const std::string &filename, const Image &image) const override;
 
@@ -1,8 +1,6 @@
 #define SPICA_API_EXPORT
 #include "bdpt.h"
 
-#include <mutex>
-
 #include "core/ray.h"
 #include "core/interaction.h"
 #include "core/sampling.h"
@@ -10,6 +8,7 @@
 #include "core/parallel.h"
 #include "core/renderparams.h"
 #include "core/film.h"
+#include "core/checkpoint.h"
 #include "core/scene.h"
 #include "core/light.h"
 #include "core/camera.h"
@@ -28,7 +27,7 @@ enum class VertexType : int {
 };
 
 double densityIBL(const Scene& scene, const Distribution1D& lightDist,
-                  const Vector3d& w) {
+                  const Vector3& w) {
     double pdf = 0.0;
     const int nLights = (int)scene.lights().size();
     for (int i = 0; i < nLights; i++) {
@@ -54,7 +53,7 @@ struct EndpointInteraction : Interaction {
     EndpointInteraction(const Ray& ray)
         : Interaction { ray.proceeded(1.0) }
         , light{ nullptr } {
-        normal_ = Normal3d(-ray.dir());
+        normal_ = Normal3(-ray.dir());
     }
 
     EndpointInteraction(const Interaction& it, const Light* light_)
@@ -73,7 +72,7 @@ struct EndpointInteraction : Interaction {
     }
 
     // TODO: a bit different.
-    EndpointInteraction(const Light* light_, const Ray& r, const Normal3d& nl)
+    EndpointInteraction(const Light* light_, const Ray& r, const Normal3& nl)
         : Interaction{ r.org() }
         , light{ light_ } {
         normal_ = nl;        
@@ -148,13 +147,13 @@ struct Vertex {
         return *this;
     }
 
-    inline Point3d pos() const { return intr->pos(); }
-    inline Normal3d normal() const { return intr->normal(); }
+    inline Point3 pos() const { return intr->pos(); }
+    inline Normal3 normal() const { return intr->normal(); }
 
     Spectrum Le(const Scene& scene, const Vertex& v) const {
         if (!isLight()) return Spectrum(0.0);
 
-        Vector3d w = v.pos() - this->pos();
+        Vector3 w = v.pos() - this->pos();
         if (w.squaredNorm() == 0.0) return Spectrum(0.0);
 
         w = w.normalized();
@@ -184,11 +183,11 @@ struct Vertex {
     }
 
     inline bool isOnSurface() const {
-        return normal() != Normal3d();
+        return normal() != Normal3();
     }
 
     Spectrum f(const Vertex& next) const {
-        Vector3d wi = next.pos() - this->pos();
+        Vector3 wi = next.pos() - this->pos();
         if (wi.squaredNorm() == 0.0) return Spectrum(0.0);
 
         wi = wi.normalized();
@@ -245,7 +244,7 @@ struct Vertex {
     double convertDensity(double pdf, const Vertex& next) const {
         if (next.isIBL()) return pdf;
 
-        Vector3d w = next.pos() - this->pos();
+        Vector3 w = next.pos() - this->pos();
         double dist2 = w.squaredNorm();
         if (dist2 == 0.0) return 0.0;
 
@@ -260,11 +259,11 @@ struct Vertex {
                const Vertex& next) const {
         if (type == VertexType::Light) return pdfLight(scene, next);
 
-        Vector3d wn = next.pos() - this->pos();
+        Vector3 wn = next.pos() - this->pos();
         if (wn.squaredNorm() == 0.0) return 0.0;
 
         wn = wn.normalized();
-        Vector3d wp;
+        Vector3 wp;
         if (prev) {
             wp = prev->pos() - this->pos();
             if (wp.squaredNorm() == 0.0) return 0.0;
@@ -288,14 +287,14 @@ struct Vertex {
     }
 
     double pdfLight(const Scene& scene, const Vertex& v) const {
-        Vector3d w = v.pos() - this->pos();
+        Vector3 w = v.pos() - this->pos();
         double invDist2 = 1.0 / w.squaredNorm();
         w *= std::sqrt(invDist2);
 
         double pdf;
         if (isIBL()) {
-            Bounds3d b = scene.worldBound();
-            Point3d worldCenter = (b.posMin() + b.posMax()) * 0.5;
+            Bounds3 b = scene.worldBound();
+            Point3 worldCenter = (b.posMin() + b.posMax()) * 0.5;
             double worldRadius = (b.posMax() - worldCenter).norm();
             pdf = 1.0 / (PI * worldRadius * worldRadius);
         } else {
@@ -315,7 +314,7 @@ struct Vertex {
 
     double pdfLightOrigin(const Scene& scene, const Vertex& v,
                           const Distribution1D& lightDist) const {
-        Vector3d w = v.pos() - this->pos();
+        Vector3 w = v.pos() - this->pos();
         if (w.squaredNorm() == 0.0) return 0.0;
 
         w = w.normalized();
@@ -361,7 +360,7 @@ struct Vertex {
     }
 
     static inline Vertex createLight(const Light& light, const Ray& ray,
-                                     const Normal3d& nrmLight, const Spectrum& Le,
+                                     const Normal3& nrmLight, const Spectrum& Le,
                                      double pdf) {
         Vertex v(VertexType::Light, EndpointInteraction(&light, ray, nrmLight), Le);
         v.pdfFwd = pdf;
@@ -432,7 +431,7 @@ int randomWalk(const Scene& scene, Ray ray, Sampler& sampler,
             vertex = Vertex::createMedium(mi, beta, pdfFwd, prev);
             if (++bounces >= maxDepth) break;
         
-            Vector3d wi;
+            Vector3 wi;
             pdfFwd = pdfRev = mi.phase()->sample(-ray.dir(), &wi, sampler.get2D());
             ray = mi.spawnRay(wi);
         } else {
@@ -457,13 +456,13 @@ int randomWalk(const Scene& scene, Ray ray, Sampler& sampler,
             if (++bounces >= maxDepth) break;
 
             // Sample next direction and compute reverse probability.
-            Vector3d wi, wo = isect.wo();
+            Vector3 wi, wo = isect.wo();
             BxDFType type;
             Spectrum f = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdfFwd,
                                               BxDFType::All, &type);
             if (f.isBlack() || pdfFwd == 0.0) break;
 
-            beta *= f * vect::absDot(wi, isect.normal()) / pdfFwd;
+            beta *= f * (vect::absDot(wi, isect.normal()) / pdfFwd);
             pdfRev = isect.bsdf()->pdf(wi, wo, BxDFType::All);
             if ((type & BxDFType::Specular) != BxDFType::None) {
                 vertex.delta = true;
@@ -507,7 +506,7 @@ int calcLightSubpath(const Scene& scene, Sampler& sampler,
 
     // Generate a ray, and compute contributing light radiance.
     Ray ray;
-    Normal3d nrmLight;
+    Normal3 nrmLight;
     double pdfPos, pdfDir;
     Spectrum Le = light->sampleLe(sampler.get2D(), sampler.get2D(), &ray,
                                   &nrmLight, &pdfPos, &pdfDir);
@@ -612,7 +611,7 @@ double calcMISWeight(const Scene& scene,
 
 Spectrum G(const Scene& scene, Sampler& sampler, const Vertex& v0,
            const Vertex& v1) {
-    Vector3d d = v0.pos() - v1.pos();
+    Vector3 d = v0.pos() - v1.pos();
     double g = 1.0 / d.squaredNorm();
 
     d *= std::sqrt(g);
@@ -642,7 +641,7 @@ Spectrum connectBDPT(const Scene& scene,
         const Vertex& vl = lightPath[lightID - 1];
         if (vl.isConnectible()) {
             VisibilityTester vis;
-            Vector3d wi;
+            Vector3 wi;
             double pdf;
             Spectrum Wi = camera.sampleWi(vl.getInteraction(), sampler.get2D(),
                                           &wi, &pdf, pRaster, &vis);
@@ -658,7 +657,7 @@ Spectrum connectBDPT(const Scene& scene,
         if (vc.isConnectible()) {
             double lightPdf;
             VisibilityTester vis;
-            Vector3d wi;
+            Vector3 wi;
             double pdf;
             int id = lightDist.sampleDiscrete(sampler.get1D(), &lightPdf);
             const auto& l = scene.lights()[id];
@@ -688,7 +687,7 @@ Spectrum connectBDPT(const Scene& scene,
     double misW = L.isBlack() ? 0.0 : calcMISWeight(scene, lightPath, cameraPath,
                                                     sampled, lightID, cameraID,
                                                     lightDist);
-    Assertion(!std::isnan(misW), "Invalid MIS weight!!");
+    SPICA_PARANOID_CHECK(!std::isnan(misW), "Invalid MIS weight!!");
 
     L *= misW;
     if (misWeight) *misWeight = misW;
@@ -724,16 +723,27 @@ void BDPTIntegrator::render(const std::shared_ptr<const Camera>& camera,
     const int numPixels = width * height;
     const int numSamples = params.getInt("sampleCount");
     const int maxBounces = params.getInt("maxDepth");
-    for (int i = 0; i < numSamples; i++) {
+
+    // Resume from the checkpoint
+    Checkpointer checkpointer(params, "BDPTIntegrator");
+    int startPass = 0;
+    bool samplersLoaded = false;
+    if (auto reader = checkpointer.resume()) {
+        reader->read(&startPass);
+        camera->film()->loadState(*reader);
+        samplersLoaded = loadSamplers(*reader, *sampler_, &samplers);
+    }
+
+    for (int i = startPass; i < numSamples; i++) {
         // Prepare samplers
-        if (i % numThreads == 0) {
+        if (i % numThreads == 0 || (i == startPass && !samplersLoaded)) {
             for (int t = 0; t < numThreads; t++) {
                 auto seed = static_cast<unsigned int>(time(0) + t);
                 samplers[t] = sampler_->clone(seed);
             }
         }
 
-        std::mutex mtx;
+        camera->film()->beginPass(i);
         std::atomic<int> proc(0);
         parallel_for(0, numPixels, [&](int pid) {
             const int threadID = getThreadID();
@@ -767,9 +777,7 @@ void BDPTIntegrator::render(const std::shared_ptr<const Camera>& camera,
                         &pFilm, &misWeight);
                     if (cid == 1 && !Lpath.isBlack()) {
                         pFilm = Point2d(width - pFilm.x(), pFilm.y());
-                        mtx.lock();
-                        camera->film()->addPixel(pFilm, Lpath);
-                        mtx.unlock();
+                        camera->film()->addSplat(pFilm, Lpath);
                     } else {
                         L += Lpath;
                     }
@@ -783,13 +791,27 @@ void BDPTIntegrator::render(const std::shared_ptr<const Camera>& camera,
                 fflush(stdout);
             }
         });
+        camera->film()->endPass(i + 1);
 
-        camera->film()->saveMLT(1.0 / (i + 1), i + 1);
+        if (camera->film()->saveDue(i + 1, i + 1 == numSamples)) {
+            camera->film()->saveMLT(1.0 / (i + 1), i + 1);
+        }
 
         for (int t = 0; t < numThreads; t++) {
             arenas[t].reset();
         }
+
+        // Save the checkpoint
+        if (checkpointer.due(camera->film()->mapped())) {
+            const int numPasses = i + 1;
+            auto writer = checkpointer.writer();
+            writer->write(numPasses);
+            camera->film()->saveState(*writer);
+            saveSamplers(*writer, samplers);
+            writer->commit();
+        }
     }
+    camera->film()->close();
     std::cout << "Finish!!" << std::endl;    
 }
 
@@ -16,6 +16,7 @@ DirectLightingIntegrator::DirectLightingIntegrator(
 
 DirectLightingIntegrator::DirectLightingIntegrator(RenderParams &params)
     : DirectLightingIntegrator{std::static_pointer_cast<Sampler>(params.getObject("sampler", true))} {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
 }
 
 Spectrum DirectLightingIntegrator::Li(const Scene& scene,
@@ -44,12 +45,12 @@ Spectrum DirectLightingIntegrator::Li(const Scene& scene,
         L += isect.Le(-ray.dir());
     }
 
-    Vector3d wo = isect.wo();
+    Vector3 wo = isect.wo();
     if (scene.lights().size() > 0) {
         L += uniformSampleOneLight(isect, scene, arena, sampler);
     }
 
-    if (depth + 1 < params.getInt("maxDepth")) {
+    if (depth + 1 < maxDepth_) {
         L += specularReflect(scene, params, ray, isect, sampler, arena, depth + 1);
         L += specularTransmit(scene, params, ray, isect, sampler, arena, depth + 1);
     }
@@ -6,6 +6,7 @@
 #define _SPICA_DIRECTLIGHTING_H_
 
 #include "core/integrator.h"
+#include "core/renderparams.h"
 
 namespace spica {
 
@@ -21,6 +22,9 @@ public:
                 Sampler& sampler,
                 MemoryArena& arena,
                 int depth = 0) const override;
+
+private:
+    ParamHandle<int> maxDepth_{ 16 };
 };
 
 SPICA_EXPORT_PLUGIN(DirectLightingIntegrator, "Integrate only direct lighting");
@@ -5,6 +5,7 @@
 #include "core/parallel.h"
 #include "core/camera.h"
 #include "core/film.h"
+#include "core/checkpoint.h"
 #include "core/sampler.h"
 #include "core/scene.h"
 #include "core/bsdf.h"
@@ -48,7 +49,7 @@ struct TraceRecord {
 
 struct SurfaceEventRecord {
     SurfaceEventRecord() {}
-    SurfaceEventRecord(const Vector3d &wh_, const Vector3d &whLocal_, BxDFType bxdfType_,
+    SurfaceEventRecord(const Vector3 &wh_, const Vector3 &whLocal_, BxDFType bxdfType_,
                        double eta_, int sampledLightIndex_ = -1,
                        const Point2d &randLight_ = Point2d(),
                        const Point2d &randShade_ = Point2d())
@@ -61,8 +62,8 @@ struct SurfaceEventRecord {
         , randShade{randShade_} {
     }
 
-    Vector3d wh;
-    Vector3d whLocal;
+    Vector3 wh;
+    Vector3 whLocal;
     BxDFType bxdfType;
     double eta;
     int sampledLightIndex;
@@ -71,7 +72,7 @@ struct SurfaceEventRecord {
 };
 
 struct Vertex {
-    static Vertex createCamera(const Point3d &pos) {
+    static Vertex createCamera(const Point3 &pos) {
         Vertex v;
         v.intr = std::make_shared<Interaction>(pos);
         v.type = VertexType::Camera;
@@ -96,17 +97,17 @@ struct Vertex {
 
     static Vertex createLight(const Ray &ray) {
         Vertex v;
-        v.intr = std::make_shared<Interaction>(ray.org(), Normal3d(), -ray.dir());
+        v.intr = std::make_shared<Interaction>(ray.org(), Normal3(), -ray.dir());
         v.type = VertexType::Light;
         return v;
     }
 
-    Point3d pos() const {
+    Point3 pos() const {
         Assertion(intr != nullptr, "Interaction has no position. Maybe this is light endpoint of non area light.");
         return intr->pos();
     }
 
-    Normal3d normal() const {
+    Normal3 normal() const {
         Assertion(intr != nullptr, "Interaction has no position. Maybe this is light endpoint of non area light.");
         return intr->normal();
     }
@@ -168,8 +169,8 @@ struct Vertex {
 };
 
 bool nextDirection(const SurfaceInteraction &isect, const Vertex &prev, const Vertex &current, const Vertex &next,
-                   Vector3d *wiOffset, double *pdf, Spectrum *f, double *J, bool *reconnect, bool *specularBounce) {
-    const Vector3d woOffset = isect.wo();
+                   Vector3 *wiOffset, double *pdf, Spectrum *f, double *J, bool *reconnect, bool *specularBounce) {
+    const Vector3 woOffset = isect.wo();
     *reconnect = false;
     
     // Compute next direction, reflectance and PDF
@@ -203,10 +204,10 @@ bool nextDirection(const SurfaceInteraction &isect, const Vertex &prev, const Ve
     } else if ((current.isDiffuse() && isect.bsdf()->hasType(BxDFType::Diffuse)) ||
                (current.isGlossy() && isect.bsdf()->hasType(BxDFType::Glossy))) {
         // Half-vector copy
-        const Vector3d whLocalBase = current.surfaceRecord.whLocal;
-        const Vector3d whOffset = vect::normalize(whLocalBase.x() * isect.dpdu() +
-                                                  whLocalBase.y() * isect.dpdv() +
-                                                  whLocalBase.z() * Vector3d(isect.normal()));
+        const Vector3 whLocalBase = current.surfaceRecord.whLocal;
+        const Vector3 whOffset = vect::normalize(whLocalBase.x() * isect.dpdu() +
+                                                 whLocalBase.y() * isect.dpdv() +
+                                                 whLocalBase.z() * Vector3(isect.normal()));
         if (current.isReflection()) {
             // Reflection
             *wiOffset = vect::reflect(isect.wo(), whOffset);
@@ -232,14 +233,14 @@ bool nextDirection(const SurfaceInteraction &isect, const Vertex &prev, const Ve
     }
 
     // Compute Jacobian
-    const Vector3d wiBase = vect::normalize(next.pos() - current.pos());
-    const Vector3d woBase = vect::normalize(prev.pos() - current.pos());
+    const Vector3 wiBase = vect::normalize(next.pos() - current.pos());
+    const Vector3 woBase = vect::normalize(prev.pos() - current.pos());
     if (*reconnect) {
         // Reconnect
-        Normal3d nx = current.intr->normal();
-        Normal3d ny = isect.ns();
-        double cosThetaX = std::max(0.0, vect::dot(nx, wiBase));
-        double cosThetaY = std::max(0.0, vect::dot(ny, *wiOffset));
+        Normal3 nx = current.intr->normal();
+        Normal3 ny = isect.ns();
+        double cosThetaX = std::max(0.0, static_cast<double>(vect::dot(nx, wiBase)));
+        double cosThetaY = std::max(0.0, static_cast<double>(vect::dot(ny, *wiOffset)));
         double distX = (next.pos() - current.pos()).squaredNorm();
         double distY = (next.pos() - isect.pos()).squaredNorm();
         if (cosThetaX * distY == 0.0) {
@@ -251,10 +252,10 @@ bool nextDirection(const SurfaceInteraction &isect, const Vertex &prev, const Ve
         // Half-vector copy
         if (current.isReflection()) {
             // Reflection
-            const Vector3d whBase = current.surfaceRecord.wh;
-            const Vector3d whOffset = vect::normalize(woOffset + (*wiOffset));
-            const double dotX = std::max(0.0, vect::dot(woBase, whBase));
-            const double dotY = std::max(0.0, vect::dot(woOffset, whOffset));
+            const Vector3 whBase = current.surfaceRecord.wh;
+            const Vector3 whOffset = vect::normalize(woOffset + (*wiOffset));
+            const double dotX = std::max(0.0, static_cast<double>(vect::dot(woBase, whBase)));
+            const double dotY = std::max(0.0, static_cast<double>(vect::dot(woOffset, whOffset)));
             if (dotX == 0.0) {
                 *J = 0.0;
             } else {
@@ -271,8 +272,8 @@ bool nextDirection(const SurfaceInteraction &isect, const Vertex &prev, const Ve
                 etaY = 1.0 / etaY;
             }
             
-            const Vector3d whBase = current.surfaceRecord.wh;
-            const Vector3d whOffset = vect::normalize(woOffset + etaY * (*wiOffset));
+            const Vector3 whBase = current.surfaceRecord.wh;
+            const Vector3 whOffset = vect::normalize(woOffset + etaY * (*wiOffset));
             const double dotX = vect::absDot(wiBase, whBase);
             const double dotY = vect::absDot(*wiOffset, whOffset);
             const double distX = (etaX * wiBase + woBase).squaredNorm();
@@ -377,7 +378,7 @@ TraceRecord shiftMap(const Scene &scene, RenderParams &params, const Ray &r, Sam
         const Vertex &next = baseVerts[bounces + 1];
 
         // Next direction
-        Vector3d wiSub;
+        Vector3 wiSub;
         double J = 1.0, pdf = 0.0;
         Spectrum f(0.0);
         specularBounce = false;
@@ -402,7 +403,7 @@ TraceRecord shiftMap(const Scene &scene, RenderParams &params, const Ray &r, Sam
     return record;    
 }
 
-TraceRecord pathTrace(const Scene &scene, RenderParams &params, const Ray &r,
+TraceRecord pathTrace(const Scene &scene, int maxBounces, const Ray &r,
                       Sampler &sampler, MemoryArena &arena, std::vector<Vertex> *vertices) {
     const auto addItem = [&](const Vertex &v) {
         if (vertices) {
@@ -458,7 +459,7 @@ TraceRecord pathTrace(const Scene &scene, RenderParams &params, const Ray &r,
             }
         }
 
-        if (!isIntersect || bounces >= params.getInt("maxDepth")) {
+        if (!isIntersect || bounces >= maxBounces) {
             break;
         }
 
@@ -482,8 +483,8 @@ TraceRecord pathTrace(const Scene &scene, RenderParams &params, const Ray &r,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -497,7 +498,7 @@ TraceRecord pathTrace(const Scene &scene, RenderParams &params, const Ray &r,
         ray = isect.spawnRay(wi);
 
         // Compute half vector
-        Vector3d wh;
+        Vector3 wh;
         double eta = 1.0;
         if ((sampledType & BxDFType::Transmission) != BxDFType::None) {
             
@@ -510,7 +511,7 @@ TraceRecord pathTrace(const Scene &scene, RenderParams &params, const Ray &r,
         } else {
             wh = vect::normalize(wi + wo);            
         }
-        Vector3d whLocal = Vector3d(wh.dot(isect.dpdu()), wh.dot(isect.dpdv()), wh.dot(Vector3d(isect.normal()))).normalized();
+        Vector3 whLocal = Vector3(wh.dot(isect.dpdu()), wh.dot(isect.dpdv()), wh.dot(Vector3(isect.normal()))).normalized();
 
 
         // Add vertex
@@ -565,6 +566,7 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
     const int offsetY[] = { 0, 0, -1, 1 };
     const int numPixels  = width * height;
     const int numSamples = params.getInt("sampleCount");
+    const int maxBounces = params.getInt("maxDepth");
     
     Image inversionRatio(width, height);
     auto shiftImages = std::make_unique<Image[]>(4);
@@ -574,9 +576,19 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
         misImages[k] = Image(width, height);
     }
 
-    for (int i = 0; i < numSamples; i++) {
+    // Resume from the checkpoint
+    Checkpointer checkpointer(params, "GDPTIntegrator");
+    int startPass = 0;
+    bool samplersLoaded = false;
+    if (auto reader = checkpointer.resume()) {
+        reader->read(&startPass);
+        film.loadState(*reader);
+        samplersLoaded = loadSamplers(*reader, *sampler_, &samplers);
+    }
+
+    for (int i = startPass; i < numSamples; i++) {
         // Prepare samplers
-        if (i % numThreads == 0) {
+        if (i % numThreads == 0 || (i == startPass && !samplersLoaded)) {
             for (int t = 0; t < numThreads; t++) {
                 auto seed = static_cast<unsigned int>(time(0) + t);
                 samplers[t] = sampler_->clone(seed);
@@ -600,7 +612,7 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
 
             // Base path
             std::vector<Vertex> baseVerts;
-            TraceRecord baseRecord = pathTrace(scene, params, ray, *sampler, arenas[threadID], &baseVerts);
+            TraceRecord baseRecord = pathTrace(scene, maxBounces, ray, *sampler, arenas[threadID], &baseVerts);
             film.addPixel(x, y, baseRecord.f, filterWeight);
 
             // Offset path
@@ -630,7 +642,7 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
                     invRatio += 0.25;
                 } else if (subRecord.type == PathType::NotInvertible) {
                     // Naively compute gradient with path tracing
-                    subRecord = pathTrace(scene, params, subRay, *sampler, arenas[threadID], nullptr);
+                    subRecord = pathTrace(scene, maxBounces, subRay, *sampler, arenas[threadID], nullptr);
                     G = 0.5 * (baseRecord.f - subRecord.f);                
                 } else if (subRecord.type == PathType::NonSymmetric) {
                     // Subpath results in "zero contribution"
@@ -662,7 +674,9 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
         printf("\n");
         MsgInfo("%d / %d samples inverted!", nInvertedPath, nSampledPath);
 
-        film.save(i + 1, solver_);
+        if (camera->film()->saveDue(i + 1, i + 1 == numSamples)) {
+            film.save(i + 1, solver_);
+        }
 
         #ifdef GDPT_TAKE_LOG
         Image temp;
@@ -701,7 +715,18 @@ void GDPTIntegrator::render(const std::shared_ptr<const Camera> &camera,
         for (int t = 0; t < numThreads; t++) {
             arenas[t].reset();
         }
+
+        // Save the checkpoint
+        if (checkpointer.due()) {
+            const int numPasses = i + 1;
+            auto writer = checkpointer.writer();
+            writer->write(numPasses);
+            film.saveState(*writer);
+            saveSamplers(*writer, samplers);
+            writer->commit();
+        }
     }
+    camera->film()->close();
     printf("Finish!!\n");
 }
 
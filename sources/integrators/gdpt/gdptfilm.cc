@@ -1,6 +1,7 @@
 #include "gdptfilm.h"
 
 #include "core/film.h"
+#include "core/checkpoint.h"
 
 #ifdef SPICA_WITH_FFTW
 #include <fftw3.h>
@@ -8,6 +9,36 @@
 
 namespace spica {
 
+namespace {
+
+void writeBuffer(CheckpointWriter &writer, const Image &image,
+                 const std::vector<std::vector<double>> &weights) {
+    std::vector<double> row(image.width() * 4);
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            for (int ch = 0; ch < 3; ch++) {
+                row[x * 4 + ch] = image(x, y)[ch];
+            }
+            row[x * 4 + 3] = weights[x][y];
+        }
+        writer.write(row.data(), row.size());
+    }
+}
+
+void readBuffer(CheckpointReader &reader, Image *image,
+                std::vector<std::vector<double>> *weights) {
+    std::vector<double> row(image->width() * 4);
+    for (int y = 0; y < image->height(); y++) {
+        reader.read(row.data(), row.size());
+        for (int x = 0; x < image->width(); x++) {
+            image->pixel(x, y) = RGBSpectrum(row[x * 4 + 0], row[x * 4 + 1], row[x * 4 + 2]);
+            (*weights)[x][y] = row[x * 4 + 3];
+        }
+    }
+}
+
+}  // anonymous namespace
+
 GDPTFilm::GDPTFilm(const std::shared_ptr<Film> &film)
     : film_{film} {
     // Initialize buffers
@@ -57,6 +88,31 @@ double GDPTFilm::evalFilter(const Point2d &pixel) const {
     return film_->weight(pixel);
 }
 
+void GDPTFilm::saveState(CheckpointWriter &writer) const {
+    const int width  = image_.width();
+    const int height = image_.height();
+    writer.write(width);
+    writer.write(height);
+    writeBuffer(writer, image_, weights_);
+    for (int k = 0; k < 4; k++) {
+        writeBuffer(writer, gradients_[k], gradWeights_[k]);
+    }
+}
+
+void GDPTFilm::loadState(CheckpointReader &reader) {
+    int width, height;
+    reader.read(&width);
+    reader.read(&height);
+    if (width != image_.width() || height != image_.height()) {
+        throw RuntimeException("Checkpoint is for the film of %dx%d!!", width, height);
+    }
+
+    readBuffer(reader, &image_, &weights_);
+    for (int k = 0; k < 4; k++) {
+        readBuffer(reader, &gradients_[k], &gradWeights_[k]);
+    }
+}
+
 Image GDPTFilm::evalImage() const {
     Image res = image_;
     for (int y = 0; y < image_.height(); y++) {
@@ -14,6 +14,9 @@
 
 namespace spica {
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class GDPTFilm {
 public:
     GDPTFilm(const std::shared_ptr<Film> &film);
@@ -23,6 +26,10 @@ public:
     void addGradient(int x, int y, int index, const Spectrum &grad, double weight);
     double evalFilter(const Point2d &pixel) const;
 
+    //! Write the image and the gradients to the checkpoint.
+    void saveState(CheckpointWriter &writer) const;
+    void loadState(CheckpointReader &reader);
+
 private:
     Image evalImage() const;
     Image evalGrad(int index) const;
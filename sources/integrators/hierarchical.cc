@@ -31,13 +31,13 @@ struct IrradiancePoint {
         , E{ 0.0 } {
     }
 
-    IrradiancePoint(const Point3d& p, double A, const Spectrum& ir)
+    IrradiancePoint(const Point3& p, double A, const Spectrum& ir)
         : pos{ p }
         , area{ A }
         , E{ ir } {
     }
 
-    Point3d  pos;
+    Point3  pos;
     double   area;
     Spectrum E;
 };
@@ -53,7 +53,7 @@ struct OctreeNode {
     }              
 
     IrradiancePoint pt;
-    Bounds3d bbox;
+    Bounds3 bbox;
     OctreeNode* children[8];
     bool isLeaf;
 };
@@ -88,7 +88,7 @@ public:
     void construct(const std::vector<IrradiancePoint>& ipoints) {
         release();
         
-        Bounds3d bounds;
+        Bounds3 bounds;
         for (const auto& p : ipoints) {
             bounds.merge(p.pos);
         }
@@ -104,7 +104,7 @@ public:
 private:
     // Private methods
     OctreeNode* constructRec(const std::vector<IrradiancePoint>& ipoints,
-                             const Bounds3d& bbox) {
+                             const Bounds3& bbox) {
     
         // Zero or one child case
         if (ipoints.empty()) {
@@ -118,11 +118,11 @@ private:
         }
 
         // Divide children into eight groups
-        Point3d posMid = (bbox.posMin() + bbox.posMax()) * 0.5;
+        Point3 posMid = (bbox.posMin() + bbox.posMax()) * 0.5;
         const int numPoints = static_cast<int>(ipoints.size());
         std::vector<std::vector<IrradiancePoint>> childPoints(8);
         for (int i = 0; i < numPoints; i++) {
-            const Point3d& v = ipoints[i].pos;
+            const Point3& v = ipoints[i].pos;
             int id = (v.x() < posMid.x() ? 0 : 4) + 
                      (v.y() < posMid.y() ? 0 : 2) + 
                      (v.z() < posMid.z() ? 0 : 1);
@@ -132,7 +132,7 @@ private:
         // Compute child nodes
         OctreeNode* node = new OctreeNode();
         for (int i = 0; i < 8; i++) {
-            Bounds3d childBox;
+            Bounds3 childBox;
             for (int j = 0; j < childPoints[i].size(); j++) {
                 childBox.merge(childPoints[i][j].pos);
             }
@@ -142,7 +142,7 @@ private:
         node->isLeaf = false;
 
         // Accumulate child nodes
-        node->pt.pos  = Point3d(0.0, 0.0, 0.0);
+        node->pt.pos  = Point3(0.0, 0.0, 0.0);
         node->pt.area = 0.0;
 
         double sumWgt    = 0.0;
@@ -246,8 +246,8 @@ Spectrum Hierarchy::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -292,7 +292,7 @@ Spectrum Hierarchy::irradiance(const SurfaceInteraction& po) const {
     return (INV_PI * (1.0 - Rd->Fdr())) * Mo;
 }
 
-void Hierarchy::samplePoints(const Scene& scene, const Point3d& pCamera) {
+void Hierarchy::samplePoints(const Scene& scene, const Point3& pCamera) {
     samplePoissonDisk(scene, pCamera, radius_, &points_);
     MsgInfo("%zu points sampled with PDS.", points_.size());
 }
@@ -321,10 +321,10 @@ void Hierarchy::buildOctree(const Scene& scene, const RenderParams& params,
         Spectrum E(0.0);
         for (int s = 0; s < nSamples; s++) {
             // Indirect lighting
-            Vector3d n(points_[i].normal());
-            Vector3d u, v;
+            Vector3 n(points_[i].normal());
+            Vector3 u, v;
             vect::coordinateSystem(n, &u, &v);
-            Vector3d dir  = sampleCosineHemisphere(samplers[threadID]->get2D());
+            Vector3 dir  = sampleCosineHemisphere(samplers[threadID]->get2D());
             double pdfDir = cosineHemispherePdf(vect::cosTheta(dir));
             if (pdfDir == 0.0) continue;
 
@@ -335,7 +335,7 @@ void Hierarchy::buildOctree(const Scene& scene, const RenderParams& params,
 
             // Direct lighting
             for (const auto& l : scene.lights()) {
-                Vector3d wi;
+                Vector3 wi;
                 double lightPdf;
                 VisibilityTester vis;
                 Spectrum Li = l->sampleLi(points_[i], samplers[threadID]->get2D(), &wi, &lightPdf, &vis);
@@ -415,8 +415,8 @@ Spectrum HierarchicalIntegrator::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -449,7 +449,7 @@ void HierarchicalIntegrator::initialize(const Scene& scene,
                                         Sampler& sampler) {
     // Compute dA and copy maxError
     double maxError = params.get<double>("HIERARCHICAL_MAX_ERROR");
-    Bounds3d bounds = scene.worldBound();
+    Bounds3 bounds = scene.worldBound();
     double radius = (bounds.posMax() - bounds.posMin()).norm() * 0.0001;
     hi_ = std::make_unique<Hierarchy>(radius, maxError);
 }
@@ -458,7 +458,7 @@ void HierarchicalIntegrator::loopStarted(const Scene& scene,
                                          const RenderParams& params,
                                          Sampler& sampler) {
     // Sample points with dart throwing
-    Point3d pCamera = camera_->cameraToWorld().apply(Point3d(0.0, 0.0, 0.0));
+    Point3 pCamera = camera_->cameraToWorld().apply(Point3(0.0, 0.0, 0.0));
     hi_->samplePoints(scene, pCamera);
 
     // Compute irradiance at sample points
@@ -27,7 +27,7 @@ public:
     // Private methods
     Spectrum irradiance(const SurfaceInteraction& po) const;
 
-    void samplePoints(const Scene& scene, const Point3d& pCamera);
+    void samplePoints(const Scene& scene, const Point3& pCamera);
 
     void buildOctree(const Scene& scene,
                      const RenderParams& params,
@@ -31,13 +31,13 @@ struct IrradiancePoint {
         , E{ 0.0 } {
     }
 
-    IrradiancePoint(const Point3d& p, double A, const Spectrum& ir)
+    IrradiancePoint(const Point3& p, double A, const Spectrum& ir)
         : pos{ p }
         , area{ A }
         , E{ ir } {
     }
 
-    Point3d  pos;
+    Point3  pos;
     double   area;
     Spectrum E;
 };
@@ -53,7 +53,7 @@ struct OctreeNode {
     }              
 
     IrradiancePoint pt;
-    Bounds3d bbox;
+    Bounds3 bbox;
     OctreeNode* children[8];
     bool isLeaf;
 };
@@ -88,7 +88,7 @@ public:
     void construct(const std::vector<IrradiancePoint>& ipoints) {
         release();
         
-        Bounds3d bounds;
+        Bounds3 bounds;
         for (const auto& p : ipoints) {
             bounds.merge(p.pos);
         }
@@ -104,7 +104,7 @@ public:
 private:
     // Private methods
     OctreeNode* constructRec(const std::vector<IrradiancePoint>& ipoints,
-                             const Bounds3d& bbox) {
+                             const Bounds3& bbox) {
     
         // Zero or one child case
         if (ipoints.empty()) {
@@ -118,11 +118,11 @@ private:
         }
 
         // Divide children into eight groups
-        Point3d posMid = (bbox.posMin() + bbox.posMax()) * 0.5;
+        Point3 posMid = (bbox.posMin() + bbox.posMax()) * 0.5;
         const int numPoints = static_cast<int>(ipoints.size());
         std::vector<std::vector<IrradiancePoint>> childPoints(8);
         for (int i = 0; i < numPoints; i++) {
-            const Point3d& v = ipoints[i].pos;
+            const Point3& v = ipoints[i].pos;
             int id = (v.x() < posMid.x() ? 0 : 4) + 
                      (v.y() < posMid.y() ? 0 : 2) + 
                      (v.z() < posMid.z() ? 0 : 1);
@@ -132,7 +132,7 @@ private:
         // Compute child nodes
         OctreeNode* node = new OctreeNode();
         for (int i = 0; i < 8; i++) {
-            Bounds3d childBox;
+            Bounds3 childBox;
             for (int j = 0; j < childPoints[i].size(); j++) {
                 childBox.merge(childPoints[i][j].pos);
             }
@@ -142,7 +142,7 @@ private:
         node->isLeaf = false;
 
         // Accumulate child nodes
-        node->pt.pos  = Point3d(0.0, 0.0, 0.0);
+        node->pt.pos  = Point3(0.0, 0.0, 0.0);
         node->pt.area = 0.0;
 
         double sumWgt    = 0.0;
@@ -213,9 +213,6 @@ Spectrum Hierarchy::Li(const Scene& scene,
     Spectrum L(0.0);
     Spectrum beta(1.0);
     bool specularBounce = false;
-    const int maxBounces      = params.getInt("maxDepth");
-    const int gatherPhotons   = params.getInt("gatherPhotons", 32);
-    const double gatherRadius = params.getDouble("gatherRadius", 1.0);
     for (int bounces = 0; ; bounces++) {
         SurfaceInteraction isect;
         bool isIntersect = scene.intersect(ray, &isect);
@@ -231,7 +228,7 @@ Spectrum Hierarchy::Li(const Scene& scene,
             }
         }
 
-        if (!isIntersect || bounces >= maxBounces) break;
+        if (!isIntersect || bounces >= maxDepth_) break;
 
         isect.setScatterFuncs(ray, arena);
         if (!isect.bsdf()) {
@@ -246,8 +243,8 @@ Spectrum Hierarchy::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -257,8 +254,8 @@ Spectrum Hierarchy::Li(const Scene& scene,
 
         if ((sampledType & BxDFType::Diffuse) != BxDFType::None &&
             (sampledType & BxDFType::Reflection) != BxDFType::None) {
-            L += beta * photonmap_->evaluateL(isect, gatherPhotons, 
-                                              gatherRadius);
+            L += beta * photonmap_->evaluateL(isect, gatherPhotons_,
+                                              gatherRadius_);
             break;
         } else {
             L += Ld;
@@ -292,13 +289,18 @@ Spectrum Hierarchy::irradiance(const SurfaceInteraction& po) const {
     return (INV_PI * (1.0 - Rd->Fdr())) * Mo;
 }
 
-void Hierarchy::samplePoints(const Scene& scene, const Point3d& pCamera) {
+void Hierarchy::samplePoints(const Scene& scene, const Point3& pCamera) {
     samplePoissonDisk(scene, pCamera, radius_, &points_);
     MsgInfo("%zu points sampled with PDS.", points_.size());
 }
 
 void Hierarchy::buildOctree(const Scene& scene, RenderParams& params,
                             Sampler& sampler) {
+    // Resolve parameters used by Li
+    maxDepth_      = ParamHandle<int>(params, "maxDepth");
+    gatherPhotons_ = ParamHandle<int>(params, "gatherPhotons", 32);
+    gatherRadius_  = ParamHandle<double>(params, "gatherRadius", 1.0);
+
     // Build photon map
     photonmap_->construct(scene, params, sampler);
 
@@ -321,10 +323,10 @@ void Hierarchy::buildOctree(const Scene& scene, RenderParams& params,
         Spectrum E(0.0);
         for (int s = 0; s < nSamples; s++) {
             // Indirect lighting
-            Vector3d n(points_[i].normal());
-            Vector3d u, v;
+            Vector3 n(points_[i].normal());
+            Vector3 u, v;
             vect::coordinateSystem(n, &u, &v);
-            Vector3d dir  = sampleCosineHemisphere(samplers[threadID]->get2D());
+            Vector3 dir  = sampleCosineHemisphere(samplers[threadID]->get2D());
             double pdfDir = cosineHemispherePdf(vect::cosTheta(dir));
             if (pdfDir == 0.0) continue;
 
@@ -335,7 +337,7 @@ void Hierarchy::buildOctree(const Scene& scene, RenderParams& params,
 
             // Direct lighting
             for (const auto& l : scene.lights()) {
-                Vector3d wi;
+                Vector3 wi;
                 double lightPdf;
                 VisibilityTester vis;
                 Spectrum Li = l->sampleLi(points_[i], samplers[threadID]->get2D(), &wi, &lightPdf, &vis);
@@ -374,6 +376,7 @@ HierarchicalIntegrator::HierarchicalIntegrator(
 HierarchicalIntegrator::HierarchicalIntegrator(RenderParams &params)
     : HierarchicalIntegrator{std::static_pointer_cast<Sampler>(params.getObject("sampler")),
                              params.getDouble("maxError", 0.005, true)} {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
 }
 
 HierarchicalIntegrator::~HierarchicalIntegrator() {
@@ -405,7 +408,7 @@ Spectrum HierarchicalIntegrator::Li(const Scene& scene,
             }
         }
 
-        if (!isIntersect || bounces >= params.getInt("maxDepth")) break;
+        if (!isIntersect || bounces >= maxDepth_) break;
 
         isect.setScatterFuncs(ray, arena);
         if (!isect.bsdf()) {
@@ -420,8 +423,8 @@ Spectrum HierarchicalIntegrator::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -454,7 +457,7 @@ void HierarchicalIntegrator::initialize(const std::shared_ptr<const Camera> &cam
                                         RenderParams& params,
                                         Sampler& sampler) {
     // Compute dA and copy maxError
-    Bounds3d bounds = scene.worldBound();
+    Bounds3 bounds = scene.worldBound();
     double radius = (bounds.posMax() - bounds.posMin()).norm() * 0.01;
     hi_ = std::make_unique<Hierarchy>(radius, maxError_);
 }
@@ -464,7 +467,7 @@ void HierarchicalIntegrator::loopStarted(const std::shared_ptr<const Camera> &ca
                                          RenderParams& params,
                                          Sampler& sampler) {
     // Sample points with dart throwing
-    Point3d pCamera = camera->cameraToWorld().apply(Point3d(0.0, 0.0, 0.0));
+    Point3 pCamera = camera->cameraToWorld().apply(Point3(0.0, 0.0, 0.0));
     hi_->samplePoints(scene, pCamera);
 
     // Compute irradiance at sample points
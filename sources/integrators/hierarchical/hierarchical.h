@@ -10,6 +10,7 @@
 #include "core/interaction.h"
 
 #include "core/integrator.h"
+#include "core/renderparams.h"
 #include "../photon_map.h"
 
 namespace spica {
@@ -26,7 +27,7 @@ public:
     // Private methods
     Spectrum irradiance(const SurfaceInteraction& po) const;
 
-    void samplePoints(const Scene& scene, const Point3d& pCamera);
+    void samplePoints(const Scene& scene, const Point3& pCamera);
 
     void buildOctree(const Scene& scene,
                      RenderParams& params,
@@ -48,6 +49,9 @@ private:
     std::unique_ptr<Octree> octree_;
     double radius_;
     std::unique_ptr<PhotonMap> photonmap_;
+    ParamHandle<int> maxDepth_{ 16 };
+    ParamHandle<int> gatherPhotons_{ 32 };
+    ParamHandle<double> gatherRadius_{ 1.0 };
 };
 
 /** Irradiance integrator for subsurface scattering objects
@@ -83,6 +87,7 @@ public:
 private:
     std::unique_ptr<Hierarchy> hi_;
     double maxError_;
+    ParamHandle<int> maxDepth_{ 16 };
 
 };  // class HierarchicalIntegrator
 
@@ -21,9 +21,9 @@
 namespace spica {
 
 struct CacheData {
-    Point3d pos;
-    Normal3d nrm;
-    Vector3d wi;
+    Point3 pos;
+    Normal3 nrm;
+    Vector3 wi;
     Spectrum E;
     double Ri;
 
@@ -35,7 +35,7 @@ struct CacheData {
         , Ri{} {
     }
 
-    CacheData(const Point3d& p, const Normal3d& n, const Vector3d& w,
+    CacheData(const Point3& p, const Normal3& n, const Vector3& w,
               const Spectrum& e, double t)
         : pos{ p }
         , nrm{ n }
@@ -44,7 +44,7 @@ struct CacheData {
         , Ri{ t } {
     }
 
-    double weight(const Point3d& p, const Normal3d& n) const {
+    double weight(const Point3& p, const Normal3& n) const {
         double d = (pos - p).norm();
         double epsilon = d / Ri + std::sqrt(1.0 - vect::dot(nrm, n));
         return epsilon != 0.0 ? 1.0 / epsilon : 0.0;
@@ -56,11 +56,11 @@ struct CacheData {
 };
 
 struct CacheQuery {
-    Point3d pos;
-    Normal3d nrm;
+    Point3 pos;
+    Normal3 nrm;
     double r2;
     double threshold;
-    CacheQuery(const Point3d& p, const Normal3d& n, double r2_, double t)
+    CacheQuery(const Point3& p, const Normal3& n, double r2_, double t)
         : pos{ p }
         , nrm{ n }
         , r2{ r2_ }
@@ -252,8 +252,8 @@ Spectrum IrradCacheIntegrator::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -271,15 +271,15 @@ Spectrum IrradCacheIntegrator::Li(const Scene& scene,
             cache_->search(query, &results);
 
             Spectrum E(0.0);
-            Vector3d avgWi(0.0, 0.0, 0.0);
+            Vector3 avgWi(0.0, 0.0, 0.0);
             if (results.empty() || cacheMode_) {
                 // Create new cache
                 double Ri = 0.0;
                 for (int k = 0; k < nGathering_; k++) {
-                    Vector3d n(isect.normal());
-                    Vector3d u, v;
+                    Vector3 n(isect.normal());
+                    Vector3 u, v;
                     vect::coordinateSystem(n, &u, &v);
-                    Vector3d dir = sampleCosineHemisphere(sampler.get2D());
+                    Vector3 dir = sampleCosineHemisphere(sampler.get2D());
                     double pdfDir = cosineHemispherePdf(vect::cosTheta(dir));
                     if (pdfDir == 0.0) continue;
 
@@ -34,6 +34,7 @@ PathIntegrator::PathIntegrator(const std::shared_ptr<Sampler>& sampler)
 
 PathIntegrator::PathIntegrator(RenderParams &params) 
     : PathIntegrator{std::static_pointer_cast<Sampler>(params.getObject("sampler"))} {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
 }
 
 PathIntegrator::~PathIntegrator() {
@@ -57,15 +58,15 @@ Spectrum PathIntegrator::Li(const Scene& scene,
         // Sample Le which contributes without any loss
         if (bounces == 0 || specularBounce) {
             if (isIntersect) {
-                L += beta * isect.Le(-ray.dir());
+                L = Spectrum::fma(beta, isect.Le(-ray.dir()), L);
             } else {
                 for (const auto& light : scene.lights()) {
-                    L += beta * light->Le(ray);
+                    L = Spectrum::fma(beta, light->Le(ray), L);
                 }
             }
         }
 
-        if (!isIntersect || bounces >= params.getInt("maxDepth")) break;
+        if (!isIntersect || bounces >= maxDepth_) break;
 
         isect.setScatterFuncs(ray, arena);
         if (!isect.bsdf()) {
@@ -75,13 +76,12 @@ Spectrum PathIntegrator::Li(const Scene& scene,
         }
 
         if (isect.bsdf()->numComponents(BxDFType::All & (~BxDFType::Specular)) > 0) {
-            Spectrum Ld = beta * uniformSampleOneLight(isect, scene, arena, sampler);
-            L += Ld;
+            L = Spectrum::fma(beta, uniformSampleOneLight(isect, scene, arena, sampler), L);
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
@@ -89,7 +89,7 @@ Spectrum PathIntegrator::Li(const Scene& scene,
 
         if (ref.isBlack() || pdf == 0.0) break;
 
-        beta *= ref * vect::absDot(wi, isect.ns()) / pdf;
+        beta *= ref * (vect::absDot(wi, isect.ns()) / pdf);
         specularBounce = (sampledType & BxDFType::Specular) != BxDFType::None;
         ray = isect.spawnRay(wi);
 
@@ -102,12 +102,12 @@ Spectrum PathIntegrator::Li(const Scene& scene,
             if (S.isBlack() || pdf == 0.0) break;
             beta *= S / pdf;
 
-            L += beta * uniformSampleOneLight(pi, scene, arena, sampler);
+            L = Spectrum::fma(beta, uniformSampleOneLight(pi, scene, arena, sampler), L);
 
             Spectrum f = pi.bsdf()->sample(pi.wo(), &wi, sampler.get2D(), &pdf,
                                            BxDFType::All, &sampledType);
             if (f.isBlack() || pdf == 0.0) break;
-            beta *= f * vect::absDot(wi, pi.normal()) / pdf;
+            beta *= f * (vect::absDot(wi, pi.normal()) / pdf);
 
             specularBounce = (sampledType & BxDFType::Specular) != BxDFType::None;
             ray = pi.spawnRay(wi);
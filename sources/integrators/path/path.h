@@ -11,6 +11,7 @@
 #include "core/core.hpp"
 
 #include "core/integrator.h"
+#include "core/renderparams.h"
 
 namespace spica {
 
@@ -36,6 +37,7 @@ protected:
 
     // Private
     std::shared_ptr<Sampler> sampler_;
+    ParamHandle<int> maxDepth_{ 16 };
 };
 
 SPICA_EXPORT_PLUGIN(PathIntegrator, "Path tracing integrator");
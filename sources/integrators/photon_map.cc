@@ -31,8 +31,8 @@ Photon::Photon()
     , normal_{} {
 }
 
-Photon::Photon(const Point3d& pos, const Spectrum& beta, 
-               const Vector3d& wi, const Normal3d& normal)
+Photon::Photon(const Point3& pos, const Spectrum& beta, 
+               const Vector3& wi, const Normal3& normal)
     : pos_{ pos }
     , beta_{ beta }
     , wi_{ wi }
@@ -93,6 +93,7 @@ void PhotonMap::construct(const Scene& scene,
 
     // Distribute tasks
     const int castPhotons = params.getInt("castPhotons", 1000000);
+    const int maxBounces  = params.getInt("maxDepth");
     std::vector<std::vector<Photon>> photons(nThreads);
 
     // Shooting photons
@@ -110,7 +111,7 @@ void PhotonMap::construct(const Scene& scene,
         Point2d rand0 = sampler->get2D();
         Point2d rand1 = sampler->get2D();
         Ray photonRay;
-        Normal3d nLight;
+        Normal3 nLight;
         double pdfPos, pdfDir;
         Spectrum Le = light->sampleLe(rand0, rand1, &photonRay,
                                       &nLight, &pdfPos, &pdfDir);
@@ -119,7 +120,7 @@ void PhotonMap::construct(const Scene& scene,
             Spectrum beta = (vect::absDot(nLight, photonRay.dir()) * Le) /
                             (lightPdf * pdfPos * pdfDir * castPhotons);
             if (!beta.isBlack()) {
-                tracePhoton(scene, params, photonRay, beta, *sampler,
+                tracePhoton(scene, maxBounces, photonRay, beta, *sampler,
                             arenas[threadID], &photons[threadID]);
             }
         }
@@ -166,7 +167,7 @@ Spectrum PhotonMap::evaluateL(const SurfaceInteraction& po,
     std::vector<double> distances;
     double maxdist = 0.0;
     for (int i = 0; i < numPhotons; i++) {
-        const Vector3d diff = query.pos() - photons[i].pos();
+        const Vector3 diff = query.pos() - photons[i].pos();
         const double dist = diff.norm();
         const double dt   = vect::dot(po.ns(), diff) / dist;
         if (std::abs(dt) < gatherRadius * gatherRadius * 0.01) {
@@ -209,7 +210,7 @@ Spectrum PhotonMap::evaluateL(const MediumInteraction& mi,
     double maxdist = 0.0;
     for (int i = 0; i < numPhotons; i++) {
         if (photons[i].normal().norm() < EPS) {
-            const Vector3d diff = query.pos() - photons[i].pos();
+            const Vector3 diff = query.pos() - photons[i].pos();
             const double dist = diff.norm();
     
             validPhotons.push_back(photons[i]);
@@ -245,7 +246,7 @@ void PhotonMap::knnFind(const Photon& photon, std::vector<Photon>* photons,
 }
 
 void PhotonMap::tracePhoton(const Scene& scene,
-                            RenderParams& params,
+                            int maxBounces,
                             const Ray& r,
                             const Spectrum& b,
                             Sampler& sampler,
@@ -254,7 +255,6 @@ void PhotonMap::tracePhoton(const Scene& scene,
     Ray ray(r);
     Spectrum beta(b);
     SurfaceInteraction isect;
-    const int maxBounces = params.getInt("maxDepth");
     for (int bounces = 0; bounces < maxBounces; bounces++) {
         bool isIntersect = scene.intersect(ray, &isect);
         
@@ -264,8 +264,8 @@ void PhotonMap::tracePhoton(const Scene& scene,
         if (beta.isBlack()) break;
 
         if (mi.isValid()) {
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             beta *= mi.phase()->sample(wo, &wi, sampler.get2D());
             ray = mi.spawnRay(wi);
         } else {
@@ -281,7 +281,7 @@ void PhotonMap::tracePhoton(const Scene& scene,
             }
             const BSDF& bsdf = *isect.bsdf();
 
-            Vector3d wi, wo = -ray.dir();
+            Vector3 wi, wo = -ray.dir();
             double pdf;
             BxDFType sampledType;
             Spectrum ref = bsdf.sample(wo, &wi, sampler.get2D(), &pdf,
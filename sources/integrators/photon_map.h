@@ -25,8 +25,8 @@ namespace spica {
 class SPICA_EXPORTS Photon  {
 public:
     Photon();
-    Photon(const Point3d& pos, const Spectrum& beta, 
-           const Vector3d& wi, const Normal3d& normal);
+    Photon(const Point3& pos, const Spectrum& beta, 
+           const Vector3& wi, const Normal3& normal);
     Photon(const Photon& photon);
     ~Photon();
 
@@ -35,17 +35,17 @@ public:
 
     static double distance(const Photon& p1, const Photon& p2);
 
-    inline Point3d  pos()    const { return pos_; }
+    inline Point3  pos()    const { return pos_; }
     inline Spectrum beta()   const { return beta_; }
-    inline Vector3d wi()     const { return wi_; }
-    inline Normal3d normal() const { return normal_; }
+    inline Vector3 wi()     const { return wi_; }
+    inline Normal3 normal() const { return normal_; }
     inline const Material* const material() const { return material_; }
     
 private:
-    Point3d  pos_;
+    Point3  pos_;
     Spectrum beta_;
-    Vector3d wi_;
-    Normal3d normal_;
+    Vector3 wi_;
+    Normal3 normal_;
     const Material* material_;
 };
 
@@ -78,7 +78,7 @@ protected:
                     int gatherPhotons, double gatherRadius) const;
 
     void tracePhoton(const Scene& scene,
-                     RenderParams& params,
+                     int maxBounces,
                      const Ray& r,
                      const Spectrum& b,
                      Sampler& sampler,
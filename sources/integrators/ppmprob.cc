@@ -37,7 +37,7 @@ void PPMProbIntegrator::initialize(const Scene& scene,
                                    const RenderParams& params,
                                    Sampler& sampler) {
     // Compute global radius
-    Bounds3d bounds = scene.worldBound();
+    Bounds3 bounds = scene.worldBound();
     globalRadius_ = (bounds.posMax() - bounds.posMin()).norm() * 0.5;
 }
 
@@ -83,8 +83,8 @@ Spectrum PPMProbIntegrator::Li(const Scene& scene,
 
             if (bounces >= maxBounces) break;
 
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             mi.phase()->sample(wo, &wi, sampler.get2D());
             ray = mi.spawnRay(wi);
         } else {
@@ -114,8 +114,8 @@ Spectrum PPMProbIntegrator::Li(const Scene& scene,
             }
 
             // Process BxDF
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             double pdf;
             BxDFType sampledType;
             Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
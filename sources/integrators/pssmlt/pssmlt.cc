@@ -2,11 +2,11 @@
 #include "pssmlt.h"
 
 #include <atomic>
-#include <mutex>
 
 #include "core/memory.h"
 #include "core/parallel.h"
 #include "core/renderparams.h"
+#include "core/checkpoint.h"
 #include "core/interaction.h"
 #include "core/scene.h"
 #include "core/camera.h"
@@ -198,6 +198,7 @@ PSSMLTIntegrator::PSSMLTIntegrator()
 
 PSSMLTIntegrator::PSSMLTIntegrator(spica::RenderParams &params)
     : PSSMLTIntegrator{ } {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
 }
 
 PSSMLTIntegrator::~PSSMLTIntegrator() {
@@ -218,11 +219,20 @@ void PSSMLTIntegrator::render(const std::shared_ptr<const Camera>& camera, const
     const int nThreads = numSystemThreads();
     const int nLoop = (sampleCount + nThreads - 1) / nThreads;
     
+    // Resume from the checkpoint
+    Checkpointer checkpointer(params, "PSSMLTIntegrator");
+    int startLoop = 0;
     int progress = 0;
-    for (int loop = 0; loop < nLoop; loop++) {
-        std::mutex mtx;
+    if (auto reader = checkpointer.resume()) {
+        reader->read(&startLoop);
+        reader->read(&progress);
+        camera->film()->loadState(*reader);
+    }
+
+    for (int loop = startLoop; loop < nLoop; loop++) {
         std::atomic<int64_t> nAccept(0);
         std::atomic<int64_t> nTotal(0);
+        camera->film()->beginPass(loop);
         parallel_for (0, nThreads, [&](int t) {
             MemoryArena arena;
         
@@ -252,19 +262,15 @@ void PSSMLTIntegrator::render(const std::shared_ptr<const Camera>& camera, const
                 acceptRatio = std::min(1.0, acceptRatio);
 
                 // Update image.
-                mtx.lock();
-                {
-                    double currentWeight = (1.0 - acceptRatio) /
-                                           ((currentSample.Li().gray() / b + psSampler->pLarge()) * M);
-                    double nextWeight    = (acceptRatio + psSampler->largeStep()) /
-                                           ((nextSample.Li().gray() / b + psSampler->pLarge()) * M);
-
-                    Point2d curPixel(width - currentSample.pixel().x(), currentSample.pixel().y());
-                    Point2d nextPixel(width - nextSample.pixel().x(), nextSample.pixel().y());
-                    camera->film()->addPixel(curPixel, currentWeight * currentSample.Li());
-                    camera->film()->addPixel(nextPixel, nextWeight * nextSample.Li());
-                }
-                mtx.unlock();
+                const double currentWeight = (1.0 - acceptRatio) /
+                                             ((currentSample.Li().gray() / b + psSampler->pLarge()) * M);
+                const double nextWeight    = (acceptRatio + psSampler->largeStep()) /
+                                             ((nextSample.Li().gray() / b + psSampler->pLarge()) * M);
+
+                Point2d curPixel(width - currentSample.pixel().x(), currentSample.pixel().y());
+                Point2d nextPixel(width - nextSample.pixel().x(), nextSample.pixel().y());
+                camera->film()->addSplat(curPixel, currentWeight * currentSample.Li());
+                camera->film()->addSplat(nextPixel, nextWeight * nextSample.Li());
 
                 // Update sample.
                 if (randomSampler->get1D() < acceptRatio) {
@@ -287,6 +293,8 @@ void PSSMLTIntegrator::render(const std::shared_ptr<const Camera>& camera, const
             }
         });
 
+        camera->film()->endPass(loop + 1);
+
         // Report accept / reject ratio.
         const double ratio = 100.0 * nAccept / nTotal;
         MsgInfo("Accept ratio = %5.2f %% (%lld / %lld)", ratio, nAccept.load(), nTotal.load());
@@ -294,8 +302,21 @@ void PSSMLTIntegrator::render(const std::shared_ptr<const Camera>& camera, const
 
         // Save image.
         progress += nThreads;
-        camera->film()->saveMLT(scrnArea / progress, progress);
+        if (camera->film()->saveDue(loop + 1, loop + 1 == nLoop)) {
+            camera->film()->saveMLT(scrnArea / progress, progress);
+        }
+
+        // Save the checkpoint
+        if (checkpointer.due(camera->film()->mapped())) {
+            const int numLoops = loop + 1;
+            auto writer = checkpointer.writer();
+            writer->write(numLoops);
+            writer->write(progress);
+            camera->film()->saveState(*writer);
+            writer->commit();
+        }
     }
+    camera->film()->close();
 }
 
 PSSMLTIntegrator::PathSample PSSMLTIntegrator::generateSample(const std::shared_ptr<const Camera> &camera,
@@ -329,7 +350,7 @@ Spectrum PSSMLTIntegrator::Li(const Scene& scene,
     Spectrum beta(1.0);
     bool specularBounce = false;
     
-    const int maxDepth = params.getInt("maxDepth");
+    const int maxDepth = maxDepth_;
     for (int bounces = 0; bounces < maxDepth; bounces++) {
         SurfaceInteraction isect;
         bool isIntersect = scene.intersect(ray, &isect);
@@ -360,8 +381,8 @@ Spectrum PSSMLTIntegrator::Li(const Scene& scene,
         }
 
         // Process BxDF
-        Vector3d wo = -ray.dir();
-        Vector3d wi;
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
         double pdf;
         BxDFType sampledType;
         Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
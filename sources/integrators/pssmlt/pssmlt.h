@@ -8,6 +8,7 @@
 #include "core/common.h"
 #include "core/cobject.h"
 #include "core/integrator.h"
+#include "core/renderparams.h"
 
 namespace spica {
 
@@ -37,6 +38,8 @@ private:
                 Sampler& sampler,
                 MemoryArena& arena,
                 int depth = 0) const;
+
+    ParamHandle<int> maxDepth_{ 16 };
 };
 
 SPICA_EXPORT_PLUGIN(PSSMLTIntegrator, "Primary sampling space metroplis light transport");
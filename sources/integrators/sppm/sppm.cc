@@ -21,15 +21,16 @@
 #include "core/bssrdf.h"
 #include "core/phase.h"
 #include "core/mis.h"
+#include "core/checkpoint.h"
 
 namespace spica {
 
 struct SPPMIntegrator::SPPMPixel {
-    Vector3d wo;
+    Vector3 wo;
     Spectrum Ld = Spectrum(0.0, 0.0, 0.0);
     struct VisiblePoint {
         VisiblePoint() {}
-        VisiblePoint(const Point3d& p_, const Vector3d& wo_, const BSDF* bsdf_,
+        VisiblePoint(const Point3& p_, const Vector3& wo_, const BSDF* bsdf_,
                      const Spectrum& beta_)
             : p{ p_ }
             , wo{ wo_ }
@@ -37,8 +38,8 @@ struct SPPMIntegrator::SPPMPixel {
             , beta{ beta_ } {
         }
 
-        Point3d p;
-        Vector3d wo;
+        Point3 p;
+        Vector3 wo;
         const BSDF* bsdf = nullptr;
         Spectrum beta;
     } vp;
@@ -59,6 +60,7 @@ SPPMIntegrator::SPPMIntegrator(const std::shared_ptr<Sampler>& sampler)
 
 SPPMIntegrator::SPPMIntegrator(RenderParams &params)
     : SPPMIntegrator{std::static_pointer_cast<Sampler>(params.getObject("sampler", true))} {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
 }
 
 SPPMIntegrator::~SPPMIntegrator() {
@@ -84,18 +86,36 @@ void SPPMIntegrator::render(const std::shared_ptr<const Camera>& camera,
     // Compute light power distribution
     Distribution1D lightDistrib = calcLightPowerDistrib(scene);
 
+    // Resume from the checkpoint
+    Checkpointer checkpointer(params, "SPPMIntegrator");
+    int startPass = 0;
+    uint32_t seed = static_cast<uint32_t>(time(0));
+    std::vector<double> state;
+    if (auto reader = checkpointer.resume()) {
+        state.resize(numPoints * 8);
+        reader->read(&startPass);
+        reader->read(&seed);
+        reader->read(state.data(), state.size());
+        for (int i = 0; i < numPoints; i++) {
+            const double *v = &state[i * 8];
+            pixels[i].Ld  = Spectrum(v[0], v[1], v[2]);
+            pixels[i].tau = Spectrum(v[3], v[4], v[5]);
+            pixels[i].r2  = v[6];
+            pixels[i].n   = v[7];
+        }
+    }
+
     // Initialize random number samplers
     const int nThreads = numSystemThreads();
     auto samplers = std::vector<std::unique_ptr<Sampler>>(nThreads);
     auto arenas   = std::vector<MemoryArena>(nThreads);
     for (int i = 0; i < nThreads; i++) {
-        unsigned int seed = (unsigned int)time(0) + i;
-        samplers[i] = sampler_->clone(seed);
+        samplers[i] = sampler_->clone(seed + startPass * nThreads + i);
     }
 
     const int numSamples = params.getInt("sampleCount");
     const int castPhotons = params.getInt("globalPhotons");
-    for (int t = 0; t < numSamples; t++) {
+    for (int t = startPass; t < numSamples; t++) {
         std::cout << "--- Iteration No." << (t + 1) << " ---" << std::endl;
 
         // 1st pass: Trace rays from camera
@@ -134,7 +154,30 @@ void SPPMIntegrator::render(const std::shared_ptr<const Camera>& camera,
             arenas[k].reset();
         }
 
+        // Save the checkpoint
+        if (checkpointer.due()) {
+            state.resize(numPoints * 8);
+            for (int i = 0; i < numPoints; i++) {
+                double *v = &state[i * 8];
+                for (int ch = 0; ch < 3; ch++) {
+                    v[ch]     = pixels[i].Ld[ch];
+                    v[ch + 3] = pixels[i].tau[ch];
+                }
+                v[6] = pixels[i].r2;
+                v[7] = pixels[i].n;
+            }
+
+            const int numPasses = t + 1;
+            auto writer = checkpointer.writer();
+            writer->write(numPasses);
+            writer->write(seed);
+            writer->write(state.data(), state.size());
+            writer->commit();
+        }
+
         // Save temporal image
+        if (!camera->film()->saveDue(t + 1, t + 1 == numSamples)) continue;
+
         const int totalPhotons = (t + 1) * castPhotons;
         Image image(width, height);
         image.fill(RGBSpectrum(0.0, 0.0, 0.0));
@@ -149,6 +192,7 @@ void SPPMIntegrator::render(const std::shared_ptr<const Camera>& camera,
         camera->film()->setImage(image);
         camera->film()->save(t + 1);
     }
+    camera->film()->close();
 }
 
 void SPPMIntegrator::constructHashGrid(std::vector<SPPMPixel>& pixels,
@@ -159,18 +203,18 @@ void SPPMIntegrator::constructHashGrid(std::vector<SPPMPixel>& pixels,
     const int numPoints = static_cast<int>(pixels.size());
 
     // Compute bounding box
-    Bounds3d bbox;
+    Bounds3 bbox;
     for (int i = 0; i < numPoints; i++) {
         bbox.merge(pixels[i].vp.p);
     }
 
     // Heuristic for initial radius
-    Vector3d boxSize = bbox.posMax() - bbox.posMin();
+    Vector3 boxSize = bbox.posMax() - bbox.posMin();
     const double irad = ((boxSize.x() + boxSize.y() + boxSize.z()) / 3.0) /
                         ((imageW + imageH) / 2.0) * 2.0;
 
     // Update initial radius
-    Vector3d iradv(irad, irad, irad);
+    Vector3 iradv(irad, irad, irad);
     for (int i = 0; i < numPoints; i++) {
         if (pixels[i].n == 0) {
             pixels[i].r2 = irad * irad;
@@ -190,8 +234,8 @@ void SPPMIntegrator::constructHashGrid(std::vector<SPPMPixel>& pixels,
 
     // Set hit points to the grid
     for (int i = 0; i < numPoints; i++) {
-        Point3d boxMin = pixels[i].vp.p - iradv;
-        Point3d boxMax = pixels[i].vp.p + iradv;
+        Point3 boxMin = pixels[i].vp.p - iradv;
+        Point3 boxMax = pixels[i].vp.p + iradv;
         hashgrid_.add(&pixels[i], boxMin, boxMax);
     }
 }
@@ -268,7 +312,7 @@ void SPPMIntegrator::tracePhotons(const Scene& scene,
         Point2d rand0 = sampler->get2D();
         Point2d rand1 = sampler->get2D();
         Ray photonRay;
-        Normal3d nLight;
+        Normal3 nLight;
         double pdfPos, pdfDir;
         Spectrum Le = light->sampleLe(rand0, rand1, &photonRay,
                                         &nLight, &pdfPos, &pdfDir);
@@ -302,7 +346,7 @@ void SPPMIntegrator::tracePhotonsSub(const Scene& scene,
     Ray ray(r);
     Spectrum beta(b);
     SurfaceInteraction isect;
-    const int maxBounces = params.getInt("maxDepth");
+    const int maxBounces = maxDepth_;
     for (int bounces = 0; bounces < maxBounces; bounces++) {
         bool isIntersect = scene.intersect(ray, &isect);
 
@@ -314,8 +358,8 @@ void SPPMIntegrator::tracePhotonsSub(const Scene& scene,
         if (mi.isValid()) {
             if (bounces >= maxBounces) break;
 
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             mi.phase()->sample(wo, &wi, sampler.get2D());
             ray = mi.spawnRay(wi);        
         } else {
@@ -335,7 +379,7 @@ void SPPMIntegrator::tracePhotonsSub(const Scene& scene,
                         continue;
                     }
 
-                    Vector3d wi = -ray.dir();
+                    Vector3 wi = -ray.dir();
                     Spectrum phi = beta * pixel->vp.bsdf->f(pixel->vp.wo, wi);
                     for (int ch = 0; ch < Spectrum::channels; ch++) {
                         pixel->phi[ch].add(phi[ch]);
@@ -352,7 +396,7 @@ void SPPMIntegrator::tracePhotonsSub(const Scene& scene,
             }
             const BSDF& bsdf = *isect.bsdf();
 
-            Vector3d wi, wo = -ray.dir();
+            Vector3 wi, wo = -ray.dir();
             double pdf;
             BxDFType sampledType;
             Spectrum ref = bsdf.sample(wo, &wi, sampler.get2D(), &pdf,
@@ -396,7 +440,7 @@ void SPPMIntegrator::pathTrace(const Scene& scene,
     Ray ray(r);
     Spectrum beta(1.0);
     bool specularBounce = false;
-    const int maxBounces = params.getInt("maxDepth");
+    const int maxBounces = maxDepth_;
     for (int bounces = 0; bounces < maxBounces; bounces++) {
         SurfaceInteraction isect;
         bool isIntersect = scene.intersect(ray, &isect);
@@ -411,8 +455,8 @@ void SPPMIntegrator::pathTrace(const Scene& scene,
 
             if (bounces >= maxBounces) break;
 
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             mi.phase()->sample(wo, &wi, sampler.get2D());
             ray = mi.spawnRay(wi);
         } else {
@@ -432,7 +476,7 @@ void SPPMIntegrator::pathTrace(const Scene& scene,
             }
             const BSDF& bsdf = *isect.bsdf();
 
-            const Vector3d wo = -ray.dir();
+            const Vector3 wo = -ray.dir();
             if (bounces == 0 || specularBounce) {
                 pixel->Ld += beta * isect.Le(wo);
             }
@@ -450,7 +494,7 @@ void SPPMIntegrator::pathTrace(const Scene& scene,
             }
 
             if (bounces < maxBounces - 1) {
-                Vector3d wi;
+                Vector3 wi;
                 double pdf;
                 BxDFType sampledType;
                 Spectrum ref = bsdf.sample(wo, &wi, sampler.get2D(), &pdf,
@@ -10,6 +10,7 @@
 #include "core/hash_grid.h"
 #include "core/render.hpp"
 #include "core/integrator.h"
+#include "core/renderparams.h"
 
 namespace spica {
 
@@ -69,6 +70,7 @@ private:
     // Private fields
     std::shared_ptr<Sampler> sampler_;
     mutable HashGrid<SPPMPixel*> hashgrid_;
+    ParamHandle<int> maxDepth_{ 16 };
     static const double kAlpha_;
 
 };  // class SPPMIntegrator
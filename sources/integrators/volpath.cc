@@ -46,8 +46,8 @@ Spectrum VolPathIntegrator::Li(const Scene& scene,
 
             if (bounces >= maxBounces) break;
 
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             mi.phase()->sample(wo, &wi, sampler.get2D());
             ray = mi.spawnRay(wi);
         } else {
@@ -77,8 +77,8 @@ Spectrum VolPathIntegrator::Li(const Scene& scene,
             }
 
             // Process BxDF
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             double pdf;
             BxDFType sampledType;
             Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
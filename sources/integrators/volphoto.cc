@@ -74,7 +74,7 @@ public:
             Point2d rand0 = sampler->get2D();
             Point2d rand1 = sampler->get2D();
             Ray photonRay;
-            Normal3d nLight;
+            Normal3 nLight;
             double pdfPos, pdfDir;
             Spectrum Le = light->sampleLe(rand0, rand1, &photonRay,
                                           &nLight, &pdfPos, &pdfDir);
@@ -133,7 +133,7 @@ public:
         std::vector<double> distances;
         double maxdist = 0.0;
         for (int i = 0; i < numPhotons; i++) {
-            const Vector3d diff = query.pos() - photons[i].pos();
+            const Vector3 diff = query.pos() - photons[i].pos();
             const double dist = diff.norm();
             const double dt   = vect::dot(po.normal(), diff) / dist;
             if (po.normal().norm() > EPS &&
@@ -178,7 +178,7 @@ public:
         double maxdist = 0.0;
         for (int i = 0; i < numPhotons; i++) {
             if (photons[i].normal().norm() < EPS) {
-                const Vector3d diff = query.pos() - photons[i].pos();
+                const Vector3 diff = query.pos() - photons[i].pos();
                 const double dist = diff.norm();
     
                 validPhotons.push_back(photons[i]);
@@ -234,10 +234,10 @@ private:
             if (beta.isBlack()) break;
 
             if (mi.isValid()) {
-                photons->emplace_back(mi.pos(), beta, -ray.dir(), Normal3d());
+                photons->emplace_back(mi.pos(), beta, -ray.dir(), Normal3());
                 
-                Vector3d wo = -ray.dir();
-                Vector3d wi;
+                Vector3 wo = -ray.dir();
+                Vector3 wi;
 
                 bnew = bnew * mi.phase()->sample(wo, &wi, sampler.get2D());
                 double continueProb = std::min(1.0, bnew.luminance() / beta.luminance());
@@ -258,7 +258,7 @@ private:
                 }
                 const BSDF& bsdf = *isect.bsdf();
 
-                Vector3d wi, wo = -ray.dir();
+                Vector3 wi, wo = -ray.dir();
                 double pdf;
                 BxDFType sampledType;
                 Spectrum ref = bsdf.sample(wo, &wi, sampler.get2D(), &pdf,
@@ -317,7 +317,7 @@ void VolPhotoIntegrator::initialize(const Scene& scene,
                                    const RenderParams& params,
                                    Sampler& sampler) {
     // Compute global radius
-    Bounds3d bounds = scene.worldBound();
+    Bounds3 bounds = scene.worldBound();
     globalRadius_ = (bounds.posMax() - bounds.posMin()).norm() * 0.5;
 }
 
@@ -399,8 +399,8 @@ Spectrum VolPhotoIntegrator::Li(const Scene& scene,
             }
 
             // Process BxDF
-            Vector3d wo = -ray.dir();
-            Vector3d wi;
+            Vector3 wo = -ray.dir();
+            Vector3 wi;
             double pdf;
             BxDFType sampledType;
             Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
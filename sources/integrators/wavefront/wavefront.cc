@@ -0,0 +1,518 @@
+#define SPICA_API_EXPORT
+#include "wavefront.h"
+
+#include <atomic>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+
+#include "core/common.h"
+#include "core/memory.h"
+#include "core/parallel.h"
+#include "core/spectrum.h"
+#include "core/renderparams.h"
+#include "core/vector3d.h"
+#include "core/sampler.h"
+
+#include "core/sampling.h"
+#include "core/interaction.h"
+#include "core/primitive.h"
+#include "core/camera.h"
+#include "core/film.h"
+#include "core/light.h"
+#include "core/visibility_tester.h"
+
+#include "core/bsdf.h"
+#include "core/bxdf.h"
+#include "core/bssrdf.h"
+
+#include "core/scene.h"
+#include "core/raybatch.h"
+#include "core/mis.h"
+
+namespace spica {
+
+namespace {
+
+// Interleave the lower 9 bits of x with two zero bits.
+inline uint32_t leftShift3(uint32_t x) {
+    x &= 0x000001ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x <<  8)) & 0x0300f00f;
+    x = (x | (x <<  4)) & 0x030c30c3;
+    x = (x | (x <<  2)) & 0x09249249;
+    return x;
+}
+
+/**
+ * Sort key of the ray, which is the octant of the direction followed by
+ * the 27-bit Morton code of the origin in the scene bounds. The rays with
+ * close keys visit similar nodes of the accelerator.
+ */
+uint32_t coherenceKey(const Ray &ray, const Bounds3 &bounds) {
+    const Vector3 d = ray.dir();
+    const uint32_t octant = (d.x() < 0.0 ? 1 : 0) |
+                            (d.y() < 0.0 ? 2 : 0) |
+                            (d.z() < 0.0 ? 4 : 0);
+
+    const Point3 pMin = bounds.posMin();
+    const Point3 pMax = bounds.posMax();
+    uint32_t q[3];
+    for (int i = 0; i < 3; i++) {
+        const double extent = pMax[i] - pMin[i];
+        const double t = extent > 0.0 ? (ray.org()[i] - pMin[i]) / extent : 0.0;
+        q[i] = static_cast<uint32_t>(clamp(t, 0.0, 1.0) * 511.0);
+    }
+    const uint32_t morton = (leftShift3(q[2]) << 2) | (leftShift3(q[1]) << 1) | leftShift3(q[0]);
+    return (octant << 27) | morton;
+}
+
+//! Sort the indices of the rays by their coherence keys.
+void sortRays(const std::vector<Ray> &rays, const Bounds3 &bounds,
+              std::vector<int> *indices) {
+    const int n = static_cast<int>(indices->size());
+    std::vector<uint64_t> keys(n);
+    parallel_for(0, n, [&](int k) {
+        const int i = (*indices)[k];
+        keys[k] = (static_cast<uint64_t>(coherenceKey(rays[i], bounds)) << 32) |
+                  static_cast<uint32_t>(i);
+    });
+    std::sort(keys.begin(), keys.end());
+    for (int k = 0; k < n; k++) {
+        (*indices)[k] = static_cast<int>(keys[k] & 0xffffffff);
+    }
+}
+
+/**
+ * Number of the consecutive rays in a sorted queue which are given to the
+ * accelerator as a batch.
+ */
+const int kBatchSize = 256;
+
+//! Run func(start, end) for the batches [start, end) of [0, n) in parallel.
+void forEachBatch(int n, const std::function<void(int, int)> &func) {
+    const int nBatches = (n + kBatchSize - 1) / kBatchSize;
+    parallel_for(0, nBatches, [&](int b) {
+        const int start = b * kBatchSize;
+        func(start, std::min(start + kBatchSize, n));
+    });
+}
+
+}  // anonymous namespace
+
+/**
+ * States of the paths in flight, stored as the structure of arrays. The
+ * paths move between the threads in every stage, so each path keeps the
+ * position in its sample, which is restored to the sampler of the thread
+ * before drawing the numbers.
+ */
+struct WavefrontPathIntegrator::PathStates {
+    explicit PathStates(int size)
+        : rays(size)
+        , hits(size)
+        , beta(size)
+        , L(size)
+        , pFilm(size)
+        , pixels(size)
+        , bounces(size)
+        , specularBounce(size)
+        , dimensions(size) {
+    }
+
+    std::vector<Ray> rays;
+    std::vector<HitRecord> hits;
+    std::vector<Spectrum> beta;
+    std::vector<Spectrum> L;
+    std::vector<Point2d> pFilm;
+    std::vector<Point2i> pixels;
+    std::vector<int> bounces;
+    std::vector<uint8_t> specularBounce;
+    std::vector<int> dimensions;
+    int sampleIndex = 0;
+};
+
+/**
+ * Queue of the rays whose contributions to the paths are determined by
+ * tracing them. Each path pushes at most one ray to a queue in a bounce,
+ * so the queue holds as many rays as the paths. Rays can be pushed from
+ * multiple threads.
+ */
+struct WavefrontPathIntegrator::RayQueue {
+    explicit RayQueue(int capacity)
+        : rays(capacity)
+        , contribs(capacity)
+        , lights(capacity)
+        , paths(capacity) {
+    }
+
+    void push(const Ray &ray, const Spectrum &contrib, int path,
+              const Light *light = nullptr) {
+        const int i = size++;
+        rays[i]     = ray;
+        contribs[i] = contrib;
+        lights[i]   = light;
+        paths[i]    = path;
+    }
+
+    std::vector<Ray> rays;
+    std::vector<Spectrum> contribs;
+    std::vector<const Light*> lights;
+    std::vector<int> paths;
+    std::atomic<int> size{ 0 };
+};
+
+WavefrontPathIntegrator::WavefrontPathIntegrator(const std::shared_ptr<Sampler>& sampler)
+    : Integrator{}
+    , sampler_{ sampler } {
+}
+
+WavefrontPathIntegrator::WavefrontPathIntegrator(RenderParams &params)
+    : WavefrontPathIntegrator{std::static_pointer_cast<Sampler>(params.getObject("sampler"))} {
+    maxDepth_ = ParamHandle<int>(params, "maxDepth");
+}
+
+WavefrontPathIntegrator::~WavefrontPathIntegrator() {
+}
+
+void WavefrontPathIntegrator::render(const std::shared_ptr<const Camera>& camera,
+                                     const Scene& scene,
+                                     RenderParams& params) {
+    const int width  = camera->film()->resolution().x();
+    const int height = camera->film()->resolution().y();
+    const int numPixels = width * height;
+    const int waveSize  = std::max(1, std::min(numPixels, params.getInt("wavefrontSize", 1 << 18)));
+
+    const int nThreads = numSystemThreads();
+    auto samplers = std::vector<std::unique_ptr<Sampler>>(nThreads);
+    auto arenas   = std::vector<MemoryArena>(nThreads);
+
+    PathStates paths(waveSize);
+    RayQueue shadowRays(waveSize);
+    RayQueue lightRays(waveSize);
+    std::vector<int> active, next;
+
+    const uint32_t seed = static_cast<uint32_t>(time(0));
+    const int numSamples = params.getInt("sampleCount");
+    for (int pass = 0; pass < numSamples; pass++) {
+        for (int t = 0; t < nThreads; t++) {
+            samplers[t] = sampler_->clone(seed + pass * nThreads + t);
+        }
+        // Offset by the seed so that the renders do not repeat themselves
+        paths.sampleIndex = static_cast<int>((seed + pass) & 0x7fffffff);
+
+        for (int start = 0; start < numPixels; start += waveSize) {
+            const int count = std::min(waveSize, numPixels - start);
+
+            // Generate camera rays. The image is flipped horizontally as
+            // in SamplerIntegrator.
+            parallel_for(0, count, [&](int p) {
+                Sampler &sampler = *samplers[getThreadID()];
+                const int x = (start + p) % width;
+                const int y = (start + p) / width;
+                sampler.startPixelSample(Point2i(x, y), paths.sampleIndex);
+
+                const Point2d randFilm = sampler.get2D();
+                const Point2d randLens = sampler.get2D();
+                paths.dimensions[p] = sampler.dimension();
+                paths.rays[p]   = camera->spawnRay(Point2i(width - x - 1, y), randFilm, randLens);
+                paths.pixels[p] = Point2i(x, y);
+                paths.pFilm[p]  = randFilm;
+                paths.beta[p]   = Spectrum(1.0);
+                paths.L[p]      = Spectrum(0.0);
+                paths.bounces[p] = 0;
+                paths.specularBounce[p] = 0;
+            });
+
+            active.resize(count);
+            std::iota(active.begin(), active.end(), 0);
+            while (!active.empty()) {
+                traceExtension(scene, paths, active);
+
+                shadowRays.size = 0;
+                lightRays.size  = 0;
+                shade(scene, paths, active, &next, &shadowRays, &lightRays,
+                      samplers, arenas);
+
+                traceShadow(scene, paths, shadowRays);
+                traceLight(scene, paths, lightRays);
+
+                std::swap(active, next);
+                for (int t = 0; t < nThreads; t++) {
+                    arenas[t].reset();
+                }
+            }
+
+            // Each pixel appears once in the wavefront
+            parallel_for(0, count, [&](int p) {
+                camera->film()->addPixel(paths.pixels[p], paths.pFilm[p], paths.L[p]);
+            });
+
+            printf("\r[ %d / %d ] %6.2f %% processed...", pass + 1, numSamples,
+                   100.0 * (start + count) / numPixels);
+            fflush(stdout);
+        }
+        printf("\n");
+
+        if (camera->film()->saveDue(pass + 1, pass + 1 == numSamples)) {
+            camera->film()->save(pass + 1);
+        }
+    }
+    camera->film()->close();
+    printf("Finish!!\n");
+}
+
+void WavefrontPathIntegrator::traceExtension(const Scene& scene, PathStates& paths,
+                                             std::vector<int>& active) const {
+    sortRays(paths.rays, scene.worldBound(), &active);
+
+    const int n = static_cast<int>(active.size());
+    forEachBatch(n, [&](int start, int end) {
+        RayBatch rays(end - start);
+        HitBatch hits;
+        for (int k = start; k < end; k++) {
+            rays.push(paths.rays[active[k]]);
+        }
+        scene.intersect(rays, hits);
+
+        for (int k = start; k < end; k++) {
+            const int p = active[k];
+            paths.rays[p] = rays[k - start];
+            paths.hits[p] = hits[k - start];
+            if (hits.isHit(k - start)) continue;
+
+            // Sample Le of the escaped path, which contributes without any loss
+            if (paths.bounces[p] == 0 || paths.specularBounce[p]) {
+                for (const auto& light : scene.lights()) {
+                    paths.L[p] = Spectrum::fma(paths.beta[p], light->Le(paths.rays[p]), paths.L[p]);
+                }
+            }
+        }
+    });
+
+    active.erase(std::remove_if(active.begin(), active.end(), [&](int p) {
+        return paths.hits[p].primitive == nullptr;
+    }), active.end());
+}
+
+void WavefrontPathIntegrator::shade(const Scene& scene, PathStates& paths,
+                                    std::vector<int>& active,
+                                    std::vector<int>* next,
+                                    RayQueue* shadowRays,
+                                    RayQueue* lightRays,
+                                    const std::vector<std::unique_ptr<Sampler>>& samplers,
+                                    std::vector<MemoryArena>& arenas) const {
+    // Shade the paths on the same material together. The sort is stable so
+    // that the paths of a material keep the coherent order of their rays.
+    std::stable_sort(active.begin(), active.end(), [&](int p1, int p2) {
+        return paths.hits[p1].primitive->material() < paths.hits[p2].primitive->material();
+    });
+
+    const int maxBounces = maxDepth_;
+    const int n = static_cast<int>(active.size());
+    next->resize(n);
+    std::atomic<int> numNext(0);
+    parallel_for(0, n, [&](int k) {
+        const int p = active[k];
+        const int threadID = getThreadID();
+        Sampler &sampler = *samplers[threadID];
+        MemoryArena &arena = arenas[threadID];
+
+        Ray &ray = paths.rays[p];
+        Spectrum &L = paths.L[p];
+        Spectrum &beta = paths.beta[p];
+        const int bounces = paths.bounces[p];
+
+        sampler.startPixelSample(paths.pixels[p], paths.sampleIndex);
+        sampler.setDimension(paths.dimensions[p]);
+
+        SurfaceInteraction isect;
+        scene.computeSurfaceInteraction(ray, paths.hits[p], &isect);
+
+        // Sample Le which contributes without any loss
+        if (bounces == 0 || paths.specularBounce[p]) {
+            L = Spectrum::fma(beta, isect.Le(-ray.dir()), L);
+        }
+
+        if (bounces >= maxBounces) return;
+
+        isect.setScatterFuncs(ray, arena);
+        if (!isect.bsdf()) {
+            // The path passes through the surface without a bounce
+            ray = isect.spawnRay(ray.dir());
+            (*next)[numNext++] = p;
+            return;
+        }
+
+        if (isect.bsdf()->numComponents(BxDFType::All & (~BxDFType::Specular)) > 0) {
+            sampleLight(scene, isect, beta, p, sampler, shadowRays, lightRays);
+        }
+
+        // Process BxDF
+        Vector3 wo = -ray.dir();
+        Vector3 wi;
+        double pdf;
+        BxDFType sampledType;
+        Spectrum ref = isect.bsdf()->sample(wo, &wi, sampler.get2D(), &pdf,
+                                            BxDFType::All, &sampledType);
+
+        if (ref.isBlack() || pdf == 0.0) return;
+
+        beta *= ref * (vect::absDot(wi, isect.ns()) / pdf);
+        bool specularBounce = (sampledType & BxDFType::Specular) != BxDFType::None;
+        ray = isect.spawnRay(wi);
+
+        // Account for BSSRDF, which traces its own probe rays. The direct
+        // lighting at the exit point is not deferred.
+        if (isect.bssrdf() && (sampledType & BxDFType::Transmission) != BxDFType::None) {
+            SurfaceInteraction pi;
+            Spectrum S = isect.bssrdf()->sample(scene, sampler.get1D(),
+                sampler.get2D(), arena, &pi, &pdf);
+
+            if (S.isBlack() || pdf == 0.0) return;
+            beta *= S / pdf;
+
+            L = Spectrum::fma(beta, uniformSampleOneLight(pi, scene, arena, sampler), L);
+
+            Spectrum f = pi.bsdf()->sample(pi.wo(), &wi, sampler.get2D(), &pdf,
+                                           BxDFType::All, &sampledType);
+            if (f.isBlack() || pdf == 0.0) return;
+            beta *= f * (vect::absDot(wi, pi.normal()) / pdf);
+
+            specularBounce = (sampledType & BxDFType::Specular) != BxDFType::None;
+            ray = pi.spawnRay(wi);
+        }
+
+        // Russian roulette
+        if (bounces > 3) {
+            double continueProbability = std::min(0.95, beta.gray());
+            if (sampler.get1D() > continueProbability) return;
+            beta /= continueProbability;
+        }
+
+        paths.bounces[p] = bounces + 1;
+        paths.specularBounce[p] = specularBounce ? 1 : 0;
+        paths.dimensions[p] = sampler.dimension();
+        (*next)[numNext++] = p;
+    });
+    next->resize(numNext);
+}
+
+void WavefrontPathIntegrator::sampleLight(const Scene& scene,
+                                          const SurfaceInteraction& isect,
+                                          const Spectrum& beta, int path,
+                                          Sampler& sampler,
+                                          RayQueue* shadowRays,
+                                          RayQueue* lightRays) const {
+    // The same estimate as "uniformSampleOneLight", whose rays are deferred
+    // to the queues.
+    const int nLights = static_cast<int>(scene.lights().size());
+    if (nLights == 0) return;
+
+    const int lightID = std::min((int)(sampler.get1D() * nLights), nLights - 1);
+    const Light &light = *scene.lights()[lightID];
+    const Point2d randLight = sampler.get2D();
+    const Point2d randShade = sampler.get2D();
+    const BxDFType bxdfType = BxDFType::All & (~BxDFType::Specular);
+
+    // Sample light with multiple importance sampling
+    Vector3 wi;
+    VisibilityTester vis;
+    double lightPdf = 0.0, bsdfPdf = 0.0;
+    Spectrum Li = light.sampleLi(isect, randLight, &wi, &lightPdf, &vis);
+    if (lightPdf > 0.0 && !Li.isBlack()) {
+        const Spectrum f = isect.bsdf()->f(isect.wo(), wi, bxdfType) *
+                           vect::absDot(wi, isect.ns());
+        bsdfPdf = isect.bsdf()->pdf(isect.wo(), wi, bxdfType);
+        if (!f.isBlack()) {
+            const double weight = light.isDelta() ? 1.0 : powerHeuristic(1, lightPdf, 1, bsdfPdf);
+            shadowRays->push(vis.p1().spawnRayTo(vis.p2()),
+                             beta * f * Li * (nLights * weight / lightPdf), path);
+        }
+    }
+
+    // Sample BSDF with multiple importance sampling
+    if (!light.isDelta()) {
+        BxDFType sampledType;
+        Spectrum f = isect.bsdf()->sample(isect.wo(), &wi, randShade, &bsdfPdf,
+                                          bxdfType, &sampledType);
+        f *= vect::absDot(wi, isect.ns());
+        const bool sampledSpecular = (sampledType & BxDFType::Specular) != BxDFType::None;
+
+        if (!f.isBlack() && bsdfPdf > 0.0) {
+            double weight = 1.0;
+            if (!sampledSpecular) {
+                lightPdf = light.pdfLi(isect, wi);
+                if (lightPdf == 0.0) return;
+                weight = powerHeuristic(1, bsdfPdf, 1, lightPdf);
+            }
+            lightRays->push(isect.spawnRay(wi),
+                            beta * f * (nLights * weight / bsdfPdf), path, &light);
+        }
+    }
+}
+
+void WavefrontPathIntegrator::traceShadow(const Scene& scene, PathStates& paths,
+                                          RayQueue& shadowRays) const {
+    std::vector<int> order(shadowRays.size);
+    std::iota(order.begin(), order.end(), 0);
+    sortRays(shadowRays.rays, scene.worldBound(), &order);
+
+    const int n = static_cast<int>(order.size());
+    forEachBatch(n, [&](int start, int end) {
+        RayBatch rays(end - start);
+        for (int k = start; k < end; k++) {
+            rays.push(shadowRays.rays[order[k]]);
+        }
+        bool occluded[kBatchSize];
+        scene.occluded(rays, occluded);
+
+        for (int k = start; k < end; k++) {
+            if (occluded[k - start]) continue;
+            const int i = order[k];
+            Spectrum &L = paths.L[shadowRays.paths[i]];
+            L += shadowRays.contribs[i];
+        }
+    });
+}
+
+void WavefrontPathIntegrator::traceLight(const Scene& scene, PathStates& paths,
+                                         RayQueue& lightRays) const {
+    std::vector<int> order(lightRays.size);
+    std::iota(order.begin(), order.end(), 0);
+    sortRays(lightRays.rays, scene.worldBound(), &order);
+
+    const int n = static_cast<int>(order.size());
+    forEachBatch(n, [&](int start, int end) {
+        RayBatch rays(end - start);
+        HitBatch hits;
+        for (int k = start; k < end; k++) {
+            rays.push(lightRays.rays[order[k]]);
+        }
+        scene.intersect(rays, hits);
+
+        for (int k = start; k < end; k++) {
+            const int i = order[k];
+            const Light *light = lightRays.lights[i];
+            const Ray &ray = rays[k - start];
+            const HitRecord &hit = hits[k - start];
+
+            Spectrum Li(0.0);
+            if (hits.isHit(k - start)) {
+                if (hit.primitive->light() == light) {
+                    SurfaceInteraction lightIsect;
+                    scene.computeSurfaceInteraction(ray, hit, &lightIsect);
+                    Li = lightIsect.Le(-ray.dir());
+                }
+            } else {
+                Li = light->Le(ray);
+            }
+
+            if (!Li.isBlack()) {
+                Spectrum &L = paths.L[lightRays.paths[i]];
+                L = Spectrum::fma(lightRays.contribs[i], Li, L);
+            }
+        }
+    });
+}
+
+}  // namespace spica
@@ -0,0 +1,81 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef _SPICA_WAVEFRONT_INTEGRATOR_H_
+#define _SPICA_WAVEFRONT_INTEGRATOR_H_
+
+#include <vector>
+
+#include "core/common.h"
+#include "core/core.hpp"
+
+#include "core/integrator.h"
+#include "core/renderparams.h"
+
+namespace spica {
+
+/**
+ * Wavefront path tracing
+ * @ingroup renderer_module
+ * @details
+ * This integrator computes the same estimator as PathIntegrator, but the
+ * paths of "wavefrontSize" pixels are advanced together one bounce at a
+ * time instead of following each path to its end. Each bounce runs as the
+ * following stages over the queues of the path states.
+ *   1. The extension rays are sorted by their direction and origin, and
+ *      are traced in a batch.
+ *   2. The paths which hit surfaces are sorted by their materials and are
+ *      shaded. Shading samples the lights and the BSDFs, and puts the
+ *      shadow rays and the rays toward the lights into the queues.
+ *   3. The shadow rays and the rays toward the lights are traced in
+ *      batches, and their contributions are added to the paths.
+ */
+class SPICA_EXPORTS WavefrontPathIntegrator : public Integrator {
+public:
+    // Public methods
+    explicit WavefrontPathIntegrator(const std::shared_ptr<Sampler>& sampler);
+    explicit WavefrontPathIntegrator(RenderParams &params);
+    ~WavefrontPathIntegrator();
+
+    void render(const std::shared_ptr<const Camera>& camera,
+                const Scene& scene,
+                RenderParams& params) override;
+
+private:
+    // Private internal classes
+    struct PathStates;
+    struct RayQueue;
+
+    // Private methods
+    void traceExtension(const Scene& scene, PathStates& paths,
+                        std::vector<int>& active) const;
+
+    void shade(const Scene& scene, PathStates& paths,
+               std::vector<int>& active,
+               std::vector<int>* next,
+               RayQueue* shadowRays,
+               RayQueue* lightRays,
+               const std::vector<std::unique_ptr<Sampler>>& samplers,
+               std::vector<MemoryArena>& arenas) const;
+
+    void sampleLight(const Scene& scene, const SurfaceInteraction& isect,
+                     const Spectrum& beta, int path, Sampler& sampler,
+                     RayQueue* shadowRays, RayQueue* lightRays) const;
+
+    void traceShadow(const Scene& scene, PathStates& paths,
+                     RayQueue& shadowRays) const;
+
+    void traceLight(const Scene& scene, PathStates& paths,
+                    RayQueue& lightRays) const;
+
+    // Private fields
+    std::shared_ptr<Sampler> sampler_;
+    ParamHandle<int> maxDepth_{ 16 };
+};
+
+SPICA_EXPORT_PLUGIN(WavefrontPathIntegrator, "Wavefront path tracing integrator");
+
+}  // namespace spica
+
+#endif  // _SPICA_WAVEFRONT_INTEGRATOR_H_
@@ -26,12 +26,12 @@ namespace spica {
     AreaLight::~AreaLight() {
     }
 
-    Spectrum AreaLight::L(const Interaction& pLight, const Vector3d& w) const {
+    Spectrum AreaLight::L(const Interaction& pLight, const Vector3& w) const {
         return vect::dot(pLight.normal(), w) > 0.0 ? Lemit_ : Spectrum(0.0);                
     }
 
     Spectrum AreaLight::sampleLi(const Interaction& pObj, const Point2d& rands,
-                                 Vector3d* dir, double* pdf,
+                                 Vector3* dir, double* pdf,
                                  VisibilityTester* vis) const {
         Interaction pLight = shape_->sample(pObj, rands);
         *dir = (pLight.pos() - pObj.pos()).normalized();
@@ -40,30 +40,30 @@ namespace spica {
         return L(pLight, -(*dir));
     }
 
-    double AreaLight::pdfLi(const Interaction& pObj, const Vector3d& dir) const {
+    double AreaLight::pdfLi(const Interaction& pObj, const Vector3& dir) const {
         return shape_->pdf(pObj, dir);
     }
 
     Spectrum AreaLight::sampleLe(const Point2d& randPos, const Point2d& randDir,
-                                 Ray* ray, Normal3d* nLight, double* pdfPos,
+                                 Ray* ray, Normal3* nLight, double* pdfPos,
                                  double* pdfDir) const {
         Interaction pShape = shape_->sample(randPos);
         *pdfPos = shape_->pdf(pShape);
         *nLight = pShape.normal();
 
-        Vector3d w = sampleCosineHemisphere(randDir);
+        Vector3 w = sampleCosineHemisphere(randDir);
         *pdfDir = cosineHemispherePdf(vect::cosTheta(w));
 
-        Vector3d v1, v2, n(pShape.normal());
+        Vector3 v1, v2, n(pShape.normal());
         vect::coordinateSystem(n, &v1, &v2);
         w = w.x() * v1 + w.y() * v2 + w.z() * n;
         *ray = pShape.spawnRay(w);
         return L(pShape, w);
     }
 
-    void AreaLight::pdfLe(const Ray& ray, const Normal3d& nLight,
+    void AreaLight::pdfLe(const Ray& ray, const Normal3& nLight,
                           double* pdfPos, double* pdfDir) const {
-        Interaction it(ray.org(), nLight, Vector3d(nLight));
+        Interaction it(ray.org(), nLight, Vector3(nLight));
         *pdfPos = shape_->pdf(it);
         *pdfDir = cosineHemispherePdf(vect::dot(nLight, ray.dir()));
     }
@@ -27,18 +27,18 @@ public:
 
     virtual ~AreaLight();
 
-    Spectrum L(const Interaction& pLight, const Vector3d& dir) const override;
+    Spectrum L(const Interaction& pLight, const Vector3& dir) const override;
 
     Spectrum sampleLi(const Interaction& isect, const Point2d& rands,
-                        Vector3d* dir, double* pdf,
+                        Vector3* dir, double* pdf,
                         VisibilityTester* vis) const override;
 
-    double pdfLi(const Interaction& pObj, const Vector3d& dir) const override;
+    double pdfLi(const Interaction& pObj, const Vector3& dir) const override;
 
     Spectrum sampleLe(const Point2d& rand1, const Point2d& rand2,
-                        Ray* ray, Normal3d* nLight, double* pdfPos,
+                        Ray* ray, Normal3* nLight, double* pdfPos,
                         double* pdfDir) const override;
-    void pdfLe(const Ray& ray, const Normal3d& nLight, double* pdfPos,
+    void pdfLe(const Ray& ray, const Normal3& nLight, double* pdfPos,
                 double* pdfDir) const override;
 
     Spectrum power() const override;
@@ -47,7 +47,7 @@ Envmap::Envmap(const BSphere& worldSphere, const Image& texmap, const Transform&
 }
 
 Envmap::Envmap(RenderParams &params)
-    : Envmap{BSphere(params.getPoint3d("worldCenter", Point3d(0.0, 0.0, 0.0), true),
+    : Envmap{BSphere(params.getPoint3d("worldCenter", Point3(0.0, 0.0, 0.0), true),
                      params.getDouble("worldRadius", 2.0, true)),
              Image::fromFile(params.getString("filename", true)),
              params.getTransform("toWorld", Transform{}, true),
@@ -58,7 +58,7 @@ Envmap::~Envmap() {
 }
 
 Spectrum Envmap::sampleLi(const Interaction& pObj, const Point2d& rands,
-                            Vector3d* dir, double* pdf, VisibilityTester* vis) const {
+                            Vector3* dir, double* pdf, VisibilityTester* vis) const {
     double mapPdf;
     Point2d uv = distrib_.sample(rands, &mapPdf);
     if (mapPdf == 0.0) return Spectrum();
@@ -69,7 +69,7 @@ Spectrum Envmap::sampleLi(const Interaction& pObj, const Point2d& rands,
     const double sinTheta = std::sin(theta);
     const double cosPhi   = std::cos(phi);
     const double sinPhi   = std::sin(phi);
-    *dir = lightToWorld_.apply(Vector3d(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta));
+    *dir = lightToWorld_.apply(Vector3(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta));
     *pdf = sinTheta == 0.0 ? 0.0 : mapPdf / (2.0 * PI * PI * sinTheta);
 
     Interaction pLight(pObj.pos() + (*dir) * (2.0 * worldRadius_));
@@ -78,8 +78,8 @@ Spectrum Envmap::sampleLi(const Interaction& pObj, const Point2d& rands,
     return Spectrum(mipmap_->lookup(uv));
 }
 
-double Envmap::pdfLi(const Interaction&, const Vector3d& d) const {
-    Vector3d dir = worldToLight_.apply(d);
+double Envmap::pdfLi(const Interaction&, const Vector3& d) const {
+    Vector3 dir = worldToLight_.apply(d);
     double theta = vect::sphericalTheta(dir);
     double phi   = vect::sphericalPhi(dir);
     double sinTheta = sin(theta);
@@ -88,7 +88,7 @@ double Envmap::pdfLi(const Interaction&, const Vector3d& d) const {
 }
 
 Spectrum Envmap::sampleLe(const Point2d& rand1, const Point2d& rand2,
-                          Ray* ray, Normal3d* nLight, double* pdfPos,
+                          Ray* ray, Normal3* nLight, double* pdfPos,
                           double* pdfDir) const {
     double mapPdf;
     Point2d uv = distrib_.sample(rand1, &mapPdf);
@@ -100,13 +100,13 @@ Spectrum Envmap::sampleLe(const Point2d& rand1, const Point2d& rand2,
     double sinTheta = std::sin(theta);
     double sinPhi   = std::sin(phi);
     double cosPhi   = std::cos(phi);
-    Vector3d d = -lightToWorld_.apply(Vector3d(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta));
-    *nLight = Normal3d(d);
+    Vector3 d = -lightToWorld_.apply(Vector3(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta));
+    *nLight = Normal3(d);
 
-    Vector3d v1, v2;
+    Vector3 v1, v2;
     vect::coordinateSystem(-d, &v1, &v2);
     Point2d cd = sampleConcentricDisk(rand2);
-    Point3d pDisk = worldCenter_ + worldRadius_ * (cd.x() * v1 + cd.y() * v2);
+    Point3 pDisk = worldCenter_ + worldRadius_ * (cd.x() * v1 + cd.y() * v2);
     *ray = Ray(pDisk - worldRadius_ * d, d, INFTY);
 
     *pdfDir = sinTheta == 0.0 ? 0.0 : mapPdf / (2.0 * PI * PI * sinTheta);
@@ -115,10 +115,10 @@ Spectrum Envmap::sampleLe(const Point2d& rand1, const Point2d& rand2,
 }
 
 
-void Envmap::pdfLe(const Ray& ray, const Normal3d& nLight, double* pdfPos,
+void Envmap::pdfLe(const Ray& ray, const Normal3& nLight, double* pdfPos,
                    double* pdfDir) const {
-    Vector3d d = -worldToLight_.apply(ray.dir());
-    double theta = std::acos(clamp(d.z(), -1.0, 1.0));
+    Vector3 d = -worldToLight_.apply(ray.dir());
+    double theta = std::acos(clamp(static_cast<double>(d.z()), -1.0, 1.0));
     double phi   = std::atan2(d.y(), d.x());
     if (phi < 0.0) phi += 2.0 * PI;
     Point2d uv(phi * (0.5 * INV_PI), theta * INV_PI);
@@ -128,7 +128,7 @@ void Envmap::pdfLe(const Ray& ray, const Normal3d& nLight, double* pdfPos,
 }
 
 Spectrum Envmap::Le(const Ray& ray) const {
-    Vector3d dir = worldToLight_.apply(ray.dir()).normalized();
+    Vector3 dir = worldToLight_.apply(ray.dir()).normalized();
     Point2d st(vect::sphericalPhi(dir) * (0.5 * INV_PI), vect::sphericalTheta(dir) * INV_PI);
     return Spectrum(mipmap_->lookup(st));
 }
@@ -33,14 +33,14 @@ public:
     virtual ~Envmap();
 
     Spectrum sampleLi(const Interaction& pObj, const Point2d& rands,
-                        Vector3d* dir, double* pdf, VisibilityTester* vis) const override;
+                        Vector3* dir, double* pdf, VisibilityTester* vis) const override;
 
-    double pdfLi(const Interaction& pObj, const Vector3d& dir) const override;
+    double pdfLi(const Interaction& pObj, const Vector3& dir) const override;
 
     Spectrum sampleLe(const Point2d& rand1, const Point2d& rand2,
-                        Ray* ray, Normal3d* nLight, double* pdfPos,
+                        Ray* ray, Normal3* nLight, double* pdfPos,
                         double* pdfDir) const override;
-    void pdfLe(const Ray& ray, const Normal3d& nLight, double* pdfPos,
+    void pdfLe(const Ray& ray, const Normal3& nLight, double* pdfPos,
                 double* pdfDir) const override;
 
     Spectrum Le(const Ray& ray) const override;
@@ -50,7 +50,7 @@ public:
 
 private:
     std::unique_ptr<const MipMap> mipmap_;
-    Point3d worldCenter_;
+    Point3 worldCenter_;
     double   worldRadius_;
     Distribution2D distrib_;
 };
@@ -38,10 +38,10 @@ GridDensityMedium::GridDensityMedium(const Spectrum& sigmaAbsorb,
     invMaxDensity_ = 1.0 / maxDensity;
 }
 
-double GridDensityMedium::density(const Point3d& p) const {
-    Point3d pSamples(p.x() * nx_, p.y() * ny_, p.z() * nz_);
+double GridDensityMedium::density(const Point3& p) const {
+    Point3 pSamples(p.x() * nx_, p.y() * ny_, p.z() * nz_);
     Point3i pi(std::floor(pSamples.x()), std::floor(pSamples.y()), std::floor(pSamples.z()));
-    Vector3d d = pSamples - Point3d(pi.x(), pi.y(), pi.z());
+    Vector3 d = pSamples - Point3(pi.x(), pi.y(), pi.z());
 
     double d00 = lerp(d.x(), D(pi), D(pi + Vector3i(1, 0, 0)));
     double d01 = lerp(d.x(), D(pi + Vector3i(0, 0, 1)), D(pi + Vector3i(1, 0, 1)));
@@ -62,11 +62,11 @@ double GridDensityMedium::D(const Point3i& p) const {
 Spectrum GridDensityMedium::sample(const Ray& rWorld, Sampler& sampler,
                                    MemoryArena& arena,
                                    MediumInteraction* mi) const {
-    Point3d  rOrg = worldToMedium_.apply(rWorld.org());
-    Vector3d rDir = worldToMedium_.apply(rWorld.dir());
+    Point3  rOrg = worldToMedium_.apply(rWorld.org());
+    Vector3 rDir = worldToMedium_.apply(rWorld.dir());
     Ray ray(rOrg, rDir.normalized(), rWorld.maxDist());
 
-    Bounds3d b(Point3d(0.0, 0.0, 0.0), Point3d(1.0, 1.0, 1.0));
+    Bounds3 b(Point3(0.0, 0.0, 0.0), Point3(1.0, 1.0, 1.0));
     double tMin, tMax;
     if (!b.intersect(ray, &tMin, &tMax)) {
         return Spectrum(1.0);
@@ -87,11 +87,11 @@ Spectrum GridDensityMedium::sample(const Ray& rWorld, Sampler& sampler,
 }
 
 Spectrum GridDensityMedium::Tr(const Ray& rWorld, Sampler& sampler) const {
-    Point3d  rOrg = worldToMedium_.apply(rWorld.org());
-    Vector3d rDir = worldToMedium_.apply(rWorld.dir());
+    Point3  rOrg = worldToMedium_.apply(rWorld.org());
+    Vector3 rDir = worldToMedium_.apply(rWorld.dir());
     Ray ray(rOrg, rDir.normalized(), rWorld.maxDist());
 
-    Bounds3d b(Point3d(0.0, 0.0, 0.0), Point3d(1.0, 1.0, 1.0));
+    Bounds3 b(Point3(0.0, 0.0, 0.0), Point3(1.0, 1.0, 1.0));
     double tMin, tMax;
     if (!b.intersect(ray, &tMin, &tMax)) {
         return Spectrum(1.0);
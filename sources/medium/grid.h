@@ -19,7 +19,7 @@ public:
                       int nx, int ny, int nz, const Transform& mediumToWorld,
                       const std::vector<double>& data);
 
-    double density(const Point3d& p) const;
+    double density(const Point3& p) const;
     double D(const Point3i& p) const;
 
     Spectrum sample(const Ray& ray, Sampler& sampler, MemoryArena& arena,
@@ -42,7 +42,7 @@ Spectrum HomogeneousMedium::sample(const Ray& ray, Sampler& sampler,
     bool sampleMedium = t < ray.maxDist();
 
     if (sampleMedium) {
-        Point3d p = ray.org() + t * ray.dir();        
+        Point3 p = ray.org() + t * ray.dir();        
         PhaseFunction* phase = arena.allocate<HenyeyGreenstein>(g_);
         *mi = MediumInteraction(p, -ray.dir(), this, phase);    
     }
@@ -4,6 +4,8 @@
 #include <cstdlib>
 #include <algorithm>
 
+#include "core/checkpoint.h"
+
 namespace spica {
 
 namespace {
@@ -86,7 +88,7 @@ Halton::Halton(int ns, bool isPermute, uint32_t seed)
     , bases_{ std::make_unique<int[]>(ns) }
     , permute_{ std::make_unique<int[]>(sumOfPrimes(ns)) }
     , samples_{ std::make_unique<double[]>(ns) } {
-    Assertion(nSamples_ <= nPrimes_,
+    SPICA_CHECK(nSamples_ <= nPrimes_,
               "You cannot specify dimension over 1000");
 
     for (int i = 0; i < nSamples_; i++) {
@@ -139,6 +141,29 @@ std::unique_ptr<Sampler> Halton::clone(unsigned int seed) const {
     return std::make_unique<Halton>(nSamples_, isPermute_, seed);
 }
 
+void Halton::saveState(CheckpointWriter &writer) const {
+    // The permutation depends on the seed of the clone, and is written too.
+    writer.write(nSamples_);
+    writer.write(sampleIndex_);
+    writer.write(nUsedSamples_);
+    writer.write(permute_.get(), sumOfPrimes(nSamples_));
+    writer.write(samples_.get(), nSamples_);
+    rng_.saveState(writer);
+}
+
+void Halton::loadState(CheckpointReader &reader) {
+    int nSamples;
+    reader.read(&nSamples);
+    if (nSamples != nSamples_) {
+        throw RuntimeException("Checkpoint is for Halton sampler of %d dimensions!!", nSamples);
+    }
+    reader.read(&sampleIndex_);
+    reader.read(&nUsedSamples_);
+    reader.read(permute_.get(), sumOfPrimes(nSamples_));
+    reader.read(samples_.get(), nSamples_);
+    rng_.loadState(reader);
+}
+
 double Halton::radicalInverse(int n, int base, const int* p) const {
     double val = 0.0;
     double invBase = 1.0 / base;
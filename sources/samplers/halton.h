@@ -34,6 +34,9 @@ public:
 
     std::unique_ptr<Sampler> clone(unsigned int seed = 0) const override;
 
+    void saveState(CheckpointWriter &writer) const override;
+    void loadState(CheckpointReader &reader) override;
+
 private:
     double radicalInverse(int n, int base, const int* p) const;
 
@@ -1,6 +1,8 @@
 #define SPICA_API_EXPORT
 #include "independent.h"
 
+#include "core/checkpoint.h"
+
 namespace spica {
 
 Independent::Independent(uint32_t seed)
@@ -15,11 +17,41 @@ Independent::~Independent() {
 }
 
 double Independent::get1D() {
+    if (indexed_) {
+        return hashedSample(pixel_, sampleIndex_, dimension_++);
+    }
     return random_.get1D();
 }
 
+void Independent::startPixel() {
+    indexed_ = false;
+}
+
+void Independent::startPixelSample(const Point2i &pixel, int sampleIndex) {
+    pixel_ = pixel;
+    sampleIndex_ = sampleIndex;
+    dimension_ = 0;
+    indexed_ = true;
+}
+
+int Independent::dimension() const {
+    return dimension_;
+}
+
+void Independent::setDimension(int dimension) {
+    dimension_ = dimension;
+}
+
 std::unique_ptr<Sampler> Independent::clone(uint32_t seed) const {
     return std::make_unique<Independent>(seed);
 }
 
+void Independent::saveState(CheckpointWriter &writer) const {
+    random_.saveState(writer);
+}
+
+void Independent::loadState(CheckpointReader &reader) {
+    random_.loadState(reader);
+}
+
 }  // namespace spica
@@ -6,6 +6,7 @@
 #define _SPICA_INDEPENDENT_H_
 
 #include "core/random.h"
+#include "core/point2d.h"
 
 namespace spica {
 
@@ -20,11 +21,26 @@ public:
     ~Independent();
 
     double get1D() override;
+    void startPixel() override;
+
+    /** After this call, the numbers are the hashes of the pixel, the sample
+     *  index and the dimension, until "startPixel" is called.
+     */
+    void startPixelSample(const Point2i &pixel, int sampleIndex) override;
+    int dimension() const override;
+    void setDimension(int dimension) override;
 
     std::unique_ptr<Sampler> clone(uint32_t seed = 0) const override;
 
+    void saveState(CheckpointWriter &writer) const override;
+    void loadState(CheckpointReader &reader) override;
+
 private:
     Random random_;
+    Point2i pixel_;
+    int sampleIndex_ = 0;
+    int dimension_ = 0;
+    bool indexed_ = false;
 };
 
 SPICA_EXPORT_PLUGIN(Independent, "Random number generator with Mersenne twister.");
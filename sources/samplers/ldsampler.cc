@@ -2,6 +2,7 @@
 #include "ldsampler.h"
 
 #include "core/renderparams.h"
+#include "core/checkpoint.h"
 
 namespace spica {
 
@@ -132,6 +133,10 @@ LowDiscrepancySampler::~LowDiscrepancySampler() {
 double LowDiscrepancySampler::get1D() {
     if (currentSample1DDim_ < nSampledDimensions_) {
         return sample1D_[currentSample1DDim_++][currentSampleIndex_];
+    } else if (indexed_) {
+        // 1D and 2D dimensions are interleaved not to share the hashes
+        const int dim = 3 * currentSample1DDim_++;
+        return hashedSample(currentPixel_, pixelSampleIndex_, dim);
     } else {
         return rng_.get1D();
     }
@@ -140,6 +145,10 @@ double LowDiscrepancySampler::get1D() {
 Point2d LowDiscrepancySampler::get2D() {
     if (currentSample2DDim_ < nSampledDimensions_) {
         return sample2D_[currentSample2DDim_++][currentSampleIndex_];
+    } else if (indexed_) {
+        const int dim = 3 * currentSample2DDim_++;
+        return Point2d(hashedSample(currentPixel_, pixelSampleIndex_, dim + 1),
+                       hashedSample(currentPixel_, pixelSampleIndex_, dim + 2));
     } else {
         return rng_.get2D();
     }
@@ -155,12 +164,72 @@ void LowDiscrepancySampler::startPixel() {
     currentSample1DDim_ = 0;
     currentSample2DDim_ = 0;
     currentSampleIndex_ = 0;
+    indexed_ = false;
+}
+
+void LowDiscrepancySampler::startPixelSample(const Point2i &pixel, int sampleIndex) {
+    currentSample1DDim_ = 0;
+    currentSample2DDim_ = 0;
+    currentSampleIndex_ = sampleIndex % samplesPerPixel_;
+    currentPixel_ = pixel;
+    pixelSampleIndex_ = sampleIndex;
+    indexed_ = true;
+}
+
+int LowDiscrepancySampler::dimension() const {
+    // Both of the dimensions are packed in an integer
+    return currentSample1DDim_ | (currentSample2DDim_ << 16);
+}
+
+void LowDiscrepancySampler::setDimension(int dimension) {
+    currentSample1DDim_ = dimension & 0xffff;
+    currentSample2DDim_ = dimension >> 16;
 }
 
 std::unique_ptr<Sampler> LowDiscrepancySampler::clone(uint32_t seed) const {
     return std::make_unique<LowDiscrepancySampler>(samplesPerPixel_, nSampledDimensions_, seed);
 }
 
+void LowDiscrepancySampler::saveState(CheckpointWriter &writer) const {
+    writer.write(samplesPerPixel_);
+    writer.write(nSampledDimensions_);
+    writer.write(currentSampleIndex_);
+    writer.write(currentSample1DDim_);
+    writer.write(currentSample2DDim_);
+    std::vector<double> xy(samplesPerPixel_ * 2);
+    for (int i = 0; i < nSampledDimensions_; i++) {
+        for (int k = 0; k < samplesPerPixel_; k++) {
+            xy[k * 2 + 0] = sample2D_[i][k].x();
+            xy[k * 2 + 1] = sample2D_[i][k].y();
+        }
+        writer.write(sample1D_[i].data(), samplesPerPixel_);
+        writer.write(xy.data(), xy.size());
+    }
+    rng_.saveState(writer);
+}
+
+void LowDiscrepancySampler::loadState(CheckpointReader &reader) {
+    int samplesPerPixel, nSampledDimensions;
+    reader.read(&samplesPerPixel);
+    reader.read(&nSampledDimensions);
+    if (samplesPerPixel != samplesPerPixel_ || nSampledDimensions != nSampledDimensions_) {
+        throw RuntimeException("Checkpoint is for the sampler of %d samples in %d dimensions!!",
+                               samplesPerPixel, nSampledDimensions);
+    }
+    reader.read(&currentSampleIndex_);
+    reader.read(&currentSample1DDim_);
+    reader.read(&currentSample2DDim_);
+    std::vector<double> xy(samplesPerPixel_ * 2);
+    for (int i = 0; i < nSampledDimensions_; i++) {
+        reader.read(sample1D_[i].data(), samplesPerPixel_);
+        reader.read(xy.data(), xy.size());
+        for (int k = 0; k < samplesPerPixel_; k++) {
+            sample2D_[i][k] = Point2d(xy[k * 2 + 0], xy[k * 2 + 1]);
+        }
+    }
+    rng_.loadState(reader);
+}
+
 void LowDiscrepancySampler::initializeSamples() {
     // 1D samples
     sample1D_.assign(nSampledDimensions_,
@@ -28,8 +28,19 @@ public:
 
     bool startNextSample() override;
     void startPixel() override;
+
+    /** Draws the sample "sampleIndex" of the tables. The dimensions beyond
+     *  the tables are the hashes of the pixel, the sample index and the
+     *  dimension, until "startPixel" is called.
+     */
+    void startPixelSample(const Point2i &pixel, int sampleIndex) override;
+    int dimension() const override;
+    void setDimension(int dimension) override;
     std::unique_ptr<Sampler> clone(uint32_t seed = 0) const override;
 
+    void saveState(CheckpointWriter &writer) const override;
+    void loadState(CheckpointReader &reader) override;
+
 private:
     void initializeSamples();
 
@@ -38,6 +49,9 @@ private:
     int currentSampleIndex_;
     int currentSample1DDim_;
     int currentSample2DDim_;
+    Point2i currentPixel_;
+    int pixelSampleIndex_ = 0;
+    bool indexed_ = false;
     std::vector<std::vector<double>> sample1D_;
     std::vector<std::vector<Point2d>> sample2D_;
     Random rng_;
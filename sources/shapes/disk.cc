@@ -19,7 +19,7 @@ Disk::Disk()
     : Shape{ Transform(), ShapeType::Disk } {
 }
 
-Disk::Disk(const Point3d& center, const Normal3d& normal, double radius,
+Disk::Disk(const Point3& center, const Normal3& normal, double radius,
            const Transform& objectToWorld)
     : Shape{ objectToWorld, ShapeType::Disk }
     , center_{ center }
@@ -45,33 +45,50 @@ Disk& Disk::operator=(const Disk& disk) {
 
 bool Disk::intersect(const Ray& ray, double* tHit,
                      SurfaceInteraction* isect) const {
+    double b1, b2;
+    if (!hitTest(ray, tHit, &b1, &b2)) return false;
+    computeSurfaceInteraction(ray, *tHit, b1, b2, isect);
+    return true;
+}
+
+bool Disk::hitTest(const Ray& ray, double* tHit,
+                   double* b1, double* b2) const {
     double dt = vect::dot(ray.dir(), normal_);
     if (dt > -EPS) return false;
 
     *tHit = vect::dot(normal_, center_ - ray.org()) / dt;
     if (*tHit > ray.maxDist()) return false;
 
-    Point3d pos = ray.org() + (*tHit) * ray.dir();
-    Vector3d p2c = pos - center_;
+    Point3 pos = ray.org() + (*tHit) * ray.dir();
+    if ((pos - center_).norm() > radius_) return false;
+
+    // The hit point is recomputed from "tHit".
+    *b1 = *b2 = 0.0;
+    return true;
+}
+
+void Disk::computeSurfaceInteraction(const Ray& ray, double tHit,
+                                     double b1, double b2,
+                                     SurfaceInteraction* isect) const {
+    Point3 pos = ray.org() + tHit * ray.dir();
+    Vector3 p2c = pos - center_;
     const double r = p2c.norm();
-    if (r > radius_) return false;
 
-    Vector3d uVec, vVec;
-    vect::coordinateSystem(Vector3d(normal_), &uVec, &vVec);
+    Vector3 uVec, vVec;
+    vect::coordinateSystem(Vector3(normal_), &uVec, &vVec);
     const double theta = atan2(vect::dot(vVec, p2c), vect::dot(uVec, p2c)); 
     const double u = r / radius_;
     const double v = (theta + PI) / (2.0 * PI);
 
     const double cosTheta = cos(theta);
     const double sinTheta = sin(theta);
-    const Vector3d dpdu = radius_ * (uVec * cosTheta + vVec * sinTheta);
-    const Vector3d dpdv = 2.0 * PI * r * (-uVec * sinTheta + vVec * cosTheta);
-    const Normal3d nrm = Normal3d(vect::cross(dpdu, dpdv));
+    const Vector3 dpdu = radius_ * (uVec * cosTheta + vVec * sinTheta);
+    const Vector3 dpdv = 2.0 * PI * r * (-uVec * sinTheta + vVec * cosTheta);
+    const Normal3 nrm = Normal3(vect::cross(dpdu, dpdv));
 
     *isect = SurfaceInteraction(pos, Point2d(u, v), -ray.dir(),
-                                dpdu, dpdv, Normal3d(0.0, 0.0, 0.0),
-                                Normal3d(0.0, 0.0, 0.0), this);
-    return true;
+                                dpdu, dpdv, Normal3(0.0, 0.0, 0.0),
+                                Normal3(0.0, 0.0, 0.0), this);
 }
 
 bool Disk::intersect(const Ray& ray) const {
@@ -81,25 +98,25 @@ bool Disk::intersect(const Ray& ray) const {
     const double tHit = vect::dot(normal_, center_ - ray.org()) / dt;
     if (tHit > ray.maxDist()) return false;
 
-    Point3d pos = ray.org() + tHit * ray.dir();
-    Vector3d p2c = pos - center_;
+    Point3 pos = ray.org() + tHit * ray.dir();
+    Vector3 p2c = pos - center_;
     const double r = p2c.norm();
     return r <= radius_;
 }
 
 Interaction Disk::sample(const Point2d& rands) const {
     const Point2d uv = sampleConcentricDisk(rands);
-    Vector3d u, v;
-    vect::coordinateSystem(Vector3d(normal_), &u, &v);
+    Vector3 u, v;
+    vect::coordinateSystem(Vector3(normal_), &u, &v);
 
-    Point3d pos = center_ + uv[0] * u + uv[1] * v;
+    Point3 pos = center_ + uv[0] * u + uv[1] * v;
     return Interaction{ pos, normal_ };
 }
 
-Bounds3d Disk::objectBound() const {
-    Bounds3d b;
-    Vector3d u, v;
-    vect::coordinateSystem(Vector3d(normal_), &u, &v);
+Bounds3 Disk::objectBound() const {
+    Bounds3 b;
+    Vector3 u, v;
+    vect::coordinateSystem(Vector3(normal_), &u, &v);
     b.merge(center_ + radius_ * u);
     b.merge(center_ + radius_ * v);
     return b;
@@ -110,16 +127,16 @@ double Disk::area() const {
 }
 
 std::vector<Triangle> Disk::triangulate() const {
-    Vector3d u, v;
-    vect::coordinateSystem(Vector3d(normal_), &u, &v);
+    Vector3 u, v;
+    vect::coordinateSystem(Vector3(normal_), &u, &v);
 
     std::vector<Triangle> retval;
     for (int i = 0; i < kSubdivDisk; i++) {
         int    j  = (i + 1) % kSubdivDisk;
         double t1 = (2.0 * PI * i) / kSubdivDisk;
         double t2 = (2.0 * PI * j) / kSubdivDisk;
-        Point3d p0 = center_ + radius_ * ((u * cos(t1)) + (v * sin(t1)));
-        Point3d p1 = center_ + radius_ * ((u * cos(t2)) + (v * sin(t2)));
+        Point3 p0 = center_ + radius_ * ((u * cos(t1)) + (v * sin(t1)));
+        Point3 p1 = center_ + radius_ * ((u * cos(t2)) + (v * sin(t2)));
         retval.emplace_back(center_, p0, p1, normal_, normal_, normal_);
     }
     return std::move(retval);
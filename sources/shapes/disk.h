@@ -20,7 +20,7 @@ namespace spica {
 class SPICA_EXPORTS Disk : public Shape {
 public:
     Disk();
-    Disk(const Point3d& center, const Normal3d& normal, double radius,
+    Disk(const Point3& center, const Normal3& normal, double radius,
          const Transform& objectToWorld = Transform());
     Disk(const Disk& disk);
     ~Disk();
@@ -30,22 +30,27 @@ public:
     bool intersect(const Ray& ray, double* tHit,
                    SurfaceInteraction* isect) const override;
     bool intersect(const Ray& ray) const override;
+    bool hitTest(const Ray& ray, double* tHit,
+                 double* b1, double* b2) const override;
+    void computeSurfaceInteraction(const Ray& ray, double tHit,
+                                   double b1, double b2,
+                                   SurfaceInteraction* isect) const override;
 
     Interaction sample(const Point2d& rands) const override;
 
-    Bounds3d objectBound() const override;
+    Bounds3 objectBound() const override;
 
     double area() const override;
 
     std::vector<Triangle> triangulate() const override;
 
-    inline Point3d  center() const { return center_; }
-    inline Normal3d normal() const { return normal_; }
+    inline Point3  center() const { return center_; }
+    inline Normal3 normal() const { return normal_; }
     inline double   radius() const { return radius_; }
     
 private:
-    Point3d  center_ = { 0.0, 0.0, 0.0 };
-    Normal3d normal_ = { 0.0, 0.0, 0.0 };
+    Point3  center_ = { 0.0, 0.0, 0.0 };
+    Normal3 normal_ = { 0.0, 0.0, 0.0 };
     double   radius_ = 0.0;
 
 };  // class Disk
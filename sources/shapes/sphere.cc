@@ -15,7 +15,7 @@ Sphere::Sphere()
     : Shape{ Transform{}, ShapeType::Sphere } {
 }
 
-Sphere::Sphere(const Point3d& center, double radius, const Transform& objectToWorld)
+Sphere::Sphere(const Point3& center, double radius, const Transform& objectToWorld)
     : Shape{ objectToWorld, ShapeType::Sphere }
     , center_{ center }
     , radius_{ radius } {
@@ -37,8 +37,16 @@ Sphere& Sphere::operator=(const Sphere& sphere) {
 
 bool Sphere::intersect(const Ray& ray, double* tHit,
                         SurfaceInteraction* isect) const {
+    double b1, b2;
+    if (!hitTest(ray, tHit, &b1, &b2)) return false;
+    computeSurfaceInteraction(ray, *tHit, b1, b2, isect);
+    return true;
+}
+
+bool Sphere::hitTest(const Ray& ray, double* tHit,
+                     double* b1, double* b2) const {
     // Compute intersection
-    const Vector3d VtoC = center_ - ray.org();
+    const Vector3 VtoC = center_ - ray.org();
     const double b = VtoC.dot(ray.dir());
     const double D4 = b * b - VtoC.dot(VtoC) + radius_ * radius_;
 
@@ -57,9 +65,17 @@ bool Sphere::intersect(const Ray& ray, double* tHit,
     }
     if (*tHit > ray.maxDist()) return false;
 
-    Point3d  pWorld = ray.org() + (*tHit) * ray.dir();
-    Point3d  pObj   = Point3d(pWorld - center_);
-    Normal3d nrm    = Normal3d(pObj).normalized();
+    // The hit point is recomputed from "tHit".
+    *b1 = *b2 = 0.0;
+    return true;
+}
+
+void Sphere::computeSurfaceInteraction(const Ray& ray, double tHit,
+                                       double b1, double b2,
+                                       SurfaceInteraction* isect) const {
+    Point3  pWorld = ray.org() + tHit * ray.dir();
+    Point3  pObj   = Point3(pWorld - center_);
+    Normal3 nrm    = Normal3(pObj).normalized();
 
     // Compute differential geometries
     const double phi   = vect::sphericalPhi(nrm);
@@ -68,45 +84,44 @@ bool Sphere::intersect(const Ray& ray, double* tHit,
     const double sinPhi = sin(phi);
     const double u = phi / (2.0 * PI);
     const double v = theta  / PI;
-    Vector3d dpdu = Vector3d{ -2.0 * PI * pObj.y(), 2.0 * PI * pObj.x(), 0.0 };
-    Vector3d dpdv = -PI * Vector3d(cosPhi * pObj.z(), sinPhi * pObj.z(),
-                                   -radius_ * sin(theta));
+    Vector3 dpdu = Vector3{ -2.0 * PI * pObj.y(), 2.0 * PI * pObj.x(), 0.0 };
+    Vector3 dpdv = -PI * Vector3(cosPhi * pObj.z(), sinPhi * pObj.z(),
+                                 -radius_ * sin(theta));
 
     // Prevent dpdu becomes zero when the ray intersect on either north or south pole.
     if (dpdu.norm() < EPS) {
         double sz = pObj.z() > 0.0 ? 1.0 : -1.0;
-        if (dpdv.cross(Vector3d(sz, 0.0, 0.0)).z() > EPS) {
-            dpdu = dpdv.cross(Vector3d(sz, 0.0, 0.0));
+        if (dpdv.cross(Vector3(sz, 0.0, 0.0)).z() > EPS) {
+            dpdu = dpdv.cross(Vector3(sz, 0.0, 0.0));
         } else {
-            dpdu = dpdv.cross(Vector3d(0.0, sz, 0.0));
+            dpdu = dpdv.cross(Vector3(0.0, sz, 0.0));
         }
     }
 
 
-    Vector3d d2pdudu = - (2.0 * PI) * (2.0 * PI) * Vector3d(pObj.x(), pObj.y(), 0.0);
-    Vector3d d2pdudv = PI * pObj.z() * (2.0 * PI) * Vector3d(sinPhi, -cosPhi, 0.0);
-    Vector3d d2pdvdv = -PI * PI * pObj;
+    Vector3 d2pdudu = - (2.0 * PI) * (2.0 * PI) * Vector3(pObj.x(), pObj.y(), 0.0);
+    Vector3 d2pdudv = PI * pObj.z() * (2.0 * PI) * Vector3(sinPhi, -cosPhi, 0.0);
+    Vector3 d2pdvdv = -PI * PI * pObj;
 
     // Fundamental forms
-    const double E = Vector3d::dot(dpdu, dpdu);
-    const double F = Vector3d::dot(dpdu, dpdv);
-    const double G = Vector3d::dot(dpdv, dpdv);
-    const Vector3d N = Vector3d::cross(dpdu, dpdv).normalized();
-    const double e = Vector3d::dot(N, d2pdudu);
-    const double f = Vector3d::dot(N, d2pdudv);
-    const double g = Vector3d::dot(N, d2pdvdv);
+    const double E = Vector3::dot(dpdu, dpdu);
+    const double F = Vector3::dot(dpdu, dpdv);
+    const double G = Vector3::dot(dpdv, dpdv);
+    const Vector3 N = Vector3::cross(dpdu, dpdv).normalized();
+    const double e = Vector3::dot(N, d2pdudu);
+    const double f = Vector3::dot(N, d2pdudv);
+    const double g = Vector3::dot(N, d2pdvdv);
 
     double invEGF2 = 1.0 / (E * G - F * F);
-    Normal3d dndu = Normal3d((F * f - G * e) * invEGF2 * dpdu + (F * e - E * f) * invEGF2 * dpdv);
-    Normal3d dndv = Normal3d((F * g - G * f) * invEGF2 * dpdu + (F * f - E * g) * invEGF2 * dpdv);
+    Normal3 dndu = Normal3((F * f - G * e) * invEGF2 * dpdu + (F * e - E * f) * invEGF2 * dpdv);
+    Normal3 dndv = Normal3((F * g - G * f) * invEGF2 * dpdu + (F * f - E * g) * invEGF2 * dpdv);
 
     *isect = SurfaceInteraction(pWorld, Point2d(u, v), -ray.dir(), dpdu, dpdv, dndu, dndv, this);
-    return true;
 }
 
 bool Sphere::intersect(const Ray& ray) const {
     // Compute intersection
-    const Vector3d v2c = center_ - ray.org();
+    const Vector3 v2c = center_ - ray.org();
     const double b = v2c.dot(ray.dir());
     const double D4 = b * b - v2c.squaredNorm() + radius_ * radius_;
 
@@ -129,9 +144,9 @@ bool Sphere::intersect(const Ray& ray) const {
 }
 
 Interaction Sphere::sample(const Point2d& rands) const {
-    Vector3d pLocal = sampleUniformSphere(rands);
-    Point3d pObj = center_ + radius_ * pLocal;
-    Normal3d pNorm = Normal3d(pLocal).normalized();
+    Vector3 pLocal = sampleUniformSphere(rands);
+    Point3 pObj = center_ + radius_ * pLocal;
+    Normal3 pNorm = Normal3(pLocal).normalized();
     return Interaction{ pObj, pNorm };
 }
 
@@ -153,16 +168,16 @@ Interaction Sphere::sample(const Interaction& isect,
     double cosAlpha = (dc * dc + radius_ * radius_ - ds * ds) / (2.0 * dc * radius_);
     double sinAlpha = sqrt(std::max(0.0, 1.0 - cosAlpha * cosAlpha));
 
-    Vector3d sw = vect::normalize(isect.pos() - center_);
-    Vector3d su, sv;
+    Vector3 sw = vect::normalize(isect.pos() - center_);
+    Vector3 su, sv;
     vect::coordinateSystem(sw, &su, & sv);
-    Vector3d nObj = su * cos(phi) * cosAlpha + sv * sin(phi) * cosAlpha + sw * sinAlpha;
-    Vector3d pObj = center_ + radius_ * nObj;
+    Vector3 nObj = su * cos(phi) * cosAlpha + sv * sin(phi) * cosAlpha + sw * sinAlpha;
+    Vector3 pObj = center_ + radius_ * nObj;
 
-    return Interaction{ Point3d(pObj), Normal3d(nObj) };
+    return Interaction{ Point3(pObj), Normal3(nObj) };
 }
 
-double Sphere::pdf(const Interaction& pObj, const Vector3d& wi) const {
+double Sphere::pdf(const Interaction& pObj, const Vector3& wi) const {
     // TODO: For sphere (because it's a closed geometry),
     //       the case where the intersection is inside the sphere
     //       should be considered.
@@ -173,9 +188,9 @@ double Sphere::pdf(const Interaction& pObj, const Vector3d& wi) const {
     return 1.0 / (2.0 * PI * (1.0 - cosTheta));
 }
 
-Bounds3d Sphere::objectBound() const {
-    const Point3d posMin = center_ - Vector3d(radius_, radius_, radius_);
-    const Point3d posMax = center_ + Vector3d(radius_, radius_, radius_);
+Bounds3 Sphere::objectBound() const {
+    const Point3 posMin = center_ - Vector3(radius_, radius_, radius_);
+    const Point3 posMax = center_ + Vector3(radius_, radius_, radius_);
     return { posMin, posMax };
 }
 
@@ -185,7 +200,7 @@ double Sphere::area() const {
 
 std::vector<Triangle> Sphere::triangulate() const {
     const double phi = (1.0 + std::sqrt(5.0)) * 0.5;
-    std::vector<Point3d> points;
+    std::vector<Point3> points;
     points.emplace_back(0.0, -1.0, -phi);
     points.emplace_back(0.0,  1.0, -phi);
     points.emplace_back(0.0, -1.0,  phi);
@@ -231,12 +246,12 @@ std::vector<Triangle> Sphere::triangulate() const {
     for (int i = 0; i < maxDepth; i++) {
         std::vector<Triangle> temp;
         for (const auto& t : tris) {
-            Point3d p0 = t[0];
-            Point3d p1 = t[1];
-            Point3d p2 = t[2];
-            Point3d p01 = vect::normalize(0.5 * (p0 + p1));
-            Point3d p12 = vect::normalize(0.5 * (p1 + p2));
-            Point3d p20 = vect::normalize(0.5 * (p2 + p0));
+            Point3 p0 = t[0];
+            Point3 p1 = t[1];
+            Point3 p2 = t[2];
+            Point3 p01 = vect::normalize(0.5 * (p0 + p1));
+            Point3 p12 = vect::normalize(0.5 * (p1 + p2));
+            Point3 p20 = vect::normalize(0.5 * (p2 + p0));
             temp.emplace_back(p0, p01, p20);
             temp.emplace_back(p1, p12, p01);
             temp.emplace_back(p2, p20, p12);
@@ -247,12 +262,12 @@ std::vector<Triangle> Sphere::triangulate() const {
 
     std::vector<Triangle> ret;
     for (const auto& t : tris) {
-        Point3d p0 = t[0] * radius_ + center_;
-        Point3d p1 = t[1] * radius_ + center_;
-        Point3d p2 = t[2] * radius_ + center_;
-        Normal3d n0(t[0]);
-        Normal3d n1(t[1]);
-        Normal3d n2(t[2]);
+        Point3 p0 = t[0] * radius_ + center_;
+        Point3 p1 = t[1] * radius_ + center_;
+        Point3 p2 = t[2] * radius_ + center_;
+        Normal3 n0(t[0]);
+        Normal3 n1(t[1]);
+        Normal3 n2(t[2]);
         ret.emplace_back(p0, p1, p2, n0, n1, n2);
     }
 
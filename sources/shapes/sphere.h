@@ -18,7 +18,7 @@ namespace spica {
 class SPICA_EXPORTS Sphere : public Shape {
 public:
     Sphere();
-    Sphere(const Point3d& center, double radius,
+    Sphere(const Point3& center, double radius,
            const Transform& objectToWorld = Transform());
     Sphere(const Sphere& sphere);
     ~Sphere();
@@ -28,24 +28,29 @@ public:
     bool intersect(const Ray& ray, double* tHit,
                    SurfaceInteraction* isect) const override;
     bool intersect(const Ray& ray) const override;
+    bool hitTest(const Ray& ray, double* tHit,
+                 double* b1, double* b2) const override;
+    void computeSurfaceInteraction(const Ray& ray, double tHit,
+                                   double b1, double b2,
+                                   SurfaceInteraction* isect) const override;
 
     Interaction sample(const Point2d& rands) const override;
     Interaction sample(const Interaction& isect,
                        const Point2d& rands) const override;
 
-    double pdf(const Interaction& pObj, const Vector3d& wi) const override;
+    double pdf(const Interaction& pObj, const Vector3& wi) const override;
 
-    Bounds3d objectBound() const override;
+    Bounds3 objectBound() const override;
 
     double area() const override;
 
     std::vector<Triangle> triangulate() const override;
 
-    inline Point3d  center() const { return center_; }
+    inline Point3  center() const { return center_; }
     inline double radius() const { return radius_; }
 
 private:
-    Point3d  center_ = { 0.0, 0.0, 0.0 };
+    Point3  center_ = { 0.0, 0.0, 0.0 };
     double radius_ = 0.0;
 
 };  // class Sphere
@@ -22,9 +22,11 @@
 #include "core/shape.h"
 #include "core/bsphere.h"
 #include "core/triangle.h"
+#include "core/trimesh.h"
 #include "core/primitive.h"
 #include "core/random.h"
 #include "core/accelerator.h"
+#include "core/raybatch.h"
 
 #include "core/bsdf.h"
 #include "core/bxdf.h"
@@ -17,12 +17,29 @@ std::string remove_extension(const std::string &path) {
     return path.substr(0, p);
 }
 
+/**
+ * Parse the duration such as "90", "90s", "30m" or "2h" to seconds.
+ */
+double parse_duration(const std::string &str) {
+    size_t pos = 0;
+    const double value = std::stod(str, &pos);
+    const std::string unit = str.substr(pos);
+    if (unit == "" || unit == "s") return value;
+    if (unit == "m") return value * 60.0;
+    if (unit == "h") return value * 3600.0;
+    throw std::runtime_error("Unknown unit of duration: " + str);
+}
+
 int main(int argc, char** argv) {
     ArgumentParser parser;
     try {
         parser.addArgument("-i", "--input", "", true);
         parser.addArgument("-t", "--threads", "4");
         parser.addArgument("-o", "--output", "");
+        parser.addArgument("-c", "--checkpoint", "0");
+        parser.addArgument("-r", "--resume", "false");
+        parser.addArgument("-T", "--time", "0");
+        parser.addArgument("-e", "--error", "0");
         if (!parser.parse(argc, argv)) {
             std::cout << parser.helpText() << std::endl;
         }
@@ -46,6 +63,16 @@ int main(int argc, char** argv) {
     RenderParams &params = RenderParams::getInstance();
     params.add("numUserThreads", nThreads);
     params.add("outputFile", outfile);
+    params.add("checkpointFile", outfile + ".ckpt");
+    params.add("checkpointInterval", parser.getDouble("checkpoint"));
+    try {
+        params.add("resume", parser.getBool("resume"));
+        params.add("timeBudget", parse_duration(parser.getString("time")));
+    } catch (std::exception &e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    params.add("targetError", parser.getDouble("error"));
 
 //    KillTimer timer(0, 4, 30);
 //    timer.start();
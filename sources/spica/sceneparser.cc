@@ -15,6 +15,8 @@
 #include "core/integrator.h"
 #include "core/primitive.h"
 #include "core/meshio.h"
+#include "core/triangle.h"
+#include "core/trimesh.h"
 #include "core/transform.h"
 
 using namespace tinyxml2;
@@ -78,11 +80,11 @@ void SceneParser::parse() {
     }
 
     const XMLElement *root = doc.RootElement();
-    Assertion(std::strcmp(root->Name(), "scene") == 0, "XML root node should be \"scene\"!");
+    SPICA_CHECK(std::strcmp(root->Name(), "scene") == 0, "XML root node should be \"scene\"!");
     printf("Version: %s\n", root->Attribute("version"));
 
     parseChildren(root);
-    Assertion(camera_ != nullptr, "Sensor is not specified!");
+    SPICA_CHECK(camera_ != nullptr, "Sensor is not specified!");
 
     const std::string integType = params_.getString("integrator");
     plugins_.initModule(integType);
@@ -126,7 +128,7 @@ Transform SceneParser::parseTransform(const XMLElement *parent) {
         if (std::strcmp(elem->Name(), "matrix") == 0) {
             const std::string values = std::string(getAttribute(elem, "value"));
             auto valueList = split(values, " ");
-            Assertion(valueList.size() == 16, "# of matrix values is not 16!");
+            SPICA_CHECK(valueList.size() == 16, "# of matrix values is not 16!");
 
             double m[4][4];
             for (int i = 0; i < 4; i++) {
@@ -145,17 +147,17 @@ Transform SceneParser::parseTransform(const XMLElement *parent) {
             const double y = str2double(getAttribute(elem, "y"));
             const double z = str2double(getAttribute(elem, "z"));
             const double angle = str2double(getAttribute(elem, "angle"));
-            sub = Transform::rotate(angle, Vector3d(x, y, z));
+            sub = Transform::rotate(angle, Vector3(x, y, z));
         } else if (std::strcmp(elem->Name(), "translate") == 0) {
             const double x = str2double(getAttribute(elem, "x"));
             const double y = str2double(getAttribute(elem, "y"));
             const double z = str2double(getAttribute(elem, "z"));
-            sub = Transform::translate(Vector3d(x, y, z));
+            sub = Transform::translate(Vector3(x, y, z));
         } else if (std::strcmp(elem->Name(), "lookAt") == 0) {
-            const Vector3d origin = Vector3d(getAttribute(elem, "origin"));
-            const Vector3d target = Vector3d(getAttribute(elem, "target"));
-            const Vector3d up = Vector3d(getAttribute(elem, "up"));
-            sub = Transform::lookAt(Point3d(origin), Point3d(target), up);
+            const Vector3 origin = Vector3(getAttribute(elem, "origin"));
+            const Vector3 target = Vector3(getAttribute(elem, "target"));
+            const Vector3 up = Vector3(getAttribute(elem, "up"));
+            sub = Transform::lookAt(Point3(origin), Point3(target), up);
         }
         trans = sub * trans;
 
@@ -187,6 +189,29 @@ std::shared_ptr<Primitive> SceneParser::createPrimitive(const std::shared_ptr<Sh
     return std::make_shared<GeometricPrimitive>(shape, material, light, mi);
 }
 
+void SceneParser::addMeshPrimitives(const std::shared_ptr<TriangleMesh> &mesh,
+                                    const Transform &transform,
+                                    const std::shared_ptr<Material> &material,
+                                    const std::shared_ptr<Medium> &medium) {
+    if (waitAreaLight_) {
+        // Area lights need a shape for each face to sample it.
+        for (int i = 0; i < mesh->numFaces(); i++) {
+            auto tri = std::make_shared<Triangle>(mesh->triangle(i));
+            primitives_.push_back(createPrimitive(tri, transform, material, medium));
+        }
+        return;
+    }
+
+    std::shared_ptr<MediumInterface> mi = nullptr;
+    if (medium) {
+        mediums_.push_back(medium);
+        mi = std::make_shared<MediumInterface>(medium.get(), nullptr);
+    }
+
+    auto prims = MeshTriangle::createPrimitives(mesh, material, mi);
+    primitives_.insert(primitives_.end(), prims.begin(), prims.end());
+}
+
 void SceneParser::storeToParam(const XMLElement *elem) {
     const std::string nodeName = elem->Name();
     if (nodeName == "#comment") return;
@@ -223,7 +248,7 @@ void SceneParser::storeToParam(const XMLElement *elem) {
             params_.add(name, value);
         }
     } else if (nodeName == "rgb") {
-        Vector3d v(getAttribute(elem, "value"));
+        Vector3 v(getAttribute(elem, "value"));
         Spectrum value(v.x(), v.y(), v.z());
         if (name != "") {
             params_.add(name, value);
@@ -263,17 +288,13 @@ void SceneParser::storeToParam(const XMLElement *elem) {
             const std::string filename = params_.getString("filename");
             std::vector<ShapeGroup> groups = meshio::loadOBJ(filename, transform);
             for (const auto &g : groups) {
-                for (const auto &s : g.shapes()) {
-                    primitives_.push_back(createPrimitive(s, transform, material, medium));
-                }
+                addMeshPrimitives(g.mesh(), transform, material, medium);
             }
         } else if (type == "ply") {
             const std::string filename = params_.getString("filename");
             std::vector<ShapeGroup> groups = meshio::loadPLY(filename, transform);
             for (const auto &g : groups) {
-                for (const auto &s : g.shapes()) {
-                    primitives_.push_back(createPrimitive(s, transform, material, medium));
-                }
+                addMeshPrimitives(g.mesh(), transform, material, medium);
             }
         } else {
             plugins_.initModule(type);
@@ -297,7 +318,7 @@ void SceneParser::storeToParam(const XMLElement *elem) {
         }
     } else if (nodeName == "integrator") {
         std::string type = elem->Attribute("type");
-        Assertion(type != "", "Integrator type is not specified!");
+        SPICA_CHECK(type != "", "Integrator type is not specified!");
         params_.add("integrator", type);
     } else {
         std::string type = elem->Attribute("type");
@@ -306,7 +327,7 @@ void SceneParser::storeToParam(const XMLElement *elem) {
             return;
         }
 
-        Assertion(type != "", "Type parameter is not specified for \"%s\"", nodeName.c_str());
+        SPICA_CHECK(type != "", "Type parameter is not specified for \"%s\"", nodeName.c_str());
 
         plugins_.initModule(type);
         auto value = std::shared_ptr<CObject>(plugins_.createObject(type, params_));
@@ -326,7 +347,7 @@ void SceneParser::storeToParam(const XMLElement *elem) {
         }
 
         if (nodeName == "sensor") {
-            Assertion(!camera_, "Multiple cameras are specified!");
+            SPICA_CHECK(!camera_, "Multiple cameras are specified!");
             camera_ = std::static_pointer_cast<Camera>(value);
         } else if (nodeName == "emitter") {
             lights_.push_back(std::static_pointer_cast<Light>(value));
@@ -29,6 +29,10 @@ private:
                                                const Transform &transform,
                                                const std::shared_ptr<Material> &material,
                                                const std::shared_ptr<Medium> &medium);
+    void addMeshPrimitives(const std::shared_ptr<TriangleMesh> &mesh,
+                           const Transform &transform,
+                           const std::shared_ptr<Material> &material,
+                           const std::shared_ptr<Medium> &medium);
 
     void storeToParam(const tinyxml2::XMLElement *node);
 
@@ -0,0 +1,280 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "spica.h"
+using namespace spica;
+
+// -----------------------------------------------------------------------------
+// BVH Value-parameterized Tests
+// -----------------------------------------------------------------------------
+
+struct BVHVariant {
+    std::string name;
+    bool useSIMD;
+    bool useLinearBVH;
+    int maxPrimsInNode;
+    std::string builder;
+    int simdWidth;
+};
+
+void PrintTo(const BVHVariant& v, std::ostream* os) {
+    *os << v.name;
+}
+
+class BVHTest : public ::testing::TestWithParam<BVHVariant> {
+protected:
+    BVHTest() {}
+    virtual ~BVHTest() {}
+
+    virtual void SetUp() {
+        // Triangle soup of a mesh, whose leaves are tested four triangles at
+        // a time, and of standalone triangles tested one by one.
+        Random rng(31);
+        std::vector<Point3> positions;
+        std::vector<int> indices;
+        for (int i = 0; i < kNumTriangles; i++) {
+            const Point3 c = randomPoint(rng, 0.0, 10.0);
+            for (int k = 0; k < 3; k++) {
+                positions.push_back(c + randomVector(rng));
+                indices.push_back(i * 3 + k);
+            }
+        }
+        auto mesh = std::make_shared<TriangleMesh>(positions, indices);
+        prims = MeshTriangle::createPrimitives(mesh, nullptr);
+
+        for (int i = 0; i < kNumTriangles / 4; i++) {
+            const Point3 c = randomPoint(rng, 0.0, 10.0);
+            auto tri = std::make_shared<Triangle>(c + randomVector(rng),
+                                                  c + randomVector(rng),
+                                                  c + randomVector(rng));
+            prims.emplace_back(new GeometricPrimitive(tri, nullptr, nullptr));
+        }
+
+        // Rays from inside and outside of the soup. Some of them are
+        // shortened so that the hits behind "maxDist" must be ignored.
+        for (int i = 0; i < kNumRays; i++) {
+            const Point3 org = randomPoint(rng, -2.0, 12.0);
+            const Vector3 dir = randomVector(rng).normalized();
+            const double maxDist = i % 4 == 0 ? 3.0 * rng.get1D() : INFTY;
+            rays.emplace_back(org, dir, maxDist);
+        }
+
+        const BVHVariant& v = GetParam();
+        RenderParams& params = RenderParams::getInstance();
+        params.clear();
+        params.add("useSIMD", v.useSIMD);
+        params.add("useLinearBVH", v.useLinearBVH);
+        params.add("maxPrimsInNode", v.maxPrimsInNode);
+        params.add("bvhBuilder", v.builder);
+        params.add("simdWidth", v.simdWidth);
+
+        // The statistics of the tree are only reported to the log.
+        PluginManager& plugins = PluginManager::getInstance();
+        plugins.initAccelerator("bvh");
+        ::testing::internal::CaptureStdout();
+        accel = std::shared_ptr<Accelerator>(plugins.createAccelerator("bvh", prims, params));
+        buildLog = ::testing::internal::GetCapturedStdout();
+    }
+
+    //! Number of the leaves for each number of primitives in the build log.
+    std::map<int, int> leafHistogram() const {
+        std::map<int, int> histogram;
+        std::istringstream iss(buildLog);
+        std::string line;
+        while (std::getline(iss, line)) {
+            int nPrims, nLeaves;
+            if (std::sscanf(line.c_str(), "[INFO] BVH:   leaves with %d prims: %d",
+                            &nPrims, &nLeaves) == 2) {
+                histogram[nPrims] = nLeaves;
+            }
+        }
+        return histogram;
+    }
+
+    static Point3 randomPoint(Random& rng, double lo, double hi) {
+        return Point3(lo + (hi - lo) * rng.get1D(),
+                      lo + (hi - lo) * rng.get1D(),
+                      lo + (hi - lo) * rng.get1D());
+    }
+
+    static Vector3 randomVector(Random& rng) {
+        return Vector3(2.0 * rng.get1D() - 1.0,
+                       2.0 * rng.get1D() - 1.0,
+                       2.0 * rng.get1D() - 1.0);
+    }
+
+    //! Closest hit found by testing all the primitives.
+    bool bruteForce(Ray ray, HitRecord* hit) const {
+        bool isHit = false;
+        for (const auto& p : prims) {
+            if (p->hitTest(ray, hit)) isHit = true;
+        }
+        return isHit;
+    }
+
+    static constexpr int kNumTriangles = 2000;
+    static constexpr int kNumRays = 2000;
+    static constexpr int kBatchSize = 67;
+
+    std::vector<std::shared_ptr<Primitive>> prims;
+    std::vector<Ray> rays;
+    std::shared_ptr<Accelerator> accel;
+    std::string buildLog;
+};
+
+TEST_P(BVHTest, HitTest) {
+    int numHits = 0;
+    for (const Ray& r : rays) {
+        HitRecord expected;
+        const bool isHit = bruteForce(r, &expected);
+        numHits += isHit ? 1 : 0;
+
+        Ray ray = r;
+        HitRecord hit;
+        ASSERT_EQ(isHit, accel->hitTest(ray, &hit));
+        if (isHit) {
+            EXPECT_EQ(expected.primitive, hit.primitive);
+            // Mesh triangles in leaves are tested in single precision.
+            EXPECT_NEAR(expected.t, hit.t, 1.0e-4);
+            EXPECT_EQ(hit.t, ray.maxDist());
+        }
+    }
+
+    // Both hits and misses should be tested.
+    EXPECT_GT(numHits, kNumRays / 4);
+    EXPECT_LT(numHits, kNumRays);
+}
+
+TEST_P(BVHTest, Intersect) {
+    for (const Ray& r : rays) {
+        HitRecord expected;
+        const bool isHit = bruteForce(r, &expected);
+
+        Ray ray = r;
+        SurfaceInteraction isect;
+        ASSERT_EQ(isHit, accel->intersect(ray, &isect));
+        if (isHit) {
+            EXPECT_EQ(expected.primitive, isect.primitive());
+            EXPECT_LT((r.proceeded(expected.t) - isect.pos()).norm(), 1.0e-3);
+        }
+    }
+}
+
+TEST_P(BVHTest, Shadow) {
+    for (const Ray& r : rays) {
+        HitRecord expected;
+        const bool isHit = bruteForce(r, &expected);
+
+        Ray ray = r;
+        EXPECT_EQ(isHit, accel->intersect(ray));
+    }
+}
+
+TEST_P(BVHTest, BatchIntersect) {
+    // The batches are not multiples of four rays, so each ends with a
+    // partial packet.
+    for (int start = 0; start < kNumRays; start += kBatchSize) {
+        const int end = std::min(start + kBatchSize, kNumRays);
+        RayBatch batch(end - start);
+        for (int i = start; i < end; i++) {
+            batch.push(rays[i]);
+        }
+        HitBatch hits;
+        accel->intersect(batch, hits);
+        ASSERT_EQ(batch.size(), hits.size());
+
+        for (int i = start; i < end; i++) {
+            HitRecord expected;
+            const bool isHit = bruteForce(rays[i], &expected);
+
+            Ray ray = rays[i];
+            HitRecord single;
+            ASSERT_EQ(accel->hitTest(ray, &single), hits.isHit(i - start));
+            ASSERT_EQ(isHit, hits.isHit(i - start));
+            if (isHit) {
+                const HitRecord& hit = hits[i - start];
+                EXPECT_EQ(expected.primitive, hit.primitive);
+                EXPECT_EQ(single.primitive, hit.primitive);
+                EXPECT_NEAR(expected.t, hit.t, 1.0e-4);
+                EXPECT_EQ(hit.t, batch[i - start].maxDist());
+            } else {
+                EXPECT_EQ(rays[i].maxDist(), batch[i - start].maxDist());
+            }
+        }
+    }
+}
+
+TEST_P(BVHTest, BatchOccluded) {
+    for (int start = 0; start < kNumRays; start += kBatchSize) {
+        const int end = std::min(start + kBatchSize, kNumRays);
+        RayBatch batch(end - start);
+        for (int i = start; i < end; i++) {
+            batch.push(rays[i]);
+        }
+        bool occluded[kBatchSize];
+        accel->occluded(batch, occluded);
+
+        for (int i = start; i < end; i++) {
+            HitRecord expected;
+            const bool isHit = bruteForce(rays[i], &expected);
+
+            Ray ray = rays[i];
+            ASSERT_EQ(accel->intersect(ray), occluded[i - start]);
+            ASSERT_EQ(isHit, occluded[i - start]);
+        }
+    }
+}
+
+TEST_P(BVHTest, LeafSizes) {
+    const int maxPrimsInNode = GetParam().maxPrimsInNode;
+    const std::map<int, int> histogram = leafHistogram();
+    ASSERT_FALSE(histogram.empty());
+
+    int nPrims = 0;
+    int nPacked = 0;
+    for (const auto& h : histogram) {
+        EXPECT_GE(h.first, 1);
+        EXPECT_LE(h.first, maxPrimsInNode);
+        nPrims += h.first * h.second;
+        if (h.first > 1) nPacked += h.first * h.second;
+    }
+    EXPECT_EQ(static_cast<int>(prims.size()), nPrims);
+
+    // Both of the builders fill the leaves up to "maxPrimsInNode", so that
+    // the triangles of a leaf are tested four at a time.
+    if (maxPrimsInNode > 1) {
+        EXPECT_GT(nPacked, nPrims / 2);
+        EXPECT_GT(histogram.count(maxPrimsInNode), 0u);
+    }
+}
+
+TEST_P(BVHTest, WorldBound) {
+    Bounds3 bounds;
+    for (const auto& p : prims) {
+        bounds.merge(p->worldBound());
+    }
+    EXPECT_EQ(bounds.posMin(), accel->worldBound().posMin());
+    EXPECT_EQ(bounds.posMax(), accel->worldBound().posMax());
+}
+
+std::vector<BVHVariant> bvhVariants = {
+    { "Binary",         false, false, 4, "sah",   4 },
+    { "BinarySingle",   false, false, 1, "sah",   4 },
+    { "Linear",         false, true,  4, "sah",   4 },
+    { "HLBVH",          false, false, 4, "hlbvh", 4 },
+    { "LinearHLBVH",    false, true,  4, "hlbvh", 4 },
+    { "QBVH",           true,  false, 4, "sah",   4 },
+    { "QBVHSingle",     true,  false, 1, "sah",   4 },
+    { "QBVHHLBVH",      true,  false, 4, "hlbvh", 4 },
+    { "OBVH",           true,  false, 4, "sah",   8 },
+    { "OBVHHLBVH",      true,  false, 4, "hlbvh", 8 },
+};
+
+INSTANTIATE_TEST_CASE_P(, BVHTest, ::testing::ValuesIn(bvhVariants));
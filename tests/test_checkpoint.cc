@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "spica.h"
+#include "core/checkpoint.h"
+#include "test_params.h"
+using namespace spica;
+
+#include <experimental/filesystem>
+
+namespace fs = std::experimental::filesystem;
+
+namespace {
+
+const std::string ckptpath = TEMP_DIRECTORY + "test_checkpoint.ckpt";
+
+//! Sampler which draws the numbers of its random number generator.
+class RandomSampler : public Sampler {
+public:
+    explicit RandomSampler(uint32_t seed) : random_{ seed } {}
+
+    double get1D() override { return random_.get1D(); }
+
+    std::unique_ptr<Sampler> clone(uint32_t seed = 0) const override {
+        return std::make_unique<RandomSampler>(seed);
+    }
+
+    void saveState(CheckpointWriter &writer) const override { random_.saveState(writer); }
+    void loadState(CheckpointReader &reader) override { random_.loadState(reader); }
+
+private:
+    Random random_;
+};
+
+}  // anonymous namespace
+
+// -----------------------------------------------------------------------------
+// Checkpoint Tests
+// -----------------------------------------------------------------------------
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() {
+        fs::create_directory(fs::path(TEMP_DIRECTORY));
+        fs::remove(fs::path(ckptpath));
+        fs::remove(fs::path(ckptpath + ".tmp"));
+    }
+
+    void TearDown() {
+        fs::remove(fs::path(ckptpath));
+        fs::remove(fs::path(ckptpath + ".tmp"));
+        // The directory is left if the other tests still have files in it.
+        std::error_code ec;
+        fs::remove(fs::path(TEMP_DIRECTORY), ec);
+    }
+};
+
+TEST_F(CheckpointTest, RoundTrip) {
+    const std::vector<double> values = { 0.5, 1.0, 2.0 };
+    {
+        CheckpointWriter writer(ckptpath, "Test");
+        writer.write(42);
+        writer.write(values.data(), values.size());
+        writer.commit();
+    }
+    EXPECT_TRUE(fs::exists(fs::path(ckptpath)));
+    EXPECT_FALSE(fs::exists(fs::path(ckptpath + ".tmp")));
+
+    CheckpointReader reader(ckptpath, "Test");
+    ASSERT_TRUE(reader.valid());
+    int i;
+    std::vector<double> read(values.size());
+    reader.read(&i);
+    reader.read(read.data(), read.size());
+    EXPECT_EQ(42, i);
+    EXPECT_EQ(values, read);
+
+    // Reading past the values fails.
+    ASSERT_THROW(reader.read(&i), RuntimeException);
+}
+
+TEST_F(CheckpointTest, CommitReplacesPrevious) {
+    {
+        CheckpointWriter writer(ckptpath, "Test");
+        writer.write(1);
+        writer.commit();
+    }
+
+    // The previous checkpoint survives until the next one is committed.
+    auto writer = std::make_unique<CheckpointWriter>(ckptpath, "Test");
+    writer->write(2);
+    EXPECT_TRUE(fs::exists(fs::path(ckptpath + ".tmp")));
+    {
+        CheckpointReader reader(ckptpath, "Test");
+        ASSERT_TRUE(reader.valid());
+        int i;
+        reader.read(&i);
+        EXPECT_EQ(1, i);
+    }
+
+    writer->commit();
+    EXPECT_FALSE(fs::exists(fs::path(ckptpath + ".tmp")));
+    {
+        CheckpointReader reader(ckptpath, "Test");
+        ASSERT_TRUE(reader.valid());
+        int i;
+        reader.read(&i);
+        EXPECT_EQ(2, i);
+    }
+}
+
+TEST_F(CheckpointTest, TagMismatch) {
+    EXPECT_FALSE(CheckpointReader(ckptpath, "Test").valid());
+
+    CheckpointWriter writer(ckptpath, "Test");
+    writer.write(1);
+    writer.commit();
+
+    EXPECT_TRUE(CheckpointReader(ckptpath, "Test").valid());
+    EXPECT_FALSE(CheckpointReader(ckptpath, "Other").valid());
+    EXPECT_FALSE(CheckpointReader(ckptpath, "Tes").valid());
+}
+
+TEST_F(CheckpointTest, RandomContinuesSequence) {
+    Random random(7);
+    for (int i = 0; i < 1000; i++) random.get1D();
+    {
+        CheckpointWriter writer(ckptpath, "Test");
+        random.saveState(writer);
+        writer.commit();
+    }
+
+    Random resumed(0);
+    CheckpointReader reader(ckptpath, "Test");
+    ASSERT_TRUE(reader.valid());
+    resumed.loadState(reader);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(random.get1D(), resumed.get1D());
+    }
+}
+
+TEST_F(CheckpointTest, Samplers) {
+    std::vector<std::unique_ptr<Sampler>> samplers;
+    for (int t = 0; t < 2; t++) {
+        samplers.push_back(std::make_unique<RandomSampler>(t + 1));
+        samplers[t]->get1D();
+    }
+    {
+        CheckpointWriter writer(ckptpath, "Test");
+        saveSamplers(writer, samplers);
+        writer.commit();
+    }
+
+    const RandomSampler sampler(0);
+    {
+        std::vector<std::unique_ptr<Sampler>> resumed(2);
+        CheckpointReader reader(ckptpath, "Test");
+        ASSERT_TRUE(loadSamplers(reader, sampler, &resumed));
+        for (int t = 0; t < 2; t++) {
+            ASSERT_NE(nullptr, resumed[t]);
+            EXPECT_EQ(samplers[t]->get1D(), resumed[t]->get1D());
+        }
+    }
+
+    // The samplers of another number of threads are not resumed.
+    {
+        std::vector<std::unique_ptr<Sampler>> resumed(3);
+        CheckpointReader reader(ckptpath, "Test");
+        EXPECT_FALSE(loadSamplers(reader, sampler, &resumed));
+        EXPECT_EQ(nullptr, resumed[0]);
+    }
+}
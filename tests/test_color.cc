@@ -135,6 +135,19 @@ TEST_P(SpectrumTestWithParam, ComponentWiseMultiplication) {
     EXPECT_EQ(c1.blue() * c2.blue(), c3.blue());
 }
 
+TEST_P(SpectrumTestWithParam, FusedMultiplyAdd) {
+    const Spectrum c3 = Spectrum::fma(c1, c2, c1);
+    EXPECT_DOUBLE_EQ(c1.red() * c2.red() + c1.red(), c3.red());
+    EXPECT_DOUBLE_EQ(c1.green() * c2.green() + c1.green(), c3.green());
+    EXPECT_DOUBLE_EQ(c1.blue() * c2.blue() + c1.blue(), c3.blue());
+
+    const double d = c2.red();
+    const Spectrum c4 = Spectrum::fma(c1, d, c2);
+    EXPECT_DOUBLE_EQ(c1.red() * d + c2.red(), c4.red());
+    EXPECT_DOUBLE_EQ(c1.green() * d + c2.green(), c4.green());
+    EXPECT_DOUBLE_EQ(c1.blue() * d + c2.blue(), c4.blue());
+}
+
 TEST_P(SpectrumTestWithParam, Division) {
     const double d = c2.red();
     if (d != 0.0) {
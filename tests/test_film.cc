@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "spica.h"
+#include "core/checkpoint.h"
+#include "test_params.h"
+#include "test_film_helper.h"
+using namespace spica;
+
+#include <experimental/filesystem>
+
+namespace fs = std::experimental::filesystem;
+
+namespace {
+
+const std::string accumpath = TEMP_DIRECTORY + "test_film.accum";
+const std::string ckptpath  = TEMP_DIRECTORY + "test_film.ckpt";
+
+}  // anonymous namespace
+
+// -----------------------------------------------------------------------------
+// Film Tests
+// -----------------------------------------------------------------------------
+
+TEST(FilmTest, CloseWritesSavedImage) {
+    CaptureFilm film(Point2i(4, 4));
+    film.save(1);
+    film.close();
+    ASSERT_EQ(1u, film.saved().size());
+    EXPECT_EQ("image001", film.saved()[0]);
+
+    // Saving after "close" starts a new writer.
+    film.save(2);
+    film.close();
+    ASSERT_EQ(2u, film.saved().size());
+    EXPECT_EQ("image002", film.saved()[1]);
+}
+
+class FilmFileTest : public ::testing::Test {
+protected:
+    void SetUp() {
+        fs::create_directory(fs::path(TEMP_DIRECTORY));
+    }
+
+    void TearDown() {
+        fs::remove(fs::path(accumpath));
+        fs::remove(fs::path(ckptpath));
+        fs::remove(fs::path(ckptpath + ".tmp"));
+        // The directory is left if the other tests still have files in it.
+        std::error_code ec;
+        fs::remove(fs::path(TEMP_DIRECTORY), ec);
+    }
+};
+
+TEST_F(FilmFileTest, AccumulationFileIsResumedByItsCheckpoint) {
+    const Point2i pixel(1, 2);
+    {
+        CaptureFilm film(Point2i(4, 4));
+        film.setAccumulationFile(accumpath);
+        film.beginPass(0);
+        film.addPixel(pixel, Point2d(0.5, 0.5), Spectrum(1.0));
+        film.endPass(1);
+
+        CheckpointWriter writer(ckptpath, "FilmTest");
+        film.saveState(writer);
+        writer.commit();
+    }
+
+    {
+        CaptureFilm film(Point2i(4, 4));
+        film.setAccumulationFile(accumpath, true);
+        EXPECT_EQ(1, film.samples(pixel));
+
+        CheckpointReader reader(ckptpath, "FilmTest");
+        ASSERT_TRUE(reader.valid());
+        film.loadState(reader);
+
+        // The pass after the checkpoint is interrupted.
+        ASSERT_THROW(film.beginPass(0), RuntimeException);
+        film.beginPass(1);
+        film.addPixel(pixel, Point2d(0.5, 0.5), Spectrum(1.0));
+    }
+
+    {
+        // The samples of the interrupted pass must not be resumed.
+        CaptureFilm film(Point2i(4, 4));
+        film.setAccumulationFile(accumpath, true);
+        CheckpointReader reader(ckptpath, "FilmTest");
+        ASSERT_TRUE(reader.valid());
+        ASSERT_THROW(film.loadState(reader), RuntimeException);
+    }
+
+    {
+        // Without resuming, the file is truncated.
+        CaptureFilm film(Point2i(4, 4));
+        film.setAccumulationFile(accumpath);
+        EXPECT_EQ(0, film.samples(pixel));
+        film.beginPass(0);
+    }
+}
+
+TEST(FilmTest, RelativeErrorOfMergedTiles) {
+    // Luminance of the samples of pixel (1, 1), added by two tiles
+    const std::vector<double> lums = { 0.2, 0.5, 0.9, 0.4, 0.7, 0.1, 0.6 };
+    const int split = 3;
+
+    CaptureFilm film(Point2i(4, 4));
+    EXPECT_EQ(INFTY, film.relativeError(Point2i(1, 1)));
+    film.enableVariance();
+
+    const Bounds2i bounds(0, 0, 2, 2);
+    auto tile0 = film.filmTile();
+    auto tile1 = film.filmTile();
+    tile0->reset(bounds);
+    tile1->reset(bounds);
+    for (int i = 0; i < static_cast<int>(lums.size()); i++) {
+        FilmTile &tile = i < split ? *tile0 : *tile1;
+        tile.addPixel(Point2i(1, 1), Point2d(0.5, 0.5), Spectrum(lums[i]));
+    }
+    tile0->addPixel(Point2i(0, 0), Point2d(0.5, 0.5), Spectrum(1.0));
+    film.mergeFilmTile(*tile0);
+    film.mergeFilmTile(*tile1);
+
+    // Two-pass estimate of the standard error of the mean
+    const double n = static_cast<double>(lums.size());
+    double mean = 0.0;
+    for (double l : lums) mean += l / n;
+    double m2 = 0.0;
+    for (double l : lums) m2 += (l - mean) * (l - mean);
+    const double stdError = std::sqrt(m2 / ((n - 1.0) * n));
+
+    EXPECT_EQ(static_cast<int>(lums.size()), film.samples(Point2i(1, 1)));
+    EXPECT_NEAR(stdError / mean, film.relativeError(Point2i(1, 1)), 1.0e-12);
+
+    // One sample has no error estimate.
+    EXPECT_EQ(INFTY, film.relativeError(Point2i(0, 0)));
+
+    // Samples added to the film directly are combined as well.
+    film.addPixel(Point2i(1, 1), Point2d(0.5, 0.5), Spectrum(0.3));
+    film.addPixel(Point2i(1, 1), Point2d(0.5, 0.5), Spectrum(0.8));
+    std::vector<double> all = lums;
+    all.push_back(0.3);
+    all.push_back(0.8);
+    const double na = static_cast<double>(all.size());
+    double meanAll = 0.0;
+    for (double l : all) meanAll += l / na;
+    double m2All = 0.0;
+    for (double l : all) m2All += (l - meanAll) * (l - meanAll);
+    EXPECT_NEAR(std::sqrt(m2All / ((na - 1.0) * na)) / meanAll,
+                film.relativeError(Point2i(1, 1)), 1.0e-12);
+}
+
+TEST(FilmTest, RelativeErrorOfBlackPixel) {
+    // The error of an almost black pixel is relative to a small floor.
+    CaptureFilm film(Point2i(2, 2));
+    film.enableVariance();
+    film.addPixel(Point2i(0, 0), Point2d(0.5, 0.5), Spectrum(0.0));
+    film.addPixel(Point2i(0, 0), Point2d(0.5, 0.5), Spectrum(0.0));
+    EXPECT_EQ(0.0, film.relativeError(Point2i(0, 0)));
+
+    film.addPixel(Point2i(1, 0), Point2d(0.5, 0.5), Spectrum(0.0));
+    film.addPixel(Point2i(1, 0), Point2d(0.5, 0.5), Spectrum(2.0e-4));
+    EXPECT_NEAR(1.0e-4 / 1.0e-3, film.relativeError(Point2i(1, 0)), 1.0e-9);
+}
+
+TEST(FilmTest, TileWithoutVarianceKeepsEstimate) {
+    CaptureFilm film(Point2i(2, 2));
+    auto tile = film.filmTile();
+    EXPECT_FALSE(tile->variance());
+
+    // A tile created before the variance is enabled only adds the samples.
+    film.enableVariance();
+    tile->reset(Bounds2i(0, 0, 2, 2));
+    tile->addPixel(Point2i(0, 0), Point2d(0.5, 0.5), Spectrum(0.2));
+    tile->addPixel(Point2i(0, 0), Point2d(0.5, 0.5), Spectrum(0.6));
+    film.mergeFilmTile(*tile);
+    EXPECT_EQ(2, film.samples(Point2i(0, 0)));
+    EXPECT_EQ(INFTY, film.relativeError(Point2i(0, 0)));
+
+    EXPECT_TRUE(film.filmTile()->variance());
+}
@@ -0,0 +1,63 @@
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef SPICA_TEST_FILM_HELPER_H
+#define SPICA_TEST_FILM_HELPER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "spica.h"
+
+namespace spica {
+
+//! Filter which weights all the samples equally.
+class ConstantFilter : public Filter {
+public:
+    ConstantFilter() : Filter{ Vector2d(0.5, 0.5) } {}
+    double evaluate(const Point2d&) const override { return 1.0; }
+};
+
+/**
+ * Film which keeps the names and the last of the saved images instead of
+ * writing them.
+ */
+class CaptureFilm : public Film {
+public:
+    explicit CaptureFilm(const Point2i& resolution)
+        : Film{ resolution, std::make_shared<ConstantFilter>(), "image%03d" } {
+    }
+
+    ~CaptureFilm() {
+        // The writer calls "saveImage" of this class
+        close();
+    }
+
+    void saveImage(const std::string& filename, const Image& image) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_.push_back(filename);
+        image_ = image;
+    }
+
+    std::vector<std::string> saved() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return saved_;
+    }
+
+    Image image() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return image_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::vector<std::string> saved_;
+    mutable Image image_;
+};
+
+}  // namespace spica
+
+#endif  // SPICA_TEST_FILM_HELPER_H
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+
+#include "spica.h"
+#include "core/float.h"
+using namespace spica;
+
+// -----------------------------------------------------------------------------
+// Floating point utility Tests
+// -----------------------------------------------------------------------------
+
+template <class T>
+class FloatTest : public ::testing::Test {
+protected:
+    using limits = std::numeric_limits<T>;
+};
+
+using FloatTypes = ::testing::Types<float, double>;
+TYPED_TEST_CASE(FloatTest, FloatTypes);
+
+TYPED_TEST(FloatTest, NextFloatUp) {
+    using T = TypeParam;
+    using limits = typename TestFixture::limits;
+    const T zero = 0;
+    EXPECT_EQ(limits::denorm_min(), nextFloatUp(zero));
+    EXPECT_EQ(limits::denorm_min(), nextFloatUp(-zero));
+    EXPECT_EQ(zero, nextFloatUp(-limits::denorm_min()));
+    EXPECT_EQ(std::nextafter(T(1), T(2)), nextFloatUp(T(1)));
+    EXPECT_EQ(std::nextafter(T(-1), T(0)), nextFloatUp(T(-1)));
+    EXPECT_EQ(limits::infinity(), nextFloatUp(limits::infinity()));
+    EXPECT_EQ(-limits::max(), nextFloatUp(-limits::infinity()));
+    EXPECT_EQ(limits::infinity(), nextFloatUp(limits::max()));
+}
+
+TYPED_TEST(FloatTest, NextFloatDown) {
+    using T = TypeParam;
+    using limits = typename TestFixture::limits;
+    const T zero = 0;
+    EXPECT_EQ(-limits::denorm_min(), nextFloatDown(zero));
+    EXPECT_EQ(-limits::denorm_min(), nextFloatDown(-zero));
+    EXPECT_EQ(zero, nextFloatDown(limits::denorm_min()));
+    EXPECT_EQ(std::nextafter(T(1), T(0)), nextFloatDown(T(1)));
+    EXPECT_EQ(std::nextafter(T(-1), T(-2)), nextFloatDown(T(-1)));
+    EXPECT_EQ(-limits::infinity(), nextFloatDown(-limits::infinity()));
+    EXPECT_EQ(limits::max(), nextFloatDown(limits::infinity()));
+    EXPECT_EQ(-limits::infinity(), nextFloatDown(-limits::max()));
+}
+
+TYPED_TEST(FloatTest, Gamma) {
+    using T = TypeParam;
+    using limits = typename TestFixture::limits;
+    EXPECT_EQ(T(0), gamma<T>(0));
+    EXPECT_GT(gamma<T>(1), limits::epsilon() * T(0.5));
+    EXPECT_LT(gamma<T>(1), gamma<T>(2));
+}
@@ -16,14 +16,14 @@ TEST(BSphereTest, InstanceTest) {
     EXPECT_EQ(0.0, sp0.center().z());
     EXPECT_EQ(0.0, sp0.radius());
 
-    BSphere sp(Point3d(0.0, 0.0, 0.0), 2.0);
+    BSphere sp(Point3(0.0, 0.0, 0.0), 2.0);
     EXPECT_EQ(0.0, sp.center().x());
     EXPECT_EQ(0.0, sp.center().y());
     EXPECT_EQ(0.0, sp.center().z());
 }
 
 TEST(SphereTest, CopyConstructor) {
-    BSphere sp(Point3d(0.0, 0.0, 0.0), 2.0);
+    BSphere sp(Point3(0.0, 0.0, 0.0), 2.0);
     BSphere sp0 = sp;
     EXPECT_EQ(0.0, sp0.center().x());
     EXPECT_EQ(0.0, sp0.center().y());
@@ -35,91 +35,134 @@ TEST(SphereTest, CopyConstructor) {
 // ------------------------------
 TEST(TriangleTest, InstanceTest) {
     Triangle t0;
-    EXPECT_EQ(Point3d(), t0[0]);
-    EXPECT_EQ(Point3d(), t0[1]);
-    EXPECT_EQ(Point3d(), t0[2]);
-
-    Triangle t1(Point3d(0, 0, 0),
-                Point3d(0, 1, 0),
-                Point3d(1, 1, 0));
-    EXPECT_EQ(Point3d(0, 0, 0), t1[0]);
-    EXPECT_EQ(Point3d(0, 1, 0), t1[1]);
-    EXPECT_EQ(Point3d(1, 1, 0), t1[2]);
+    EXPECT_EQ(Point3(), t0[0]);
+    EXPECT_EQ(Point3(), t0[1]);
+    EXPECT_EQ(Point3(), t0[2]);
+
+    Triangle t1(Point3(0, 0, 0),
+                Point3(0, 1, 0),
+                Point3(1, 1, 0));
+    EXPECT_EQ(Point3(0, 0, 0), t1[0]);
+    EXPECT_EQ(Point3(0, 1, 0), t1[1]);
+    EXPECT_EQ(Point3(1, 1, 0), t1[2]);
 }
 
 TEST(TriangleTest, IntersectionTest) {
-    Triangle t0(Point3d(1, 0, 0),
-                Point3d(0, 0, 0),
-                Point3d(0, 1, 0));
-    Ray ray = Ray(Point3d(0, 0, -1), (Vector3d(1, 1, 1) - Vector3d(0, 0, -1)).normalized());
+    Triangle t0(Point3(1, 0, 0),
+                Point3(0, 0, 0),
+                Point3(0, 1, 0));
+    Ray ray = Ray(Point3(0, 0, -1), (Vector3(1, 1, 1) - Vector3(0, 0, -1)).normalized());
     
     SurfaceInteraction isect;
     double tHit;
     EXPECT_TRUE(t0.intersect(ray));
     EXPECT_TRUE(t0.intersect(ray, &tHit, &isect));
-    EXPECT_EQ(sqrt(6.0) / 2.0, tHit);
+    EXPECT_FLOAT_EQ(sqrt(6.0) / 2.0, tHit);
 
-    ray = Ray(Point3d(-0.1, -0.1, 1.0), Vector3d(0.0, 0.0, -1.0));
+    ray = Ray(Point3(-0.1, -0.1, 1.0), Vector3(0.0, 0.0, -1.0));
     EXPECT_FALSE(t0.intersect(ray));
     EXPECT_FALSE(t0.intersect(ray, &tHit, &isect));
 
-    ray = Ray(Point3d(0.6, 0.6, 1.0), Vector3d(0.0, 0.0, -1.0));
+    ray = Ray(Point3(0.6, 0.6, 1.0), Vector3(0.0, 0.0, -1.0));
     EXPECT_FALSE(t0.intersect(ray));
     EXPECT_FALSE(t0.intersect(ray, &tHit, &isect));
 
-    ray = Ray(Point3d(-0.1, 1.1, 1.0), Vector3d(0.0, 0.0, -1.0));
+    ray = Ray(Point3(-0.1, 1.1, 1.0), Vector3(0.0, 0.0, -1.0));
     EXPECT_FALSE(t0.intersect(ray));
     EXPECT_FALSE(t0.intersect(ray, &tHit, &isect));
 
-    ray = Ray(Point3d(1.1, -0.1, 1.0), Vector3d(0.0, 0.0, -1.0));
+    ray = Ray(Point3(1.1, -0.1, 1.0), Vector3(0.0, 0.0, -1.0));
     EXPECT_FALSE(t0.intersect(ray));
     EXPECT_FALSE(t0.intersect(ray, &tHit, &isect));
 }
 
 TEST(TriangleTest, AreaTest) {
-    Triangle t0(Point3d(1, 0, 0),
-                Point3d(0, 0, 0),
-                Point3d(0, 1, 0));
+    Triangle t0(Point3(1, 0, 0),
+                Point3(0, 0, 0),
+                Point3(0, 1, 0));
     EXPECT_EQ(0.5, t0.area());
 }
 
 // ------------------------------
-// Bounds3d class test
+// TriangleMesh class test
+// ------------------------------
+TEST(TriangleMeshTest, InstanceTest) {
+    std::vector<Point3> positions = { Point3(-10.0, 0.0, -10.0), Point3(-10.0, 0.0, 10.0),
+                                       Point3( 10.0, 0.0, -10.0), Point3( 10.0, 0.0, 10.0) };
+    std::vector<int> indices = { 0, 1, 3, 3, 2, 0 };
+    TriangleMesh mesh(positions, indices);
+    EXPECT_EQ(2, mesh.numFaces());
+    EXPECT_EQ(4, mesh.numVerts());
+    EXPECT_FALSE(mesh.hasNormals());
+    EXPECT_FALSE(mesh.hasTexcoords());
+
+    Triangle t1 = mesh.triangle(1);
+    EXPECT_EQ(Point3(10.0, 0.0, 10.0), t1[0]);
+    EXPECT_EQ(Point3(10.0, 0.0, -10.0), t1[1]);
+    EXPECT_EQ(Point3(-10.0, 0.0, -10.0), t1[2]);
+    EXPECT_EQ(200.0, t1.area());
+}
+
+TEST(TriangleMeshTest, IntersectionTest) {
+    std::vector<Point3> positions = { Point3(1, 0, 0), Point3(0, 0, 0), Point3(0, 1, 0) };
+    std::vector<int> indices = { 0, 1, 2 };
+    TriangleMesh mesh(positions, indices);
+    Triangle t0(Point3(1, 0, 0),
+                Point3(0, 0, 0),
+                Point3(0, 1, 0));
+
+    Ray ray = Ray(Point3(0, 0, -1), (Vector3(1, 1, 1) - Vector3(0, 0, -1)).normalized());
+    SurfaceInteraction isect, isectGT;
+    double tHit, tHitGT;
+    EXPECT_TRUE(mesh.intersect(0, ray));
+    EXPECT_TRUE(mesh.intersect(0, ray, &tHit, &isect));
+    EXPECT_TRUE(t0.intersect(ray, &tHitGT, &isectGT));
+    EXPECT_EQ(tHitGT, tHit);
+    EXPECT_EQ(isectGT.pos(), isect.pos());
+    EXPECT_EQ(isectGT.normal(), isect.normal());
+
+    ray = Ray(Point3(0.6, 0.6, 1.0), Vector3(0.0, 0.0, -1.0));
+    EXPECT_FALSE(mesh.intersect(0, ray));
+    EXPECT_FALSE(mesh.intersect(0, ray, &tHit, &isect));
+}
+
+// ------------------------------
+// Bounds3 class test
 // ------------------------------
 TEST(Bounds3dTest, InstanceTest) {
-    Bounds3d b;
-    const double minValue = std::numeric_limits<double>::lowest();
-    const double maxValue = std::numeric_limits<double>::max();
-    EXPECT_EQ(Point3d(maxValue, maxValue, maxValue), b.posMin());
-    EXPECT_EQ(Point3d(minValue, minValue, minValue), b.posMax());
-
-    Bounds3d b0(Point3d(0.0, 0.0, 0.0), Point3d(1.0, 1.0, 1.0));
-    EXPECT_EQ(Point3d(0.0, 0.0, 0.0), b0.posMin());
-    EXPECT_EQ(Point3d(1.0, 1.0, 1.0), b0.posMax());
+    Bounds3 b;
+    const Float minValue = std::numeric_limits<Float>::lowest();
+    const Float maxValue = std::numeric_limits<Float>::max();
+    EXPECT_EQ(Point3(maxValue, maxValue, maxValue), b.posMin());
+    EXPECT_EQ(Point3(minValue, minValue, minValue), b.posMax());
+
+    Bounds3 b0(Point3(0.0, 0.0, 0.0), Point3(1.0, 1.0, 1.0));
+    EXPECT_EQ(Point3(0.0, 0.0, 0.0), b0.posMin());
+    EXPECT_EQ(Point3(1.0, 1.0, 1.0), b0.posMax());
 }
 
 TEST(Bounds3dTest, CopyConstructor) {
-    Bounds3d b0(Point3d(0.0, 0.0, 0.0), Point3d(1.0, 1.0, 1.0));
-    Bounds3d b1(b0);
-    EXPECT_EQ(Point3d(0.0, 0.0, 0.0), b1.posMin());
-    EXPECT_EQ(Point3d(1.0, 1.0, 1.0), b1.posMax());
+    Bounds3 b0(Point3(0.0, 0.0, 0.0), Point3(1.0, 1.0, 1.0));
+    Bounds3 b1(b0);
+    EXPECT_EQ(Point3(0.0, 0.0, 0.0), b1.posMin());
+    EXPECT_EQ(Point3(1.0, 1.0, 1.0), b1.posMax());
 }
 
 TEST(Bounds3dTest, MergeTest) {
-    Bounds3d Bounds3d;
-    Bounds3d.merge(Point3d(0.0, 0.0, 0.0));
-    EXPECT_EQ(Point3d(0.0, 0.0, 0.0), Bounds3d.posMin());
-    EXPECT_EQ(Point3d(0.0, 0.0, 0.0), Bounds3d.posMax());
-
-    Bounds3d.merge(Point3d(1.0, 1.0, 1.0));
-    EXPECT_EQ(Point3d(0.0, 0.0, 0.0), Bounds3d.posMin());
-    EXPECT_EQ(Point3d(1.0, 1.0, 1.0), Bounds3d.posMax());
+    Bounds3 Bounds3;
+    Bounds3.merge(Point3(0.0, 0.0, 0.0));
+    EXPECT_EQ(Point3(0.0, 0.0, 0.0), Bounds3.posMin());
+    EXPECT_EQ(Point3(0.0, 0.0, 0.0), Bounds3.posMax());
+
+    Bounds3.merge(Point3(1.0, 1.0, 1.0));
+    EXPECT_EQ(Point3(0.0, 0.0, 0.0), Bounds3.posMin());
+    EXPECT_EQ(Point3(1.0, 1.0, 1.0), Bounds3.posMax());
 }
 
 TEST(Bounds3dTest, IntersectionTest) {
-    Bounds3d b0(Point3d(0.0, 0.0, 0.0), Point3d(1.0, 1.0, 1.0));
+    Bounds3 b0(Point3(0.0, 0.0, 0.0), Point3(1.0, 1.0, 1.0));
     double tMin, tMax;
-    b0.intersect(Ray(Point3d(0.5, 0.5, -1.0), Vector3d(0.0, 0.0, 1.0)), &tMin, &tMax);
+    b0.intersect(Ray(Point3(0.5, 0.5, -1.0), Vector3(0.0, 0.0, 1.0)), &tMin, &tMax);
     EXPECT_DOUBLE_EQ(1.0, tMin);
     EXPECT_DOUBLE_EQ(2.0, tMax);
 }
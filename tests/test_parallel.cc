@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "spica.h"
+using namespace spica;
+
+namespace {
+
+/**
+ * Number of the threads in the tests, which may be more than the cores so
+ * that the steals and the nested calls are tested on any machine.
+ */
+const int kNumThreads = 4;
+
+}  // anonymous namespace
+
+class ParallelTest : public ::testing::Test {
+protected:
+    void SetUp() {
+        prevThreads = numSystemThreads();
+        setNumThreads(kNumThreads, true);
+    }
+
+    void TearDown() {
+        setNumThreads(prevThreads, true);
+    }
+
+    int prevThreads = 1;
+};
+
+TEST_F(ParallelTest, ParallelFor) {
+    const int n = 10000;
+    std::vector<int> values(n, 0);
+    parallel_for(0, n, [&](int i) {
+        values[i] += i;
+    });
+
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(i, values[i]);
+    }
+}
+
+TEST_F(ParallelTest, ParallelForWithOffset) {
+    std::atomic<int> count(0);
+    std::atomic<int> sum(0);
+    parallel_for(100, 200, [&](int i) {
+        count++;
+        sum += i;
+    }, ParallelSchedule::Static);
+
+    EXPECT_EQ(100, count);
+    EXPECT_EQ((100 + 199) * 100 / 2, sum);
+}
+
+TEST_F(ParallelTest, ThreadID) {
+    const int nThreads = numSystemThreads();
+    ASSERT_EQ(kNumThreads, nThreads);
+    std::atomic<bool> valid(true);
+    parallel_for(0, 1000, [&](int i) {
+        const int id = getThreadID();
+        if (id < 0 || id >= nThreads) valid = false;
+    });
+    EXPECT_TRUE(valid);
+}
+
+TEST_F(ParallelTest, NestedParallelFor) {
+    const int n = 64;
+    std::atomic<int> count(0);
+    std::vector<std::atomic<int>> perThread(kNumThreads);
+    for (auto &c : perThread) c = 0;
+    parallel_for(0, n, [&](int i) {
+        parallel_for(0, n, [&](int j) {
+            // Some work so that the other threads join the inner loops
+            volatile int s = 0;
+            for (int k = 0; k < 1000; k++) s += k;
+            count++;
+            perThread[getThreadID()]++;
+        });
+    });
+    EXPECT_EQ(n * n, count);
+
+    int nWorking = 0;
+    for (auto &c : perThread) nWorking += c > 0 ? 1 : 0;
+    EXPECT_GT(nWorking, 1);
+}
+
+TEST_F(ParallelTest, ConcurrentParallelFor) {
+    const int n = 1000;
+    std::atomic<int> count(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            for (int k = 0; k < 10; k++) {
+                parallel_for(0, n, [&](int i) {
+                    count++;
+                });
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(4 * 10 * n, count);
+}
+
+class ParallelScheduleTest : public ::testing::TestWithParam<ParallelSchedule> {
+protected:
+    void SetUp() {
+        prevThreads = numSystemThreads();
+        setNumThreads(kNumThreads, true);
+    }
+
+    void TearDown() {
+        setNumThreads(prevThreads, true);
+    }
+
+    int prevThreads = 1;
+};
+
+TEST_P(ParallelScheduleTest, EachIndexOnce) {
+    const int n = 12345;
+    std::vector<std::atomic<int>> counts(n);
+    for (auto &c : counts) c = 0;
+
+    parallel_for(0, n, [&](int i) {
+        counts[i]++;
+    }, GetParam());
+
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(1, counts[i]);
+    }
+}
+
+TEST_P(ParallelScheduleTest, Imbalanced) {
+    const int n = 2000;
+    std::atomic<int64_t> sum(0);
+    std::vector<std::atomic<int>> perThread(kNumThreads);
+    for (auto &c : perThread) c = 0;
+    parallel_for(0, n, [&](int i) {
+        // Later iterations are much heavier than earlier ones.
+        volatile int64_t s = 0;
+        for (int k = 0; k < i * 10; k++) s += k;
+        sum += i;
+        perThread[getThreadID()]++;
+    }, GetParam());
+    EXPECT_EQ((int64_t)n * (n - 1) / 2, sum);
+
+    // The heavy iterations are shared by all the threads.
+    for (int t = 0; t < kNumThreads; t++) {
+        EXPECT_GT(perThread[t], 0) << "thread " << t;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(Schedules, ParallelScheduleTest,
+                        ::testing::Values(ParallelSchedule::Static,
+                                          ParallelSchedule::Dynamic,
+                                          ParallelSchedule::Guided));
@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spica.h"
+#include "core/samplemap.h"
+#include "test_film_helper.h"
+using namespace spica;
+
+// -----------------------------------------------------------------------------
+// SampleMap Tests
+// -----------------------------------------------------------------------------
+
+class SampleMapTest : public ::testing::Test {
+protected:
+    SampleMapTest()
+        : film(Point2i(kSize, kSize))
+        , tiles({ Bounds2i(0, 0, 4, 4), Bounds2i(4, 0, 8, 4),
+                  Bounds2i(0, 4, 4, 8), Bounds2i(4, 4, 8, 8) }) {
+        film.enableVariance();
+    }
+
+    //! Add the samples of the luminance to the pixel.
+    void addSamples(int x, int y, const std::vector<double>& lums) {
+        for (double l : lums) {
+            film.addPixel(Point2i(x, y), Point2d(0.5, 0.5), Spectrum(l));
+        }
+    }
+
+    //! Make all the pixels converged with two equal samples.
+    void converge() {
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                addSamples(x, y, { 0.5, 0.5 });
+            }
+        }
+    }
+
+    int totalSamples(const SampleMap& map) const {
+        int total = 0;
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                total += map.samples(x, y);
+            }
+        }
+        return total;
+    }
+
+    static constexpr int kSize = 8;
+
+    CaptureFilm film;
+    std::vector<Bounds2i> tiles;
+};
+
+TEST_F(SampleMapTest, SamplesAllPixelsByDefault) {
+    SampleMap map(film.resolution(), tiles);
+    EXPECT_EQ(kSize * kSize, totalSamples(map));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), map.activeTiles());
+}
+
+TEST_F(SampleMapTest, UnconvergedPixelsBeforeMinSamples) {
+    SampleMap map(film.resolution(), tiles);
+    map.setAdaptive(4, 0.01);
+
+    // The error of the pixels with too few samples is not trusted.
+    converge();
+    EXPECT_EQ(kSize * kSize, map.update(film, 1000));
+    EXPECT_EQ(kSize * kSize, totalSamples(map));
+
+    addSamples(0, 0, { 0.5, 0.5 });
+    EXPECT_EQ(kSize * kSize - 1, map.update(film, 1000));
+    EXPECT_EQ(0, map.samples(0, 0));
+}
+
+TEST_F(SampleMapTest, ShareBudget) {
+    SampleMap map(film.resolution(), tiles);
+    map.setAdaptive(2, 0.01);
+    converge();
+    EXPECT_EQ(0, map.update(film, 1000));
+    EXPECT_TRUE(map.activeTiles().empty());
+
+    // 64 / 8 active pixels take 8 samples each.
+    for (int x = 0; x < 8; x++) {
+        addSamples(x, 1, { 0.2, 0.8 });
+    }
+    EXPECT_EQ(8, map.update(film, 1000));
+    EXPECT_EQ(std::vector<int>({ 0, 1 }), map.activeTiles());
+    for (int x = 0; x < 8; x++) {
+        EXPECT_EQ(8, map.samples(x, 1));
+        EXPECT_EQ(0, map.samples(x, 0));
+    }
+    EXPECT_EQ(64, totalSamples(map));
+}
+
+TEST_F(SampleMapTest, SharePerPixelIsLimited) {
+    SampleMap map(film.resolution(), tiles);
+    map.setAdaptive(2, 0.01);
+    converge();
+
+    // A single active pixel takes at most 16 samples, not 64.
+    addSamples(5, 6, { 0.2, 0.8 });
+    EXPECT_EQ(1, map.update(film, 1000));
+    EXPECT_EQ(std::vector<int>({ 3 }), map.activeTiles());
+    EXPECT_EQ(16, map.samples(5, 6));
+    EXPECT_EQ(16, totalSamples(map));
+}
+
+TEST_F(SampleMapTest, ClampToMaxSamples) {
+    SampleMap map(film.resolution(), tiles);
+    map.setAdaptive(2, 0.01);
+    converge();
+    addSamples(1, 1, { 0.2, 0.8 });                       // 4 samples
+    addSamples(6, 6, { 0.2, 0.8, 0.2, 0.8, 0.2, 0.8 });   // 8 samples
+
+    // The pixel which reached the maximum is not sampled.
+    EXPECT_EQ(1, map.update(film, 8));
+    EXPECT_EQ(0, map.samples(6, 6));
+    EXPECT_EQ(4, map.samples(1, 1));
+
+    EXPECT_EQ(2, map.update(film, 10));
+    EXPECT_EQ(6, map.samples(1, 1));
+    EXPECT_EQ(2, map.samples(6, 6));
+}
+
+TEST_F(SampleMapTest, TopKTiles) {
+    converge();
+    addSamples(1, 1, { 0.2, 0.8 });  // Tile 0
+    addSamples(5, 1, { 0.1, 0.9 });  // Tile 1, of the largest error
+    addSamples(5, 5, { 0.3, 0.7 });  // Tile 3, of the smallest error
+
+    SampleMap top1(film.resolution(), tiles);
+    top1.setAdaptive(2, 0.01, 1);
+    EXPECT_EQ(1, top1.update(film, 1000));
+    EXPECT_EQ(std::vector<int>({ 1 }), top1.activeTiles());
+    EXPECT_EQ(0, top1.samples(1, 1));
+    EXPECT_EQ(16, top1.samples(5, 1));
+    EXPECT_EQ(0, top1.samples(5, 5));
+
+    // The active tiles are kept in the order of the tiles.
+    SampleMap top2(film.resolution(), tiles);
+    top2.setAdaptive(2, 0.01, 2);
+    EXPECT_EQ(2, top2.update(film, 1000));
+    EXPECT_EQ(std::vector<int>({ 0, 1 }), top2.activeTiles());
+    EXPECT_EQ(16, top2.samples(1, 1));
+    EXPECT_EQ(0, top2.samples(5, 5));
+
+    // Without the limit, all the tiles with active pixels are sampled.
+    SampleMap all(film.resolution(), tiles);
+    all.setAdaptive(2, 0.01);
+    EXPECT_EQ(3, all.update(film, 1000));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 3 }), all.activeTiles());
+}
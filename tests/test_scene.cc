@@ -21,8 +21,8 @@ protected:
     virtual void SetUp() {
         std::vector<std::shared_ptr<Primitive>> prims;
         std::vector<std::shared_ptr<Light>> lights;
-        auto s1 = std::make_shared<Sphere>(Point3d(0.0, 0.0, 0.0), 5.0);
-        auto s2 = std::make_shared<Sphere>(Point3d(0.0, 10.0, 0.0), 2.0);
+        auto s1 = std::make_shared<Sphere>(Point3(0.0, 0.0, 0.0), 5.0);
+        auto s2 = std::make_shared<Sphere>(Point3(0.0, 10.0, 0.0), 2.0);
         prims.emplace_back(new GeometricPrimitive(s1, nullptr, nullptr));
         prims.emplace_back(new GeometricPrimitive(s2, nullptr, nullptr));
         auto bvh = std::make_shared<AccelType>(prims);
@@ -44,14 +44,14 @@ TYPED_TEST_CASE_P(SceneTypedTest);
 
 TYPED_TEST_P(SceneTypedTest, IntersectionTest) {
     SurfaceInteraction isect;
-    Ray ray(Point3d(0.0, 0.0, 10.0), Vector3d(0.0, 0.0, -1.0));
+    Ray ray(Point3(0.0, 0.0, 10.0), Vector3(0.0, 0.0, -1.0));
     EXPECT_TRUE(this->scene.intersect(ray));
     EXPECT_TRUE(this->scene.intersect(ray, &isect));
 
     EXPECT_NE(isect.primitive(), nullptr);
-    EXPECT_EQ(Point3d(0.0, 0.0, 5.0), isect.pos());
+    EXPECT_EQ(Point3(0.0, 0.0, 5.0), isect.pos());
 
-    ray = Ray(Point3d(0.0, 0.0, 10.0), Vector3d(0.0, 1.0, 0.0));
+    ray = Ray(Point3(0.0, 0.0, 10.0), Vector3(0.0, 1.0, 0.0));
     EXPECT_FALSE(this->scene.intersect(ray));
     EXPECT_FALSE(this->scene.intersect(ray, &isect));
 }
@@ -101,20 +101,20 @@ TEST_P(SceneIntersectionTest, DISABLED_BBVHvsQBVH) {
 
     Random rng((unsigned int)time(0));
 
-    Bounds3d bounds = scene1.worldBound();
-    Vector3d bsize = bounds.posMax() - bounds.posMin();
-    Point3d centroid = bounds.posMin() + bsize * 0.5;
-    bounds = Bounds3d(centroid - bsize, centroid + bsize);
+    Bounds3 bounds = scene1.worldBound();
+    Vector3 bsize = bounds.posMax() - bounds.posMin();
+    Point3 centroid = bounds.posMin() + bsize * 0.5;
+    bounds = Bounds3(centroid - bsize, centroid + bsize);
 
-    Point3d f(0.0, 0.0, 2.0);
-    Point3d t(0.0, 0.0, -2.0);
-    Vector3d dir = (t - f).normalized();
+    Point3 f(0.0, 0.0, 2.0);
+    Point3 t(0.0, 0.0, -2.0);
+    Vector3 dir = (t - f).normalized();
     Ray ray(f, dir);
 
     for (int i = 0; i < nTrial; i++) {
-        Point3d f = bounds.posMin() + Vector3d(bsize.x() * rng.get1D(), bsize.y() * rng.get1D(), bsize.z() * rng.get1D());
-        Point3d t = bounds.posMin() + Vector3d(bsize.x() * rng.get1D(), bsize.y() * rng.get1D(), bsize.z() * rng.get1D());
-        Vector3d dir = (t - f).normalized();
+        Point3 f = bounds.posMin() + Vector3(bsize.x() * rng.get1D(), bsize.y() * rng.get1D(), bsize.z() * rng.get1D());
+        Point3 t = bounds.posMin() + Vector3(bsize.x() * rng.get1D(), bsize.y() * rng.get1D(), bsize.z() * rng.get1D());
+        Vector3 dir = (t - f).normalized();
         Ray ray(f, dir);
 
         SurfaceInteraction isect1, isect2;
@@ -236,6 +236,20 @@ TEST_P(Vector3dUnaryTest, ToStringAndCout) {
     EXPECT_EQ(ss.str(), v1.toString());
 }
 
+TEST_F(Vector3dTest, SinglePrecision) {
+    const Vector3f v(1.0f, 2.0f, 2.0f);
+    static_assert(std::is_same<decltype(v.norm()), float>::value,
+                  "Norm of Vector3f must be float!!");
+    EXPECT_FLOAT_EQ(3.0f, v.norm());
+
+    const Vector3f u = 2.0f * v / 4.0f;
+    EXPECT_FLOAT_EQ(0.5f, u.x());
+    EXPECT_FLOAT_EQ(1.0f, u.y());
+    EXPECT_FLOAT_EQ(1.0f, u.z());
+
+    EXPECT_FLOAT_EQ(1.0f, v.normalized().norm());
+}
+
 std::vector<Vector3d> vectors = {
     Vector3d(0.0, 1.0, 2.0),
     Vector3d(-2.0, -1.0, 0.0),
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spica.h"
+#include "core/material.h"
+#include "test_film_helper.h"
+using namespace spica;
+
+namespace {
+
+//! Mean luminance of the block of the image.
+double blockMean(const Image& image, int x0, int y0, int size) {
+    double sum = 0.0;
+    for (int y = y0; y < y0 + size; y++) {
+        for (int x = x0; x < x0 + size; x++) {
+            sum += image(x, y).gray();
+        }
+    }
+    return sum / (size * size);
+}
+
+}  // anonymous namespace
+
+// -----------------------------------------------------------------------------
+// Wavefront Integrator Tests
+// -----------------------------------------------------------------------------
+
+class WavefrontTest : public ::testing::Test {
+protected:
+    WavefrontTest() {}
+    virtual ~WavefrontTest() {}
+
+    virtual void SetUp() {
+        RenderParams& params = RenderParams::getInstance();
+        params.clear();
+        PluginManager& plugins = PluginManager::getInstance();
+
+        // Box whose front is open, lit by a small light below the ceiling
+        params.add("reflectance", Spectrum(0.7));
+        plugins.initModule("diffuse");
+        auto bsdf = std::shared_ptr<SurfaceMaterial>(
+            (SurfaceMaterial*)plugins.createObject("diffuse", params));
+        auto material = std::make_shared<Material>(bsdf, nullptr);
+
+        addQuad(Point3(-1.0, 0.0, -1.0), Point3(1.0, 0.0, -1.0),
+                Point3(1.0, 0.0, 1.0), Point3(-1.0, 0.0, 1.0), material);
+        addQuad(Point3(-1.0, 2.0, -1.0), Point3(1.0, 2.0, -1.0),
+                Point3(1.0, 2.0, 1.0), Point3(-1.0, 2.0, 1.0), material);
+        addQuad(Point3(-1.0, 0.0, -1.0), Point3(1.0, 0.0, -1.0),
+                Point3(1.0, 2.0, -1.0), Point3(-1.0, 2.0, -1.0), material);
+        addQuad(Point3(-1.0, 0.0, -1.0), Point3(-1.0, 2.0, -1.0),
+                Point3(-1.0, 2.0, 1.0), Point3(-1.0, 0.0, 1.0), material);
+        addQuad(Point3(1.0, 0.0, -1.0), Point3(1.0, 2.0, -1.0),
+                Point3(1.0, 2.0, 1.0), Point3(1.0, 0.0, 1.0), material);
+
+        // The light faces downward.
+        plugins.initModule("area");
+        const double y = 1.99;
+        const Point3 lightPos[4] = {
+            Point3(-0.3, y, -0.3), Point3(0.3, y, -0.3),
+            Point3(0.3, y, 0.3), Point3(-0.3, y, 0.3)
+        };
+        for (int i = 0; i < 2; i++) {
+            auto tri = std::make_shared<Triangle>(lightPos[0], lightPos[i + 1], lightPos[i + 2]);
+            params.add("shape", std::static_pointer_cast<CObject>(tri));
+            params.add("toWorld", Transform());
+            params.add("radiance", Spectrum(8.0));
+            auto light = std::shared_ptr<Light>((Light*)plugins.createObject("area", params));
+            lights.push_back(light);
+            prims.push_back(std::make_shared<GeometricPrimitive>(tri, material, light));
+        }
+
+        plugins.initAccelerator("bvh");
+        accel = std::shared_ptr<Accelerator>(plugins.createAccelerator("bvh", prims, params));
+    }
+
+    void addQuad(const Point3& p0, const Point3& p1, const Point3& p2, const Point3& p3,
+                 const std::shared_ptr<Material>& material) {
+        prims.push_back(std::make_shared<GeometricPrimitive>(
+            std::make_shared<Triangle>(p0, p1, p2), material, nullptr));
+        prims.push_back(std::make_shared<GeometricPrimitive>(
+            std::make_shared<Triangle>(p0, p2, p3), material, nullptr));
+    }
+
+    //! Render the scene with the integrator and return the image.
+    Image render(const std::string& integrator) {
+        RenderParams& params = RenderParams::getInstance();
+        PluginManager& plugins = PluginManager::getInstance();
+        auto film = std::make_shared<CaptureFilm>(Point2i(kSize, kSize));
+
+        params.add("toWorld", Transform::lookAt(Point3(0.0, 1.0, 3.5),
+                                                Point3(0.0, 1.0, 0.0),
+                                                Vector3(0.0, 1.0, 0.0)));
+        params.add("fov", 40.0);
+        params.add("film", std::static_pointer_cast<CObject>(film));
+        plugins.initModule("perspective");
+        auto camera = std::shared_ptr<Camera>((Camera*)plugins.createObject("perspective", params));
+
+        plugins.initModule("independent");
+        params.add("sampler", std::shared_ptr<CObject>(plugins.createObject("independent", params)));
+        params.add("maxDepth", 8);
+        params.add("sampleCount", kNumSamples);
+        params.add("wavefrontSize", kSize * kSize / 4);
+
+        plugins.initModule(integrator);
+        auto integ = std::shared_ptr<Integrator>((Integrator*)plugins.createObject(integrator, params));
+        integ->render(camera, Scene(accel, lights), params);
+        return film->image();
+    }
+
+    static constexpr int kSize = 16;
+    static constexpr int kNumSamples = 256;
+    static constexpr int kBlockSize = 8;
+
+    std::vector<std::shared_ptr<Primitive>> prims;
+    std::vector<std::shared_ptr<Light>> lights;
+    std::shared_ptr<Accelerator> accel;
+};
+
+TEST_F(WavefrontTest, MatchesPathTracing) {
+    const Image expected = render("path");
+    const Image actual = render("wavefront");
+    ASSERT_EQ(expected.width(), actual.width());
+    ASSERT_EQ(expected.height(), actual.height());
+
+    const double mean = blockMean(expected, 0, 0, kSize);
+    ASSERT_GT(mean, 0.0);
+    EXPECT_NEAR(mean, blockMean(actual, 0, 0, kSize), 0.02 * mean);
+
+    // Each block of pixels converges to the same value.
+    for (int y = 0; y < kSize; y += kBlockSize) {
+        for (int x = 0; x < kSize; x += kBlockSize) {
+            const double m = blockMean(expected, x, y, kBlockSize);
+            EXPECT_NEAR(m, blockMean(actual, x, y, kBlockSize), 0.05 * m)
+                << "block (" << x << ", " << y << ")";
+        }
+    }
+}